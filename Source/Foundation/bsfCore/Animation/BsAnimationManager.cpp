@@ -15,6 +15,9 @@ namespace bs
 {
 	AnimationManager::AnimationManager()
 	{
+		mAnimData.resize(gCoreThread().getNumSyncBuffers() + 1);
+		mPoseReadBufferIdx = (UINT32)mAnimData.size() - 1;
+
 		mBlendShapeVertexDesc = VertexDataDesc::create();
 		mBlendShapeVertexDesc->addVertElem(VET_FLOAT3, VES_POSITION, 1, 1);
 		mBlendShapeVertexDesc->addVertElem(VET_UBYTE4_NORM, VES_NORMAL, 1, 1);
@@ -45,8 +48,9 @@ namespace bs
 			// Advance the buffers (last write buffer becomes read buffer)
 			if(mSwapBuffers)
 			{
-				mPoseReadBufferIdx = (mPoseReadBufferIdx + 1) % (CoreThread::NUM_SYNC_BUFFERS + 1);
-				mPoseWriteBufferIdx = (mPoseWriteBufferIdx + 1) % (CoreThread::NUM_SYNC_BUFFERS + 1);
+				const auto numBuffers = (UINT32)mAnimData.size();
+				mPoseReadBufferIdx = (mPoseReadBufferIdx + 1) % numBuffers;
+				mPoseWriteBufferIdx = (mPoseWriteBufferIdx + 1) % numBuffers;
 
 				mSwapBuffers = false;
 			}
@@ -112,45 +116,28 @@ namespace bs
 		renderData.transforms.resize(totalNumBones);
 		renderData.infos.clear();
 
-		// Queue animation evaluation tasks
-		{
-			Lock lock(mMutex);
-			mNumActiveWorkers = (UINT32)mProxies.size();
-		}
+		// Calculate where in the output buffer will each animation write its bones
+		mProxyBoneOffsets.resize(mProxies.size());
 
 		UINT32 curBoneIdx = 0;
-		for (auto& anim : mProxies)
+		for (UINT32 i = 0; i < (UINT32)mProxies.size(); i++)
 		{
-			auto evaluateAnimWorker = [this, anim, curBoneIdx]()
-			{
-				UINT32 boneIdx = curBoneIdx;
-				evaluateAnimation(anim.get(), boneIdx);
-
-				Lock lock(mMutex);
-				{
-					assert(mNumActiveWorkers > 0);
-					mNumActiveWorkers--;
-				}
-
-				mWorkerDoneSignal.notify_one();
-			};
-
-			SPtr<Task> task = Task::create("AnimWorker", evaluateAnimWorker);
-			TaskScheduler::instance().addTask(task);
+			mProxyBoneOffsets[i] = curBoneIdx;
 
+			const SPtr<AnimationProxy>& anim = mProxies[i];
 			if (anim->skeleton != nullptr)
 				curBoneIdx += anim->skeleton->getNumBones();
 		}
 
-		// Wait for tasks to complete
-		if(!async)
+		const auto evaluateAnimWorker = [this](UINT32 idx)
 		{
-			{
-				Lock lock(mMutex);
+			UINT32 boneIdx = mProxyBoneOffsets[idx];
+			evaluateAnimation(mProxies[idx].get(), boneIdx);
+		};
 
-				while (mNumActiveWorkers > 0)
-					mWorkerDoneSignal.wait(lock);
-			}
+		if(!async)
+		{
+			TaskScheduler::instance().parallelFor(0, (UINT32)mProxies.size(), 1, evaluateAnimWorker);
 
 			// Trigger events and update attachments (for the data we just evaluated)
 			for (auto& anim : mAnimations)
@@ -159,6 +146,31 @@ namespace bs
 				anim.second->triggerEvents(timeDelta);
 			}
 		}
+		else
+		{
+			// Evaluate in the background, the next update() call will wait until it finishes
+			{
+				Lock lock(mMutex);
+				mNumActiveWorkers = 1;
+			}
+
+			auto evaluateAllWorker = [this, evaluateAnimWorker]()
+			{
+				TaskScheduler::instance().parallelFor(0, (UINT32)mProxies.size(), 1, evaluateAnimWorker);
+
+				{
+					Lock lock(mMutex);
+
+					assert(mNumActiveWorkers > 0);
+					mNumActiveWorkers--;
+				}
+
+				mWorkerDoneSignal.notify_one();
+			};
+
+			SPtr<Task> task = Task::create("AnimWorker", evaluateAllWorker);
+			TaskScheduler::instance().addTask(task);
+		}
 
 		mSwapBuffers = true;
 
@@ -188,7 +200,8 @@ namespace bs
 
 		EvaluatedAnimationData& renderData = mAnimData[mPoseWriteBufferIdx];
 		
-		UINT32 prevPoseBufferIdx = (mPoseWriteBufferIdx + CoreThread::NUM_SYNC_BUFFERS) % (CoreThread::NUM_SYNC_BUFFERS + 1);
+		const auto numBuffers = (UINT32)mAnimData.size();
+		UINT32 prevPoseBufferIdx = (mPoseWriteBufferIdx + numBuffers - 1) % numBuffers;
 		EvaluatedAnimationData& prevRenderData = mAnimData[prevPoseBufferIdx];
 
 		EvaluatedAnimationData::AnimInfo animInfo;
@@ -128,10 +128,11 @@ namespace bs
 
 		// Animation thread
 		Vector<SPtr<AnimationProxy>> mProxies;
+		Vector<UINT32> mProxyBoneOffsets;
 		Vector<ConvexVolume> mCullFrustums;
-		EvaluatedAnimationData mAnimData[CoreThread::NUM_SYNC_BUFFERS + 1];
+		Vector<EvaluatedAnimationData> mAnimData; /**< One buffer per core thread sync buffer, plus one for async evaluation. */
 
-		UINT32 mPoseReadBufferIdx = 2;
+		UINT32 mPoseReadBufferIdx = 0;
 		UINT32 mPoseWriteBufferIdx = 0;
 		
 		Signal mWorkerDoneSignal;
@@ -48,8 +48,18 @@
 
 namespace bs
 {
+	/** Portion of the expected sync wait time that the start of a sim frame is delayed by, when frame pacing is on. */
+	static constexpr float FRAME_PACING_FACTOR = 0.8f;
+
+	/** Maximum time the start of a sim frame can be delayed by, when frame pacing is on. In microseconds. */
+	static constexpr UINT64 MAX_FRAME_PACING_DELAY = 100000;
+
+	/** Weight of the most recent frame when calculating the average sync wait time used for frame pacing. */
+	static constexpr float FRAME_PACING_SMOOTHING = 0.1f;
+
 	CoreApplication::CoreApplication(START_UP_DESC desc)
-		: mPrimaryWindow(nullptr), mStartUpDesc(desc), mRendererPlugin(nullptr), mIsFrameRenderingFinished(true)
+		: mPrimaryWindow(nullptr), mStartUpDesc(desc), mRendererPlugin(nullptr), mNumFramesInFlight(0)
+		, mMaxFramesInFlight(1)
 		, mSimThreadId(BS_THREAD_CURRENT_ID), mRunMainLoop(false)
 	{
 		// Ensure all errors are reported properly
@@ -135,7 +145,8 @@ namespace bs
 		TaskScheduler::startUp();
 		TaskScheduler::instance().removeWorker();
 		RenderStats::startUp();
-		CoreThread::startUp();
+		CoreThread::startUp(mStartUpDesc.maxFramesInFlight);
+		mMaxFramesInFlight = gCoreThread().getMaxFramesInFlight();
 		StringTableManager::startUp();
 		DeferredCallManager::startUp();
 		Time::startUp();
@@ -186,32 +197,20 @@ namespace bs
 		{
 			// Limit FPS if needed
 			if (mFrameStep > 0)
-			{
-				UINT64 currentTime = gTime().getTimePrecise();
-				UINT64 nextFrameTime = mLastFrameTime + mFrameStep;
-				while (nextFrameTime > currentTime)
-				{
-					UINT32 waitTime = (UINT32)(nextFrameTime - currentTime);
-
-					// If waiting for longer, sleep
-					if (waitTime >= 2000)
-					{
-						Platform::sleep(waitTime / 1000);
-						currentTime = gTime().getTimePrecise();
-					}
-					else
-					{
-						// Otherwise we just spin, sleep timer granularity is too low and we might end up wasting a 
-						// millisecond otherwise. 
-						// Note: For mobiles where power might be more important than input latency, consider using sleep.
-						while(nextFrameTime > currentTime)
-							currentTime = gTime().getTimePrecise();
-					}
-				}
+				mLastFrameTime = waitUntil(mLastFrameTime + mFrameStep);
 
-				mLastFrameTime = currentTime;
+			// Start the frame later by the time we'd otherwise spend waiting on the core thread at the end of the frame.
+			// This way input and simulation state are sampled closer to when the frame is actually rendered.
+			UINT64 pacingDelay = 0;
+			if (mFramePacing)
+			{
+				pacingDelay = std::min((UINT64)(mAverageSyncWaitTime * FRAME_PACING_FACTOR), MAX_FRAME_PACING_DELAY);
+				if (pacingDelay > 0)
+					waitUntil(gTime().getTimePrecise() + pacingDelay);
 			}
 
+			const UINT64 frameStartTime = gTime().getTimePrecise();
+
 			gProfilerCPU().beginThread("Sim");
 
 			Platform::_update();
@@ -271,23 +270,35 @@ namespace bs
 			gSceneManager()._updateCoreObjectTransforms();
 			PROFILE_CALL(RendererManager::instance().getActive()->renderAll(perFrameData), "Render");
 
-			// Core and sim thread run in lockstep. This will result in a larger input latency than if I was 
-			// running just a single thread. Latency becomes worse if the core thread takes longer than sim 
-			// thread, in which case sim thread needs to wait. Optimal solution would be to get an average 
-			// difference between sim/core thread and start the sim thread a bit later so they finish at nearly the same time.
+			// Sim thread is allowed to be up to mMaxFramesInFlight frames ahead of the core thread, so both threads can 
+			// work in parallel. Once the limit is reached, wait for the core thread to finish its oldest frame.
+			const UINT64 syncStartTime = gTime().getTimePrecise();
 			{
 				Lock lock(mFrameRenderingFinishedMutex);
 
-				while(!mIsFrameRenderingFinished)
+				mFrameTiming.framesInFlight = mNumFramesInFlight;
+				while(mNumFramesInFlight >= mMaxFramesInFlight)
 				{
 					TaskScheduler::instance().addWorker();
 					mFrameRenderingFinishedCondition.wait(lock);
 					TaskScheduler::instance().removeWorker();
 				}
 
-				mIsFrameRenderingFinished = false;
+				mNumFramesInFlight++;
+				mFrameTiming.coreTime = mLastCoreFrameTime;
 			}
 
+			const UINT64 syncEndTime = gTime().getTimePrecise();
+
+			mFrameTiming.simTime = syncStartTime - frameStartTime;
+			mFrameTiming.syncWaitTime = syncEndTime - syncStartTime;
+			mFrameTiming.pacingDelay = pacingDelay;
+
+			// Track the time we would have waited without any pacing delay, so the delay converges instead of cancelling
+			// itself out
+			const float unpacedSyncWaitTime = (float)(mFrameTiming.syncWaitTime + pacingDelay);
+			mAverageSyncWaitTime += (unpacedSyncWaitTime - mAverageSyncWaitTime) * FRAME_PACING_SMOOTHING;
+
 			gCoreThread().queueCommand(std::bind(&CoreApplication::beginCoreProfiling, this), CTQF_InternalQueue);
 			gCoreThread().queueCommand(&Platform::_coreUpdate, CTQF_InternalQueue);
 			gCoreThread().queueCommand(std::bind(&ct::RenderWindowManager::_update, ct::RenderWindowManager::instancePtr()), CTQF_InternalQueue);
@@ -308,7 +319,7 @@ namespace bs
 		{
 			Lock lock(mFrameRenderingFinishedMutex);
 
-			while (!mIsFrameRenderingFinished)
+			while (mNumFramesInFlight > 0)
 			{
 				TaskScheduler::instance().addWorker();
 				mFrameRenderingFinishedCondition.wait(lock);
@@ -351,11 +362,40 @@ namespace bs
 			mFrameStep = 0;
 	}
 
+	UINT64 CoreApplication::waitUntil(UINT64 time)
+	{
+		UINT64 currentTime = gTime().getTimePrecise();
+		while (time > currentTime)
+		{
+			UINT32 waitTime = (UINT32)(time - currentTime);
+
+			// If waiting for longer, sleep
+			if (waitTime >= 2000)
+			{
+				Platform::sleep(waitTime / 1000);
+				currentTime = gTime().getTimePrecise();
+			}
+			else
+			{
+				// Otherwise we just spin, sleep timer granularity is too low and we might end up wasting a 
+				// millisecond otherwise. 
+				// Note: For mobiles where power might be more important than input latency, consider using sleep.
+				while(time > currentTime)
+					currentTime = gTime().getTimePrecise();
+			}
+		}
+
+		return currentTime;
+	}
+
 	void CoreApplication::frameRenderingFinishedCallback()
 	{
+		const UINT64 frameEndTime = gTime().getTimePrecise();
+
 		Lock lock(mFrameRenderingFinishedMutex);
 
-		mIsFrameRenderingFinished = true;
+		mLastCoreFrameTime = frameEndTime - mCoreFrameStartTime;
+		mNumFramesInFlight--;
 		mFrameRenderingFinishedCondition.notify_one();
 	}
 
@@ -366,6 +406,8 @@ namespace bs
 
 	void CoreApplication::beginCoreProfiling()
 	{
+		mCoreFrameStartTime = gTime().getTimePrecise();
+
 		gProfilerCPU().beginThread("Core");
 	}
 
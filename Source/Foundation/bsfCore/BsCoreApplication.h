@@ -29,11 +29,37 @@ namespace bs
 		 */
 		bool physicsCooking = true;
 
+		/**
+		 * Maximum number of frames the core thread can be behind the simulation thread. Higher values allow the threads
+		 * to overlap more and reduce stalls when one of them has an uneven workload, at the cost of increased input 
+		 * latency. Must be in range [1, 4].
+		 */
+		UINT32 maxFramesInFlight = 1;
+
 		RENDER_WINDOW_DESC primaryWindowDesc; /**< Describes the window to create during start-up. */
 
 		Vector<String> importers; /**< A list of importer plugins to load. */
 	};
 
+	/** Timing information about a single iteration of the main loop. All times are in microseconds. */
+	struct FrameTiming
+	{
+		/** Time the sim thread spent on the frame, excluding frame limiting and waiting on the core thread. */
+		UINT64 simTime = 0;
+
+		/** Time the core thread spent on the most recently completed frame. */
+		UINT64 coreTime = 0;
+
+		/** Time the sim thread spent waiting on the core thread before it could submit the frame. */
+		UINT64 syncWaitTime = 0;
+
+		/** Time the start of the frame was delayed by, so that the sim and core threads finish close together. */
+		UINT64 pacingDelay = 0;
+
+		/** Number of frames the core thread was still processing when the sim thread finished the frame. */
+		UINT32 framesInFlight = 0;
+	};
+
 	/**
 	 * Represents the primary entry point for the core systems. Handles start-up, shutdown, primary loop and allows you to
 	 * load and unload plugins.
@@ -60,6 +86,16 @@ namespace bs
 		/** Changes the maximum FPS the application is allowed to run in. Zero means unlimited. */
 		void setFPSLimit(UINT32 limit);
 
+		/**
+		 * Enables or disables frame pacing. When enabled the start of each sim thread frame is delayed by the time the sim
+		 * thread is expected to wait on the core thread, so both threads finish their frames close together. This reduces
+		 * input latency when the core thread is the bottleneck. Disabled by default.
+		 */
+		void setFramePacing(bool enabled) { mFramePacing = enabled; }
+
+		/** Returns timing information about the last iteration of the main loop. */
+		const FrameTiming& getFrameTiming() const { return mFrameTiming; }
+
 		/**
 		 * Issues a request for the application to close. Application may choose to ignore the request depending on the
 		 * circumstances and the implementation.
@@ -121,6 +157,9 @@ namespace bs
 		/**	Called by the core thread to end profiling. */
 		void endCoreProfiling();
 
+		/** Blocks the calling thread until the specified time is reached, in microseconds. Returns the current time. */
+		UINT64 waitUntil(UINT64 time);
+
 	protected:
 		typedef void(*UpdatePluginFunc)();
 
@@ -135,9 +174,19 @@ namespace bs
 
 		Map<DynLib*, UpdatePluginFunc> mPluginUpdateFunctions;
 
-		bool mIsFrameRenderingFinished;
+		// Sim/core frame pipelining
+		UINT32 mNumFramesInFlight;
+		UINT32 mMaxFramesInFlight;
 		Mutex mFrameRenderingFinishedMutex;
 		Signal mFrameRenderingFinishedCondition;
+
+		UINT64 mCoreFrameStartTime = 0; // Core thread only
+		UINT64 mLastCoreFrameTime = 0;
+
+		// Frame pacing
+		bool mFramePacing = false;
+		float mAverageSyncWaitTime = 0.0f;
+		FrameTiming mFrameTiming;
 		ThreadId mSimThreadId;
 
 		volatile bool mRunMainLoop;
@@ -51,6 +51,7 @@ set(BS_CORE_INC_PHYSICS
 	"bsfCore/Physics/BsCharacterController.h"
 	"bsfCore/Physics/BsCollider.h"
 	"bsfCore/Physics/BsPhysicsCommon.h"
+	"bsfCore/Physics/BsPhysicsQueryBatch.h"
 )
 
 set(BS_CORE_INC_CORETHREAD
@@ -112,6 +113,7 @@ set(BS_CORE_INC_RENDERER
 	"bsfCore/Renderer/BsIBLUtility.h"
 	"bsfCore/Renderer/BsGpuResourcePool.h"
 	"bsfCore/Renderer/BsDecal.h"
+	"bsfCore/Renderer/BsCullInfo.h"
 )
 
 set(BS_CORE_SRC_LOCALIZATION
@@ -408,6 +410,7 @@ set(BS_CORE_SRC_RENDERER
 	"bsfCore/Renderer/BsIBLUtility.cpp"
 	"bsfCore/Renderer/BsGpuResourcePool.cpp"
 	"bsfCore/Renderer/BsDecal.cpp"
+	"bsfCore/Renderer/BsCullInfo.cpp"
 )
 
 set(BS_CORE_SRC_RESOURCES
@@ -518,6 +521,7 @@ set(BS_CORE_SRC_NOFILTER
 set(BS_CORE_SRC_PHYSICS
 	"bsfCore/Physics/BsPhysicsManager.cpp"
 	"bsfCore/Physics/BsPhysics.cpp"
+	"bsfCore/Physics/BsPhysicsQueryBatch.cpp"
 	"bsfCore/Physics/BsPhysicsMaterial.cpp"
 	"bsfCore/Physics/BsCollider.cpp"
 	"bsfCore/Physics/BsRigidbody.cpp"
@@ -4,15 +4,240 @@
 #include "Error/BsException.h"
 #include "CoreThread/BsCoreThread.h"
 #include "Debug/BsDebug.h"
+#include "Math/BsMath.h"
+#include "Utility/BsBitwise.h"
+#include <thread>
 
 namespace bs
 {
+	constexpr UINT32 CommandBuffer::BLOCK_SIZE;
+	constexpr UINT32 CommandBuffer::ALIGNMENT;
+
+	void QueuedCommand::completeUnresolved(AsyncOp& asyncOp)
+	{
+		LOGDBG("Async operation return value wasn't resolved properly. Resolving automatically to nullptr. " \
+			"Make sure to complete the operation before returning from the command callback method.");
+		asyncOp._completeOperation(nullptr);
+	}
+
+	HeapQueuedCommand::~HeapQueuedCommand()
+	{
+		bs_delete(command);
+	}
+
+	CommandBuffer::~CommandBuffer()
+	{
+		clear();
+
+		for(auto& block : mBlocks)
+			bs_free_aligned(block.data);
+	}
+
+	void* CommandBuffer::allocate(UINT32 size)
+	{
+		size = Math::divideAndRoundUp(size, ALIGNMENT) * ALIGNMENT;
+
+		while(mActiveBlock < (UINT32)mBlocks.size())
+		{
+			Block& block = mBlocks[mActiveBlock];
+			if((block.size + size) <= block.capacity)
+			{
+				UINT8* data = block.data + block.size;
+				block.size += size;
+
+				return data;
+			}
+
+			mActiveBlock++;
+		}
+
+		Block block;
+		block.capacity = std::max(BLOCK_SIZE, size);
+		block.data = (UINT8*)bs_alloc_aligned(block.capacity, ALIGNMENT);
+		block.size = size;
+
+		mBlocks.push_back(block);
+		mActiveBlock = (UINT32)mBlocks.size() - 1;
+
+		return block.data;
+	}
+
+	void CommandBuffer::playback(const std::function<void(UINT32)>& notifyCallback)
+	{
+		for(auto& command : mCommands)
+		{
+			command->execute();
+
+			if(command->notifyWhenComplete && notifyCallback != nullptr)
+				notifyCallback(command->callbackId);
+
+			command->~QueuedCommand();
+		}
+
+		mCommands.clear();
+		clear();
+	}
+
+	void CommandBuffer::clear()
+	{
+		for(auto& command : mCommands)
+			command->~QueuedCommand();
+
+		mCommands.clear();
+
+		for(auto& block : mBlocks)
+			block.size = 0;
+
+		mActiveBlock = 0;
+	}
+
+	CommandRingBuffer::CommandRingBuffer(UINT32 numSlots)
+		:mMask(numSlots - 1), mEnqueuePosition(0), mDequeuePosition(0), mOverflowing(false)
+	{
+		assert(Bitwise::isPow2(numSlots));
+
+		mAsyncOpSyncData = bs_shared_ptr_new<AsyncOpSyncData>();
+		mSlots = (Slot*)bs_alloc_aligned(numSlots * sizeof(Slot), SLOT_SIZE);
+
+		for(UINT32 i = 0; i < numSlots; i++)
+			new (&mSlots[i].sequence) std::atomic<UINT64>(i);
+	}
+
+	CommandRingBuffer::~CommandRingBuffer()
+	{
+		// Destroy any commands that were never executed
+		while(!isEmpty())
+		{
+			Slot& slot = mSlots[mDequeuePosition & mMask];
+			((QueuedCommand*)slot.storage)->~QueuedCommand();
+
+			mDequeuePosition++;
+		}
+
+		for(auto& entry : mOverflow)
+			bs_delete(entry);
+
+		const UINT64 numSlots = mMask + 1;
+		for(UINT64 i = 0; i < numSlots; i++)
+			mSlots[i].sequence.~atomic<UINT64>();
+
+		bs_free_aligned(mSlots);
+	}
+
+	CommandRingBuffer::Slot* CommandRingBuffer::acquireSlot(UINT64& position)
+	{
+		position = mEnqueuePosition.load(std::memory_order_relaxed);
+		while(true)
+		{
+			// Commands queued after ones in the overflow list must not overtake them
+			if(mOverflowing.load(std::memory_order_acquire))
+				return nullptr;
+
+			Slot& slot = mSlots[position & mMask];
+			const UINT64 sequence = slot.sequence.load(std::memory_order_acquire);
+			const INT64 diff = (INT64)sequence - (INT64)position;
+
+			if(diff == 0)
+			{
+				// Slot is free, try to claim it
+				if(mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					return &slot;
+			}
+			else if(diff < 0)
+			{
+				// Ring buffer is full. Waiting for the consumer could deadlock if it is itself waiting on this thread.
+				return nullptr;
+			}
+			else
+			{
+				// Another producer claimed the slot
+				position = mEnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void CommandRingBuffer::pushOverflow(QueuedCommand* command)
+	{
+		Lock lock(mOverflowMutex);
+
+		mOverflow.push_back(command);
+		mOverflowing.store(true, std::memory_order_release);
+	}
+
+	UINT32 CommandRingBuffer::playbackOverflow(const std::function<void(UINT32)>& notifyCallback)
+	{
+		// Producers append to the overflow list until it is cleared, after which they go back to using the ring buffer
+		Vector<QueuedCommand*> commands;
+		{
+			Lock lock(mOverflowMutex);
+
+			std::swap(commands, mOverflow);
+			mOverflowing.store(false, std::memory_order_release);
+		}
+
+		for(auto& command : commands)
+		{
+			command->execute();
+
+			if(command->notifyWhenComplete && notifyCallback != nullptr)
+				notifyCallback(command->callbackId);
+
+			bs_delete(command);
+		}
+
+		return (UINT32)commands.size();
+	}
+
+	UINT32 CommandRingBuffer::playback(const std::function<void(UINT32)>& notifyCallback)
+	{
+		UINT32 numExecuted = 0;
+		while(true)
+		{
+			Slot& slot = mSlots[mDequeuePosition & mMask];
+			if(slot.sequence.load(std::memory_order_acquire) != (mDequeuePosition + 1))
+			{
+				// Commands in the overflow list were queued after all the slots claimed so far. Once those are executed,
+				// the overflow list is next.
+				if(!mOverflowing.load(std::memory_order_acquire) || 
+					mEnqueuePosition.load(std::memory_order_relaxed) != mDequeuePosition)
+				{
+					break;
+				}
+
+				numExecuted += playbackOverflow(notifyCallback);
+				continue;
+			}
+
+			auto command = (QueuedCommand*)slot.storage;
+			command->execute();
+
+			if(command->notifyWhenComplete && notifyCallback != nullptr)
+				notifyCallback(command->callbackId);
+
+			command->~QueuedCommand();
+
+			// Release the slot for the producers' next pass around the ring buffer
+			slot.sequence.store(mDequeuePosition + mMask + 1, std::memory_order_release);
+			mDequeuePosition++;
+			numExecuted++;
+		}
+
+		return numExecuted;
+	}
+
+	bool CommandRingBuffer::isEmpty() const
+	{
+		const Slot& slot = mSlots[mDequeuePosition & mMask];
+		return slot.sequence.load(std::memory_order_acquire) != (mDequeuePosition + 1) && 
+			!mOverflowing.load(std::memory_order_acquire);
+	}
+
 #if BS_DEBUG_MODE
 	CommandQueueBase::CommandQueueBase(ThreadId threadId)
 		:mMyThreadId(threadId), mMaxDebugIdx(0)
 	{
 		mAsyncOpSyncData = bs_shared_ptr_new<AsyncOpSyncData>();
-		mCommands = bs_new<bs::Queue<QueuedCommand>>();
+		mCommands = bs_new<CommandBuffer>();
 
 		{
 			Lock lock(CommandQueueBreakpointMutex);
@@ -25,7 +250,7 @@ namespace bs
 		:mMyThreadId(threadId)
 	{
 		mAsyncOpSyncData = bs_shared_ptr_new<AsyncOpSyncData>();
-		mCommands = bs_new<bs::Queue<QueuedCommand>>();
+		mCommands = bs_new<CommandBuffer>();
 	}
 #endif
 
@@ -34,125 +259,85 @@ namespace bs
 		if(mCommands != nullptr)
 			bs_delete(mCommands);
 
-		while(!mEmptyCommandQueues.empty())
+		CommandBuffer* lists[] = { mEmptyCommandBuffers, mReturnedCommandBuffers.exchange(nullptr) };
+		for(auto& buffer : lists)
 		{
-			bs_delete(mEmptyCommandQueues.top());
-			mEmptyCommandQueues.pop();
+			while(buffer != nullptr)
+			{
+				CommandBuffer* next = buffer->mNext;
+				bs_delete(buffer);
+
+				buffer = next;
+			}
 		}
 	}
 
-	AsyncOp CommandQueueBase::queueReturn(std::function<void(AsyncOp&)> commandCallback, bool _notifyWhenComplete, UINT32 _callbackId)
+	void CommandQueueBase::onCommandQueued(QueuedCommand* command)
 	{
 #if BS_DEBUG_MODE
 		breakIfNeeded(mCommandQueueIdx, mMaxDebugIdx);
 
-		QueuedCommand newCommand(commandCallback, mMaxDebugIdx++, mAsyncOpSyncData, _notifyWhenComplete, _callbackId);
-#else
-		QueuedCommand newCommand(commandCallback, mAsyncOpSyncData, _notifyWhenComplete, _callbackId);
+		command->debugId = mMaxDebugIdx++;
 #endif
 
-		mCommands->push(newCommand);
-
 #if BS_FORCE_SINGLETHREADED_RENDERING
-		Queue<QueuedCommand>* commands = flush();
+		CommandBuffer* commands = flush();
 		playback(commands);
 #endif
-
-		return newCommand.asyncOp;
 	}
 
-	void CommandQueueBase::queue(std::function<void()> commandCallback, bool _notifyWhenComplete, UINT32 _callbackId)
+	CommandBuffer* CommandQueueBase::flush()
 	{
-#if BS_DEBUG_MODE
-		breakIfNeeded(mCommandQueueIdx, mMaxDebugIdx);
-
-		QueuedCommand newCommand(commandCallback, mMaxDebugIdx++, _notifyWhenComplete, _callbackId);
-#else
-		QueuedCommand newCommand(commandCallback, _notifyWhenComplete, _callbackId);
-#endif
+		CommandBuffer* oldCommands = mCommands;
 
-		mCommands->push(newCommand);
+		if(mEmptyCommandBuffers == nullptr)
+			mEmptyCommandBuffers = mReturnedCommandBuffers.exchange(nullptr, std::memory_order_acquire);
 
-#if BS_FORCE_SINGLETHREADED_RENDERING
-		Queue<QueuedCommand>* commands = flush();
-		playback(commands);
-#endif
-	}
-
-	bs::Queue<QueuedCommand>* CommandQueueBase::flush()
-	{
-		bs::Queue<QueuedCommand>* oldCommands = mCommands;
-
-		if(!mEmptyCommandQueues.empty())
+		if(mEmptyCommandBuffers != nullptr)
 		{
-			mCommands = mEmptyCommandQueues.top();
-			mEmptyCommandQueues.pop();
+			mCommands = mEmptyCommandBuffers;
+			mEmptyCommandBuffers = mEmptyCommandBuffers->mNext;
+			mCommands->mNext = nullptr;
 		}
 		else
 		{
-			mCommands = bs_new<bs::Queue<QueuedCommand>>();
+			mCommands = bs_new<CommandBuffer>();
 		}
 
 		return oldCommands;
 	}
 
-	void CommandQueueBase::playbackWithNotify(bs::Queue<QueuedCommand>* commands, std::function<void(UINT32)> notifyCallback)
+	void CommandQueueBase::playbackWithNotify(CommandBuffer* commands, std::function<void(UINT32)> notifyCallback)
 	{
 		THROW_IF_NOT_CORE_THREAD;
 
 		if(commands == nullptr)
 			return;
 
-		while(!commands->empty())
-		{
-			QueuedCommand& command = commands->front();
-
-			if(command.returnsValue)
-			{
-				AsyncOp& op = command.asyncOp;
-				command.callbackWithReturnValue(op);
-
-				if(!command.asyncOp.hasCompleted())
-				{
-					LOGDBG("Async operation return value wasn't resolved properly. Resolving automatically to nullptr. " \
-						"Make sure to complete the operation before returning from the command callback method.");
-					command.asyncOp._completeOperation(nullptr);
-				}
-			}
-			else
-			{
-				command.callback();
-			}
+		commands->playback(notifyCallback);
 
-			if(command.notifyWhenComplete && notifyCallback != nullptr)
-			{
-				notifyCallback(command.callbackId);
-			}
-
-			commands->pop();
-		}
-
-		mEmptyCommandQueues.push(commands);
+		// Return the buffer to the queuing thread. Playback happens on a different thread, so this needs to be lock-free.
+		CommandBuffer* head = mReturnedCommandBuffers.load(std::memory_order_relaxed);
+		do
+		{
+			commands->mNext = head;
+		} while(!mReturnedCommandBuffers.compare_exchange_weak(head, commands, std::memory_order_release, 
+			std::memory_order_relaxed));
 	}
 
-	void CommandQueueBase::playback(bs::Queue<QueuedCommand>* commands)
+	void CommandQueueBase::playback(CommandBuffer* commands)
 	{
 		playbackWithNotify(commands, std::function<void(UINT32)>());
 	}
 
 	void CommandQueueBase::cancelAll()
 	{
-		bs::Queue<QueuedCommand>* commands = flush();
-
-		while(!commands->empty())
-			commands->pop();
-
-		mEmptyCommandQueues.push(commands);
+		mCommands->clear();
 	}
 
 	bool CommandQueueBase::isEmpty()
 	{
-		if(mCommands != nullptr && mCommands->size() > 0)
+		if(mCommands != nullptr && !mCommands->isEmpty())
 			return false;
 
 		return true;
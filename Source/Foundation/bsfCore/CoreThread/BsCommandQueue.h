@@ -5,6 +5,7 @@
 #include "BsCorePrerequisites.h"
 #include "Threading/BsAsyncOp.h"
 #include <functional>
+#include <atomic>
 
 namespace bs
 {
@@ -65,75 +66,298 @@ namespace bs
 
 	/**
 	 * Represents a single queued command in the command list. Contains all the data for executing the command and checking 
-	 * up on the command status.
+	 * up on the command status. Commands are constructed in-place in command storage, with the callback stored inline in
+	 * one of the derived types.
 	 */
-	struct QueuedCommand
+	struct BS_CORE_EXPORT QueuedCommand
 	{
-#if BS_DEBUG_MODE
-		QueuedCommand(std::function<void(AsyncOp&)> _callback, UINT32 _debugId, const SPtr<AsyncOpSyncData>& asyncOpSyncData,
-			bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
-			: debugId(_debugId), callbackWithReturnValue(_callback), asyncOp(asyncOpSyncData), returnsValue(true)
-			, callbackId(_callbackId), notifyWhenComplete(_notifyWhenComplete)
+		QueuedCommand(bool notifyWhenComplete, UINT32 callbackId)
+			:callbackId(callbackId), notifyWhenComplete(notifyWhenComplete)
 		{ }
 
-		QueuedCommand(std::function<void()> _callback, UINT32 _debugId, bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
-			:debugId(_debugId), callback(_callback), asyncOp(AsyncOpEmpty()), returnsValue(false), callbackId(_callbackId)
-			, notifyWhenComplete(_notifyWhenComplete)
-		{ }
+		virtual ~QueuedCommand() = default;
+
+		/** Executes the command callback. */
+		virtual void execute() = 0;
+
+		UINT32 callbackId;
+		bool notifyWhenComplete;
+
+#if BS_DEBUG_MODE
+		UINT32 debugId = 0;
+#endif
 
-		UINT32 debugId;
-#else
-		QueuedCommand(std::function<void(AsyncOp&)> _callback, const SPtr<AsyncOpSyncData>& asyncOpSyncData, 
-			bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
-			: callbackWithReturnValue(_callback), asyncOp(asyncOpSyncData), returnsValue(true), callbackId(_callbackId)
-			, notifyWhenComplete(_notifyWhenComplete)
+	protected:
+		/** Resolves the async operation to nullptr, in case the command callback didn't resolve it. */
+		static void completeUnresolved(AsyncOp& asyncOp);
+	};
+
+	/** Queued command executing a callback that doesn't return a value. */
+	template<class T>
+	struct TQueuedCommand final : QueuedCommand
+	{
+		template<class U>
+		TQueuedCommand(U&& callback, bool notifyWhenComplete, UINT32 callbackId)
+			:QueuedCommand(notifyWhenComplete, callbackId), callback(std::forward<U>(callback))
 		{ }
 
-		QueuedCommand(std::function<void()> _callback, bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
-			: callback(_callback), asyncOp(AsyncOpEmpty()), returnsValue(false), callbackId(_callbackId)
-			, notifyWhenComplete(_notifyWhenComplete)
+		void execute() override
+		{
+			callback();
+		}
+
+		T callback;
+	};
+
+	/** Queued command executing a callback that returns a value through an AsyncOp. */
+	template<class T>
+	struct TQueuedReturnCommand final : QueuedCommand
+	{
+		template<class U>
+		TQueuedReturnCommand(U&& callback, const AsyncOp& asyncOp, bool notifyWhenComplete, UINT32 callbackId)
+			:QueuedCommand(notifyWhenComplete, callbackId), callback(std::forward<U>(callback)), asyncOp(asyncOp)
 		{ }
-#endif
 
-		~QueuedCommand()
+		void execute() override
+		{
+			callback(asyncOp);
+
+			if(!asyncOp.hasCompleted())
+				completeUnresolved(asyncOp);
+		}
+
+		T callback;
+		AsyncOp asyncOp;
+	};
+
+	/** 
+	 * Queued command that wraps a heap allocated command. Used when the command doesn't fit in the storage provided by
+	 * the command queue.
+	 */
+	struct BS_CORE_EXPORT HeapQueuedCommand final : QueuedCommand
+	{
+		HeapQueuedCommand(QueuedCommand* command)
+			:QueuedCommand(command->notifyWhenComplete, command->callbackId), command(command)
 		{ }
 
-		QueuedCommand(const QueuedCommand& source)
+		~HeapQueuedCommand();
+
+		void execute() override
 		{
-			callback = source.callback;
-			callbackWithReturnValue = source.callbackWithReturnValue;
-			asyncOp = source.asyncOp;
-			returnsValue = source.returnsValue;
-			callbackId = source.callbackId;
-			notifyWhenComplete = source.notifyWhenComplete;
+			command->execute();
+		}
 
-#if BS_DEBUG_MODE
-			debugId = source.debugId;
-#endif
+		QueuedCommand* command;
+	};
+
+	/**
+	 * Stores a list of commands for later execution. Commands are constructed in-place in large memory blocks, and the 
+	 * blocks are reused once the commands are executed, meaning that in the steady state queuing a command doesn't 
+	 * allocate any memory. Not thread safe.
+	 */
+	class BS_CORE_EXPORT CommandBuffer : public INonCopyable
+	{
+	public:
+		/** Size of a single memory block the commands are allocated from, in bytes. */
+		static constexpr UINT32 BLOCK_SIZE = 32 * 1024;
+
+		/** Alignment of all commands stored in the buffer, in bytes. */
+		static constexpr UINT32 ALIGNMENT = 16;
+
+		CommandBuffer() = default;
+		~CommandBuffer();
+
+		/** Adds a new command that executes a callback that doesn't return a value. */
+		template<class T>
+		QueuedCommand* queue(T&& callback, bool notifyWhenComplete, UINT32 callbackId)
+		{
+			using CommandType = TQueuedCommand<std::decay_t<T>>;
+			static_assert(alignof(CommandType) <= ALIGNMENT, "Unsupported command alignment.");
+
+			void* storage = allocate(sizeof(CommandType));
+			return add(new (storage) CommandType(std::forward<T>(callback), notifyWhenComplete, callbackId));
 		}
 
-		QueuedCommand& operator=(const QueuedCommand& rhs)
+		/** Adds a new command that executes a callback that returns a value through the provided AsyncOp. */
+		template<class T>
+		QueuedCommand* queueReturn(T&& callback, const AsyncOp& asyncOp, bool notifyWhenComplete, UINT32 callbackId)
 		{
-			callback = rhs.callback;
-			callbackWithReturnValue = rhs.callbackWithReturnValue;
-			asyncOp = rhs.asyncOp;
-			returnsValue = rhs.returnsValue;
-			callbackId = rhs.callbackId;
-			notifyWhenComplete = rhs.notifyWhenComplete;
-			
-#if BS_DEBUG_MODE
-			debugId = rhs.debugId;
-#endif
+			using CommandType = TQueuedReturnCommand<std::decay_t<T>>;
+			static_assert(alignof(CommandType) <= ALIGNMENT, "Unsupported command alignment.");
 
-			return *this;
+			void* storage = allocate(sizeof(CommandType));
+			return add(new (storage) CommandType(std::forward<T>(callback), asyncOp, notifyWhenComplete, callbackId));
 		}
 
-		std::function<void()> callback;
-		std::function<void(AsyncOp&)> callbackWithReturnValue;
-		AsyncOp asyncOp;
-		bool returnsValue;
-		UINT32 callbackId;
-		bool notifyWhenComplete;
+		/**
+		 * Executes all commands in the order they were queued, and clears the buffer.
+		 *
+		 * @param[in]	notifyCallback  	Callback that will be called if a command that has @p notifyOnComplete flag set.
+		 * 									The callback will receive @p callbackId of the command.
+		 */
+		void playback(const std::function<void(UINT32)>& notifyCallback);
+
+		/** Destroys all commands without executing them. Memory used by the commands is kept for reuse. */
+		void clear();
+
+		/** Returns true if no commands are queued. */
+		bool isEmpty() const { return mCommands.empty(); }
+
+	private:
+		friend class CommandQueueBase;
+
+		/** Memory block the commands are allocated from. */
+		struct Block
+		{
+			UINT8* data;
+			UINT32 size;
+			UINT32 capacity;
+		};
+
+		/** Allocates aligned storage for a new command. */
+		void* allocate(UINT32 size);
+
+		/** Registers a newly constructed command. */
+		QueuedCommand* add(QueuedCommand* command)
+		{
+			mCommands.push_back(command);
+			return command;
+		}
+
+		Vector<QueuedCommand*> mCommands;
+		Vector<Block> mBlocks;
+		UINT32 mActiveBlock = 0;
+
+		CommandBuffer* mNext = nullptr; /**< Next buffer when stored in a list of empty buffers. */
+	};
+
+	/**
+	 * Lock-free bounded queue of commands, supporting multiple producer threads and a single consumer thread. Commands are 
+	 * constructed in-place in fixed size slots of a ring buffer, so queuing a command doesn't allocate memory unless the 
+	 * command is too large to fit in a slot. If the ring buffer is full, commands are allocated on the heap and stored in 
+	 * an overflow list until the consumer catches up, so producers never wait on the consumer.
+	 */
+	class BS_CORE_EXPORT CommandRingBuffer : public INonCopyable
+	{
+	public:
+		/** Size of a single slot in the ring buffer, in bytes. Commands that don't fit are allocated on the heap. */
+		static constexpr UINT32 SLOT_SIZE = 128;
+
+		/**
+		 * Constructor.
+		 *
+		 * @param[in]	numSlots	Maximum number of commands that can be queued at once. Must be a power of two.
+		 */
+		CommandRingBuffer(UINT32 numSlots = 1024);
+		~CommandRingBuffer();
+
+		/** 
+		 * Queues a new command that doesn't return a value. 
+		 *
+		 * @see	CommandQueueBase::queue
+		 * @note	Thread safe.
+		 */
+		template<class T>
+		void queue(T&& commandCallback, bool notifyWhenComplete = false, UINT32 callbackId = 0)
+		{
+			push<TQueuedCommand<std::decay_t<T>>>(std::forward<T>(commandCallback), notifyWhenComplete, callbackId);
+		}
+
+		/** 
+		 * Queues a new command that returns a value through an AsyncOp. 
+		 *
+		 * @see	CommandQueueBase::queueReturn
+		 * @note	Thread safe.
+		 */
+		template<class T>
+		AsyncOp queueReturn(T&& commandCallback, bool notifyWhenComplete = false, UINT32 callbackId = 0)
+		{
+			AsyncOp asyncOp(mAsyncOpSyncData);
+			push<TQueuedReturnCommand<std::decay_t<T>>>(std::forward<T>(commandCallback), asyncOp, notifyWhenComplete, 
+				callbackId);
+
+			return asyncOp;
+		}
+
+		/**
+		 * Executes all commands that are ready, in the order they were queued. Must only be called from the consumer 
+		 * thread.
+		 *
+		 * @param[in]	notifyCallback  	Callback that will be called if a command that has @p notifyOnComplete flag set.
+		 * 									The callback will receive @p callbackId of the command.
+		 * @return							Number of executed commands.
+		 */
+		UINT32 playback(const std::function<void(UINT32)>& notifyCallback);
+
+		/** Returns true if there are no commands ready for execution. Must only be called from the consumer thread. */
+		bool isEmpty() const;
+
+	private:
+		/** Single entry in the ring buffer. */
+		struct alignas(SLOT_SIZE) Slot
+		{
+			static constexpr UINT32 STORAGE_SIZE = SLOT_SIZE - 16;
+
+			std::atomic<UINT64> sequence;
+			alignas(16) UINT8 storage[STORAGE_SIZE];
+		};
+
+		/** Constructs a new command in the next free slot, and makes it visible to the consumer. */
+		template<class T, class... Args>
+		void push(Args&&... args)
+		{
+			static_assert(alignof(T) <= 16, "Unsupported command alignment.");
+
+			UINT64 position;
+			Slot* slot = acquireSlot(position);
+			if(slot == nullptr)
+			{
+				pushOverflow(bs_new<T>(std::forward<Args>(args)...));
+				return;
+			}
+
+			construct<T>(slot->storage, std::integral_constant<bool, sizeof(T) <= Slot::STORAGE_SIZE>(), 
+				std::forward<Args>(args)...);
+
+			slot->sequence.store(position + 1, std::memory_order_release);
+		}
+
+		/** Constructs a command that fits in the slot storage. */
+		template<class T, class... Args>
+		static void construct(UINT8* storage, std::true_type fitsInSlot, Args&&... args)
+		{
+			new (storage) T(std::forward<Args>(args)...);
+		}
+
+		/** Constructs a command that doesn't fit in the slot storage. */
+		template<class T, class... Args>
+		static void construct(UINT8* storage, std::false_type fitsInSlot, Args&&... args)
+		{
+			new (storage) HeapQueuedCommand(bs_new<T>(std::forward<Args>(args)...));
+		}
+
+		/** 
+		 * Claims the next free slot for writing. Returns null if the ring buffer is full, or if earlier commands are still 
+		 * waiting in the overflow list, in which case the command must be added to the overflow list to keep its order.
+		 */
+		Slot* acquireSlot(UINT64& position);
+
+		/** Adds a command that didn't fit into the ring buffer to the overflow list. Takes ownership of the command. */
+		void pushOverflow(QueuedCommand* command);
+
+		/** Executes all commands in the overflow list. Must only be called once all the queued slots were executed. */
+		UINT32 playbackOverflow(const std::function<void(UINT32)>& notifyCallback);
+
+		Slot* mSlots;
+		UINT64 mMask;
+		SPtr<AsyncOpSyncData> mAsyncOpSyncData;
+
+		alignas(64) std::atomic<UINT64> mEnqueuePosition;
+		alignas(64) UINT64 mDequeuePosition;
+
+		Vector<QueuedCommand*> mOverflow;
+		std::atomic<bool> mOverflowing;
+		Mutex mOverflowMutex;
 	};
 
 	/** Manages a list of commands that can be queued for later execution on the core thread. */
@@ -163,10 +387,10 @@ namespace bs
 		 * @param[in]	notifyCallback  	Callback that will be called if a command that has @p notifyOnComplete flag set.
 		 * 									The callback will receive @p callbackId of the command.
 		 */
-		void playbackWithNotify(Queue<QueuedCommand>* commands, std::function<void(UINT32)> notifyCallback);
+		void playbackWithNotify(CommandBuffer* commands, std::function<void(UINT32)> notifyCallback);
 
 		/** Executes all provided commands one by one in order. To get the commands you should call flush(). */
-		void playback(Queue<QueuedCommand>* commands);
+		void playback(CommandBuffer* commands);
 
 		/**
 		 * Allows you to set a breakpoint that will trigger when the specified command is executed.		
@@ -201,7 +425,15 @@ namespace bs
 		 * Callback method also needs to call AsyncOp::markAsResolved once it is done processing. (If it doesn't it will 
 		 * still be called automatically, but the return value will default to nullptr)
 		 */
-		AsyncOp queueReturn(std::function<void(AsyncOp&)> commandCallback, bool _notifyWhenComplete = false, UINT32 _callbackId = 0);
+		template<class T>
+		AsyncOp queueReturn(T&& commandCallback, bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
+		{
+			AsyncOp asyncOp(mAsyncOpSyncData);
+			onCommandQueued(mCommands->queueReturn(std::forward<T>(commandCallback), asyncOp, _notifyWhenComplete, 
+				_callbackId));
+
+			return asyncOp;
+		}
 
 		/**
 		 * Queue up a new command to execute. Make sure the provided function has all of its parameters properly bound. 
@@ -214,13 +446,17 @@ namespace bs
 		 * @param[in]	_callbackId		   	(optional) Identifier for the callback so you can then later find
 		 * 									it if needed.
 		 */
-		void queue(std::function<void()> commandCallback, bool _notifyWhenComplete = false, UINT32 _callbackId = 0);
+		template<class T>
+		void queue(T&& commandCallback, bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
+		{
+			onCommandQueued(mCommands->queue(std::forward<T>(commandCallback), _notifyWhenComplete, _callbackId));
+		}
 
 		/**
 		 * Returns a copy of all queued commands and makes room for new ones. Must be called from the thread that created 
 		 * the command queue. Returned commands must be passed to playback() method.
 		 */
-		Queue<QueuedCommand>* flush();
+		CommandBuffer* flush();
 
 		/** Cancels all currently queued commands. */
 		void cancelAll();
@@ -236,8 +472,17 @@ namespace bs
 		void throwInvalidThreadException(const String& message) const;
 
 	private:
-		Queue<QueuedCommand>* mCommands;
-		Stack<Queue<QueuedCommand>*> mEmptyCommandQueues; /**< List of empty queues for reuse. */
+		/** Performs debug checks on a newly queued command, and executes it immediately if rendering is single-threaded. */
+		void onCommandQueued(QueuedCommand* command);
+
+		CommandBuffer* mCommands;
+		CommandBuffer* mEmptyCommandBuffers = nullptr; /**< List of empty buffers for reuse. */
+
+		/** 
+		 * List of buffers that finished executing, returned by the thread executing the commands. Moved to the list of empty
+		 * buffers when it runs out.
+		 */
+		std::atomic<CommandBuffer*> mReturnedCommandBuffers { nullptr };
 
 		SPtr<AsyncOpSyncData> mAsyncOpSyncData;
 		ThreadId mMyThreadId;
@@ -300,7 +545,8 @@ namespace bs
 		{ }
 
 		/** @copydoc CommandQueueBase::queueReturn */
-		AsyncOp queueReturn(std::function<void(AsyncOp&)> commandCallback, bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
+		template<class T>
+		AsyncOp queueReturn(T&& commandCallback, bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
 		{
 #if BS_DEBUG_MODE
 #if BS_THREAD_SUPPORT != 0
@@ -310,14 +556,15 @@ namespace bs
 #endif
 
 			this->lock();
-			AsyncOp asyncOp = CommandQueueBase::queueReturn(commandCallback, _notifyWhenComplete, _callbackId);
+			AsyncOp asyncOp = CommandQueueBase::queueReturn(std::forward<T>(commandCallback), _notifyWhenComplete, _callbackId);
 			this->unlock();
 
 			return asyncOp;
 		}
 
 		/** @copydoc CommandQueueBase::queue */
-		void queue(std::function<void()> commandCallback, bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
+		template<class T>
+		void queue(T&& commandCallback, bool _notifyWhenComplete = false, UINT32 _callbackId = 0)
 		{
 #if BS_DEBUG_MODE
 #if BS_THREAD_SUPPORT != 0
@@ -327,12 +574,12 @@ namespace bs
 #endif
 
 			this->lock();
-			CommandQueueBase::queue(commandCallback, _notifyWhenComplete, _callbackId);
+			CommandQueueBase::queue(std::forward<T>(commandCallback), _notifyWhenComplete, _callbackId);
 			this->unlock();
 		}
 
 		/** @copydoc CommandQueueBase::flush */
-		bs::Queue<QueuedCommand>* flush()
+		CommandBuffer* flush()
 		{
 #if BS_DEBUG_MODE
 #if BS_THREAD_SUPPORT != 0
@@ -342,7 +589,7 @@ namespace bs
 #endif
 
 			this->lock();
-			bs::Queue<QueuedCommand>* commands = CommandQueueBase::flush();
+			CommandBuffer* commands = CommandQueueBase::flush();
 			this->unlock();
 
 			return commands;
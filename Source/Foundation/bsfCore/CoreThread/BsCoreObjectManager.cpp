@@ -9,22 +9,33 @@
 
 namespace bs
 {
+	/** Returns the index of the slot referenced by a core object ID. */
+	static UINT32 getSlotIndex(UINT64 id)
+	{
+		return (UINT32)(id & 0xFFFFFFFF);
+	}
+
+	/** Returns the generation of the slot referenced by a core object ID. */
+	static UINT32 getSlotGeneration(UINT64 id)
+	{
+		return (UINT32)(id >> 32);
+	}
+
 	CoreObjectManager::CoreObjectManager()
-		:mNextAvailableID(1)
 	{
 
-	} 
+	}
 
 	CoreObjectManager::~CoreObjectManager()
 	{
 #if BS_DEBUG_MODE
 		Lock lock(mObjectsMutex);
 
-		if(mObjects.size() > 0)
+		if(mNumObjects > 0)
 		{
 			// All objects MUST be destroyed at this point, otherwise there might be memory corruption.
-			// (Reason: This is called on application shutdown and at that point we also unload any dynamic libraries, 
-			// which will invalidate any pointers to objects created from those libraries. Therefore we require of the user to 
+			// (Reason: This is called on application shutdown and at that point we also unload any dynamic libraries,
+			// which will invalidate any pointers to objects created from those libraries. Therefore we require of the user to
 			// clean up all objects manually before shutting down the application).
 			BS_EXCEPT(InternalErrorException, "Core object manager shut down, but not all objects were released. Application must release ALL " \
 				"engine objects before shutdown.");
@@ -36,16 +47,36 @@ namespace bs
 	{
 		Lock lock(mObjectsMutex);
 
-		return mNextAvailableID++;
+		UINT32 slotIdx;
+		if(!mFreeSlots.empty())
+		{
+			slotIdx = mFreeSlots.back();
+			mFreeSlots.pop_back();
+		}
+		else
+		{
+			slotIdx = (UINT32)mSlots.size();
+			mSlots.push_back(ObjectSlot());
+		}
+
+		ObjectSlot& slot = mSlots[slotIdx];
+		slot.creationIdx = mNextCreationIdx++;
+
+		// Generation is never zero, ensuring zero is never a valid ID
+		return ((UINT64)slot.generation << 32) | slotIdx;
 	}
 
 	void CoreObjectManager::registerObject(CoreObject* object)
 	{
 		Lock lock(mObjectsMutex);
 
-		UINT64 objId = object->getInternalID();
-		mObjects[objId] = object;
-		mDirtyObjects[objId] = { object, -1 };
+		ObjectSlot* slot = findSlot(object->getInternalID());
+		assert(slot != nullptr && slot->object == nullptr);
+
+		slot->object = object;
+		mNumObjects++;
+
+		markDirty(*slot, object);
 	}
 
 	void CoreObjectManager::unregisterObject(CoreObject* object)
@@ -54,66 +85,71 @@ namespace bs
 
 		UINT64 internalId = object->getInternalID();
 
+		Lock lock(mObjectsMutex);
+
+		ObjectSlot* slot = findSlot(internalId);
+		assert(slot != nullptr);
+
 		// If dirty, we generate sync data before it is destroyed
+		bool isDirty = object->isCoreDirty() || slot->dirtyIdx != -1;
+		if (isDirty)
 		{
-			Lock lock(mObjectsMutex);
-			bool isDirty = object->isCoreDirty() || (mDirtyObjects.find(internalId) != mDirtyObjects.end());
+			DirtyObjectData& dirtyObjData = markDirty(*slot, object);
+			dirtyObjData.object = nullptr;
+			dirtyObjData.syncDataId = -1;
 
-			if (isDirty)
+			SPtr<ct::CoreObject> coreObject = object->getCore();
+			if (coreObject != nullptr)
 			{
-				SPtr<ct::CoreObject> coreObject = object->getCore();
-				if (coreObject != nullptr)
-				{
-					CoreSyncData objSyncData = object->syncToCore(gCoreThread().getFrameAlloc());
-				
-					mDestroyedSyncData.push_back(CoreStoredSyncObjData(coreObject, internalId, objSyncData));
+				CoreSyncData objSyncData = object->syncToCore(gCoreThread().getFrameAlloc());
 
-					DirtyObjectData& dirtyObjData = mDirtyObjects[internalId];
-					dirtyObjData.syncDataId = (INT32)mDestroyedSyncData.size() - 1;
-					dirtyObjData.object = nullptr;
-				}
-				else
-				{
-					DirtyObjectData& dirtyObjData = mDirtyObjects[internalId];
-					dirtyObjData.syncDataId = -1;
-					dirtyObjData.object = nullptr;
-				}
+				mDestroyedSyncData.push_back(CoreStoredSyncObjData(coreObject, internalId, objSyncData));
+				dirtyObjData.syncDataId = (INT32)mDestroyedSyncData.size() - 1;
 			}
-
-			mObjects.erase(internalId);
 		}
 
-		updateDependencies(object, nullptr);
-
-		// Clear dependencies from dependants
+		// Clear the object from the dependant lists of its dependencies
+		for (auto& dependency : slot->dependencies)
 		{
-			Lock lock(mObjectsMutex);
+			ObjectSlot* dependencySlot = findSlot(dependency->getInternalID());
+			if (dependencySlot == nullptr)
+				continue;
 
-			auto iterFind = mDependants.find(internalId);
-			if (iterFind != mDependants.end())
-			{
-				Vector<CoreObject*>& dependants = iterFind->second;
-				for (auto& entry : dependants)
-				{
-					auto iterFind2 = mDependencies.find(entry->getInternalID());
-					if (iterFind2 != mDependencies.end())
-					{
-						Vector<CoreObject*>& dependencies = iterFind2->second;
-						auto iterFind3 = std::find(dependencies.begin(), dependencies.end(), object);
+			Vector<CoreObject*>& dependants = dependencySlot->dependants;
+			auto iterFind = std::find(dependants.begin(), dependants.end(), object);
 
-						if (iterFind3 != dependencies.end())
-							dependencies.erase(iterFind3);
+			if (iterFind != dependants.end())
+				dependants.erase(iterFind);
+		}
 
-						if (dependencies.size() == 0)
-							mDependencies.erase(iterFind2);
-					}
-				}
+		// Clear the object from the dependency lists of its dependants
+		for (auto& dependant : slot->dependants)
+		{
+			ObjectSlot* dependantSlot = findSlot(dependant->getInternalID());
+			if (dependantSlot == nullptr)
+				continue;
 
-				mDependants.erase(iterFind);
-			}
+			Vector<CoreObject*>& dependencies = dependantSlot->dependencies;
+			auto iterFind = std::find(dependencies.begin(), dependencies.end(), object);
 
-			mDependencies.erase(internalId);
+			if (iterFind != dependencies.end())
+				dependencies.erase(iterFind);
 		}
+
+		if (slot->object != nullptr)
+			mNumObjects--;
+
+		// Release the slot. Any entry in the dirty list stays, as it no longer references the slot.
+		slot->object = nullptr;
+		slot->dirtyIdx = -1;
+		slot->dependencies.clear();
+		slot->dependants.clear();
+
+		slot->generation++;
+		if (slot->generation == 0)
+			slot->generation = 1;
+
+		mFreeSlots.push_back(getSlotIndex(internalId));
 	}
 
 	void CoreObjectManager::notifyCoreDirty(CoreObject* object)
@@ -122,7 +158,9 @@ namespace bs
 
 		Lock lock(mObjectsMutex);
 
-		mDirtyObjects[id] = { object, -1 };
+		ObjectSlot* slot = findSlot(id);
+		if (slot != nullptr)
+			markDirty(*slot, object);
 	}
 
 	void CoreObjectManager::notifyDependenciesDirty(CoreObject* object)
@@ -144,70 +182,50 @@ namespace bs
 
 			Lock lock(mObjectsMutex);
 
-			// Add dependencies and clear old dependencies from dependants
+			ObjectSlot* slot = findSlot(id);
+			if (slot != nullptr)
 			{
+				// Add dependencies and clear old dependencies from dependants
 				if (dependencies != nullptr)
-					std::sort(dependencies->begin(), dependencies->end());
-
-				auto iterFind = mDependencies.find(id);
-				if (iterFind != mDependencies.end())
 				{
-					const Vector<CoreObject*>& oldDependencies = iterFind->second;
-
-					if (dependencies != nullptr)
-					{
-						std::set_difference(oldDependencies.begin(), oldDependencies.end(),
-							dependencies->begin(), dependencies->end(), std::inserter(toRemove, toRemove.begin()));
+					std::sort(dependencies->begin(), dependencies->end());
 
-						std::set_difference(dependencies->begin(), dependencies->end(),
-							oldDependencies.begin(), oldDependencies.end(), std::inserter(toAdd, toAdd.begin()));
-					}
-					else
-					{
-						for (auto& dependency : oldDependencies)
-							toRemove.push_back(dependency);
-					}
+					const Vector<CoreObject*>& oldDependencies = slot->dependencies;
+					std::set_difference(oldDependencies.begin(), oldDependencies.end(),
+						dependencies->begin(), dependencies->end(), std::inserter(toRemove, toRemove.begin()));
 
-					for (auto& dependency : toRemove)
-					{
-						UINT64 dependencyId = dependency->getInternalID();
-						auto iterFind2 = mDependants.find(dependencyId);
-
-						if (iterFind2 != mDependants.end())
-						{
-							Vector<CoreObject*>& dependants = iterFind2->second;
-							auto findIter3 = std::find(dependants.begin(), dependants.end(), object);
-							dependants.erase(findIter3);
-
-							if (dependants.size() == 0)
-								mDependants.erase(iterFind2);
-						}
-					}
+					std::set_difference(dependencies->begin(), dependencies->end(),
+						oldDependencies.begin(), oldDependencies.end(), std::inserter(toAdd, toAdd.begin()));
 
-					if (dependencies != nullptr && dependencies->size() > 0)
-						mDependencies[id] = *dependencies;
-					else
-						mDependencies.erase(id);
+					slot->dependencies = *dependencies;
 				}
 				else
 				{
-					if (dependencies != nullptr && dependencies->size() > 0)
-					{
-						for (auto& dependency : *dependencies)
-							toAdd.push_back(dependency);
+					for (auto& dependency : slot->dependencies)
+						toRemove.push_back(dependency);
 
-						mDependencies[id] = *dependencies;
-					}
+					slot->dependencies.clear();
 				}
-			}
 
-			// Register dependants
-			{
+				for (auto& dependency : toRemove)
+				{
+					ObjectSlot* dependencySlot = findSlot(dependency->getInternalID());
+					if (dependencySlot == nullptr)
+						continue;
+
+					Vector<CoreObject*>& dependants = dependencySlot->dependants;
+					auto iterFind = std::find(dependants.begin(), dependants.end(), object);
+
+					if (iterFind != dependants.end())
+						dependants.erase(iterFind);
+				}
+
+				// Register dependants
 				for (auto& dependency : toAdd)
 				{
-					UINT64 dependencyId = dependency->getInternalID();
-					Vector<CoreObject*>& dependants = mDependants[dependencyId];
-					dependants.push_back(object);
+					ObjectSlot* dependencySlot = findSlot(dependency->getInternalID());
+					if (dependencySlot != nullptr)
+						dependencySlot->dependants.push_back(object);
 				}
 			}
 		}
@@ -239,36 +257,31 @@ namespace bs
 			if (!curObj->isCoreDirty())
 				return; // We already processed it as some other object's dependency
 
+			ObjectSlot* slot = findSlot(curObj->getInternalID());
+
 			// Sync dependencies before dependants
 			// Note: I don't check for recursion. Possible infinite loop if two objects
 			// are dependent on one another.
-
-			UINT64 id = curObj->getInternalID();
-			auto iterFind = mDependencies.find(id);
-
-			if (iterFind != mDependencies.end())
+			if (slot != nullptr)
 			{
-				const Vector<CoreObject*>& dependencies = iterFind->second;
-				for (auto& dependency : dependencies)
+				for (auto& dependency : slot->dependencies)
 					syncObject(dependency);
 			}
 
 			SPtr<ct::CoreObject> objectCore = curObj->getCore();
-			if (objectCore == nullptr)
+			if (objectCore != nullptr)
 			{
-				curObj->markCoreClean();
-				mDirtyObjects.erase(id);
-				return;
+				syncData.push_back(IndividualCoreSyncData());
+				IndividualCoreSyncData& data = syncData.back();
+				data.allocator = allocator;
+				data.destination = objectCore;
+				data.syncData = curObj->syncToCore(allocator);
 			}
 
-			syncData.push_back(IndividualCoreSyncData());
-			IndividualCoreSyncData& data = syncData.back();
-			data.allocator = allocator;
-			data.destination = objectCore;
-			data.syncData = curObj->syncToCore(allocator);
-
 			curObj->markCoreClean();
-			mDirtyObjects.erase(id);
+
+			if (slot != nullptr)
+				clearDirty(*slot);
 		};
 
 		syncObject(object);
@@ -301,92 +314,150 @@ namespace bs
 		CoreStoredSyncData& syncData = mCoreSyncData.back();
 
 		syncData.alloc = allocator;
-		
+
 		// Add all objects dependant on the dirty objects
-		bs_frame_mark();
+		const auto numDirtyObjects = (UINT32)mDirtyObjects.size();
+		for (UINT32 i = 0; i < numDirtyObjects; i++)
 		{
-			FrameSet<CoreObject*> dirtyDependants;
-			for (auto& objectData : mDirtyObjects)
+			CoreObject* dependency = mDirtyObjects[i].object;
+			if (dependency == nullptr)
+				continue;
+
+			const ObjectSlot& slot = mSlots[getSlotIndex(dependency->getInternalID())];
+			for (auto& dependant : slot.dependants)
 			{
-				auto iterFind = mDependants.find(objectData.first);
-				if (iterFind != mDependants.end())
-				{
-					const Vector<CoreObject*>& dependants = iterFind->second;
-					for (auto& dependant : dependants)
-					{
-						const bool wasDirty = dependant->isCoreDirty();
+				const bool wasDirty = dependant->isCoreDirty();
 
-						// Let the dependant objects know their dependency changed
-						CoreObject* dependency = objectData.second.object;
-						dependant->onDependencyDirty(dependency, dependency->getCoreDirtyFlags());
+				// Let the dependant objects know their dependency changed
+				dependant->onDependencyDirty(dependency, dependency->getCoreDirtyFlags());
 
-						if (!wasDirty && dependant->isCoreDirty())
-							dirtyDependants.insert(dependant);
-					}
-				}
+				if (!wasDirty && dependant->isCoreDirty())
+					markDirty(mSlots[getSlotIndex(dependant->getInternalID())], dependant);
 			}
+		}
 
-			for (auto& dirtyDependant : dirtyDependants)
-			{
-				UINT64 id = dirtyDependant->getInternalID();
+		// Objects created earlier should be updated first, unless their dependencies require otherwise
+		std::sort(mDirtyObjects.begin(), mDirtyObjects.end(),
+			[](const DirtyObjectData& a, const DirtyObjectData& b) { return a.creationIdx < b.creationIdx; });
 
-				mDirtyObjects[id] = { dirtyDependant, -1 };
-			}
+		for (UINT32 i = 0; i < (UINT32)mDirtyObjects.size(); i++)
+		{
+			CoreObject* object = mDirtyObjects[i].object;
+			if (object != nullptr)
+				mSlots[getSlotIndex(object->getInternalID())].dirtyIdx = (INT32)i;
 		}
 
-		bs_frame_clear();
-		
-		// Order in which objects are recursed in matters, ones with lower ID will have been created before
-		// ones with higher ones and should be updated first.
-		for (auto& objectData : mDirtyObjects)
+		const auto isPending = [this](INT32 dirtyIdx)
 		{
-			std::function<void(CoreObject*)> syncObject = [&](CoreObject* curObj)
-			{
-				if (!curObj->isCoreDirty())
-					return; // We already processed it as some other object's dependency
+			if (dirtyIdx == -1)
+				return false;
 
-				// Sync dependencies before dependants
-				// Note: I don't check for recursion. Possible infinite loop if two objects
-				// are dependent on one another.
-				
-				UINT64 id = curObj->getInternalID();
-				auto iterFind = mDependencies.find(id);
+			CoreObject* object = mDirtyObjects[dirtyIdx].object;
+			return object != nullptr && object->isCoreDirty();
+		};
+
+		const auto syncEntry = [this, &syncData, allocator](UINT32 dirtyIdx)
+		{
+			const DirtyObjectData& objectData = mDirtyObjects[dirtyIdx];
 
-				if (iterFind != mDependencies.end())
+			CoreObject* object = objectData.object;
+			if (object == nullptr)
+			{
+				// Object was destroyed but we still need to sync its modifications before it was destroyed
+				if (objectData.syncDataId != -1)
 				{
-					const Vector<CoreObject*>& dependencies = iterFind->second;
-					for (auto& dependency : dependencies)
-						syncObject(dependency);
+					const CoreStoredSyncObjData& objData = mDestroyedSyncData[objectData.syncDataId];
+
+					syncData.entries.push_back(objData);
+					syncData.destroyedObjects.push_back(objData.destinationObj);
 				}
 
-				SPtr<ct::CoreObject> objectCore = curObj->getCore();
-				if (objectCore == nullptr)
+				return;
+			}
+
+			SPtr<ct::CoreObject> objectCore = object->getCore();
+			if (objectCore != nullptr)
+			{
+				CoreSyncData objSyncData = object->syncToCore(allocator);
+				syncData.entries.push_back(CoreStoredSyncObjData(objectCore, object->getInternalID(), objSyncData));
+			}
+
+			object->markCoreClean();
+		};
+
+		// Sync dependencies before dependants. Objects are processed in levels, where each level contains objects whose
+		// dirty dependencies have all been processed in previous levels. Objects within a level have no dependencies
+		// between them, but they're still synced on this thread: CoreObject::syncToCore() implementations allocate from
+		// the core thread frame allocator, which isn't thread safe, and are free to touch other sim thread state.
+		bs_frame_mark();
+		{
+			const auto numEntries = (UINT32)mDirtyObjects.size();
+			FrameVector<UINT32> numPendingDependencies(numEntries, 0);
+
+			for (UINT32 i = 0; i < numEntries; i++)
+			{
+				if (!isPending((INT32)i))
+					continue;
+
+				const ObjectSlot& slot = mSlots[getSlotIndex(mDirtyObjects[i].object->getInternalID())];
+				for (auto& dependant : slot.dependants)
 				{
-					curObj->markCoreClean();
-					return;
+					const INT32 dependantIdx = mSlots[getSlotIndex(dependant->getInternalID())].dirtyIdx;
+					if (isPending(dependantIdx))
+						numPendingDependencies[dependantIdx]++;
 				}
+			}
 
-				CoreSyncData objSyncData = curObj->syncToCore(allocator);
-				curObj->markCoreClean();
-
-				syncData.entries.push_back(CoreStoredSyncObjData(objectCore,
-					curObj->getInternalID(), objSyncData));
-			};
+			FrameVector<UINT32> level;
+			FrameVector<UINT32> nextLevel;
+			for (UINT32 i = 0; i < numEntries; i++)
+			{
+				if (mDirtyObjects[i].object == nullptr || (isPending((INT32)i) && numPendingDependencies[i] == 0))
+					level.push_back(i);
+			}
 
-			CoreObject* object = objectData.second.object;
-			if (object != nullptr)
-				syncObject(object);
-			else
+			while (!level.empty())
 			{
-				// Object was destroyed but we still need to sync its modifications before it was destroyed
-				if (objectData.second.syncDataId != -1)
+				for (auto& entryIdx : level)
 				{
-					const CoreStoredSyncObjData& objData = mDestroyedSyncData[objectData.second.syncDataId];
+					CoreObject* object = mDirtyObjects[entryIdx].object;
+					syncEntry(entryIdx);
 
-					syncData.entries.push_back(objData);
-					syncData.destroyedObjects.push_back(objData.destinationObj);
+					if (object == nullptr)
+						continue;
+
+					const ObjectSlot& slot = mSlots[getSlotIndex(object->getInternalID())];
+					for (auto& dependant : slot.dependants)
+					{
+						const INT32 dependantIdx = mSlots[getSlotIndex(dependant->getInternalID())].dirtyIdx;
+						if (!isPending(dependantIdx))
+							continue;
+
+						if (--numPendingDependencies[dependantIdx] == 0)
+							nextLevel.push_back((UINT32)dependantIdx);
+					}
 				}
+
+				// Keep creation order within a level
+				std::sort(nextLevel.begin(), nextLevel.end());
+
+				std::swap(level, nextLevel);
+				nextLevel.clear();
 			}
+
+			// Anything left is part of a dependency cycle, sync it in creation order
+			for (UINT32 i = 0; i < numEntries; i++)
+			{
+				if (isPending((INT32)i))
+					syncEntry(i);
+			}
+		}
+		bs_frame_clear();
+
+		for (auto& objectData : mDirtyObjects)
+		{
+			if (objectData.object != nullptr)
+				mSlots[getSlotIndex(objectData.object->getInternalID())].dirtyIdx = -1;
 		}
 
 		mDirtyObjects.clear();
@@ -418,4 +489,41 @@ namespace bs
 		syncData.entries.clear();
 		mCoreSyncData.pop_front();
 	}
-}
\ No newline at end of file
+
+	CoreObjectManager::ObjectSlot* CoreObjectManager::findSlot(UINT64 id)
+	{
+		const UINT32 slotIdx = getSlotIndex(id);
+		if (slotIdx >= (UINT32)mSlots.size())
+			return nullptr;
+
+		ObjectSlot& slot = mSlots[slotIdx];
+		if (slot.generation != getSlotGeneration(id))
+			return nullptr;
+
+		return &slot;
+	}
+
+	CoreObjectManager::DirtyObjectData& CoreObjectManager::markDirty(ObjectSlot& slot, CoreObject* object)
+	{
+		if (slot.dirtyIdx == -1)
+		{
+			slot.dirtyIdx = (INT32)mDirtyObjects.size();
+			mDirtyObjects.push_back({ object, slot.creationIdx, -1 });
+		}
+
+		return mDirtyObjects[slot.dirtyIdx];
+	}
+
+	void CoreObjectManager::clearDirty(ObjectSlot& slot)
+	{
+		if (slot.dirtyIdx == -1)
+			return;
+
+		// Leave an empty entry, as the list is only compacted during sync
+		DirtyObjectData& objectData = mDirtyObjects[slot.dirtyIdx];
+		objectData.object = nullptr;
+		objectData.syncDataId = -1;
+
+		slot.dirtyIdx = -1;
+	}
+}
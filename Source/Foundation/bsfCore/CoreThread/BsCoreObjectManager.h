@@ -56,15 +56,33 @@ namespace bs
 		/** Contains information about a dirty CoreObject that requires syncing to the core thread. */	
 		struct DirtyObjectData
 		{
-			CoreObject* object;
+			CoreObject* object; // Null if the object was destroyed
+			UINT64 creationIdx;
 			INT32 syncDataId;
 		};
 
+		/**
+		 * Entry in the slot map holding all core objects. Slots are re-used after their object is destroyed, and the
+		 * generation is incremented each time that happens so that the IDs of destroyed objects can be detected.
+		 */
+		struct ObjectSlot
+		{
+			CoreObject* object = nullptr; // Null until the object is registered
+			UINT64 creationIdx = 0;
+			UINT32 generation = 1;
+			INT32 dirtyIdx = -1; // Index into the dirty object list, or -1 if not dirty
+			Vector<CoreObject*> dependencies;
+			Vector<CoreObject*> dependants;
+		};
+
 	public:
 		CoreObjectManager();
 		~CoreObjectManager();
 
-		/** Generates a new unique ID for a core object. */
+		/**
+		 * Generates a new unique ID for a core object, and reserves a slot for it. The object is expected to call 
+		 * registerObject() and unregisterObject() afterwards, at which point the slot is released.
+		 */
 		UINT64 generateId();
 
 		/** Registers a new CoreObject notifying the manager the object	is created. */
@@ -125,11 +143,20 @@ namespace bs
 		 */
 		void updateDependencies(CoreObject* object, Vector<CoreObject*>* dependencies);
 
-		UINT64 mNextAvailableID;
-		Map<UINT64, CoreObject*> mObjects;
-		Map<UINT64, DirtyObjectData> mDirtyObjects;
-		Map<UINT64, Vector<CoreObject*>> mDependencies;
-		Map<UINT64, Vector<CoreObject*>> mDependants;
+		/** Returns the slot for the object with the provided ID, or null if the ID is no longer valid. */
+		ObjectSlot* findSlot(UINT64 id);
+
+		/** Adds the object in the provided slot to the dirty list, unless it's already in it. */
+		DirtyObjectData& markDirty(ObjectSlot& slot, CoreObject* object);
+
+		/** Removes the object in the provided slot from the dirty list, if it is in it. */
+		void clearDirty(ObjectSlot& slot);
+
+		UINT64 mNextCreationIdx = 0;
+		UINT32 mNumObjects = 0;
+		Vector<ObjectSlot> mSlots;
+		Vector<UINT32> mFreeSlots;
+		Vector<DirtyObjectData> mDirtyObjects;
 
 		Vector<CoreStoredSyncObjData> mDestroyedSyncData;
 		List<CoreStoredSyncData> mCoreSyncData;
@@ -12,22 +12,25 @@ namespace bs
 	CoreThread::QueueData CoreThread::mPerThreadQueue;
 	BS_THREADLOCAL CoreThread::ThreadQueueContainer* CoreThread::QueueData::current = nullptr;
 
-	CoreThread::CoreThread()
+	CoreThread::CoreThread(UINT32 maxFramesInFlight)
 		: mActiveFrameAlloc(0)
+		, mMaxFramesInFlight(Math::clamp(maxFramesInFlight, 1U, MAX_FRAMES_IN_FLIGHT))
 		, mCoreThreadShutdown(false)
 		, mCoreThreadStarted(false)
 		, mCommandQueue(nullptr)
+		, mCoreThreadWaiting(false)
 		, mMaxCommandNotifyId(0)
 	{
-		for (UINT32 i = 0; i < NUM_SYNC_BUFFERS; i++)
+		mFrameAllocs.resize(getNumSyncBuffers());
+		for (auto& frameAlloc : mFrameAllocs)
 		{
-			mFrameAllocs[i] = bs_new<FrameAlloc>();
-			mFrameAllocs[i]->setOwnerThread(BS_THREAD_CURRENT_ID); // Sim thread
+			frameAlloc = bs_new<FrameAlloc>();
+			frameAlloc->setOwnerThread(BS_THREAD_CURRENT_ID); // Sim thread
 		}
 
 		mSimThreadId = BS_THREAD_CURRENT_ID;
 		mCoreThreadId = mSimThreadId; // For now
-		mCommandQueue = bs_new<CommandQueue<CommandQueueSync>>(BS_THREAD_CURRENT_ID);
+		mCommandQueue = bs_new<CommandRingBuffer>();
 
 		initCoreThread();
 	}
@@ -52,10 +55,10 @@ namespace bs
 			mCommandQueue = nullptr;
 		}
 
-		for (UINT32 i = 0; i < NUM_SYNC_BUFFERS; i++)
+		for (auto& frameAlloc : mFrameAllocs)
 		{
-			mFrameAllocs[i]->setOwnerThread(BS_THREAD_CURRENT_ID); // Sim thread
-			bs_delete(mFrameAllocs[i]);
+			frameAlloc->setOwnerThread(BS_THREAD_CURRENT_ID); // Sim thread
+			bs_delete(frameAlloc);
 		}
 	}
 
@@ -90,31 +93,33 @@ namespace bs
 
 		mCoreThreadStartedCondition.notify_one();
 
+		const std::function<void(UINT32)> notifyCallback = std::bind(&CoreThread::commandCompletedNotify, this, _1);
 		while(true)
 		{
+			// Play commands, in batches of all the commands that are ready
+			if(mCommandQueue->playback(notifyCallback) > 0)
+				continue;
+
 			// Wait until we get some ready commands
-			Queue<QueuedCommand>* commands = nullptr;
-			{
-				Lock lock(mCommandQueueMutex);
+			Lock lock(mCommandQueueMutex);
+
+			mCoreThreadWaiting.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
 
-				while(mCommandQueue->isEmpty())
+			while(mCommandQueue->isEmpty())
+			{
+				if(mCoreThreadShutdown)
 				{
-					if(mCoreThreadShutdown)
-					{
-						TaskScheduler::instance().addWorker();
-						return;
-					}
-
-					TaskScheduler::instance().addWorker(); // Do something else while we wait, otherwise this core will be unused
-					mCommandReadyCondition.wait(lock);
-					TaskScheduler::instance().removeWorker();
+					TaskScheduler::instance().addWorker();
+					return;
 				}
 
-				commands = mCommandQueue->flush();
+				TaskScheduler::instance().addWorker(); // Do something else while we wait, otherwise this core will be unused
+				mCommandReadyCondition.wait(lock);
+				TaskScheduler::instance().removeWorker();
 			}
 
-			// Play commands
-			mCommandQueue->playbackWithNotify(commands, std::bind(&CoreThread::commandCompletedNotify, this, _1)); 
+			mCoreThreadWaiting.store(false, std::memory_order_relaxed);
 		}
 #endif
 	}
@@ -183,75 +188,29 @@ namespace bs
 		getQueue()->submitToCoreThread(blockUntilComplete);
 	}
 
-	AsyncOp CoreThread::queueReturnCommand(std::function<void(AsyncOp&)> commandCallback, CoreThreadQueueFlags flags)
-	{
-		assert(BS_THREAD_CURRENT_ID != getCoreThreadId() && "Cannot queue commands on the core thread for the core thread");
-
-		if (!flags.isSet(CTQF_InternalQueue))
-			return getQueue()->queueReturnCommand(commandCallback);
-		else
-		{
-			bool blockUntilComplete = flags.isSet(CTQF_BlockUntilComplete);
-
-			AsyncOp op;
-			UINT32 commandId = -1;
-			{
-				Lock lock(mCommandQueueMutex);
-
-				if (blockUntilComplete)
-				{
-					commandId = mMaxCommandNotifyId++;
-					op = mCommandQueue->queueReturn(commandCallback, true, commandId);
-				}
-				else
-					op = mCommandQueue->queueReturn(commandCallback);
-			}
-
-			mCommandReadyCondition.notify_all();
-
-			if (blockUntilComplete)
-				blockUntilCommandCompleted(commandId);
-
-			return op;
-		}
-	}
-
-	void CoreThread::queueCommand(std::function<void()> commandCallback, CoreThreadQueueFlags flags)
+	void CoreThread::notifyCommandQueued()
 	{
-		assert(BS_THREAD_CURRENT_ID != getCoreThreadId() && "Cannot queue commands on the core thread for the core thread");
+#if BS_FORCE_SINGLETHREADED_RENDERING
+		mCommandQueue->playback(std::function<void(UINT32)>());
+#else
+		// Pairs with the fence in runCoreThread(). Either the core thread sees the new command before it starts waiting, 
+		// or we see that it is waiting.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
 
-		if (!flags.isSet(CTQF_InternalQueue))
-			getQueue()->queueCommand(commandCallback);
-		else
+		if(mCoreThreadWaiting.load(std::memory_order_relaxed))
 		{
-			bool blockUntilComplete = flags.isSet(CTQF_BlockUntilComplete);
-
-			UINT32 commandId = -1;
-			{
-				Lock lock(mCommandQueueMutex);
-
-				if (blockUntilComplete)
-				{
-					commandId = mMaxCommandNotifyId++;
-					mCommandQueue->queue(commandCallback, true, commandId);
-				}
-				else
-					mCommandQueue->queue(commandCallback);
-			}
-
+			Lock lock(mCommandQueueMutex);
 			mCommandReadyCondition.notify_all();
-
-			if (blockUntilComplete)
-				blockUntilCommandCompleted(commandId);
 		}
+#endif
 	}
 
 	void CoreThread::update()
 	{
-		for (UINT32 i = 0; i < NUM_SYNC_BUFFERS; i++)
-			mFrameAllocs[i]->setOwnerThread(mCoreThreadId);
+		for (auto& frameAlloc : mFrameAllocs)
+			frameAlloc->setOwnerThread(mCoreThreadId);
 
-		mActiveFrameAlloc = (mActiveFrameAlloc + 1) % 2;
+		mActiveFrameAlloc = (mActiveFrameAlloc + 1) % (UINT32)mFrameAllocs.size();
 		mFrameAllocs[mActiveFrameAlloc]->setOwnerThread(BS_THREAD_CURRENT_ID); // Sim thread
 		mFrameAllocs[mActiveFrameAlloc]->clear();
 	}
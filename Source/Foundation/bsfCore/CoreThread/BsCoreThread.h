@@ -25,7 +25,8 @@ namespace bs
 		/** 
 		 * Specifies that the queued command should be executed on the internal queue. Internal queue doesn't require
 		 * a separate CoreThread::submit() call, and the queued command is instead immediately visible to the core thread.
-		 * The downside is that the queue requires additional synchronization and is slower than the normal queue.
+		 * The downside is that the queue is shared by all threads and requires additional synchronization, making it slower
+		 * than the normal queue.
 		 */
 		CTQF_InternalQueue = 1 << 0,
 		/**
@@ -54,6 +55,8 @@ namespace bs
 	 *      which point they are made visible to the core thread, and will begin executing.
 	 * 	  - Commands can also be submitted directly to the internal command queue (via a special flag), but with a 
 	 * 	    performance cost due to extra synchronization required.
+	 *  - Commands are stored in-place without allocating memory for each command. The internal command queue is a 
+	 *    lock-free ring buffer, and the core thread executes all commands that are ready before checking for new ones.
 	 */
 	class BS_CORE_EXPORT CoreThread : public Module<CoreThread>
 	{
@@ -73,7 +76,13 @@ namespace bs
 		};
 
 	public:
-		CoreThread();
+		/**
+		 * Constructor.
+		 *
+		 * @param[in]	maxFramesInFlight	Maximum number of frames the core thread can be behind the sim thread. Clamped
+		 *									to [1, MAX_FRAMES_IN_FLIGHT] range.
+		 */
+		CoreThread(UINT32 maxFramesInFlight = 1);
 		~CoreThread();
 
 		/** Returns the id of the core thread.  */
@@ -96,7 +105,25 @@ namespace bs
 		 * @see		CommandQueue::queueReturn()
 		 * @note	Thread safe
 		 */
-		AsyncOp queueReturnCommand(std::function<void(AsyncOp&)> commandCallback, CoreThreadQueueFlags flags = CTQF_Default);
+		template<class T>
+		AsyncOp queueReturnCommand(T&& commandCallback, CoreThreadQueueFlags flags = CTQF_Default)
+		{
+			assert(BS_THREAD_CURRENT_ID != getCoreThreadId() && "Cannot queue commands on the core thread for the core thread");
+
+			if (!flags.isSet(CTQF_InternalQueue))
+				return getQueue()->queueReturnCommand(std::forward<T>(commandCallback));
+
+			const bool blockUntilComplete = flags.isSet(CTQF_BlockUntilComplete);
+			const UINT32 commandId = blockUntilComplete ? mMaxCommandNotifyId.fetch_add(1) : (UINT32)-1;
+
+			AsyncOp op = mCommandQueue->queueReturn(std::forward<T>(commandCallback), blockUntilComplete, commandId);
+			notifyCommandQueued();
+
+			if (blockUntilComplete)
+				blockUntilCommandCompleted(commandId);
+
+			return op;
+		}
 
 		/**
 		 * Queues a new command that will be added to the global command queue. 
@@ -107,7 +134,26 @@ namespace bs
 		 * @see		CommandQueue::queue()
 		 * @note	Thread safe
 		 */
-		void queueCommand(std::function<void()> commandCallback, CoreThreadQueueFlags flags = CTQF_Default);
+		template<class T>
+		void queueCommand(T&& commandCallback, CoreThreadQueueFlags flags = CTQF_Default)
+		{
+			assert(BS_THREAD_CURRENT_ID != getCoreThreadId() && "Cannot queue commands on the core thread for the core thread");
+
+			if (!flags.isSet(CTQF_InternalQueue))
+			{
+				getQueue()->queueCommand(std::forward<T>(commandCallback));
+				return;
+			}
+
+			const bool blockUntilComplete = flags.isSet(CTQF_BlockUntilComplete);
+			const UINT32 commandId = blockUntilComplete ? mMaxCommandNotifyId.fetch_add(1) : (UINT32)-1;
+
+			mCommandQueue->queue(std::forward<T>(commandCallback), blockUntilComplete, commandId);
+			notifyCommandQueued();
+
+			if (blockUntilComplete)
+				blockUntilCommandCompleted(commandId);
+		}
 
 		/**
 		 * Called once every frame.
@@ -125,10 +171,17 @@ namespace bs
 		FrameAlloc* getFrameAlloc() const;
 
 		/** 
-		 * Returns number of buffers needed to sync data between core and sim thread. Currently the sim thread can be one frame
-		 * ahead of the core thread, meaning we need two buffers. If this situation changes increase this number.
+		 * Returns the maximum number of frames the core thread can be behind the sim thread. The sim thread will wait
+		 * before submitting a new frame if this many frames are still being processed by the core thread.
+		 */
+		UINT32 getMaxFramesInFlight() const { return mMaxFramesInFlight; }
+
+		/** 
+		 * Returns number of buffers needed to sync data between core and sim thread. The sim thread can be up to 
+		 * getMaxFramesInFlight() frames ahead of the core thread, meaning we need one buffer for each of those frames, plus
+		 * one for the frame the sim thread is currently writing.
 		 *
-		 * For example:
+		 * For example, with one frame in flight:
 		 *  - Sim thread frame starts, it writes some data to buffer 0.
 		 *  - Core thread frame starts, it reads some data from buffer 0.
 		 *  - Sim thread frame finishes
@@ -140,14 +193,15 @@ namespace bs
 		 *  - New core thread frame starts, it reads some data from buffer 1.
 		 *  - ...
 		 */
-		static const int NUM_SYNC_BUFFERS = 2;
+		UINT32 getNumSyncBuffers() const { return mMaxFramesInFlight + 1; }
+
+		/** Maximum number of frames the core thread is allowed to be behind the sim thread. */
+		static constexpr UINT32 MAX_FRAMES_IN_FLIGHT = 4;
 	private:
-		/**
-		 * Double buffered frame allocators. Means sim thread cannot be more than 1 frame ahead of core thread (If that changes
-		 * you should be able to easily add more).
-		 */
-		FrameAlloc* mFrameAllocs[NUM_SYNC_BUFFERS];
+		/** Frame allocators, one for each sync buffer. */
+		Vector<FrameAlloc*> mFrameAllocs;
 		UINT32 mActiveFrameAlloc;
+		UINT32 mMaxFramesInFlight;
 
 		static QueueData mPerThreadQueue;
 		Vector<ThreadQueueContainer*> mAllQueues;
@@ -166,9 +220,10 @@ namespace bs
 		Mutex mThreadStartedMutex;
 		Signal mCoreThreadStartedCondition;
 
-		CommandQueue<CommandQueueSync>* mCommandQueue;
+		CommandRingBuffer* mCommandQueue;
+		std::atomic<bool> mCoreThreadWaiting; /**< True if the core thread might be waiting for new commands. */
 
-		UINT32 mMaxCommandNotifyId; /**< ID that will be assigned to the next command with a notifier callback. */
+		std::atomic<UINT32> mMaxCommandNotifyId; /**< ID that will be assigned to the next command with a notifier callback. */
 		Vector<UINT32> mCommandsCompleted; /**< Completed commands that have notifier callbacks set up */
 
 		/** Starts the core thread worker method. Should only be called once. */
@@ -180,6 +235,12 @@ namespace bs
 		/** Shutdowns the core thread. It will complete all ready commands before shutdown. */
 		void shutdownCoreThread();
 
+		/** 
+		 * Must be called after a command is queued on the internal command queue. Wakes up the core thread if it is 
+		 * waiting for commands.
+		 */
+		void notifyCommandQueued();
+
 		/** Creates or retrieves a queue for the calling thread. */
 		SPtr<TCoreThreadQueue<CommandQueueNoSync>> getQueue();
 
@@ -18,26 +18,17 @@ namespace bs
 		bs_delete(mCommandQueue);
 	}
 
-	AsyncOp CoreThreadQueueBase::queueReturnCommand(std::function<void(AsyncOp&)> commandCallback)
-	{
-		return mCommandQueue->queueReturn(commandCallback);
-	}
-
-	void CoreThreadQueueBase::queueCommand(std::function<void()> commandCallback)
-	{
-		mCommandQueue->queue(commandCallback);
-	}
-
 	void CoreThreadQueueBase::submitToCoreThread(bool blockUntilComplete)
 	{
-		Queue<QueuedCommand>* commands = mCommandQueue->flush();
+		CommandBuffer* commands = mCommandQueue->flush();
 
 		CoreThreadQueueFlags flags = CTQF_InternalQueue;
 
 		if(blockUntilComplete)
 			flags |= CTQF_BlockUntilComplete;
 
-		gCoreThread().queueCommand(std::bind(&CommandQueueBase::playback, mCommandQueue, commands), flags);
+		CommandQueueBase* commandQueue = mCommandQueue;
+		gCoreThread().queueCommand([commandQueue, commands]() { commandQueue->playback(commands); }, flags);
 	}
 
 	void CoreThreadQueueBase::cancelAll()
@@ -23,10 +23,18 @@ namespace bs
 		 * Queues a new generic command that will be added to the command queue. Returns an async operation object that you 
 		 * may use to check if the operation has finished, and to retrieve the return value once finished.
 		 */
-		AsyncOp queueReturnCommand(std::function<void(AsyncOp&)> commandCallback);
+		template<class T>
+		AsyncOp queueReturnCommand(T&& commandCallback)
+		{
+			return mCommandQueue->queueReturn(std::forward<T>(commandCallback));
+		}
 
 		/** Queues a new generic command that will be added to the command queue. */
-		void queueCommand(std::function<void()> commandCallback);
+		template<class T>
+		void queueCommand(T&& commandCallback)
+		{
+			mCommandQueue->queue(std::forward<T>(commandCallback));
+		}
 
 		/**
 		 * Makes all the currently queued commands available to the core thread. They will be executed as soon as the core 
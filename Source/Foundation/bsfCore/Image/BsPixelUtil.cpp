@@ -6,6 +6,8 @@
 #include "Math/BsMath.h"
 #include "Error/BsException.h"
 #include "Image/BsTexture.h"
+#include "Math/BsSIMD.h"
+#include "Threading/BsTaskScheduler.h"
 #include <nvtt.h>
 
 namespace bs
@@ -333,6 +335,425 @@ namespace bs
 		}
 	};
 
+	/** Builds a byte mask usable with simd::permute_zbytes16() by calling MASK::get() for each byte of the mask. */
+	template<class MASK, size_t... IDX>
+	simd::uint8x16 makeByteMask(std::index_sequence<IDX...>)
+	{
+		return simd::make_uint<simd::uint8x16>(MASK::get((UINT32)IDX)...);
+	}
+
+	/** Converts a group of four RGBA pixels from floating point channels to 8-bit normalized channels. */
+	inline simd::uint8x16 toUNorm8(const simd::float32<16>& rgba)
+	{
+		using namespace simd;
+
+		// Same as Bitwise::unormToUint<8>()
+		const float32<16> clamped = min(max(rgba, splat<float32<16>>(0.0f)), splat<float32<16>>(1.0f));
+		const float32<16> scaled = floor(add(mul(clamped, splat<float32<16>>(255.0f)), splat<float32<16>>(0.5f)));
+
+		return to_uint8(to_int32(scaled));
+	}
+
+	/** Converts a group of four RGBA pixels from 8-bit normalized channels to floating point channels. */
+	inline simd::float32<16> toFloat32(const simd::uint8x16& rgba)
+	{
+		using namespace simd;
+
+		// Same as Bitwise::uintToUnorm<8>()
+		return div(to_float32(to_int32(rgba)), splat<float32<16>>(255.0f));
+	}
+
+	inline simd::uint8x16 toUNorm8(const simd::uint8x16& rgba) { return rgba; }
+	inline simd::float32<16> toFloat32(const simd::float32<16>& rgba) { return rgba; }
+
+	/**
+	 * Reads and writes groups of four pixels in a format storing each channel as an 8-bit normalized integer. Pixels are
+	 * read into RGBA order, with missing color channels set to zero and missing alpha set to one, same as unpackColor().
+	 *
+	 * @tparam	PIXEL_SIZE	Size of a single pixel in bytes.
+	 * @tparam	R, G, B, A	Offset of the channel in bytes, within a single pixel. -1 if the format has no such channel.
+	 */
+	template<UINT32 PIXEL_SIZE, INT32 R, INT32 G, INT32 B, INT32 A>
+	struct PixelCodecUNorm8
+	{
+		typedef simd::uint8x16 Type;
+		static constexpr UINT32 PixelSize = PIXEL_SIZE;
+
+		/** Returns the offset of the channel with the specified index (in RGBA order), or -1 if it doesn't exist. */
+		static constexpr INT32 getOffset(UINT32 channel)
+		{
+			return channel == 0 ? R : (channel == 1 ? G : (channel == 2 ? B : A));
+		}
+
+		/** Returns the index of the RGBA channel stored at the specified offset, or 0x80 if no channel is stored there. */
+		static constexpr UINT32 getChannel(INT32 offset)
+		{
+			return R == offset ? 0 : (G == offset ? 1 : (B == offset ? 2 : (A == offset ? 3 : 0x80)));
+		}
+
+		/** Maps each byte of four RGBA pixels to the source byte of the four encoded pixels. */
+		struct ReadMask
+		{
+			static constexpr UINT8 get(UINT32 i)
+			{
+				return getOffset(i % 4) >= 0 ? (UINT8)((i / 4) * PIXEL_SIZE + getOffset(i % 4)) : 0x80;
+			}
+		};
+
+		/** Maps each byte of four encoded pixels to the source byte of the four RGBA pixels. */
+		struct WriteMask
+		{
+			static constexpr UINT8 get(UINT32 i)
+			{
+				return (i < 4 * PIXEL_SIZE && getChannel(i % PIXEL_SIZE) != 0x80) ? 
+					(UINT8)((i / PIXEL_SIZE) * 4 + getChannel(i % PIXEL_SIZE)) : 0x80;
+			}
+		};
+
+		/** Reads four pixels. */
+		static Type read(const UINT8* src)
+		{
+			using namespace simd;
+
+			uint8x16 data;
+			if (PIXEL_SIZE == 4)
+				data = load_u<uint8x16>(src);
+			else
+			{
+				UINT8 bytes[16] = { };
+				memcpy(bytes, src, 4 * PIXEL_SIZE);
+
+				data = load_u<uint8x16>(bytes);
+			}
+
+			const uint8x16 rgba = permute_zbytes16(data, makeByteMask<ReadMask>(std::make_index_sequence<16>()));
+			if (A >= 0)
+				return rgba;
+
+			return bit_or(rgba, make_uint<uint8x16>(0, 0, 0, 255));
+		}
+
+		/** Writes four pixels. */
+		template<class T>
+		static void write(const T& rgba, UINT8* dst)
+		{
+			using namespace simd;
+
+			const uint8x16 data = permute_zbytes16(toUNorm8(rgba), 
+				makeByteMask<WriteMask>(std::make_index_sequence<16>()));
+
+			if (PIXEL_SIZE == 4)
+				store_u(dst, data);
+			else
+			{
+				UINT8 bytes[16];
+				store_u(bytes, data);
+
+				memcpy(dst, bytes, 4 * PIXEL_SIZE);
+			}
+		}
+	};
+
+	typedef PixelCodecUNorm8<1, 0, -1, -1, -1> PixelCodecR8;
+	typedef PixelCodecUNorm8<2, 0, 1, -1, -1> PixelCodecRG8;
+	typedef PixelCodecUNorm8<4, 0, 1, 2, -1> PixelCodecRGB8;
+	typedef PixelCodecUNorm8<4, 2, 1, 0, -1> PixelCodecBGR8;
+	typedef PixelCodecUNorm8<4, 0, 1, 2, 3> PixelCodecRGBA8;
+	typedef PixelCodecUNorm8<4, 2, 1, 0, 3> PixelCodecBGRA8;
+
+	/** Reads and writes groups of four pixels in the PF_RGBA32F format. */
+	struct PixelCodecRGBA32F
+	{
+		typedef simd::float32<16> Type;
+		static constexpr UINT32 PixelSize = 16;
+
+		/** Reads four pixels. */
+		static Type read(const UINT8* src)
+		{
+			return simd::load_u<Type>(src);
+		}
+
+		/** Writes four pixels. */
+		template<class T>
+		static void write(const T& rgba, UINT8* dst)
+		{
+			simd::store_u(dst, toFloat32(rgba));
+		}
+	};
+
+	/** 
+	 * Reads and writes groups of four pixels in the PF_RGBA16F format. Produces the same results as 
+	 * Bitwise::halfToFloat() and Bitwise::floatToHalf().
+	 */
+	struct PixelCodecRGBA16F
+	{
+		typedef simd::float32<16> Type;
+		static constexpr UINT32 PixelSize = 8;
+
+		/** Reads four pixels. */
+		static Type read(const UINT8* src)
+		{
+			using namespace simd;
+
+			const uint32<16> half = to_uint32(load_u<uint16<16>>(src));
+			const uint32<16> sign = shift_l<16>(bit_and(half, splat<uint32<16>>(0x8000)));
+			const uint32<16> magnitude = shift_l<13>(bit_and(half, splat<uint32<16>>(0x7fff)));
+
+			// Rebias the exponent by scaling with 2^112, which also handles denormalized halves
+			const uint32<16> finite = bit_cast<uint32<16>>(
+				mul(bit_cast<float32<16>>(magnitude), splat<float32<16>>(5.192296858534828e+33f)));
+
+			// Infinity and NaN keep their mantissa, with the exponent set to all ones
+			const mask_int32<16> isInfOrNaN = cmp_eq(bit_and(half, splat<uint32<16>>(0x7c00)), 
+				splat<uint32<16>>(0x7c00));
+			const uint32<16> infOrNaN = bit_or(magnitude, splat<uint32<16>>(0x7f800000));
+
+			return bit_cast<float32<16>>(bit_or(blend(infOrNaN, finite, isInfOrNaN), sign));
+		}
+
+		/** Writes four pixels. */
+		template<class T>
+		static void write(const T& rgba, UINT8* dst)
+		{
+			using namespace simd;
+
+			const uint32<16> bits = bit_cast<uint32<16>>(toFloat32(rgba));
+			const int32<16> magnitude = bit_and(bits, splat<uint32<16>>(0x7fffffff));
+
+			// Exponent in range of a normalized half, rebias it and truncate the mantissa
+			uint32<16> half = sub(shift_r<13>(magnitude), splat<uint32<16>>((127 - 15) << 10));
+
+			// Too small for a normalized half, truncate to a denormalized half (or zero)
+			const int32<16> denormal = to_int32(mul(bit_cast<float32<16>>(magnitude), splat<float32<16>>(16777216.0f)));
+			half = blend(denormal, half, cmp_lt(magnitude, splat<int32<16>>(0x38800000)));
+
+			// Too large for a half, clamp to infinity
+			half = blend(splat<uint32<16>>(0x7c00), half, cmp_ge(magnitude, splat<int32<16>>(0x47800000)));
+
+			// NaN, keep the upper mantissa bits while making sure at least one of them is set
+			const uint32<16> mantissa = shift_r<13>(bit_and(magnitude, splat<uint32<16>>(0x007fffff)));
+			const uint32<16> nan = bit_or(bit_or(mantissa, splat<uint32<16>>(0x7c00)), 
+				bit_and(splat<uint32<16>>(1), cmp_eq(mantissa, splat<uint32<16>>(0))));
+			half = blend(nan, half, cmp_gt(magnitude, splat<int32<16>>(0x7f800000)));
+
+			// Values that truncate to zero before being denormalized don't preserve the sign
+			const uint32<16> sign = bit_and(shift_r<16>(bits), splat<uint32<16>>(0x8000));
+			half = bit_or(half, bit_and(sign, cmp_ge(magnitude, splat<int32<16>>(0x33000000))));
+
+			store_u(dst, to_uint16(half));
+		}
+	};
+
+	/** Converts a row of pixels from one format to another. */
+	typedef void(*PixelRowConverter)(const UINT8* /*src*/, UINT8* /*dst*/, UINT32 /*count*/);
+
+	/** Converts a row of pixels by reading them using the @p SRC codec, and writing them using the @p DST codec. */
+	template<class SRC, class DST>
+	void convertPixelRow(const UINT8* src, UINT8* dst, UINT32 count)
+	{
+		UINT32 i = 0;
+		for (; (i + 4) <= count; i += 4)
+		{
+			DST::write(SRC::read(src), dst);
+
+			src += 4 * SRC::PixelSize;
+			dst += 4 * DST::PixelSize;
+		}
+
+		// Pad the remaining pixels to a full group
+		if (i < count)
+		{
+			UINT8 srcTemp[4 * SRC::PixelSize] = { };
+			UINT8 dstTemp[4 * DST::PixelSize];
+
+			memcpy(srcTemp, src, (count - i) * SRC::PixelSize);
+			DST::write(SRC::read(srcTemp), dstTemp);
+			memcpy(dst, dstTemp, (count - i) * DST::PixelSize);
+		}
+	}
+
+	/** Returns a row converter from the format read by @p SRC, into the provided format. */
+	template<class SRC>
+	PixelRowConverter getPixelRowConverter(PixelFormat dstFormat)
+	{
+		switch (dstFormat)
+		{
+		case PF_R8: return &convertPixelRow<SRC, PixelCodecR8>;
+		case PF_RG8: return &convertPixelRow<SRC, PixelCodecRG8>;
+		case PF_RGB8: return &convertPixelRow<SRC, PixelCodecRGB8>;
+		case PF_BGR8: return &convertPixelRow<SRC, PixelCodecBGR8>;
+		case PF_RGBA8: return &convertPixelRow<SRC, PixelCodecRGBA8>;
+		case PF_BGRA8: return &convertPixelRow<SRC, PixelCodecBGRA8>;
+		case PF_RGBA16F: return &convertPixelRow<SRC, PixelCodecRGBA16F>;
+		case PF_RGBA32F: return &convertPixelRow<SRC, PixelCodecRGBA32F>;
+		default: return nullptr;
+		}
+	}
+
+	/** 
+	 * Returns a function that converts whole rows of pixels between the provided formats using SIMD, or null if there is
+	 * no specialized converter for the two formats. Specialized converters produce the same results as packing and
+	 * unpacking each pixel using the generic path.
+	 */
+	PixelRowConverter getPixelRowConverter(PixelFormat srcFormat, PixelFormat dstFormat)
+	{
+		switch (srcFormat)
+		{
+		case PF_R8: return getPixelRowConverter<PixelCodecR8>(dstFormat);
+		case PF_RG8: return getPixelRowConverter<PixelCodecRG8>(dstFormat);
+		case PF_RGB8: return getPixelRowConverter<PixelCodecRGB8>(dstFormat);
+		case PF_BGR8: return getPixelRowConverter<PixelCodecBGR8>(dstFormat);
+		case PF_RGBA8: return getPixelRowConverter<PixelCodecRGBA8>(dstFormat);
+		case PF_BGRA8: return getPixelRowConverter<PixelCodecBGRA8>(dstFormat);
+		case PF_RGBA16F: return getPixelRowConverter<PixelCodecRGBA16F>(dstFormat);
+		case PF_RGBA32F: return getPixelRowConverter<PixelCodecRGBA32F>(dstFormat);
+		default: return nullptr;
+		}
+	}
+
+	/** Number of pixels that need to be processed before the work is distributed across multiple threads. */
+	static constexpr UINT32 PARALLEL_PIXEL_THRESHOLD = 128 * 1024;
+
+	/** Minimum number of pixels to process as a single unit of work, when processing in parallel. */
+	static constexpr UINT32 PARALLEL_PIXEL_GRAIN = 16 * 1024;
+
+	/** 
+	 * Calls @p worker for each row in range [0, @p numRows). If the total number of pixels is large enough and the task
+	 * scheduler is running, the rows are processed in parallel.
+	 */
+	template<class T>
+	void forEachPixelRow(UINT32 numRows, UINT32 rowWidth, const T& worker)
+	{
+		const UINT64 numPixels = (UINT64)numRows * rowWidth;
+		if (numRows > 1 && numPixels >= PARALLEL_PIXEL_THRESHOLD && TaskScheduler::isStarted())
+		{
+			const UINT32 grainSize = std::max(1U, PARALLEL_PIXEL_GRAIN / std::max(1U, rowWidth));
+			TaskScheduler::instance().parallelFor(0, numRows, grainSize, worker);
+		}
+		else
+		{
+			for (UINT32 i = 0; i < numRows; i++)
+				worker(i);
+		}
+	}
+
+	/**
+	 * Bilinear resampler for 2D images in any format with a row converter to and from PF_RGBA32F. Filtering is performed
+	 * in floating point, decoding only the source rows that are sampled. Output rows are split into bands that are
+	 * processed in parallel.
+	 */
+	struct LinearResampler_RGBA32F
+	{
+		static void scale(const PixelData& source, const PixelData& dest)
+		{
+			using namespace simd;
+
+			static constexpr UINT32 ROWS_PER_BAND = 32;
+
+			const UINT32 srcWidth = source.getWidth();
+			const UINT32 srcHeight = source.getHeight();
+			const UINT32 dstWidth = dest.getWidth();
+			const UINT32 dstHeight = dest.getHeight();
+
+			const PixelRowConverter decodeRow = getPixelRowConverter(source.getFormat(), PF_RGBA32F);
+			const PixelRowConverter encodeRow = getPixelRowConverter(PF_RGBA32F, dest.getFormat());
+
+			// Get steps for traversing source data in 16/48 fixed point precision format
+			const UINT64 stepX = ((UINT64)srcWidth << 48) / dstWidth;
+			const UINT64 stepY = ((UINT64)srcHeight << 48) / dstHeight;
+
+			// Neighboring pixels along a single axis, and the blend factor between them
+			struct Sample
+			{
+				UINT32 coord1, coord2;
+				float weight;
+			};
+
+			const auto getSample = [](UINT64 position, UINT32 size)
+			{
+				UINT32 temp = (UINT32)(position >> 32);
+				temp = (temp > 0x8000) ? temp - 0x8000 : 0;
+
+				Sample sample;
+				sample.coord1 = temp >> 16;
+				sample.coord2 = std::min(sample.coord1 + 1, size - 1);
+				sample.weight = (temp & 0xFFFF) / 65536.0f;
+
+				return sample;
+			};
+
+			Vector<Sample> columnSamples(dstWidth);
+
+			UINT64 curX = (stepX >> 1) - 1; // Offset half a pixel to start at pixel center
+			for (UINT32 x = 0; x < dstWidth; x++, curX += stepX)
+				columnSamples[x] = getSample(curX, srcWidth);
+
+			const UINT32 srcPixelSize = PixelUtil::getNumElemBytes(source.getFormat());
+			const UINT32 dstPixelSize = PixelUtil::getNumElemBytes(dest.getFormat());
+
+			const UINT8* srcPixels = source.getData() + 
+				(source.getLeft() + source.getTop() * source.getRowPitch()) * srcPixelSize;
+			UINT8* dstPixels = dest.getData() + (dest.getLeft() + dest.getTop() * dest.getRowPitch()) * dstPixelSize;
+
+			const size_t srcRowPitch = source.getRowPitch() * srcPixelSize;
+			const size_t dstRowPitch = dest.getRowPitch() * dstPixelSize;
+
+			const UINT32 numBands = Math::divideAndRoundUp(dstHeight, ROWS_PER_BAND);
+			forEachPixelRow(numBands, ROWS_PER_BAND * (dstWidth + srcWidth), [&](UINT32 band)
+			{
+				// Two most recently decoded source rows, reused by neighboring output rows
+				Vector<float> decodedRows(srcWidth * 4 * 2);
+				Vector<float> dstRow(dstWidth * 4);
+				UINT32 decodedRowIds[2] = { (UINT32)-1, (UINT32)-1 };
+
+				const auto getSourceRow = [&](UINT32 row, UINT32 rowInUse) -> const float*
+				{
+					for (UINT32 i = 0; i < 2; i++)
+					{
+						if (decodedRowIds[i] == row)
+							return &decodedRows[i * srcWidth * 4];
+					}
+
+					const UINT32 slot = decodedRowIds[0] == rowInUse ? 1 : 0;
+					float* output = &decodedRows[slot * srcWidth * 4];
+					decodeRow(srcPixels + row * srcRowPitch, (UINT8*)output, srcWidth);
+
+					decodedRowIds[slot] = row;
+					return output;
+				};
+
+				const UINT32 firstRow = band * ROWS_PER_BAND;
+				const UINT32 lastRow = std::min(firstRow + ROWS_PER_BAND, dstHeight);
+				for (UINT32 y = firstRow; y < lastRow; y++)
+				{
+					const Sample rowSample = getSample((stepY >> 1) - 1 + y * stepY, srcHeight);
+					const float32x4 weightY = splat<float32x4>(rowSample.weight);
+
+					const float* srcRow1 = getSourceRow(rowSample.coord1, rowSample.coord2);
+					const float* srcRow2 = getSourceRow(rowSample.coord2, rowSample.coord1);
+
+					for (UINT32 x = 0; x < dstWidth; x++)
+					{
+						const Sample& columnSample = columnSamples[x];
+						const float32x4 weightX = splat<float32x4>(columnSample.weight);
+
+						const float32x4 x1y1 = load_u<float32x4>(srcRow1 + columnSample.coord1 * 4);
+						const float32x4 x2y1 = load_u<float32x4>(srcRow1 + columnSample.coord2 * 4);
+						const float32x4 x1y2 = load_u<float32x4>(srcRow2 + columnSample.coord1 * 4);
+						const float32x4 x2y2 = load_u<float32x4>(srcRow2 + columnSample.coord2 * 4);
+
+						const float32x4 y1 = add(x1y1, mul(sub(x2y1, x1y1), weightX));
+						const float32x4 y2 = add(x1y2, mul(sub(x2y2, x1y2), weightX));
+
+						store_u(&dstRow[x * 4], add(y1, mul(sub(y2, y1), weightY)));
+					}
+
+					encodeRow((const UINT8*)dstRow.data(), dstPixels + y * dstRowPitch, dstWidth);
+				}
+			});
+		}
+	};
+
 	/**	Data describing a pixel format. */
 	struct PixelFormatDescription
 	{
@@ -1212,43 +1633,7 @@ namespace bs
 		UINT8* bufferEnd;
 	};
 
-	/**	Handles output from NVTT library for a mip-map chain. */
-	struct NVTTMipmapOutputHandler : public nvtt::OutputHandler
-	{
-		NVTTMipmapOutputHandler(const Vector<SPtr<PixelData>>& buffers)
-			:buffers(buffers), bufferWritePos(nullptr), bufferEnd(nullptr)
-		{ }
-
-		void beginImage(int size, int width, int height, int depth, int face, int miplevel) override
-		{
-			assert(miplevel >= 0 && miplevel < (int)buffers.size());
-			assert((UINT32)size == buffers[miplevel]->getConsecutiveSize());
-
-			activeBuffer = buffers[miplevel];
-
-			bufferWritePos = activeBuffer->getData();
-			bufferEnd = bufferWritePos + activeBuffer->getConsecutiveSize();
-		}
-
-		bool writeData(const void* data, int size) override
-		{
-			assert((bufferWritePos + size) <= bufferEnd);
-			memcpy(bufferWritePos, data, size);
-			bufferWritePos += size;
-
-			return true;
-		}
-
-		void endImage() override
-		{ }
-
-		Vector<SPtr<PixelData>> buffers;
-		SPtr<PixelData> activeBuffer;
-
-		UINT8* bufferWritePos;
-		UINT8* bufferEnd;
-	};
-
+	/**	Converts a pixel format to the matching NVTT compression format. */
 	nvtt::Format toNVTTFormat(PixelFormat format)
 	{
 		switch (format)
@@ -1308,22 +1693,6 @@ namespace bs
 		return nvtt::AlphaMode_None;
 	}
 
-	nvtt::WrapMode toNVTTWrapMode(MipMapWrapMode wrapMode)
-	{
-		switch (wrapMode)
-		{
-		case MipMapWrapMode::Clamp:
-			return nvtt::WrapMode_Clamp;
-		case MipMapWrapMode::Mirror:
-			return nvtt::WrapMode_Mirror;
-		case MipMapWrapMode::Repeat:
-			return nvtt::WrapMode_Repeat;
-		}
-
-		// Unknown alpha mode
-		return nvtt::WrapMode_Mirror;
-	}
-
 	UINT32 PixelUtil::getNumElemBytes(PixelFormat format)
 	{
 		return getDescriptionFor(format).elemBytes;
@@ -1968,6 +2337,32 @@ namespace bs
 		UINT8 *dstptr = static_cast<UINT8*>(dst.getData())
 			+ (dst.getLeft() + dst.getTop() * dst.getRowPitch() + dst.getFront() * dst.getSlicePitch()) * dstPixelSize;
 
+		// Common format pairs have specialized converters that process entire rows at once
+		const PixelRowConverter rowConverter = getPixelRowConverter(src.getFormat(), dst.getFormat());
+		if (rowConverter)
+		{
+			const UINT32 width = src.getWidth();
+			const UINT32 height = src.getHeight();
+
+			const size_t srcRowPitchBytes = src.getRowPitch() * srcPixelSize;
+			const size_t srcSlicePitchBytes = src.getSlicePitch() * srcPixelSize;
+			const size_t dstRowPitchBytes = dst.getRowPitch() * dstPixelSize;
+			const size_t dstSlicePitchBytes = dst.getSlicePitch() * dstPixelSize;
+
+			forEachPixelRow(height * src.getDepth(), width, [&](UINT32 row)
+			{
+				const UINT32 y = row % height;
+				const UINT32 z = row / height;
+
+				rowConverter(
+					srcptr + z * srcSlicePitchBytes + y * srcRowPitchBytes,
+					dstptr + z * dstSlicePitchBytes + y * dstRowPitchBytes,
+					width);
+			});
+
+			return;
+		}
+
 		// Calculate pitches+skips in bytes
 		UINT32 srcRowSkipBytes = src.getRowSkip()*srcPixelSize;
 		UINT32 srcSliceSkipBytes = src.getSliceSkip()*srcPixelSize;
@@ -2165,6 +2560,14 @@ namespace bs
 			break;
 
 		case FILTER_LINEAR:
+			// Common 2D formats are resampled in floating point, with rows processed in parallel
+			if (src.getDepth() == 1 && scaled.getDepth() == 1 && 
+				getPixelRowConverter(src.getFormat(), PF_RGBA32F) && getPixelRowConverter(PF_RGBA32F, scaled.getFormat()))
+			{
+				LinearResampler_RGBA32F::scale(src, scaled);
+				break;
+			}
+
 			switch (src.getFormat())
 			{
 			case PF_RG8:
@@ -2375,6 +2778,124 @@ namespace bs
 			return std::pow((x + 0.055f) / 1.055f, 2.4f);
 	}
 
+	/** Lookup tables that convert 8-bit normalized values between linear and sRGB space. */
+	struct SRGBLUTs
+	{
+		SRGBLUTs()
+		{
+			// Same as unpacking, converting and packing each value
+			for (UINT32 i = 0; i < 256; i++)
+			{
+				const float value = Bitwise::uintToUnorm<8>(i);
+
+				toSRGB[i] = (UINT8)Bitwise::unormToUint<8>(linearToSRGB(value));
+				toLinear[i] = (UINT8)Bitwise::unormToUint<8>(SRGBToLinear(value));
+				toLinearFloat[i] = SRGBToLinear(value);
+			}
+
+			// Find the smallest linear value that encodes to each 8-bit sRGB value, by bisecting the bit patterns of 
+			// positive floats (which are ordered the same as the floats themselves)
+			const auto bitsToFloat = [](UINT32 bits)
+			{
+				float output;
+				memcpy(&output, &bits, sizeof(output));
+
+				return output;
+			};
+
+			toSRGBThresholds[0] = 0.0f;
+			for (UINT32 i = 1; i < 256; i++)
+			{
+				UINT32 low = 0;
+				UINT32 high = 0x3f800000; // 1.0f
+				while (low < high)
+				{
+					const UINT32 middle = low + (high - low) / 2;
+					if (Bitwise::unormToUint<8>(linearToSRGB(bitsToFloat(middle))) >= i)
+						high = middle;
+					else
+						low = middle + 1;
+				}
+
+				toSRGBThresholds[i] = bitsToFloat(low);
+			}
+		}
+
+		/** 
+		 * Converts a linear value to an 8-bit sRGB value. Same as converting the value to sRGB space and then to an
+		 * 8-bit normalized value, but without evaluating the sRGB curve.
+		 */
+		UINT8 encodeSRGB(float value) const
+		{
+			UINT32 idx = 0;
+			for (UINT32 step = 128; step > 0; step >>= 1)
+			{
+				if (value >= toSRGBThresholds[idx + step])
+					idx += step;
+			}
+
+			return (UINT8)idx;
+		}
+
+		UINT8 toSRGB[256];
+		UINT8 toLinear[256];
+		float toLinearFloat[256];
+		float toSRGBThresholds[256];
+	};
+
+	/** Returns lookup tables for converting 8-bit normalized values between linear and sRGB space. */
+	const SRGBLUTs& getSRGBLUTs()
+	{
+		static SRGBLUTs luts;
+		return luts;
+	}
+
+	/** Transforms the color channels of all pixels read by @p CODEC, using the provided lookup table. */
+	template<class CODEC>
+	void applyColorLUT(PixelData& pixelData, const UINT8* lut)
+	{
+		const UINT32 width = pixelData.getWidth();
+		const UINT32 height = pixelData.getHeight();
+
+		const size_t rowPitchBytes = pixelData.getRowPitch() * CODEC::PixelSize;
+		const size_t slicePitchBytes = pixelData.getSlicePitch() * CODEC::PixelSize;
+		UINT8* data = pixelData.getData();
+
+		forEachPixelRow(height * pixelData.getDepth(), width, [&](UINT32 row)
+		{
+			UINT8* pixel = data + (row / height) * slicePitchBytes + (row % height) * rowPitchBytes;
+			for (UINT32 x = 0; x < width; x++)
+			{
+				for (UINT32 i = 0; i < 3; i++)
+				{
+					const INT32 offset = CODEC::getOffset(i);
+					if (offset >= 0)
+						pixel[offset] = lut[pixel[offset]];
+				}
+
+				pixel += CODEC::PixelSize;
+			}
+		});
+	}
+
+	/** 
+	 * Transforms the color channels of all pixels using the provided lookup table. Returns false if the pixel format
+	 * doesn't store color channels as 8-bit normalized values.
+	 */
+	bool applyColorLUT(PixelData& pixelData, const UINT8* lut)
+	{
+		switch (pixelData.getFormat())
+		{
+		case PF_R8: applyColorLUT<PixelCodecR8>(pixelData, lut); return true;
+		case PF_RG8: applyColorLUT<PixelCodecRG8>(pixelData, lut); return true;
+		case PF_RGB8: applyColorLUT<PixelCodecRGB8>(pixelData, lut); return true;
+		case PF_BGR8: applyColorLUT<PixelCodecBGR8>(pixelData, lut); return true;
+		case PF_RGBA8: applyColorLUT<PixelCodecRGBA8>(pixelData, lut); return true;
+		case PF_BGRA8: applyColorLUT<PixelCodecBGRA8>(pixelData, lut); return true;
+		default: return false;
+		}
+	}
+
 	Color PixelUtil::linearToSRGB(const bs::Color& color)
 	{
 		return Color(
@@ -2395,6 +2916,9 @@ namespace bs
 
 	void PixelUtil::linearToSRGB(PixelData& pixelData)
 	{
+		if (applyColorLUT(pixelData, getSRGBLUTs().toSRGB))
+			return;
+
 		UINT32 depth = pixelData.getDepth();
 		UINT32 height = pixelData.getHeight();
 		UINT32 width = pixelData.getWidth();
@@ -2427,6 +2951,9 @@ namespace bs
 
 	void PixelUtil::SRGBToLinear(PixelData& pixelData)
 	{
+		if (applyColorLUT(pixelData, getSRGBLUTs().toLinear))
+			return;
+
 		UINT32 depth = pixelData.getDepth();
 		UINT32 height = pixelData.getHeight();
 		UINT32 width = pixelData.getWidth();
@@ -2519,119 +3046,496 @@ namespace bs
 		}
 	}
 
-	Vector<SPtr<PixelData>> PixelUtil::genMipmaps(const PixelData& src, const MipMapGenOptions& options)
+	/** Separable filter kernel used for downsampling images to half of their size. */
+	struct DownsampleKernel
 	{
-		Vector<SPtr<PixelData>> outputMipBuffers;
+		static constexpr UINT32 MAX_TAPS = 12;
 
-		if (src.getDepth() != 1)
+		/** 
+		 * Offset of the first source pixel covered by the kernel, relative to the first of the two source pixels
+		 * an output pixel is centered between.
+		 */
+		INT32 offset = 0;
+
+		UINT32 numTaps = 0;
+		float weights[MAX_TAPS];
+	};
+
+	/** Evaluates the zero-th order modified Bessel function of the first kind. */
+	float besselI0(float x)
+	{
+		float sum = 1.0f;
+		float term = 1.0f;
+		for (UINT32 i = 1; i < 32; i++)
 		{
-			LOGERR("Mipmap generation failed. 3D texture formats not supported.")
-			return outputMipBuffers;
+			const float factor = x / (2.0f * i);
+			term *= factor * factor;
+			sum += term;
+
+			if (term < sum * 1e-8f)
+				break;
 		}
 
-		if (isCompressed(src.getFormat()))
+		return sum;
+	}
+
+	/** Evaluates the normalized sinc function. */
+	float sinc(float x)
+	{
+		if (Math::abs(x) < 1e-6f)
+			return 1.0f;
+
+		return std::sin(Math::PI * x) / (Math::PI * x);
+	}
+
+	/** Creates a kernel that can be used for downsampling an image to half its size, using the specified filter. */
+	DownsampleKernel createDownsampleKernel(MipMapFilter filter)
+	{
+		DownsampleKernel kernel;
+		if (filter == MipMapFilter::Box)
 		{
-			LOGERR("Mipmap generation failed. Source data cannot be compressed.")
-			return outputMipBuffers;
+			kernel.numTaps = 2;
+			kernel.weights[0] = 0.5f;
+			kernel.weights[1] = 0.5f;
+
+			return kernel;
 		}
 
-		if (!Bitwise::isPow2(src.getWidth()) || !Bitwise::isPow2(src.getHeight()))
+		// Filter radius, in output pixels
+		const float radius = filter == MipMapFilter::Triangle ? 1.0f : 3.0f;
+		const INT32 tapsPerSide = (INT32)radius * 2;
+
+		kernel.offset = 1 - tapsPerSide;
+		kernel.numTaps = (UINT32)tapsPerSide * 2;
+
+		float weightSum = 0.0f;
+		for (UINT32 i = 0; i < kernel.numTaps; i++)
 		{
-			LOGERR("Mipmap generation failed. Texture width & height must be powers of 2.");
-			return outputMipBuffers;
+			// Distance from the output pixel center to the source pixel center, in output pixels
+			const float x = (kernel.offset + (INT32)i - 0.5f) * 0.5f;
+
+			float weight;
+			switch (filter)
+			{
+			case MipMapFilter::Triangle:
+				weight = std::max(0.0f, 1.0f - Math::abs(x));
+				break;
+			case MipMapFilter::Kaiser:
+			{
+				static constexpr float ALPHA = 4.0f;
+
+				const float t = x / radius;
+				weight = sinc(x) * besselI0(ALPHA * std::sqrt(std::max(0.0f, 1.0f - t * t))) / besselI0(ALPHA);
+			}
+				break;
+			default:
+			case MipMapFilter::Lanczos:
+				weight = sinc(x) * sinc(x / radius);
+				break;
+			}
+
+			kernel.weights[i] = weight;
+			weightSum += weight;
 		}
 
-		PixelFormat interimFormat = isFloatingPoint(src.getFormat()) ? PF_RGBA32F : PF_BGRA8;
+		for (UINT32 i = 0; i < kernel.numTaps; i++)
+			kernel.weights[i] /= weightSum;
 
-		PixelData interimData(src.getWidth(), src.getHeight(), 1, interimFormat);
-		interimData.allocateInternalBuffer();
-		bulkPixelConversion(src, interimData);
+		return kernel;
+	}
 
-		if (interimFormat != PF_RGBA32F)
-			flipComponentOrder(interimData);
+	/** Maps a pixel coordinate that might be outside of the [0, size) range into the range, using the wrap mode. */
+	UINT32 wrapPixelCoordinate(INT32 coord, INT32 size, MipMapWrapMode wrapMode)
+	{
+		switch (wrapMode)
+		{
+		case MipMapWrapMode::Clamp:
+			return (UINT32)Math::clamp(coord, 0, size - 1);
+		case MipMapWrapMode::Repeat:
+			return (UINT32)(((coord % size) + size) % size);
+		default:
+		case MipMapWrapMode::Mirror:
+			if (size == 1)
+				return 0;
 
-		nvtt::InputOptions io;
-		io.setTextureLayout(nvtt::TextureType_2D, src.getWidth(), src.getHeight());
-		io.setMipmapGeneration(true);
-		io.setNormalMap(options.isNormalMap);
-		io.setNormalizeMipmaps(options.normalizeMipmaps);
-		io.setWrapMode(toNVTTWrapMode(options.wrapMode));
+			// Reflect without repeating the edge pixel
+			coord = std::abs(coord);
+			while (coord >= size)
+				coord = std::abs(2 * size - coord - 2);
 
-		if (interimFormat == PF_RGBA32F)
-			io.setFormat(nvtt::InputFormat_RGBA_32F);
-		else
-			io.setFormat(nvtt::InputFormat_BGRA_8UB);
+			return (UINT32)coord;
+		}
+	}
 
-		if (options.isSRGB)
-			io.setGamma(2.2f, 2.2f);
-		else
-			io.setGamma(1.0f, 1.0f);
+	/** Creates a kernel that leaves the pixels unchanged, used along dimensions that aren't being downsampled. */
+	DownsampleKernel createIdentityKernel()
+	{
+		DownsampleKernel kernel;
+		kernel.numTaps = 1;
+		kernel.weights[0] = 1.0f;
 
-		io.setMipmapData(interimData.getData(), src.getWidth(), src.getHeight());
+		return kernel;
+	}
 
-		nvtt::CompressionOptions co;
-		co.setFormat(nvtt::Format_RGBA);
+	/** 
+	 * Calculates the index of the source pixel read by each tap of the kernel, for each pixel of a row or column of
+	 * @p srcSize pixels downsampled to @p dstSize pixels.
+	 */
+	Vector<UINT32> calcDownsampleTaps(const DownsampleKernel& kernel, UINT32 srcSize, UINT32 dstSize, 
+		MipMapWrapMode wrapMode)
+	{
+		const UINT32 ratio = srcSize / dstSize;
 
-		if (interimFormat == PF_RGBA32F)
+		Vector<UINT32> taps(dstSize * kernel.numTaps);
+		for (UINT32 i = 0; i < dstSize; i++)
+		{
+			for (UINT32 j = 0; j < kernel.numTaps; j++)
+			{
+				const INT32 coord = (INT32)(i * ratio) + kernel.offset + (INT32)j;
+				taps[i * kernel.numTaps + j] = wrapPixelCoordinate(coord, (INT32)srcSize, wrapMode);
+			}
+		}
+
+		return taps;
+	}
+
+	/** Returns true if the pixel format stores its color channels as 8-bit normalized integers. */
+	bool isUNorm8Format(PixelFormat format)
+	{
+		switch (format)
+		{
+		case PF_R8: case PF_RG8: case PF_RGB8: case PF_BGR8: case PF_RGBA8: case PF_BGRA8:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	/** Converts a single row of pixels from one format to another. */
+	void convertPixelRow(const UINT8* src, PixelFormat srcFormat, UINT8* dst, PixelFormat dstFormat, UINT32 width)
+	{
+		PixelData srcRow(width, 1, 1, srcFormat);
+		srcRow.setExternalBuffer(const_cast<UINT8*>(src));
+
+		PixelData dstRow(width, 1, 1, dstFormat);
+		dstRow.setExternalBuffer(dst);
+
+		PixelUtil::bulkPixelConversion(srcRow, dstRow);
+	}
+
+	/** 
+	 * Reads a row of pixels into PF_RGBA32F format, optionally converting the color channels from sRGB to linear space.
+	 * @p scratch must be large enough to hold the row in PF_RGBA8 format.
+	 */
+	void decodeLinearRow(const UINT8* src, PixelFormat format, bool isSRGB, UINT32 width, float* dst, UINT8* scratch)
+	{
+		if (!isSRGB)
+		{
+			convertPixelRow(src, format, (UINT8*)dst, PF_RGBA32F, width);
+			return;
+		}
+
+		if (isUNorm8Format(format))
 		{
-			co.setPixelType(nvtt::PixelType_Float);
-			co.setPixelFormat(32, 32, 32, 32);
+			convertPixelRow(src, format, scratch, PF_RGBA8, width);
+
+			const float* lut = getSRGBLUTs().toLinearFloat;
+			for (UINT32 i = 0; i < width * 4; i += 4)
+			{
+				dst[i + 0] = lut[scratch[i + 0]];
+				dst[i + 1] = lut[scratch[i + 1]];
+				dst[i + 2] = lut[scratch[i + 2]];
+				dst[i + 3] = Bitwise::uintToUnorm<8>(scratch[i + 3]);
+			}
 		}
 		else
 		{
-			co.setPixelType(nvtt::PixelType_UnsignedNorm);
-			co.setPixelFormat(32, 0x0000FF00, 0x00FF0000, 0xFF000000, 0x000000FF);
+			convertPixelRow(src, format, (UINT8*)dst, PF_RGBA32F, width);
+
+			for (UINT32 i = 0; i < width * 4; i += 4)
+			{
+				dst[i + 0] = SRGBToLinear(dst[i + 0]);
+				dst[i + 1] = SRGBToLinear(dst[i + 1]);
+				dst[i + 2] = SRGBToLinear(dst[i + 2]);
+			}
 		}
+	}
 
-		UINT32 numMips = getMaxMipmaps(src.getWidth(), src.getHeight(), 1, src.getFormat());
+	/** 
+	 * Writes a row of pixels in PF_RGBA32F format into the destination format, optionally converting the color channels
+	 * from linear to sRGB space. @p scratch must be large enough to hold the row in PF_RGBA32F format.
+	 */
+	void encodeLinearRow(const float* src, UINT32 width, UINT8* dst, PixelFormat format, bool isSRGB, UINT8* scratch)
+	{
+		if (!isSRGB)
+		{
+			convertPixelRow((const UINT8*)src, PF_RGBA32F, dst, format, width);
+			return;
+		}
 
-		Vector<SPtr<PixelData>> rgbaMipBuffers;
+		if (isUNorm8Format(format))
+		{
+			const SRGBLUTs& luts = getSRGBLUTs();
+			for (UINT32 i = 0; i < width * 4; i += 4)
+			{
+				scratch[i + 0] = luts.encodeSRGB(src[i + 0]);
+				scratch[i + 1] = luts.encodeSRGB(src[i + 1]);
+				scratch[i + 2] = luts.encodeSRGB(src[i + 2]);
+				scratch[i + 3] = (UINT8)Bitwise::unormToUint<8>(src[i + 3]);
+			}
 
-		// Note: This can be done more effectively without creating so many temp buffers
-		// and working with the original formats directly, but it would complicate the code
-		// too much at the moment.
-		UINT32 curWidth = src.getWidth();
-		UINT32 curHeight = src.getHeight();
-		for (UINT32 i = 0; i < numMips; i++)
+			convertPixelRow(scratch, PF_RGBA8, dst, format, width);
+		}
+		else
 		{
-			rgbaMipBuffers.push_back(bs_shared_ptr_new<PixelData>(curWidth, curHeight, 1, interimFormat));
-			rgbaMipBuffers.back()->allocateInternalBuffer();
+			float* srgb = (float*)scratch;
+			for (UINT32 i = 0; i < width * 4; i += 4)
+			{
+				srgb[i + 0] = linearToSRGB(src[i + 0]);
+				srgb[i + 1] = linearToSRGB(src[i + 1]);
+				srgb[i + 2] = linearToSRGB(src[i + 2]);
+				srgb[i + 3] = src[i + 3];
+			}
 
-			if (curWidth > 1)
-				curWidth = curWidth / 2;
+			convertPixelRow(scratch, PF_RGBA32F, dst, format, width);
+		}
+	}
 
-			if (curHeight > 1)
-				curHeight = curHeight / 2;
+	/** Re-normalizes normals stored in the color channels of a row of pixels in PF_RGBA32F format. */
+	void normalizeRow(float* pixels, UINT32 width)
+	{
+		for (UINT32 i = 0; i < width * 4; i += 4)
+		{
+			// Normals are stored in [0, 1] range
+			Vector3 normal(pixels[i + 0], pixels[i + 1], pixels[i + 2]);
+			normal = Vector3::normalize(normal * 2.0f - Vector3::ONE) * 0.5f + Vector3(0.5f, 0.5f, 0.5f);
+
+			pixels[i + 0] = normal.x;
+			pixels[i + 1] = normal.y;
+			pixels[i + 2] = normal.z;
 		}
+	}
 
-		rgbaMipBuffers.push_back(bs_shared_ptr_new<PixelData>(curWidth, curHeight, 1, interimFormat));
-		rgbaMipBuffers.back()->allocateInternalBuffer();
+	/** Describes pixel data a mip level is generated from. */
+	struct DownsampleSource
+	{
+		const UINT8* data; /**< First pixel of the data. */
+		size_t rowPitch; /**< Distance between two rows, in bytes. */
+		UINT32 width;
+		UINT32 height;
+		PixelFormat format;
+		bool isSRGB; /**< True if the color channels need to be converted from sRGB to linear space when read. */
+	};
 
-		NVTTMipmapOutputHandler outputHandler(rgbaMipBuffers);
+	/**
+	 * Generates a mip level by downsampling the source to half its size, along each dimension larger than one pixel.
+	 * Filtering is done in linear space using floating point math. Output rows are split into bands that are processed
+	 * in parallel if the task scheduler is running.
+	 *
+	 * @param[in]	source			Data to downsample.
+	 * @param[in]	kernel			Filter to downsample with.
+	 * @param[in]	options			Options controlling wrapping, output color space and normalization.
+	 * @param[out]	output			Consecutive pixel data to write the mip level to.
+	 * @param[out]	linearOutput	Optional consecutive pixel data in PF_RGBA32F format to write the mip level to, before
+	 *								it is converted to sRGB space. Can be used as the source for the next mip level.
+	 */
+	void generateMipLevel(const DownsampleSource& source, const DownsampleKernel& kernel, 
+		const MipMapGenOptions& options, PixelData& output, PixelData* linearOutput)
+	{
+		using namespace simd;
 
-		nvtt::OutputOptions oo;
-		oo.setOutputHeader(false);
-		oo.setOutputHandler(&outputHandler);
+		static constexpr UINT32 ROWS_PER_BAND = 32;
 
-		nvtt::Compressor compressor;
-		if (!compressor.process(io, co, oo))
+		const UINT32 srcWidth = source.width;
+		const UINT32 srcHeight = source.height;
+		const UINT32 dstWidth = output.getWidth();
+		const UINT32 dstHeight = output.getHeight();
+
+		const DownsampleKernel horzKernel = srcWidth != dstWidth ? kernel : createIdentityKernel();
+		const DownsampleKernel vertKernel = srcHeight != dstHeight ? kernel : createIdentityKernel();
+
+		const Vector<UINT32> horzTaps = calcDownsampleTaps(horzKernel, srcWidth, dstWidth, options.wrapMode);
+		const Vector<UINT32> vertTaps = calcDownsampleTaps(vertKernel, srcHeight, dstHeight, options.wrapMode);
+
+		float32x4 horzWeights[DownsampleKernel::MAX_TAPS];
+		for (UINT32 i = 0; i < horzKernel.numTaps; i++)
+			horzWeights[i] = splat<float32x4>(horzKernel.weights[i]);
+
+		float32x4 vertWeights[DownsampleKernel::MAX_TAPS];
+		for (UINT32 i = 0; i < vertKernel.numTaps; i++)
+			vertWeights[i] = splat<float32x4>(vertKernel.weights[i]);
+
+		const bool decodeSource = source.format != PF_RGBA32F || source.isSRGB;
+		const bool normalize = options.isNormalMap && options.normalizeMipmaps;
+		const UINT32 outputPixelSize = PixelUtil::getNumElemBytes(output.getFormat());
+		UINT8* outputPixels = output.getData();
+		float* linearPixels = linearOutput ? (float*)linearOutput->getData() : nullptr;
+
+		const UINT32 numBands = Math::divideAndRoundUp(dstHeight, ROWS_PER_BAND);
+		const UINT32 bandWork = ROWS_PER_BAND * dstWidth * (horzKernel.numTaps * 2 + vertKernel.numTaps);
+
+		forEachPixelRow(numBands, bandWork, [&](UINT32 band)
+		{
+			// Horizontally filtered source rows. Each is used by multiple output rows, so they're cached.
+			const UINT32 numCachedRows = vertKernel.numTaps;
+			Vector<float> rowCache(numCachedRows * dstWidth * 4);
+
+			UINT32 cachedRows[DownsampleKernel::MAX_TAPS];
+			for (UINT32 i = 0; i < numCachedRows; i++)
+				cachedRows[i] = (UINT32)-1;
+
+			Vector<float> decodedRow(decodeSource ? srcWidth * 4 : 0);
+			Vector<float> outputRow(linearPixels ? 0 : dstWidth * 4);
+			Vector<UINT8> scratch(std::max(srcWidth, dstWidth) * 16);
+
+			// Returns the horizontally filtered source row, filtering it if it isn't cached. Never evicts the rows in use.
+			const auto getFilteredRow = [&](UINT32 row, const UINT32* rowsInUse) -> const float*
+			{
+				UINT32 slot = 0;
+				for (; slot < numCachedRows; slot++)
+				{
+					if (cachedRows[slot] == row)
+						return &rowCache[slot * dstWidth * 4];
+				}
+
+				for (slot = 0; slot < numCachedRows; slot++)
+				{
+					bool inUse = false;
+					for (UINT32 i = 0; i < vertKernel.numTaps; i++)
+						inUse |= cachedRows[slot] == rowsInUse[i];
+
+					if (!inUse)
+						break;
+				}
+
+				assert(slot < numCachedRows);
+
+				const UINT8* srcRow = source.data + row * source.rowPitch;
+				const float* srcPixels = (const float*)srcRow;
+				if (decodeSource)
+				{
+					decodeLinearRow(srcRow, source.format, source.isSRGB, srcWidth, decodedRow.data(), scratch.data());
+					srcPixels = decodedRow.data();
+				}
+
+				float* dstPixels = &rowCache[slot * dstWidth * 4];
+				for (UINT32 x = 0; x < dstWidth; x++)
+				{
+					const UINT32* pixelTaps = &horzTaps[x * horzKernel.numTaps];
+
+					float32x4 sum = mul(load_u<float32x4>(srcPixels + pixelTaps[0] * 4), horzWeights[0]);
+					for (UINT32 i = 1; i < horzKernel.numTaps; i++)
+						sum = add(sum, mul(load_u<float32x4>(srcPixels + pixelTaps[i] * 4), horzWeights[i]));
+
+					store_u(dstPixels + x * 4, sum);
+				}
+
+				cachedRows[slot] = row;
+				return dstPixels;
+			};
+
+			const UINT32 firstRow = band * ROWS_PER_BAND;
+			const UINT32 lastRow = std::min(firstRow + ROWS_PER_BAND, dstHeight);
+			for (UINT32 y = firstRow; y < lastRow; y++)
+			{
+				const UINT32* rowTaps = &vertTaps[y * vertKernel.numTaps];
+
+				const float* srcRows[DownsampleKernel::MAX_TAPS];
+				for (UINT32 i = 0; i < vertKernel.numTaps; i++)
+					srcRows[i] = getFilteredRow(rowTaps[i], rowTaps);
+
+				float* linearRow = linearPixels ? linearPixels + (size_t)y * dstWidth * 4 : outputRow.data();
+				for (UINT32 x = 0; x < dstWidth * 4; x += 4)
+				{
+					float32x4 sum = mul(load_u<float32x4>(srcRows[0] + x), vertWeights[0]);
+					for (UINT32 i = 1; i < vertKernel.numTaps; i++)
+						sum = add(sum, mul(load_u<float32x4>(srcRows[i] + x), vertWeights[i]));
+
+					store_u(linearRow + x, sum);
+				}
+
+				if (normalize)
+					normalizeRow(linearRow, dstWidth);
+
+				encodeLinearRow(linearRow, dstWidth, outputPixels + (size_t)y * dstWidth * outputPixelSize, 
+					output.getFormat(), options.isSRGB, scratch.data());
+			}
+		});
+	}
+
+	Vector<SPtr<PixelData>> PixelUtil::genMipmaps(const PixelData& src, const MipMapGenOptions& options)
+	{
+		Vector<SPtr<PixelData>> outputMipBuffers;
+
+		if (src.getDepth() != 1)
 		{
-			LOGERR("Mipmap generation failed. Internal error.");
+			LOGERR("Mipmap generation failed. 3D texture formats not supported.")
 			return outputMipBuffers;
 		}
 
-		interimData.freeInternalBuffer();
+		if (isCompressed(src.getFormat()))
+		{
+			LOGERR("Mipmap generation failed. Source data cannot be compressed.")
+			return outputMipBuffers;
+		}
 
-		for (UINT32 i = 0; i < (UINT32)rgbaMipBuffers.size(); i++)
+		if (!Bitwise::isPow2(src.getWidth()) || !Bitwise::isPow2(src.getHeight()))
 		{
-			SPtr<PixelData> argbBuffer = rgbaMipBuffers[i];
-			SPtr<PixelData> outputBuffer = bs_shared_ptr_new<PixelData>(argbBuffer->getWidth(), argbBuffer->getHeight(), 1, src.getFormat());
-			outputBuffer->allocateInternalBuffer();
+			LOGERR("Mipmap generation failed. Texture width & height must be powers of 2.");
+			return outputMipBuffers;
+		}
+
+		UINT32 curWidth = src.getWidth();
+		UINT32 curHeight = src.getHeight();
+
+		SPtr<PixelData> baseBuffer = PixelData::create(curWidth, curHeight, 1, src.getFormat());
+		bulkPixelConversion(src, *baseBuffer);
+		outputMipBuffers.push_back(baseBuffer);
+
+		// First level is generated directly from the source, and others from the previous level in linear space
+		const UINT32 srcPixelSize = getNumElemBytes(src.getFormat());
 
-			bulkPixelConversion(*argbBuffer, *outputBuffer);
-			argbBuffer->freeInternalBuffer();
+		DownsampleSource source;
+		source.data = src.getData() + 
+			(src.getLeft() + src.getTop() * src.getRowPitch() + src.getFront() * src.getSlicePitch()) * srcPixelSize;
+		source.rowPitch = src.getRowPitch() * srcPixelSize;
+		source.width = curWidth;
+		source.height = curHeight;
+		source.format = src.getFormat();
+		source.isSRGB = options.isSRGB;
 
+		const DownsampleKernel kernel = createDownsampleKernel(options.filter);
+		const UINT32 numMips = getMaxMipmaps(src.getWidth(), src.getHeight(), 1, src.getFormat());
+
+		SPtr<PixelData> linearData;
+		for (UINT32 i = 0; i < numMips; i++)
+		{
+			if (curWidth > 1)
+				curWidth = curWidth / 2;
+
+			if (curHeight > 1)
+				curHeight = curHeight / 2;
+
+			SPtr<PixelData> outputBuffer = PixelData::create(curWidth, curHeight, 1, src.getFormat());
+
+			SPtr<PixelData> mipLinearData;
+			if ((i + 1) < numMips)
+				mipLinearData = PixelData::create(curWidth, curHeight, 1, PF_RGBA32F);
+
+			generateMipLevel(source, kernel, options, *outputBuffer, mipLinearData.get());
 			outputMipBuffers.push_back(outputBuffer);
+
+			if (mipLinearData)
+			{
+				source.data = mipLinearData->getData();
+				source.rowPitch = curWidth * getNumElemBytes(PF_RGBA32F);
+				source.width = curWidth;
+				source.height = curHeight;
+				source.format = PF_RGBA32F;
+				source.isSRGB = false;
+
+				linearData = mipLinearData;
+			}
 		}
 
 		return outputMipBuffers;
@@ -44,7 +44,8 @@ namespace bs
 	{
 		Box,
 		Triangle,
-		Kaiser
+		Kaiser,
+		Lanczos
 	};
 
 	/** Determines on which axes to mirror an image. */
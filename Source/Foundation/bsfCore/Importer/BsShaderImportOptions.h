@@ -97,6 +97,13 @@ namespace bs
 		BS_SCRIPT_EXPORT()
 		ShadingLanguageFlags languages = ShadingLanguageFlag::All;
 
+		/**
+		 * Folder in which to cache the results of GPU program cross-compilation and reflection. Re-importing a shader
+		 * whose programs haven't changed then skips the expensive compilation steps. Cache can be shared between 
+		 * multiple processes. Caching is disabled if empty.
+		 */
+		Path cacheDirectory;
+
 		/************************************************************************/
 		/* 								SERIALIZATION                      		*/
 		/************************************************************************/
@@ -24,7 +24,7 @@ namespace bs
 	{
 		String includeString;
 		{
-			Lock fileLock = FileScheduler::getLock(filePath);
+			SharedLock fileLock = FileScheduler::getReadLock(filePath);
 
 			SPtr<DataStream> stream = FileSystem::openFile(filePath);
 			includeString = stream->getAsString();
@@ -156,15 +156,12 @@ namespace bs
 		bool mPaused = false;
 
 		// Worker threads
-		ParticlePerFrameData mSimulationData[CoreThread::NUM_SYNC_BUFFERS];
+		Vector<ParticlePerFrameData> mSimulationData; /**< One buffer per core thread sync buffer. */
 
-		UINT32 mReadBufferIdx = 1;
+		UINT32 mReadBufferIdx = 0;
 		UINT32 mWriteBufferIdx = 0;
 		
-		Signal mWorkerDoneSignal;
 		Mutex mMutex;
-
-		UINT32 mNumActiveWorkers = 0;
 		bool mSwapBuffers = false;
 	};
 
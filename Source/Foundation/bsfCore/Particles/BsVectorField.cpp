@@ -149,7 +149,7 @@ namespace bs
 	{
 		String data;
 		{
-			Lock fileLock = FileScheduler::getLock(filePath);
+			SharedLock fileLock = FileScheduler::getReadLock(filePath);
 
 			SPtr<DataStream> stream = FileSystem::openFile(filePath);
 			data = stream->getAsString();
@@ -4,6 +4,7 @@
 #include "Physics/BsRigidbody.h"
 #include "Math/BsRay.h"
 #include "Components/BsCCollider.h"
+#include "Threading/BsTaskScheduler.h"
 
 namespace bs
 {
@@ -92,6 +93,27 @@ namespace bs
 		return rawToComponent(_convexOverlap(mesh, position, rotation, layer));
 	}
 
+	void PhysicsScene::queryBatch(const PhysicsQueryBatch& batch, PhysicsQueryResult* results) const
+	{
+		// Individual queries are cheap, so only bother distributing larger batches, in groups of a few queries
+		static constexpr UINT32 PARALLEL_QUERY_THRESHOLD = 64;
+		static constexpr UINT32 QUERY_GRAIN = 16;
+
+		const UINT32 numQueries = batch.getNumQueries();
+		auto worker = [this, &batch, results](UINT32 idx)
+		{
+			_executeQuery(batch.getQuery(idx), results[idx]);
+		};
+
+		if (numQueries >= PARALLEL_QUERY_THRESHOLD && TaskScheduler::isStarted())
+			TaskScheduler::instance().parallelFor(0, numQueries, QUERY_GRAIN, worker);
+		else
+		{
+			for (UINT32 i = 0; i < numQueries; i++)
+				worker(i);
+		}
+	}
+
 	Physics& gPhysics()
 	{
 		return Physics::instance();
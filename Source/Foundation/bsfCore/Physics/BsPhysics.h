@@ -6,6 +6,7 @@
 
 #include "BsCorePrerequisites.h"
 #include "Physics/BsPhysicsCommon.h"
+#include "Physics/BsPhysicsQueryBatch.h"
 #include "Utility/BsModule.h"
 #include "Math/BsVector3.h"
 #include "Math/BsVector2.h"
@@ -47,7 +48,18 @@ namespace bs
 		 * Enables continous collision detection. This will prevent fast-moving objects from tunneling through each other.
 		 * You must also enable CCD for individual Rigidbodies. This option can have a significant performance impact.
 		 */
-		CCD_Enable = 1<<3
+		CCD_Enable = 1<<3,
+		/**
+		 * Runs the physics simulation asynchronously, in parallel with the rest of the frame. A simulation step started
+		 * during a fixed update completes at the start of the next fixed update, and only then are its results (new
+		 * rigidbody transforms, collision and joint break events) reported. This trades latency for throughput: reported
+		 * state is always one fixed step behind, so changes made by components (forces, velocities, teleports) take one
+		 * extra step to show up. There is no option to report interpolated or extrapolated transforms to hide this delay,
+		 * so if smooth motion is required the caller must interpolate between the last two reported states. While a step
+		 * is running, changes to physics objects are buffered until it completes, and scene queries see the state from
+		 * before the step started. The step also completes when physics is paused or the scene is destroyed.
+		 */
+		AsyncSimulation = 1<<4
 	};
 
 	/** @copydoc CharacterCollisionFlag */
@@ -526,6 +538,17 @@ namespace bs
 		virtual bool convexOverlapAny(const HPhysicsMesh& mesh, const Vector3& position, const Quaternion& rotation,
 			UINT64 layer = BS_ALL_LAYERS) const = 0;
 
+		/**
+		 * Performs all the queries in the batch. Queries are distributed across the task scheduler's workers (if it is
+		 * running and the batch is large enough), and results are written to the caller provided buffers without 
+		 * allocating any memory. Much faster than performing the same queries one by one.
+		 *
+		 * @param[in]	batch		Queries to perform.
+		 * @param[out]	results		Buffer to write the query results to, with an entry for each query in the batch, in the
+		 *							order the queries were added to the batch.
+		 */
+		virtual void queryBatch(const PhysicsQueryBatch& batch, PhysicsQueryResult* results) const;
+
 		/******************************************************************************************************************/
 		/************************************************* OPTIONS ********************************************************/
 		/******************************************************************************************************************/
@@ -682,6 +705,12 @@ namespace bs
 		 */
 		virtual SPtr<CharacterController> createCharacterController(const CHAR_CONTROLLER_DESC& desc) = 0;
 
+		/** 
+		 * Performs a single query from a PhysicsQueryBatch. Called from multiple threads simultaneously, and must not 
+		 * allocate memory.
+		 */
+		virtual void _executeQuery(const PhysicsQuery& query, PhysicsQueryResult& result) const = 0;
+
 		/** @copydoc PhysicsScene::boxOverlap() */
 		virtual Vector<Collider*> _boxOverlap(const AABox& box, const Quaternion& rotation,
 			UINT64 layer = BS_ALL_LAYERS) const = 0;
@@ -0,0 +1,115 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#include "Physics/BsPhysicsQueryBatch.h"
+#include "Math/BsAABox.h"
+#include "Math/BsSphere.h"
+#include "Math/BsCapsule.h"
+
+namespace bs
+{
+	UINT32 PhysicsQueryBatch::addRayCast(const Vector3& origin, const Vector3& unitDir, UINT64 layer, float max)
+	{
+		PhysicsQuery query;
+		query.type = PhysicsQueryType::RayCast;
+		query.position = origin;
+		query.unitDir = unitDir;
+		query.layer = layer;
+		query.maxDist = max;
+
+		return addQuery(query);
+	}
+
+	UINT32 PhysicsQueryBatch::addBoxCast(const AABox& box, const Quaternion& rotation, const Vector3& unitDir,
+		UINT64 layer, float max)
+	{
+		PhysicsQuery query;
+		query.type = PhysicsQueryType::BoxCast;
+		query.position = box.getCenter();
+		query.rotation = rotation;
+		query.size = box.getHalfSize();
+		query.unitDir = unitDir;
+		query.layer = layer;
+		query.maxDist = max;
+
+		return addQuery(query);
+	}
+
+	UINT32 PhysicsQueryBatch::addSphereCast(const Sphere& sphere, const Vector3& unitDir, UINT64 layer, float max)
+	{
+		PhysicsQuery query;
+		query.type = PhysicsQueryType::SphereCast;
+		query.position = sphere.getCenter();
+		query.size = Vector3(sphere.getRadius(), 0.0f, 0.0f);
+		query.unitDir = unitDir;
+		query.layer = layer;
+		query.maxDist = max;
+
+		return addQuery(query);
+	}
+
+	UINT32 PhysicsQueryBatch::addCapsuleCast(const Capsule& capsule, const Quaternion& rotation, const Vector3& unitDir,
+		UINT64 layer, float max)
+	{
+		PhysicsQuery query;
+		query.type = PhysicsQueryType::CapsuleCast;
+		query.position = capsule.getCenter();
+		query.rotation = rotation;
+		query.size = Vector3(capsule.getRadius(), capsule.getHeight(), 0.0f);
+		query.unitDir = unitDir;
+		query.layer = layer;
+		query.maxDist = max;
+
+		return addQuery(query);
+	}
+
+	UINT32 PhysicsQueryBatch::addBoxOverlap(const AABox& box, const Quaternion& rotation, Collider** output,
+		UINT32 maxOutput, UINT64 layer)
+	{
+		PhysicsQuery query;
+		query.type = PhysicsQueryType::BoxOverlap;
+		query.position = box.getCenter();
+		query.rotation = rotation;
+		query.size = box.getHalfSize();
+		query.overlaps = output;
+		query.maxOverlaps = maxOutput;
+		query.layer = layer;
+
+		return addQuery(query);
+	}
+
+	UINT32 PhysicsQueryBatch::addSphereOverlap(const Sphere& sphere, Collider** output, UINT32 maxOutput, UINT64 layer)
+	{
+		PhysicsQuery query;
+		query.type = PhysicsQueryType::SphereOverlap;
+		query.position = sphere.getCenter();
+		query.size = Vector3(sphere.getRadius(), 0.0f, 0.0f);
+		query.overlaps = output;
+		query.maxOverlaps = maxOutput;
+		query.layer = layer;
+
+		return addQuery(query);
+	}
+
+	UINT32 PhysicsQueryBatch::addCapsuleOverlap(const Capsule& capsule, const Quaternion& rotation, Collider** output,
+		UINT32 maxOutput, UINT64 layer)
+	{
+		PhysicsQuery query;
+		query.type = PhysicsQueryType::CapsuleOverlap;
+		query.position = capsule.getCenter();
+		query.rotation = rotation;
+		query.size = Vector3(capsule.getRadius(), capsule.getHeight(), 0.0f);
+		query.overlaps = output;
+		query.maxOverlaps = maxOutput;
+		query.layer = layer;
+
+		return addQuery(query);
+	}
+
+	UINT32 PhysicsQueryBatch::addQuery(const PhysicsQuery& query)
+	{
+		const auto idx = (UINT32)mQueries.size();
+		mQueries.push_back(query);
+
+		return idx;
+	}
+}
@@ -0,0 +1,198 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#pragma once
+
+#include <cfloat>
+
+#include "BsCorePrerequisites.h"
+#include "Physics/BsPhysicsCommon.h"
+#include "Math/BsVector3.h"
+#include "Math/BsQuaternion.h"
+
+namespace bs
+{
+	/** @addtogroup Physics
+	 *  @{
+	 */
+
+	/** Types of scene queries that can be performed as a part of a PhysicsQueryBatch. */
+	enum class PhysicsQueryType
+	{
+		RayCast, /**< Ray cast returning the closest hit. */
+		BoxCast, /**< Box sweep returning the closest hit. */
+		SphereCast, /**< Sphere sweep returning the closest hit. */
+		CapsuleCast, /**< Capsule sweep returning the closest hit. */
+		BoxOverlap, /**< Returns colliders overlapping a box. */
+		SphereOverlap, /**< Returns colliders overlapping a sphere. */
+		CapsuleOverlap /**< Returns colliders overlapping a capsule. */
+	};
+
+	/** Describes a single scene query in a PhysicsQueryBatch. */
+	struct PhysicsQuery
+	{
+		PhysicsQueryType type = PhysicsQueryType::RayCast;
+
+		/** Origin of the ray, or the center of the query geometry. */
+		Vector3 position = Vector3::ZERO;
+
+		/** Orientation of the query geometry. */
+		Quaternion rotation = Quaternion::IDENTITY;
+
+		/** Direction of the cast. Only relevant for cast queries. */
+		Vector3 unitDir = Vector3::ZERO;
+
+		/**
+		 * Size of the query geometry. Half-size for boxes, radius in the x component for spheres, and radius and height in
+		 * the x and y components for capsules.
+		 */
+		Vector3 size = Vector3::ZERO;
+
+		/** Maximum distance of the cast. Only relevant for cast queries. */
+		float maxDist = FLT_MAX;
+
+		/** Layers to consider for the query. */
+		UINT64 layer = BS_ALL_LAYERS;
+
+		/** Caller provided buffer to write the overlapping colliders in. Only relevant for overlap queries. */
+		Collider** overlaps = nullptr;
+
+		/** Number of entries in the @p overlaps buffer. */
+		UINT32 maxOverlaps = 0;
+	};
+
+	/** Result of a single scene query in a PhysicsQueryBatch. */
+	struct PhysicsQueryResult
+	{
+		/**
+		 * Number of hits found by a cast query (zero or one), or number of colliders overlapping the geometry of an
+		 * overlap query. For overlap queries this is never larger than the size of the caller provided buffer, and any
+		 * overlaps that don't fit are dropped.
+		 */
+		UINT32 numHits = 0;
+
+		/** Closest hit of a cast query. Only valid if @p numHits is not zero. */
+		PhysicsQueryHit hit;
+	};
+
+	/**
+	 * A set of scene queries that are performed together with PhysicsScene::queryBatch(). Queries in a batch are
+	 * executed in parallel and write their results in caller provided buffers, making this the preferred way of
+	 * performing large numbers of queries. Once executed the batch can be cleared and re-populated without allocating
+	 * any memory.
+	 */
+	class BS_CORE_EXPORT PhysicsQueryBatch
+	{
+	public:
+		/**
+		 * Adds a ray cast to the batch.
+		 *
+		 * @param[in]	origin		Origin of the ray to cast.
+		 * @param[in]	unitDir		Unit direction of the ray to cast.
+		 * @param[in]	layer		Layers to consider for the query. This allows you to ignore certain groups of objects.
+		 * @param[in]	max			Maximum distance at which to perform the query. Hits past this distance will not be
+		 *							detected.
+		 * @return					Index of the query, identifying the query's entry in the result buffer.
+		 */
+		UINT32 addRayCast(const Vector3& origin, const Vector3& unitDir, UINT64 layer = BS_ALL_LAYERS,
+			float max = FLT_MAX);
+
+		/**
+		 * Adds a box sweep to the batch.
+		 *
+		 * @param[in]	box			Box to sweep through the scene.
+		 * @param[in]	rotation	Orientation of the box.
+		 * @param[in]	unitDir		Unit direction towards which to perform the sweep.
+		 * @param[in]	layer		Layers to consider for the query. This allows you to ignore certain groups of objects.
+		 * @param[in]	max			Maximum distance at which to perform the query. Hits past this distance will not be
+		 *							detected.
+		 * @return					Index of the query, identifying the query's entry in the result buffer.
+		 */
+		UINT32 addBoxCast(const AABox& box, const Quaternion& rotation, const Vector3& unitDir,
+			UINT64 layer = BS_ALL_LAYERS, float max = FLT_MAX);
+
+		/**
+		 * Adds a sphere sweep to the batch.
+		 *
+		 * @param[in]	sphere		Sphere to sweep through the scene.
+		 * @param[in]	unitDir		Unit direction towards which to perform the sweep.
+		 * @param[in]	layer		Layers to consider for the query. This allows you to ignore certain groups of objects.
+		 * @param[in]	max			Maximum distance at which to perform the query. Hits past this distance will not be
+		 *							detected.
+		 * @return					Index of the query, identifying the query's entry in the result buffer.
+		 */
+		UINT32 addSphereCast(const Sphere& sphere, const Vector3& unitDir, UINT64 layer = BS_ALL_LAYERS,
+			float max = FLT_MAX);
+
+		/**
+		 * Adds a capsule sweep to the batch.
+		 *
+		 * @param[in]	capsule		Capsule to sweep through the scene.
+		 * @param[in]	rotation	Orientation of the capsule.
+		 * @param[in]	unitDir		Unit direction towards which to perform the sweep.
+		 * @param[in]	layer		Layers to consider for the query. This allows you to ignore certain groups of objects.
+		 * @param[in]	max			Maximum distance at which to perform the query. Hits past this distance will not be
+		 *							detected.
+		 * @return					Index of the query, identifying the query's entry in the result buffer.
+		 */
+		UINT32 addCapsuleCast(const Capsule& capsule, const Quaternion& rotation, const Vector3& unitDir,
+			UINT64 layer = BS_ALL_LAYERS, float max = FLT_MAX);
+
+		/**
+		 * Adds a query returning all colliders overlapping a box to the batch.
+		 *
+		 * @param[in]	box			Box to check for overlap.
+		 * @param[in]	rotation	Orientation of the box.
+		 * @param[out]	output		Buffer to write the overlapping colliders to. Must remain valid until the batch is
+		 *							executed.
+		 * @param[in]	maxOutput	Number of entries in the @p output buffer.
+		 * @param[in]	layer		Layers to consider for the query. This allows you to ignore certain groups of objects.
+		 * @return					Index of the query, identifying the query's entry in the result buffer.
+		 */
+		UINT32 addBoxOverlap(const AABox& box, const Quaternion& rotation, Collider** output, UINT32 maxOutput,
+			UINT64 layer = BS_ALL_LAYERS);
+
+		/**
+		 * Adds a query returning all colliders overlapping a sphere to the batch.
+		 *
+		 * @param[in]	sphere		Sphere to check for overlap.
+		 * @param[out]	output		Buffer to write the overlapping colliders to. Must remain valid until the batch is
+		 *							executed.
+		 * @param[in]	maxOutput	Number of entries in the @p output buffer.
+		 * @param[in]	layer		Layers to consider for the query. This allows you to ignore certain groups of objects.
+		 * @return					Index of the query, identifying the query's entry in the result buffer.
+		 */
+		UINT32 addSphereOverlap(const Sphere& sphere, Collider** output, UINT32 maxOutput,
+			UINT64 layer = BS_ALL_LAYERS);
+
+		/**
+		 * Adds a query returning all colliders overlapping a capsule to the batch.
+		 *
+		 * @param[in]	capsule		Capsule to check for overlap.
+		 * @param[in]	rotation	Orientation of the capsule.
+		 * @param[out]	output		Buffer to write the overlapping colliders to. Must remain valid until the batch is
+		 *							executed.
+		 * @param[in]	maxOutput	Number of entries in the @p output buffer.
+		 * @param[in]	layer		Layers to consider for the query. This allows you to ignore certain groups of objects.
+		 * @return					Index of the query, identifying the query's entry in the result buffer.
+		 */
+		UINT32 addCapsuleOverlap(const Capsule& capsule, const Quaternion& rotation, Collider** output,
+			UINT32 maxOutput, UINT64 layer = BS_ALL_LAYERS);
+
+		/** Removes all queries from the batch. Keeps the allocated memory so the batch can be re-populated cheaply. */
+		void clear() { mQueries.clear(); }
+
+		/** Returns the number of queries in the batch. */
+		UINT32 getNumQueries() const { return (UINT32)mQueries.size(); }
+
+		/** Returns the query with the specified index. */
+		const PhysicsQuery& getQuery(UINT32 idx) const { return mQueries[idx]; }
+
+	private:
+		/** Appends a new query and returns its index. */
+		UINT32 addQuery(const PhysicsQuery& query);
+
+		Vector<PhysicsQuery> mQueries;
+	};
+
+	/** @} */
+}
@@ -41,6 +41,13 @@ namespace bs
 
 		void setData(MeshData* obj, const SPtr<DataStream>& value, UINT32 size)
 		{
+			// Reference mapped file data directly instead of copying it
+			if (value->isMapped())
+			{
+				obj->setExternalBuffer(std::static_pointer_cast<MappedFileDataStream>(value));
+				return;
+			}
+
 			obj->allocateInternalBuffer(size);
 			value->read(obj->getData(), size);
 		}
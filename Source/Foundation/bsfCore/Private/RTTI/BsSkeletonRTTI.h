@@ -18,6 +18,7 @@ namespace bs
 	private:
 		Matrix4& getBindPose(Skeleton* obj, UINT32 idx) { return obj->mInvBindPoses[idx]; }
 		void setBindPose(Skeleton* obj, UINT32 idx, Matrix4& value) { obj->mInvBindPoses[idx] = value; }
+		Matrix4* getBindPoseData(Skeleton* obj) { return obj->mInvBindPoses; }
 
 		void setNumBindPoses(Skeleton* obj, UINT32 size)
 		{
@@ -54,7 +55,7 @@ namespace bs
 		SkeletonRTTI()
 		{
 			addPlainArrayField("bindPoses", 0, &SkeletonRTTI::getBindPose, &SkeletonRTTI::getNumBones,
-				&SkeletonRTTI::setBindPose, &SkeletonRTTI::setNumBindPoses);
+				&SkeletonRTTI::setBindPose, &SkeletonRTTI::setNumBindPoses, &SkeletonRTTI::getBindPoseData);
 			addPlainArrayField("boneInfo", 1, &SkeletonRTTI::getBoneInfo, &SkeletonRTTI::getNumBones,
 				&SkeletonRTTI::setBoneInfo, &SkeletonRTTI::setNumBoneInfos);
 			addReflectableArrayField("boneTransforms", 3, &SkeletonRTTI::getBoneTransform, &SkeletonRTTI::getNumBones,
@@ -0,0 +1,652 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#include "Image/BsPixelUtil.h"
+#include "Image/BsPixelData.h"
+#include "Image/BsColor.h"
+#include "Math/BsMath.h"
+#include "Threading/BsThreadPool.h"
+#include "Threading/BsTaskScheduler.h"
+#include "Utility/BsTimer.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Utility/BsUUID.h"
+#include "Renderer/BsRenderQueue.h"
+#include "Renderer/BsCullInfo.h"
+#include "Math/BsConvexVolume.h"
+#include "Utility/BsBitwise.h"
+#include "Math/BsRandom.h"
+#include "Profiling/BsProfilerCPU.h"
+#include "GUI/BsGUIBatching.h"
+#include "Physics/BsPhysics.h"
+#include "Physics/BsPhysicsManager.h"
+#include "Physics/BsBoxCollider.h"
+#include "Utility/BsDynLib.h"
+#include "Utility/BsDynLibManager.h"
+#include "BsEngineConfig.h"
+#include <cstdio>
+
+namespace bs
+{
+	/**
+	 * Reference implementation of sRGB-correct box filtered mip generation, going through the generic per-pixel path on
+	 * a single thread.
+	 */
+	Vector<SPtr<PixelData>> genMipmapsReference(const PixelData& src)
+	{
+		Vector<SPtr<PixelData>> output;
+
+		SPtr<PixelData> prev = PixelData::create(src.getWidth(), src.getHeight(), 1, src.getFormat());
+		PixelUtil::bulkPixelConversion(src, *prev);
+		output.push_back(prev);
+
+		while (prev->getWidth() > 1 || prev->getHeight() > 1)
+		{
+			const UINT32 width = std::max(prev->getWidth() / 2, 1U);
+			const UINT32 height = std::max(prev->getHeight() / 2, 1U);
+
+			SPtr<PixelData> mip = PixelData::create(width, height, 1, src.getFormat());
+			for (UINT32 y = 0; y < height; y++)
+			{
+				for (UINT32 x = 0; x < width; x++)
+				{
+					const UINT32 srcX = std::min(x * 2 + 1, prev->getWidth() - 1);
+					const UINT32 srcY = std::min(y * 2 + 1, prev->getHeight() - 1);
+
+					Color sum = PixelUtil::SRGBToLinear(prev->getColorAt(x * 2, y * 2));
+					sum += PixelUtil::SRGBToLinear(prev->getColorAt(srcX, y * 2));
+					sum += PixelUtil::SRGBToLinear(prev->getColorAt(x * 2, srcY));
+					sum += PixelUtil::SRGBToLinear(prev->getColorAt(srcX, srcY));
+
+					mip->setColorAt(PixelUtil::linearToSRGB(sum * 0.25f), x, y);
+				}
+			}
+
+			output.push_back(mip);
+			prev = mip;
+		}
+
+		return output;
+	}
+
+	/** Reference implementation of bilinear scaling, going through the generic per-pixel path on a single thread. */
+	void scaleReference(const PixelData& src, PixelData& dst)
+	{
+		const float scaleX = src.getWidth() / (float)dst.getWidth();
+		const float scaleY = src.getHeight() / (float)dst.getHeight();
+
+		for (UINT32 y = 0; y < dst.getHeight(); y++)
+		{
+			const float srcY = std::max((y + 0.5f) * scaleY - 0.5f, 0.0f);
+			const UINT32 y0 = std::min((UINT32)srcY, src.getHeight() - 1);
+			const UINT32 y1 = std::min(y0 + 1, src.getHeight() - 1);
+			const float fracY = srcY - y0;
+
+			for (UINT32 x = 0; x < dst.getWidth(); x++)
+			{
+				const float srcX = std::max((x + 0.5f) * scaleX - 0.5f, 0.0f);
+				const UINT32 x0 = std::min((UINT32)srcX, src.getWidth() - 1);
+				const UINT32 x1 = std::min(x0 + 1, src.getWidth() - 1);
+				const float fracX = srcX - x0;
+
+				const Color top = Color::lerp(fracX, src.getColorAt(x0, y0), src.getColorAt(x1, y0));
+				const Color bottom = Color::lerp(fracX, src.getColorAt(x0, y1), src.getColorAt(x1, y1));
+
+				dst.setColorAt(Color::lerp(fracY, top, bottom), x, y);
+			}
+		}
+	}
+
+	/**
+	 * Loads all the provided files in parallel using the task scheduler, locking each file the same way resource loads
+	 * do. If @p globalLock is true all loads are instead serialized on a single lock, the way file access was scheduled
+	 * before the file locks were striped.
+	 */
+	void loadFilesConcurrently(const Vector<Path>& paths, bool globalLock)
+	{
+		static Mutex globalMutex;
+
+		std::atomic<UINT64> checksum(0);
+		Vector<SPtr<Task>> tasks;
+		for (auto& path : paths)
+		{
+			SPtr<Task> task = Task::create("LoadFile", [&path, &checksum, globalLock]()
+			{
+				Lock globalFileLock;
+				SharedLock fileLock;
+				if (globalLock)
+					globalFileLock = Lock(globalMutex);
+				else
+					fileLock = FileScheduler::getReadLock(path);
+
+				SPtr<DataStream> stream = FileSystem::openFile(path, true);
+				Vector<UINT8> data(stream->size());
+				stream->read(data.data(), data.size());
+
+				// Touch the data, standing in for deserialization
+				UINT64 sum = 0;
+				for (auto& entry : data)
+					sum += entry;
+
+				checksum += sum;
+			});
+
+			tasks.push_back(task);
+			TaskScheduler::instance().addTask(task);
+		}
+
+		for (auto& task : tasks)
+			task->wait();
+	}
+
+	/** Exposes the element sorting of RenderQueue, allowing it to be measured without creating any materials. */
+	class BenchmarkRenderQueue : public ct::RenderQueue
+	{
+	public:
+		BenchmarkRenderQueue(ct::StateReduction mode, UINT32 numElements)
+			:RenderQueue(mode)
+		{
+			Random random(7);
+			for (UINT32 i = 0; i < numElements; i++)
+			{
+				mSortableElements.push_back({ i, random.getRange(-1, 1) * 100, random.getUNorm() * 1000.0f,
+					(UINT32)random.getRange(0, 200), (UINT32)random.getRange(0, 1), (UINT32)random.getRange(0, 2) });
+			}
+
+			mSortableElementIdx.resize(numElements);
+		}
+
+		/** Sorts the elements using a comparison sort, as the queue did before sort keys were introduced. */
+		void sortComparison()
+		{
+			resetIndices();
+			sortIndicesComparison();
+		}
+
+		/** Sorts the elements using the sort keys. */
+		void sortKeys()
+		{
+			resetIndices();
+			sortIndices();
+		}
+
+	private:
+		void resetIndices()
+		{
+			for (UINT32 i = 0; i < (UINT32)mSortableElementIdx.size(); i++)
+				mSortableElementIdx[i] = i;
+		}
+	};
+
+	/**
+	 * Reference implementation of GUI element grouping, using the same rules as groupGUIElements() but checking for
+	 * overlaps against all the groups, as GUIManager did before. Outputs the index of the group each element was placed
+	 * in and returns the number of groups.
+	 */
+	UINT32 groupGUIElementsReference(const Vector<GUIMeshElement>& elements, Vector<UINT32>& elementGroups)
+	{
+		struct Group
+		{
+			Rect2I bounds;
+			UINT32 depth;
+			UINT32 minDepth;
+		};
+
+		Vector<Group> groups;
+		UnorderedMap<UINT64, Vector<UINT32>> materialGroups;
+		elementGroups.resize(elements.size());
+
+		for (UINT32 i = 0; i < (UINT32)elements.size(); i++)
+		{
+			const GUIMeshElement& elem = elements[i];
+			Vector<UINT32>& groupsPerMaterial = materialGroups[elem.mergeHash];
+
+			UINT32 foundGroup = (UINT32)-1;
+			for (auto groupIter = groupsPerMaterial.rbegin(); groupIter != groupsPerMaterial.rend(); ++groupIter)
+			{
+				const UINT32 groupIdx = *groupIter;
+				if (groups[groupIdx].depth == elem.depth)
+				{
+					foundGroup = groupIdx;
+					break;
+				}
+
+				const UINT32 startDepth = elem.depth;
+				const UINT32 endDepth = groups[groupIdx].depth;
+
+				Rect2I potentialGroupBounds = groups[groupIdx].bounds;
+				potentialGroupBounds.encapsulate(elem.bounds);
+
+				bool foundOverlap = false;
+				for (UINT32 j = 0; j < (UINT32)groups.size() && !foundOverlap; j++)
+				{
+					const Group& other = groups[j];
+					if (j == groupIdx)
+						continue;
+
+					if ((other.minDepth >= startDepth && other.minDepth <= endDepth) ||
+						(other.depth >= startDepth && other.depth <= endDepth))
+					{
+						foundOverlap = other.bounds.overlaps(potentialGroupBounds);
+					}
+				}
+
+				if (!foundOverlap)
+				{
+					foundGroup = groupIdx;
+					break;
+				}
+			}
+
+			if (foundGroup == (UINT32)-1)
+			{
+				foundGroup = (UINT32)groups.size();
+				groupsPerMaterial.push_back(foundGroup);
+				groups.push_back({ elem.bounds, elem.depth, elem.depth });
+			}
+			else
+			{
+				Group& group = groups[foundGroup];
+				group.bounds.encapsulate(elem.bounds);
+				group.minDepth = std::min(group.minDepth, elem.depth);
+			}
+
+			elementGroups[i] = foundGroup;
+		}
+
+		return (UINT32)groups.size();
+	}
+
+	/**
+	 * Reference implementation of renderer object culling, testing the objects one by one against the view layers, the
+	 * cull distance and the frustum.
+	 */
+	void cullReference(const Vector<ct::CullInfo>& cullInfos, UINT64 layers, const ConvexVolume& frustum,
+		const Vector3& origin, float cullDistance, Vector<bool>& visibility)
+	{
+		for (UINT32 i = 0; i < (UINT32)cullInfos.size(); i++)
+		{
+			if ((cullInfos[i].layer & layers) == 0)
+				continue;
+
+			const Sphere& sphere = cullInfos[i].bounds.getSphere();
+			const float distanceToCameraSq = origin.squaredDistance(sphere.getCenter());
+			const float maxDistanceToCamera = cullInfos[i].cullDistanceFactor * cullDistance + sphere.getRadius();
+
+			if (distanceToCameraSq > maxDistanceToCamera * maxDistanceToCamera)
+				continue;
+
+			if (frustum.intersects(sphere) && frustum.intersects(cullInfos[i].bounds.getBox()))
+				visibility[i] = true;
+		}
+	}
+
+	/** Runs the provided function a number of times, and returns the best run time in milliseconds. */
+	template<class T>
+	double measure(UINT32 numRuns, T func)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (UINT32 i = 0; i < numRuns; i++)
+		{
+			Timer timer;
+			func();
+
+			best = std::min(best, timer.getMicroseconds() / 1000.0);
+		}
+
+		return best;
+	}
+}
+
+using namespace bs;
+
+int main()
+{
+	static constexpr UINT32 SIZE = 4096;
+	static constexpr UINT32 NUM_RUNS = 3;
+
+	MemStack::beginThread();
+	ThreadPool::startUp<TThreadPool<ThreadDefaultPolicy>>(BS_THREAD_HARDWARE_CONCURRENCY);
+	TaskScheduler::startUp();
+
+	SPtr<PixelData> image = PixelData::create(SIZE, SIZE, 1, PF_RGBA8);
+	UINT8* pixels = image->getData();
+	for (UINT32 i = 0; i < SIZE * SIZE * 4; i++)
+		pixels[i] = (UINT8)((i * 7919) >> 3);
+
+	printf("Workers: %u\n", BS_THREAD_HARDWARE_CONCURRENCY);
+
+	const double refMips = measure(1, [&]() { genMipmapsReference(*image); });
+	printf("Mipmaps %ux%u RGBA8 sRGB, reference box: %.1f ms\n", SIZE, SIZE, refMips);
+
+	MipMapFilter filters[] = { MipMapFilter::Box, MipMapFilter::Triangle, MipMapFilter::Kaiser, MipMapFilter::Lanczos };
+	const char* filterNames[] = { "box", "triangle", "kaiser", "lanczos" };
+	for (UINT32 i = 0; i < 4; i++)
+	{
+		MipMapGenOptions options;
+		options.filter = filters[i];
+		options.isSRGB = true;
+
+		const double time = measure(NUM_RUNS, [&]() { PixelUtil::genMipmaps(*image, options); });
+		printf("Mipmaps %ux%u RGBA8 sRGB, %s: %.1f ms (%.1fx)\n", SIZE, SIZE, filterNames[i], time, refMips / time);
+	}
+
+	PixelData scaled(SIZE / 4 + 7, SIZE / 4 - 13, 1, PF_RGBA8);
+	scaled.allocateInternalBuffer();
+
+	const double refScale = measure(1, [&]() { scaleReference(*image, scaled); });
+	const double scale = measure(NUM_RUNS, [&]() { PixelUtil::scale(*image, scaled, PixelUtil::FILTER_LINEAR); });
+	printf("Scale %ux%u to %ux%u RGBA8, reference: %.1f ms, linear: %.1f ms (%.1fx)\n", SIZE, SIZE,
+		scaled.getWidth(), scaled.getHeight(), refScale, scale, refScale / scale);
+
+	static constexpr UINT32 NUM_FILES = 1000;
+	static constexpr UINT32 FILE_SIZE = 256 * 1024;
+
+	const Path fileDir = FileSystem::getTempDirectoryPath() + ("bsfBenchmark-" + UUIDGenerator::generateRandom().toString() + "/");
+	FileSystem::createDir(fileDir);
+
+	Vector<Path> files;
+	Vector<UINT8> fileData(FILE_SIZE);
+	for (UINT32 i = 0; i < NUM_FILES; i++)
+	{
+		for (UINT32 j = 0; j < FILE_SIZE; j++)
+			fileData[j] = (UINT8)(i + j);
+
+		Path filePath = fileDir + ("asset" + toString(i) + ".asset");
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(filePath);
+		stream->write(fileData.data(), fileData.size());
+		stream->close();
+
+		files.push_back(filePath);
+	}
+
+	const double globalLoad = measure(NUM_RUNS, [&]() { loadFilesConcurrently(files, true); });
+	const double stripedLoad = measure(NUM_RUNS, [&]() { loadFilesConcurrently(files, false); });
+	printf("Load %u files of %u KB concurrently, global lock: %.1f ms, per-file locks: %.1f ms (%.1fx)\n", NUM_FILES,
+		FILE_SIZE / 1024, globalLoad, stripedLoad, globalLoad / stripedLoad);
+
+	FileSystem::remove(fileDir);
+
+	static constexpr UINT32 NUM_SORT_ELEMENTS = 50000;
+
+	ct::StateReduction sortModes[] = { ct::StateReduction::None, ct::StateReduction::Material, ct::StateReduction::Distance };
+	const char* sortModeNames[] = { "none", "material", "distance" };
+	for (UINT32 i = 0; i < 3; i++)
+	{
+		BenchmarkRenderQueue queue(sortModes[i], NUM_SORT_ELEMENTS);
+
+		const double comparisonSort = measure(NUM_RUNS, [&]() { queue.sortComparison(); });
+		const double keySort = measure(NUM_RUNS, [&]() { queue.sortKeys(); });
+		printf("Sort %u render queue elements, %s state reduction, comparison: %.2f ms, radix keys: %.2f ms (%.1fx)\n",
+			NUM_SORT_ELEMENTS, sortModeNames[i], comparisonSort, keySort, comparisonSort / keySort);
+	}
+
+	// Small per-item work, similar to a particle system or an animation update, dispatched either as a task group with
+	// one task per item, or through parallelFor()
+	static constexpr UINT32 NUM_ITEM_ITERATIONS = 64;
+
+	UINT32 itemCounts[] = { 1000, 10000, 100000 };
+	for (auto numItems : itemCounts)
+	{
+		Vector<float> itemData(numItems);
+		const auto processItem = [&itemData](UINT32 idx)
+		{
+			float value = (float)idx;
+			for (UINT32 i = 0; i < NUM_ITEM_ITERATIONS; i++)
+				value = value * 0.99f + Math::sin(value);
+
+			itemData[idx] = value;
+		};
+
+		const double taskGroup = measure(NUM_RUNS, [&]()
+		{
+			SPtr<TaskGroup> group = TaskGroup::create("Benchmark", processItem, numItems);
+			TaskScheduler::instance().addTaskGroup(group);
+			group->wait();
+		});
+
+		const double parallelFor = measure(NUM_RUNS, [&]()
+		{
+			TaskScheduler::instance().parallelFor(0, numItems, 16, processItem);
+		});
+
+		printf("Process %u items in parallel, task group: %.2f ms, parallelFor: %.2f ms (%.1fx)\n", numItems, taskGroup,
+			parallelFor, taskGroup / parallelFor);
+	}
+
+	static constexpr UINT32 NUM_CULL_OBJECTS = 200000;
+	static constexpr UINT64 CULL_LAYERS = 0x1;
+
+	{
+		// Objects spread around a view at the origin, with every eight object on a layer the view doesn't see
+		Random random(17);
+
+		Vector<ct::CullInfo> cullInfos;
+		ct::CullInfoSoA cullInfosSoA;
+		for (UINT32 i = 0; i < NUM_CULL_OBJECTS; i++)
+		{
+			const Vector3 center(random.getSNorm() * 500.0f, random.getSNorm() * 500.0f, random.getSNorm() * 500.0f);
+			const Vector3 extents(1.0f + random.getUNorm() * 4.0f, 1.0f + random.getUNorm() * 4.0f,
+				1.0f + random.getUNorm() * 4.0f);
+
+			const Bounds bounds(AABox(center - extents, center + extents), Sphere(center, extents.length()));
+			cullInfos.push_back(ct::CullInfo(bounds, (i % 8) == 0 ? 0x2 : 0x1));
+			cullInfosSoA.add(cullInfos.back());
+		}
+
+		const ConvexVolume frustum(Matrix4::projectionPerspective(Degree(90.0f), 1.0f, 0.1f, 1000.0f));
+
+		float cullDistances[] = { 200.0f, 1000.0f };
+		for (auto cullDistance : cullDistances)
+		{
+			Vector<bool> scalarVisibility(NUM_CULL_OBJECTS);
+			const double scalar = measure(NUM_RUNS, [&]()
+			{
+				scalarVisibility.assign(NUM_CULL_OBJECTS, false);
+				cullReference(cullInfos, CULL_LAYERS, frustum, Vector3::ZERO, cullDistance, scalarVisibility);
+			});
+
+			const ct::CullView view(CULL_LAYERS, frustum.getPlanes(), Vector3::ZERO, cullDistance);
+
+			Vector<bool> batchVisibility(NUM_CULL_OBJECTS);
+			const double batched = measure(NUM_RUNS, [&]()
+			{
+				batchVisibility.assign(NUM_CULL_OBJECTS, false);
+				for (UINT32 i = 0; i < NUM_CULL_OBJECTS; i += ct::CullInfoSoA::BATCH_SIZE)
+				{
+					UINT32 visibleMask = ct::cullBatch(cullInfosSoA, i, view);
+					while (visibleMask != 0)
+					{
+						batchVisibility[i + Bitwise::leastSignificantBit(visibleMask)] = true;
+						visibleMask &= visibleMask - 1;
+					}
+				}
+			});
+
+			const auto numVisible = (UINT32)std::count(batchVisibility.begin(), batchVisibility.end(), true);
+			printf("Cull %u objects, cull distance %.0f, %u visible%s, scalar: %.2f ms, SIMD batches: %.2f ms (%.1fx)\n",
+				NUM_CULL_OBJECTS, cullDistance, numVisible, scalarVisibility == batchVisibility ? "" : " (MISMATCH)",
+				scalar, batched, scalar / batched);
+		}
+	}
+
+	static constexpr UINT32 NUM_PROFILER_SAMPLES = 200000;
+	static constexpr UINT32 NUM_PROFILER_SIBLINGS = 64;
+
+	ProfilerCPU::startUp();
+
+	Vector<String> sampleNames;
+	for (UINT32 i = 0; i < NUM_PROFILER_SIBLINGS; i++)
+		sampleNames.push_back("Sample" + toString(i));
+
+	const double namedSamples = measure(NUM_RUNS, [&]()
+	{
+		gProfilerCPU().reset();
+		gProfilerCPU().beginThread("Benchmark");
+
+		for (UINT32 i = 0; i < NUM_PROFILER_SAMPLES; i++)
+		{
+			const char* name = sampleNames[i % NUM_PROFILER_SIBLINGS].c_str();
+			gProfilerCPU().beginSample(name);
+			gProfilerCPU().endSample(name);
+		}
+
+		gProfilerCPU().endThread();
+	});
+
+	const double scopedSamples = measure(NUM_RUNS, [&]()
+	{
+		gProfilerCPU().reset();
+		gProfilerCPU().beginThread("Benchmark");
+
+		for (UINT32 i = 0; i < NUM_PROFILER_SAMPLES; i++)
+		{
+			BS_PROFILE_SCOPE("Scope");
+		}
+
+		gProfilerCPU().endThread();
+	});
+
+	ProfilerCPU::shutDown();
+
+	printf("Profiler sample overhead, %u siblings: %.1f ns, static scope: %.1f ns\n", NUM_PROFILER_SIBLINGS,
+		namedSamples * 1000000.0 / NUM_PROFILER_SAMPLES, scopedSamples * 1000000.0 / NUM_PROFILER_SAMPLES);
+
+	static constexpr UINT32 NUM_GUI_WINDOWS = 100;
+	static constexpr UINT32 NUM_GUI_BUTTONS = 33;
+	static constexpr UINT32 NUM_GUI_ICONS = 8;
+
+	{
+		// Overlapping windows, each with a column layout of buttons made out of a background, a label and an icon. Each
+		// window covers a range of depths, same as GUI widgets with separate depths would.
+		Vector<GUIMeshElement> elements;
+		const auto addElement = [&elements](const Rect2I& bounds, UINT32 depth, UINT64 material)
+		{
+			GUIMeshElement elem;
+			elem.renderElement = (UINT32)elements.size();
+			elem.bounds = bounds;
+			elem.depth = depth;
+			elem.mergeHash = material;
+			elem.numVertices = 4;
+			elem.numIndices = 6;
+
+			elements.push_back(elem);
+		};
+
+		for (UINT32 i = 0; i < NUM_GUI_WINDOWS; i++)
+		{
+			const INT32 windowX = (INT32)(i % 10) * 250;
+			const INT32 windowY = (INT32)(i / 10) * 150;
+			const UINT32 windowDepth = (NUM_GUI_WINDOWS - i) * 4;
+
+			addElement(Rect2I(windowX, windowY, 300, 200), windowDepth + 3, 0);
+			for (UINT32 j = 0; j < NUM_GUI_BUTTONS; j++)
+			{
+				const Rect2I bounds(windowX + (INT32)(j % 5) * 60, windowY + (INT32)(j / 5) * 20, 56, 18);
+
+				addElement(bounds, windowDepth + 2, 0);
+				addElement(Rect2I(bounds.x + 4, bounds.y, 30, 18), windowDepth + 1, 1);
+				addElement(Rect2I(bounds.x + 38, bounds.y, 18, 18), windowDepth + 1, 2 + j % NUM_GUI_ICONS);
+			}
+		}
+
+		std::stable_sort(elements.begin(), elements.end(),
+			[](const GUIMeshElement& a, const GUIMeshElement& b) { return a.depth > b.depth; });
+
+		Vector<UINT32> referenceGroups;
+		UINT32 numReferenceGroups = 0;
+		const double allGroups = measure(NUM_RUNS, [&]()
+		{
+			numReferenceGroups = groupGUIElementsReference(elements, referenceGroups);
+		});
+
+		UINT32 numGroups = 0;
+		Vector<UINT32> groupElements;
+		bool groupsMatch = true;
+		const double gridGroups = measure(NUM_RUNS, [&]()
+		{
+			bs_frame_mark();
+			{
+				FrameVector<GUIMeshGroup> groups;
+				groupGUIElements(elements.data(), (UINT32)elements.size(), false, groups, groupElements);
+				numGroups = (UINT32)groups.size();
+
+				// Each group must contain elements from a single reference group. With the same number of groups this
+				// means both methods partition the elements in the same way.
+				for (auto& group : groups)
+				{
+					const UINT32 referenceGroup = referenceGroups[groupElements[group.firstElement]];
+					for (UINT32 i = 1; i < group.numElements; i++)
+					{
+						if (referenceGroups[groupElements[group.firstElement + i]] != referenceGroup)
+							groupsMatch = false;
+					}
+				}
+			}
+			bs_frame_clear();
+		});
+
+		groupsMatch = groupsMatch && numGroups == numReferenceGroups;
+		printf("Group %u GUI elements into %u meshes%s, all groups: %.2f ms, group grid: %.2f ms (%.1fx)\n",
+			(UINT32)elements.size(), numGroups, groupsMatch ? "" : " (MISMATCH)", allGroups, gridGroups,
+			allGroups / gridGroups);
+	}
+
+	DynLibManager::startUp();
+	PhysicsManager::startUp(BS_PHYSICS_MODULE, false);
+
+	if (Physics::isStarted())
+	{
+		static constexpr UINT32 GRID_SIZE = 64;
+		static constexpr UINT32 NUM_QUERIES = 20000;
+
+		SPtr<PhysicsScene> physicsScene = gPhysics().createPhysicsScene();
+
+		// Field of boxes of varying heights, with rays cast down on them at random angles
+		Random random(11);
+		Vector<SPtr<BoxCollider>> colliders;
+		for (UINT32 z = 0; z < GRID_SIZE; z++)
+		{
+			for (UINT32 x = 0; x < GRID_SIZE; x++)
+			{
+				const float halfHeight = 0.5f + random.getUNorm() * 2.0f;
+				colliders.push_back(BoxCollider::create(*physicsScene, Vector3(0.4f, halfHeight, 0.4f),
+					Vector3((float)x, halfHeight, (float)z)));
+			}
+		}
+
+		PhysicsQueryBatch batch;
+		for (UINT32 i = 0; i < NUM_QUERIES; i++)
+		{
+			const Vector3 origin(random.getUNorm() * GRID_SIZE, 20.0f, random.getUNorm() * GRID_SIZE);
+			const Vector3 dir(random.getSNorm() * 0.5f, -1.0f, random.getSNorm() * 0.5f);
+
+			batch.addRayCast(origin, Vector3::normalize(dir));
+		}
+
+		const double individual = measure(NUM_RUNS, [&]()
+		{
+			PhysicsQueryHit hit;
+			for (UINT32 i = 0; i < NUM_QUERIES; i++)
+			{
+				const PhysicsQuery& query = batch.getQuery(i);
+				physicsScene->rayCast(query.position, query.unitDir, hit, query.layer, query.maxDist);
+			}
+		});
+
+		Vector<PhysicsQueryResult> results(NUM_QUERIES);
+		const double batched = measure(NUM_RUNS, [&]() { physicsScene->queryBatch(batch, results.data()); });
+		printf("Ray cast %u queries against %u boxes (%s), individual: %.1f ms, batched: %.1f ms (%.1fx)\n", 
+			NUM_QUERIES, GRID_SIZE * GRID_SIZE, BS_PHYSICS_MODULE, individual, batched, individual / batched);
+
+		colliders.clear();
+	}
+
+	PhysicsManager::shutDown();
+	DynLibManager::shutDown();
+
+	TaskScheduler::shutDown();
+	ThreadPool::shutDown();
+	MemStack::endThread();
+
+	return 0;
+}
@@ -4,6 +4,33 @@
 #include "Testing/BsTestSuite.h"
 #include "Animation/BsAnimationCurve.h"
 #include "Particles/BsParticleDistribution.h"
+#include "Image/BsPixelUtil.h"
+#include "Image/BsColor.h"
+#include "CoreThread/BsCommandQueue.h"
+#include "Renderer/BsRenderQueue.h"
+#include "Math/BsRandom.h"
+#include "Profiling/BsProfilerCPU.h"
+#include "GUI/BsGUIBatching.h"
+#include "CoreThread/BsCoreThread.h"
+#include "Threading/BsThreadPool.h"
+#include "Threading/BsTaskScheduler.h"
+#include "CoreThread/BsCoreObjectManager.h"
+#include "Managers/BsRenderAPIManager.h"
+#include "Managers/BsGpuProgramManager.h"
+#include "Managers/BsRenderStateManager.h"
+#include "Profiling/BsRenderStats.h"
+#include "RenderAPI/BsRenderWindow.h"
+#include "Renderer/BsGpuResourcePool.h"
+#include "Utility/BsDynLib.h"
+#include "Utility/BsDynLibManager.h"
+#include "Scene/BsSceneObject.h"
+#include "Scene/BsSceneManager.h"
+#include "Scene/BsGameObjectManager.h"
+#include "Physics/BsPhysics.h"
+#include "Physics/BsPhysicsManager.h"
+#include "Physics/BsRigidbody.h"
+#include "Physics/BsBoxCollider.h"
+#include "BsEngineConfig.h"
 
 namespace bs
 {
@@ -17,20 +44,149 @@ namespace bs
 		return acceleration * time;
 	}
 
+	/** Exposes the element sorting of RenderQueue, allowing it to be tested without creating any materials. */
+	class SortTestRenderQueue : public ct::RenderQueue
+	{
+	public:
+		SortTestRenderQueue(ct::StateReduction mode)
+			:RenderQueue(mode)
+		{ }
+
+		/** Adds a new element to sort. */
+		void addSortable(INT32 priority, float distance, UINT32 shaderId, UINT32 techniqueIdx, UINT32 passIdx)
+		{
+			const auto idx = (UINT32)mSortableElements.size();
+			mSortableElementIdx.push_back(idx);
+			mSortableElements.push_back({ idx, priority, distance, shaderId, techniqueIdx, passIdx });
+		}
+
+		/** Sorts the elements using the sort keys, and returns the sorted element indices. */
+		const Vector<UINT32>& sortWithKeys()
+		{
+			resetIndices();
+			sortIndices();
+
+			return mSortableElementIdx;
+		}
+
+		/** Sorts the elements using a comparison sort, and returns the sorted element indices. */
+		const Vector<UINT32>& sortWithComparison()
+		{
+			resetIndices();
+			sortIndicesComparison();
+
+			return mSortableElementIdx;
+		}
+
+	private:
+		void resetIndices()
+		{
+			for (UINT32 i = 0; i < (UINT32)mSortableElementIdx.size(); i++)
+				mSortableElementIdx[i] = i;
+		}
+	};
+
+	/** Core object that records the order in which it gets synced with the core thread. */
+	class SyncTestCoreObject : public CoreObject
+	{
+	public:
+		SyncTestCoreObject(Vector<CoreObject*>& syncOrder)
+			:mSyncOrder(syncOrder)
+		{ }
+
+		/** Marks the object as requiring a sync with the core thread. */
+		void setDirty() { markCoreDirty(); }
+
+		/** Changes the objects that must be synced before this object. */
+		void setDependencies(const Vector<CoreObject*>& dependencies)
+		{
+			mDependencies = dependencies;
+			markDependenciesDirty();
+		}
+
+	private:
+		SPtr<ct::CoreObject> createCore() const override
+		{
+			SPtr<ct::CoreObject> core = bs_shared_ptr_new<ct::CoreObject>();
+			core->_setThisPtr(core);
+
+			return core;
+		}
+
+		CoreSyncData syncToCore(FrameAlloc* allocator) override
+		{
+			mSyncOrder.push_back(this);
+			return CoreSyncData();
+		}
+
+		void getCoreDependencies(Vector<CoreObject*>& dependencies) override
+		{
+			dependencies = mDependencies;
+		}
+
+		Vector<CoreObject*>& mSyncOrder;
+		Vector<CoreObject*> mDependencies;
+	};
+
 	class CoreTestSuite : public TestSuite
 	{
 	public:
 		CoreTestSuite();
 
+		void startUp() override;
+		void shutDown() override;
+
 	private:
 		void testAnimCurveIntegration();
 		void testLookupTable();
+		void testMipmaps();
+		void testPixelConversion();
+		void testCommandQueue();
+		void testRenderQueueSort();
+		void testProfilerCPU();
+		void testGUIMeshBuffers();
+		void testFrameSyncBuffers();
+		void testCoreObjectManager();
+		void testGpuResourcePool();
+		void testPhysicsAsyncSimulation();
 	};
 
 	CoreTestSuite::CoreTestSuite()
 	{
 		BS_ADD_TEST(CoreTestSuite::testAnimCurveIntegration);
 		BS_ADD_TEST(CoreTestSuite::testLookupTable);
+		BS_ADD_TEST(CoreTestSuite::testMipmaps);
+		BS_ADD_TEST(CoreTestSuite::testPixelConversion);
+		BS_ADD_TEST(CoreTestSuite::testCommandQueue);
+		BS_ADD_TEST(CoreTestSuite::testRenderQueueSort);
+		BS_ADD_TEST(CoreTestSuite::testProfilerCPU);
+		BS_ADD_TEST(CoreTestSuite::testGUIMeshBuffers);
+		BS_ADD_TEST(CoreTestSuite::testFrameSyncBuffers);
+		BS_ADD_TEST(CoreTestSuite::testCoreObjectManager);
+		BS_ADD_TEST(CoreTestSuite::testGpuResourcePool);
+		BS_ADD_TEST(CoreTestSuite::testPhysicsAsyncSimulation);
+	}
+
+	void CoreTestSuite::startUp()
+	{
+		MemStack::beginThread();
+		ThreadPool::startUp<TThreadPool<ThreadDefaultPolicy>>(4);
+		TaskScheduler::startUp();
+
+		// Modules cannot be restarted, so modules used by more than one test are started for the entire suite
+		CoreThread::startUp();
+		CoreObjectManager::startUp();
+		DynLibManager::startUp();
+	}
+
+	void CoreTestSuite::shutDown()
+	{
+		DynLibManager::shutDown();
+		CoreObjectManager::shutDown();
+		CoreThread::shutDown();
+		TaskScheduler::shutDown();
+		ThreadPool::shutDown();
+		MemStack::endThread();
 	}
 
 	void CoreTestSuite::testAnimCurveIntegration()
@@ -143,6 +299,811 @@ namespace bs
 				BS_TEST_ASSERT(Math::approxEquals(valueLookup[j], valueCurve[j], EPSILON));
 		}
 	}
+
+	void CoreTestSuite::testMipmaps()
+	{
+		static constexpr float EPSILON = 1.0f / 255.0f;
+
+		// Constant image must remain constant, regardless of filter or wrap mode
+		const Color constantColor(0.2f, 0.4f, 0.6f, 0.8f);
+		SPtr<PixelData> constant = PixelData::create(16, 8, 1, PF_RGBA8);
+		constant->setColors(constantColor);
+
+		MipMapFilter filters[] = { MipMapFilter::Box, MipMapFilter::Triangle, MipMapFilter::Kaiser, MipMapFilter::Lanczos };
+		MipMapWrapMode wrapModes[] = { MipMapWrapMode::Clamp, MipMapWrapMode::Repeat, MipMapWrapMode::Mirror };
+		for(auto filter : filters)
+		{
+			for(auto wrapMode : wrapModes)
+			{
+				MipMapGenOptions options;
+				options.filter = filter;
+				options.wrapMode = wrapMode;
+				options.isSRGB = true;
+
+				Vector<SPtr<PixelData>> mips = PixelUtil::genMipmaps(*constant, options);
+				BS_TEST_ASSERT(mips.size() == 5);
+
+				for(auto& mip : mips)
+				{
+					Color color = mip->getColorAt(mip->getWidth() - 1, mip->getHeight() - 1);
+					for(UINT32 i = 0; i < 4; i++)
+						BS_TEST_ASSERT(Math::approxEquals(color[i], constantColor[i], EPSILON));
+				}
+			}
+		}
+
+		// Box filter must average the pixels
+		SPtr<PixelData> quad = PixelData::create(2, 2, 1, PF_RGBA32F);
+		quad->setColorAt(Color(0.0f, 0.0f, 0.0f, 0.0f), 0, 0);
+		quad->setColorAt(Color(1.0f, 0.0f, 0.0f, 1.0f), 1, 0);
+		quad->setColorAt(Color(0.0f, 1.0f, 0.0f, 1.0f), 0, 1);
+		quad->setColorAt(Color(1.0f, 1.0f, 1.0f, 1.0f), 1, 1);
+
+		MipMapGenOptions options;
+		options.filter = MipMapFilter::Box;
+
+		Vector<SPtr<PixelData>> mips = PixelUtil::genMipmaps(*quad, options);
+		BS_TEST_ASSERT(mips.size() == 2);
+
+		Color average = mips[1]->getColorAt(0, 0);
+		BS_TEST_ASSERT(Math::approxEquals(average.r, 0.5f, EPSILON));
+		BS_TEST_ASSERT(Math::approxEquals(average.g, 0.5f, EPSILON));
+		BS_TEST_ASSERT(Math::approxEquals(average.b, 0.25f, EPSILON));
+		BS_TEST_ASSERT(Math::approxEquals(average.a, 0.75f, EPSILON));
+	}
+
+	void CoreTestSuite::testPixelConversion()
+	{
+		// Conversions between these formats are done by row converters, and must match the per-pixel path exactly
+		PixelFormat formats[] = { PF_R8, PF_RG8, PF_RGB8, PF_BGR8, PF_RGBA8, PF_BGRA8, PF_RGBA16F, PF_RGBA32F };
+
+		// Signed zeroes, smallest and largest denormals, smallest normal, values around one, largest finite, infinities
+		UINT16 halfValues[] = { 0x0000, 0x8000, 0x0001, 0x8001, 0x03FF, 0x0400, 0x3BFF, 0x3C00, 0x7BFF, 0x7C00,
+			0xFC00 };
+
+		// Out of range values, values halfway between 8-bit steps, denormals, and values that underflow or overflow
+		// a half
+		float floatValues[] = { 0.0f, -0.0f, -0.5f, 1.0f, 1.5f, 0.5f / 255.0f, 1.5f / 255.0f, 127.5f / 255.0f,
+			254.5f / 255.0f, std::nextafter(1.0f, 0.0f), 1e-40f, -1e-40f, 6e-8f, 3e-8f, -3e-8f, 65504.0f, 65520.0f,
+			std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() };
+
+		// Converts the pixels one by one, using the generic per-pixel path
+		const auto convertReference = [](const PixelData& src, PixelData& dst)
+		{
+			const UINT32 srcPixelSize = PixelUtil::getNumElemBytes(src.getFormat());
+			const UINT32 dstPixelSize = PixelUtil::getNumElemBytes(dst.getFormat());
+
+			for (UINT32 y = 0; y < src.getHeight(); y++)
+			{
+				for (UINT32 x = 0; x < src.getWidth(); x++)
+				{
+					float r, g, b, a;
+					PixelUtil::unpackColor(&r, &g, &b, &a, src.getFormat(),
+						src.getData() + (y * src.getRowPitch() + x) * srcPixelSize);
+					PixelUtil::packColor(r, g, b, a, dst.getFormat(),
+						dst.getData() + (y * dst.getRowPitch() + x) * dstPixelSize);
+				}
+			}
+		};
+
+		const auto testConversion = [&convertReference](const PixelData& src, PixelFormat dstFormat)
+		{
+			PixelData converted(src.getWidth(), src.getHeight(), 1, dstFormat);
+			converted.allocateInternalBuffer();
+
+			PixelData reference(src.getWidth(), src.getHeight(), 1, dstFormat);
+			reference.allocateInternalBuffer();
+
+			PixelUtil::bulkPixelConversion(src, converted);
+			convertReference(src, reference);
+
+			return memcmp(converted.getData(), reference.getData(), reference.getSize()) == 0;
+		};
+
+		// Odd width so rows end with a partial group of pixels, and a sub-volume so the rows aren't tightly packed
+		static constexpr UINT32 WIDTH = 13;
+		static constexpr UINT32 HEIGHT = 3;
+
+		Random random(5);
+		for (auto srcFormat : formats)
+		{
+			SPtr<PixelData> image = PixelData::create(WIDTH + 3, HEIGHT + 1, 1, srcFormat);
+			UINT8* data = image->getData();
+
+			if (srcFormat == PF_RGBA16F)
+			{
+				for (UINT32 i = 0; i < image->getSize() / sizeof(UINT16); i++)
+				{
+					const UINT16 value = (i % 2) == 0 ? halfValues[(i / 2) % bs_size(halfValues)] :
+						Bitwise::floatToHalf(random.getSNorm() * 2.0f);
+
+					memcpy(data + i * sizeof(UINT16), &value, sizeof(value));
+				}
+			}
+			else if (srcFormat == PF_RGBA32F)
+			{
+				for (UINT32 i = 0; i < image->getSize() / sizeof(float); i++)
+				{
+					const float value = (i % 2) == 0 ? floatValues[(i / 2) % bs_size(floatValues)] :
+						random.getSNorm() * 2.0f;
+
+					memcpy(data + i * sizeof(float), &value, sizeof(value));
+				}
+			}
+			else
+			{
+				for (UINT32 i = 0; i < image->getSize(); i++)
+					data[i] = (UINT8)random.get();
+			}
+
+			const PixelData src = image->getSubVolume(PixelVolume(1, 1, WIDTH + 1, HEIGHT + 1));
+			for (auto dstFormat : formats)
+			{
+				// Same format is a plain copy that doesn't go through the row converters
+				if (dstFormat != srcFormat)
+					BS_TEST_ASSERT(testConversion(src, dstFormat));
+			}
+		}
+
+		// NaNs are only compared between floating point formats, as their conversion to integers is undefined
+		UINT16 halfNaNs[] = { 0x7E00, 0xFE00, 0x7C01, 0x7FFF };
+		UINT32 floatNaNs[] = { 0x7FC00000, 0xFFC00000, 0x7F800001, 0x7FC01234 };
+
+		SPtr<PixelData> halfImage = PixelData::create(WIDTH, 1, 1, PF_RGBA16F);
+		SPtr<PixelData> floatImage = PixelData::create(WIDTH, 1, 1, PF_RGBA32F);
+		for (UINT32 i = 0; i < WIDTH; i++)
+		{
+			memcpy(halfImage->getData() + i * sizeof(halfNaNs), halfNaNs, sizeof(halfNaNs));
+			memcpy(floatImage->getData() + i * sizeof(floatNaNs), floatNaNs, sizeof(floatNaNs));
+		}
+
+		BS_TEST_ASSERT(testConversion(*halfImage, PF_RGBA32F));
+		BS_TEST_ASSERT(testConversion(*floatImage, PF_RGBA16F));
+
+		// Quantization must be the exact inverse of normalization, and round to nearest
+		for (UINT32 i = 0; i < 256; i++)
+			BS_TEST_ASSERT(Bitwise::unormToUint(Bitwise::uintToUnorm(i, 8), 8) == i);
+
+		BS_TEST_ASSERT(Bitwise::unormToUint(std::nextafter(1.0f, 0.0f), 8) == 255);
+		BS_TEST_ASSERT(Bitwise::unormToUint(0.49f / 255.0f, 8) == 0);
+		BS_TEST_ASSERT(Bitwise::unormToUint(0.51f / 255.0f, 8) == 1);
+		BS_TEST_ASSERT(Bitwise::unormToUint(254.49f / 255.0f, 8) == 254);
+		BS_TEST_ASSERT(Bitwise::unormToUint(254.51f / 255.0f, 8) == 255);
+		BS_TEST_ASSERT(Bitwise::unormToUint<8>(-1.0f) == 0);
+		BS_TEST_ASSERT(Bitwise::unormToUint<8>(2.0f) == 255);
+	}
+
+	void CoreTestSuite::testCommandQueue()
+	{
+		// Commands must execute in order, including ones too large to be stored inline
+		Vector<UINT32> executed;
+		UINT8 largeData[512] = { };
+
+		CommandRingBuffer ringBuffer(16);
+		for(UINT32 i = 0; i < 10; i++)
+		{
+			if(i % 3 == 0)
+				ringBuffer.queue([&executed, i, largeData]() { executed.push_back(i + largeData[0]); });
+			else
+				ringBuffer.queue([&executed, i]() { executed.push_back(i); });
+		}
+
+		AsyncOp asyncOp = ringBuffer.queueReturn([](AsyncOp& op) { op._completeOperation(5); });
+
+		UINT32 notifiedId = 0;
+		ringBuffer.queue([]() { }, true, 3);
+
+		BS_TEST_ASSERT(!ringBuffer.isEmpty());
+		BS_TEST_ASSERT(ringBuffer.playback([&notifiedId](UINT32 id) { notifiedId = id; }) == 12);
+		BS_TEST_ASSERT(ringBuffer.isEmpty());
+
+		BS_TEST_ASSERT(executed.size() == 10);
+		for(UINT32 i = 0; i < (UINT32)executed.size(); i++)
+			BS_TEST_ASSERT(executed[i] == i);
+
+		BS_TEST_ASSERT(asyncOp.hasCompleted());
+		BS_TEST_ASSERT(any_cast<int>(asyncOp.getGenericReturnValue()) == 5);
+		BS_TEST_ASSERT(notifiedId == 3);
+
+		// Producers must not wait on a busy consumer once the ring buffer is full. Commands that don't fit still execute
+		// in order, and the ring buffer is used again once the consumer catches up.
+		CommandRingBuffer smallRingBuffer(4);
+		std::atomic<bool> consumerBusy(false);
+		std::atomic<bool> producerDone(false);
+
+		smallRingBuffer.queue([&consumerBusy, &producerDone]()
+		{
+			consumerBusy = true;
+			while(!producerDone)
+				std::this_thread::yield();
+		});
+
+		executed.clear();
+		HThread consumer = ThreadPool::instance().run("CommandConsumer", [&smallRingBuffer]()
+		{
+			smallRingBuffer.playback(nullptr);
+		});
+
+		while(!consumerBusy)
+			std::this_thread::yield();
+
+		for(UINT32 i = 0; i < 100; i++)
+			smallRingBuffer.queue([&executed, i]() { executed.push_back(i); });
+
+		producerDone = true;
+		consumer.blockUntilComplete();
+
+		BS_TEST_ASSERT(smallRingBuffer.isEmpty());
+		BS_TEST_ASSERT(executed.size() == 100);
+		for(UINT32 i = 0; i < (UINT32)executed.size(); i++)
+			BS_TEST_ASSERT(executed[i] == i);
+
+		for(UINT32 i = 0; i < 4; i++)
+			smallRingBuffer.queue([&executed, i]() { executed.push_back(100 + i); });
+
+		BS_TEST_ASSERT(smallRingBuffer.playback(nullptr) == 4);
+		BS_TEST_ASSERT(executed.size() == 104 && executed.back() == 103);
+
+		// Command buffers must execute in order, and be reusable after playback or clear
+		CommandBuffer commandBuffer;
+		for(UINT32 pass = 0; pass < 3; pass++)
+		{
+			executed.clear();
+			for(UINT32 i = 0; i < 5000; i++)
+				commandBuffer.queue([&executed, i]() { executed.push_back(i); }, false, 0);
+
+			commandBuffer.playback(nullptr);
+			BS_TEST_ASSERT(commandBuffer.isEmpty());
+			BS_TEST_ASSERT(executed.size() == 5000);
+			BS_TEST_ASSERT(executed.back() == 4999);
+		}
+
+		executed.clear();
+		commandBuffer.queue([&executed]() { executed.push_back(0); }, false, 0);
+		commandBuffer.clear();
+		commandBuffer.playback(nullptr);
+		BS_TEST_ASSERT(executed.empty());
+	}
+
+	void CoreTestSuite::testRenderQueueSort()
+	{
+		ct::StateReduction modes[] = { ct::StateReduction::None, ct::StateReduction::Material, ct::StateReduction::Distance };
+		for (auto& mode : modes)
+		{
+			Random random(5);
+			SortTestRenderQueue queue(mode);
+			for (UINT32 i = 0; i < 5000; i++)
+			{
+				// Use few distinct distances so sequential order matters for ties, and negative distances for elements 
+				// sorted back to front
+				const float distance = (float)random.getRange(-50, 50) * 0.5f;
+				queue.addSortable(random.getRange(-2, 2) * 100, distance, random.getRange(0, 40), random.getRange(0, 2),
+					random.getRange(0, 3));
+			}
+
+			// Key sort must result in exactly the same order as the comparison sort when there are enough bits to 
+			// represent the distance exactly
+			const Vector<UINT32> expected = queue.sortWithComparison();
+			const Vector<UINT32>& sorted = queue.sortWithKeys();
+
+			BS_TEST_ASSERT(expected == sorted);
+		}
+
+		// Values too far apart to fit in a single key must still sort correctly
+		SortTestRenderQueue wideQueue(ct::StateReduction::Material);
+		wideQueue.addSortable(std::numeric_limits<INT32>::max(), 1.0f, std::numeric_limits<UINT32>::max(), 0, 0);
+		wideQueue.addSortable(std::numeric_limits<INT32>::min(), 2.0f, 0, 0, 0);
+		wideQueue.addSortable(0, -1.0f, 5, 1, 1);
+
+		const Vector<UINT32>& wideSorted = wideQueue.sortWithKeys();
+		BS_TEST_ASSERT(wideSorted[0] == 0 && wideSorted[1] == 2 && wideSorted[2] == 1);
+	}
+
+	void CoreTestSuite::testProfilerCPU()
+	{
+		static constexpr UINT32 NUM_CHILDREN = 100;
+		static constexpr UINT32 NUM_PASSES = 3;
+
+		ProfilerCPU::startUp();
+
+		ProfilerCPU& profiler = gProfilerCPU();
+		profiler.reset();
+		profiler.beginThread("Main");
+
+		// Enough children to grow the child lookup table a few times. Names are re-created each pass so the blocks
+		// must be found by name, rather than by the name pointer.
+		for (UINT32 pass = 0; pass < NUM_PASSES; pass++)
+		{
+			for (UINT32 i = 0; i < NUM_CHILDREN; i++)
+			{
+				const String name = "Child" + toString(i);
+				profiler.beginSample(name.c_str());
+				{
+					BS_PROFILE_SCOPE("Nested");
+				}
+
+				// Scope constructed from a temporary identifier must record into the same block
+				{
+					ProfilerCPUScope scope("Nested");
+				}
+				profiler.endSample(name.c_str());
+			}
+		}
+
+		profiler.endThread();
+
+		CPUProfilerReport report = profiler.generateReport();
+		const CPUProfilerBasicSamplingEntry& root = report.getBasicSamplingData();
+
+		BS_TEST_ASSERT(root.childEntries.size() == NUM_CHILDREN);
+		for (auto& child : root.childEntries)
+		{
+			BS_TEST_ASSERT(child.data.numCalls == NUM_PASSES);
+			BS_TEST_ASSERT(child.childEntries.size() == 1);
+			BS_TEST_ASSERT(child.childEntries[0].data.name == "Nested");
+			BS_TEST_ASSERT(child.childEntries[0].data.numCalls == NUM_PASSES * 2);
+		}
+
+		ProfilerCPU::shutDown();
+	}
+
+	void CoreTestSuite::testGUIMeshBuffers()
+	{
+		static constexpr UINT32 NUM_ELEMENTS = 30;
+		const UINT32 vertexStride[2] = { 8, 4 };
+
+		// Render elements are identified by their render element index alone, with no GUI element
+		Vector<GUIMeshElement> elements;
+		for (UINT32 i = 0; i < NUM_ELEMENTS; i++)
+		{
+			GUIMeshElement elem;
+			elem.renderElement = i;
+			elem.meshType = i % 5 == 0 ? GUIMeshType::Line : GUIMeshType::Triangle;
+			elem.depth = 40 - i / 2;
+			elem.mergeHash = elem.meshType == GUIMeshType::Line ? 10 : i % 3;
+			elem.bounds = Rect2I((INT32)(i * 13 % 100), (INT32)(i * 7 % 80), 20 + (i % 3) * 10, 15);
+			elem.numVertices = 3 + i % 4;
+			elem.numIndices = elem.meshType == GUIMeshType::Line ? elem.numVertices : elem.numVertices * 2;
+
+			elements.push_back(elem);
+		}
+
+		// Contents of a render element depend on its version, which is bumped whenever the element is marked dirty
+		Vector<UINT32> versions(NUM_ELEMENTS + 1, 0);
+		Set<UINT32> dirty;
+		Set<UINT32> filled;
+
+		const auto isDirty = [&dirty](const GUIMeshElement& elem) { return dirty.count(elem.renderElement) > 0; };
+		const auto fill = [&](const GUIMeshElement& elem, GUIMeshBuffers& buffers)
+		{
+			const UINT32 typeIdx = (UINT32)elem.meshType;
+			const UINT32 stride = vertexStride[typeIdx];
+
+			UINT8* vertices = buffers.vertices[typeIdx].data() + elem.vertexOffset * stride;
+			for (UINT32 i = 0; i < elem.numVertices * stride; i++)
+				vertices[i] = (UINT8)(elem.renderElement * 31 + versions[elem.renderElement] * 7 + i);
+
+			UINT32* indices = buffers.indices[typeIdx].data() + elem.indexOffset;
+			for (UINT32 i = 0; i < elem.numIndices; i++)
+				indices[i] = elem.vertexOffset + (i * 5 + elem.renderElement) % elem.numVertices;
+
+			filled.insert(elem.renderElement);
+		};
+
+		// Groups the elements and fills the buffers, same as GUIManager does when the grouping changes
+		const auto build = [&](const Vector<GUIMeshElement>& prevElements, const GUIMeshBuffers& prevBuffers,
+			Vector<GUIMeshElement>& outElements, GUIMeshBuffers& outBuffers)
+		{
+			outElements = elements;
+			std::stable_sort(outElements.begin(), outElements.end(),
+				[](const GUIMeshElement& a, const GUIMeshElement& b) { return a.depth > b.depth; });
+
+			bs_frame_mark();
+			{
+				FrameVector<GUIMeshGroup> groups;
+				Vector<UINT32> groupElements;
+				groupGUIElements(outElements.data(), (UINT32)outElements.size(), false, groups, groupElements);
+
+				filled.clear();
+				fillGUIMeshBuffers(outElements.data(), (UINT32)outElements.size(), prevElements, prevBuffers,
+					vertexStride, outBuffers, isDirty, fill);
+			}
+			bs_frame_clear();
+		};
+
+		Vector<GUIMeshElement> prevElements;
+		GUIMeshBuffers prevBuffers;
+		build({}, GUIMeshBuffers(), prevElements, prevBuffers);
+		BS_TEST_ASSERT(filled.size() == NUM_ELEMENTS);
+
+		// Move elements to other depths and locations so their offsets change, re-generate some of them, change the
+		// size or mesh type of some, remove one and add a new one
+		elements[3].depth = 100;
+		elements[10].bounds = Rect2I(0, 0, 200, 200);
+		elements[17].depth = 1;
+		elements[8].numVertices++;
+		elements[9].numIndices += 2;
+		elements[11].meshType = GUIMeshType::Line;
+		elements[11].mergeHash = 10;
+		elements.erase(elements.begin() + 7);
+
+		GUIMeshElement newElem = elements[0];
+		newElem.renderElement = NUM_ELEMENTS;
+		newElem.depth = 38;
+		elements.push_back(newElem);
+
+		dirty = { 5, 12, 20 };
+		for (auto& entry : dirty)
+			versions[entry]++;
+
+		Vector<GUIMeshElement> newElements;
+		GUIMeshBuffers newBuffers;
+		build(prevElements, prevBuffers, newElements, newBuffers);
+		BS_TEST_ASSERT(filled == Set<UINT32>({ 5, 8, 9, 11, 12, 20, NUM_ELEMENTS }));
+
+		// Make sure the copied elements were actually moved, so their indices had to be rebased
+		bool anyMoved = false;
+		for (auto& elem : newElements)
+		{
+			for (auto& prevElem : prevElements)
+			{
+				if (prevElem.renderElement == elem.renderElement && !isDirty(elem) &&
+					prevElem.vertexOffset != elem.vertexOffset)
+				{
+					anyMoved = true;
+				}
+			}
+		}
+
+		BS_TEST_ASSERT(anyMoved);
+
+		// Buffers filled incrementally must be identical to buffers re-generated from scratch
+		Vector<GUIMeshElement> fullElements;
+		GUIMeshBuffers fullBuffers;
+		build({}, GUIMeshBuffers(), fullElements, fullBuffers);
+		BS_TEST_ASSERT(filled.size() == elements.size());
+
+		for (UINT32 i = 0; i < 2; i++)
+		{
+			BS_TEST_ASSERT(newBuffers.vertices[i] == fullBuffers.vertices[i]);
+			BS_TEST_ASSERT(newBuffers.indices[i] == fullBuffers.indices[i]);
+		}
+	}
+
+	void CoreTestSuite::testFrameSyncBuffers()
+	{
+		const UINT32 maxFramesInFlight = CoreThread::MAX_FRAMES_IN_FLIGHT;
+		const UINT32 requestedFrames[] = { 0, 1, 3, 100 };
+		for (auto requested : requestedFrames)
+		{
+			// Modules cannot be restarted, so each configuration uses its own instance
+			CoreThread coreThread(requested);
+
+			const UINT32 expectedFrames = Math::clamp(requested, 1U, maxFramesInFlight);
+			const UINT32 numSyncBuffers = coreThread.getNumSyncBuffers();
+			BS_TEST_ASSERT(coreThread.getMaxFramesInFlight() == expectedFrames);
+			BS_TEST_ASSERT(numSyncBuffers == expectedFrames + 1);
+
+			// Every buffer in a full rotation must be unique, so data written by the sim thread in one frame stays
+			// untouched while the core thread is up to getMaxFramesInFlight() frames behind
+			Vector<FrameAlloc*> allocs;
+			for (UINT32 i = 0; i < numSyncBuffers; i++)
+			{
+				FrameAlloc* alloc = coreThread.getFrameAlloc();
+				BS_TEST_ASSERT(std::find(allocs.begin(), allocs.end(), alloc) == allocs.end());
+
+				allocs.push_back(alloc);
+				coreThread.update();
+			}
+
+			// After a full rotation the buffers get re-used in the same order
+			for (UINT32 i = 0; i < numSyncBuffers * 2; i++)
+			{
+				BS_TEST_ASSERT(coreThread.getFrameAlloc() == allocs[i % numSyncBuffers]);
+				coreThread.update();
+			}
+		}
+	}
+
+	void CoreTestSuite::testCoreObjectManager()
+	{
+		Vector<CoreObject*> syncOrder;
+		const auto createObject = [&syncOrder]()
+		{
+			SPtr<SyncTestCoreObject> object = bs_core_ptr_new<SyncTestCoreObject>(syncOrder);
+			object->_setThisPtr(object);
+			object->initialize();
+
+			return object;
+		};
+
+		const auto sync = [&syncOrder]()
+		{
+			syncOrder.clear();
+
+			CoreObjectManager::instance().syncToCore();
+			gCoreThread().update();
+			gCoreThread().submitAll(true);
+		};
+
+		// Slot of a destroyed object gets re-used, but its ID must not
+		SPtr<SyncTestCoreObject> destroyed = createObject();
+		const UINT64 destroyedId = destroyed->getInternalID();
+		destroyed->destroy();
+
+		SPtr<SyncTestCoreObject> reused = createObject();
+		BS_TEST_ASSERT(reused->getInternalID() != destroyedId);
+		BS_TEST_ASSERT((reused->getInternalID() & 0xFFFFFFFF) == (destroyedId & 0xFFFFFFFF));
+		sync();
+
+		// Notifications using the ID of the destroyed object must not affect the object now using its slot
+		destroyed->setDirty();
+		reused->setDirty();
+		sync();
+
+		BS_TEST_ASSERT(syncOrder == Vector<CoreObject*>({ reused.get() }));
+
+		// Dependencies are synced before their dependants, otherwise objects are synced in creation order
+		SPtr<SyncTestCoreObject> objects[5];
+		for (auto& entry : objects)
+			entry = createObject();
+
+		// Dependants are registered in reverse creation order, which must not affect the order they're synced in
+		objects[4]->setDependencies({ objects[3].get() });
+		objects[1]->setDependencies({ objects[0].get(), objects[4].get() });
+		objects[0]->setDependencies({ objects[3].get() });
+
+		for (auto& entry : objects)
+			entry->setDirty();
+
+		sync();
+		BS_TEST_ASSERT(syncOrder == Vector<CoreObject*>({ objects[2].get(), objects[3].get(), objects[0].get(),
+			objects[4].get(), objects[1].get() }));
+
+		// Dependants of a dirty object are marked dirty as well
+		objects[3]->setDirty();
+		sync();
+
+		BS_TEST_ASSERT(syncOrder.size() >= 3);
+		if (syncOrder.size() >= 3)
+		{
+			BS_TEST_ASSERT(syncOrder[0] == objects[3].get());
+			BS_TEST_ASSERT(syncOrder[1] == objects[0].get());
+			BS_TEST_ASSERT(syncOrder[2] == objects[4].get());
+		}
+
+		// Objects that are a part of a dependency cycle, or depend on one, are synced once each, in creation order
+		SPtr<SyncTestCoreObject> cycle[3];
+		for (auto& entry : cycle)
+			entry = createObject();
+
+		cycle[0]->setDependencies({ cycle[1].get() });
+		cycle[1]->setDependencies({ cycle[0].get() });
+		cycle[2]->setDependencies({ cycle[0].get() });
+
+		for (auto& entry : cycle)
+			entry->setDirty();
+
+		objects[2]->setDirty();
+		sync();
+
+		BS_TEST_ASSERT(syncOrder == Vector<CoreObject*>({ objects[2].get(), cycle[0].get(), cycle[1].get(),
+			cycle[2].get() }));
+
+		reused->destroy();
+		for (auto& entry : objects)
+			entry->destroy();
+
+		for (auto& entry : cycle)
+			entry->destroy();
+
+		sync();
+	}
+
+	void CoreTestSuite::testGpuResourcePool()
+	{
+		// Start up the modules required for creating GPU resources, using the null render API
+		RenderStats::startUp();
+		GpuProgramManager::startUp();
+		RenderStateManager::startUp();
+		ct::GpuProgramManager::startUp();
+		RenderAPIManager::startUp();
+
+		RENDER_WINDOW_DESC windowDesc;
+		windowDesc.hidden = true;
+
+		SPtr<RenderWindow> window = RenderAPIManager::instance().initialize("bsfNullRenderAPI", windowDesc);
+		BS_TEST_ASSERT(window != nullptr);
+
+		const auto texDesc = ct::POOLED_RENDER_TEXTURE_DESC::create2D(PF_RGBA8, 64, 64, TU_RENDERTARGET);
+		const auto bufferDesc = ct::POOLED_STORAGE_BUFFER_DESC::createStandard(BF_32X4F, 128);
+		const UINT64 texSize = texDesc.getMemorySize();
+		const UINT64 bufferSize = bufferDesc.getMemorySize();
+
+		bool releasedTextureReused = false;
+		ct::GpuResourcePoolStats frameStats[3];
+
+		// Pooled resources can only be created and used on the core thread
+		gCoreThread().queueCommand([&]()
+		{
+			ct::GpuResourcePool::startUp();
+			ct::GpuResourcePool& pool = ct::GpuResourcePool::instance();
+
+			// First frame needs two textures at once, but the texture released in between should get reused even
+			// though nothing else references it anymore
+			SPtr<ct::PooledRenderTexture> texture0 = pool.get(texDesc);
+			SPtr<ct::PooledRenderTexture> texture1 = pool.get(texDesc);
+			SPtr<ct::PooledStorageBuffer> buffer = pool.get(bufferDesc);
+
+			const ct::PooledRenderTexture* releasedTexture = texture0.get();
+			pool.release(texture0);
+			texture0 = nullptr;
+
+			SPtr<ct::PooledRenderTexture> texture2 = pool.get(texDesc);
+			releasedTextureReused = texture2.get() == releasedTexture;
+
+			pool.release(texture1);
+			pool.release(texture2);
+			pool.release(buffer);
+			texture1 = texture2 = nullptr;
+			buffer = nullptr;
+
+			pool._beginFrame();
+			frameStats[0] = pool.getLastFrameStats();
+
+			// Second frame should be served entirely from the pool
+			texture0 = pool.get(texDesc);
+			buffer = pool.get(bufferDesc);
+
+			pool.release(texture0);
+			pool.release(buffer);
+			texture0 = nullptr;
+			buffer = nullptr;
+
+			pool._beginFrame();
+			frameStats[1] = pool.getLastFrameStats();
+
+			// Resources that don't get reused for a few frames should be removed from the pool
+			for (UINT32 i = 0; i < 5; i++)
+				pool._beginFrame();
+
+			frameStats[2] = pool.getLastFrameStats();
+
+			ct::GpuResourcePool::shutDown();
+		});
+
+		gCoreThread().submitAll(true);
+
+		BS_TEST_ASSERT(releasedTextureReused);
+
+		BS_TEST_ASSERT(frameStats[0].numTextures == 2);
+		BS_TEST_ASSERT(frameStats[0].numBuffers == 1);
+		BS_TEST_ASSERT(frameStats[0].allocatedMemory == texSize * 2 + bufferSize);
+		BS_TEST_ASSERT(frameStats[0].usedMemory == 0);
+		BS_TEST_ASSERT(frameStats[0].peakUsedMemory == texSize * 2 + bufferSize);
+
+		BS_TEST_ASSERT(frameStats[1].numTextures == 2);
+		BS_TEST_ASSERT(frameStats[1].numBuffers == 1);
+		BS_TEST_ASSERT(frameStats[1].allocatedMemory == texSize * 2 + bufferSize);
+		BS_TEST_ASSERT(frameStats[1].usedMemory == 0);
+		BS_TEST_ASSERT(frameStats[1].peakUsedMemory == texSize + bufferSize);
+
+		BS_TEST_ASSERT(frameStats[2].numTextures == 0);
+		BS_TEST_ASSERT(frameStats[2].numBuffers == 0);
+		BS_TEST_ASSERT(frameStats[2].allocatedMemory == 0);
+
+		window->destroy();
+		window = nullptr;
+
+		CoreObjectManager::instance().syncToCore();
+		gCoreThread().update();
+		gCoreThread().submitAll(true);
+
+		RenderAPIManager::shutDown();
+		ct::GpuProgramManager::shutDown();
+		RenderStateManager::shutDown();
+		GpuProgramManager::shutDown();
+		RenderStats::shutDown();
+	}
+
+	void CoreTestSuite::testPhysicsAsyncSimulation()
+	{
+		GameObjectManager::startUp();
+		PhysicsManager::startUp(BS_PHYSICS_MODULE, false);
+
+		// Null physics doesn't simulate anything, so there is nothing to compare
+		if (!Physics::isStarted())
+		{
+			PhysicsManager::shutDown();
+			GameObjectManager::shutDown();
+			return;
+		}
+
+		SceneManager::startUp();
+
+		static constexpr UINT32 NUM_BOXES = 4;
+		static constexpr UINT32 NUM_STEPS = 90;
+		static constexpr float STEP = 1.0f / 60.0f;
+
+		struct TestScene
+		{
+			SPtr<PhysicsScene> scene;
+			SPtr<BoxCollider> ground;
+			Vector<HSceneObject> sceneObjects;
+			Vector<SPtr<Rigidbody>> rigidbodies;
+			Vector<SPtr<BoxCollider>> colliders;
+		};
+
+		// Identical stacks of boxes falling on the ground and settling, one simulated synchronously and one 
+		// asynchronously
+		TestScene scenes[2];
+		for (UINT32 i = 0; i < 2; i++)
+		{
+			TestScene& testScene = scenes[i];
+			testScene.scene = gPhysics().createPhysicsScene();
+			testScene.scene->setFlag(PhysicsFlag::AsyncSimulation, i == 1);
+			testScene.ground = BoxCollider::create(*testScene.scene, Vector3(10.0f, 0.5f, 10.0f), 
+				Vector3(0.0f, -0.5f, 0.0f));
+
+			for (UINT32 j = 0; j < NUM_BOXES; j++)
+			{
+				HSceneObject so = SceneObject::create("Box");
+				so->setWorldPosition(Vector3(j * 0.1f, 1.0f + j * 1.5f, 0.0f));
+
+				SPtr<Rigidbody> rigidbody = testScene.scene->createRigidbody(so);
+				SPtr<BoxCollider> collider = BoxCollider::create(*testScene.scene, Vector3(0.5f, 0.5f, 0.5f));
+				collider->setRigidbody(rigidbody.get());
+				rigidbody->addCollider(collider.get());
+				rigidbody->setMass(1.0f);
+
+				testScene.sceneObjects.push_back(so);
+				testScene.rigidbodies.push_back(rigidbody);
+				testScene.colliders.push_back(collider);
+			}
+		}
+
+		// Asynchronous steps are only reported during the next fixed update, so the asynchronous scene should always 
+		// report what the synchronous scene reported one update earlier
+		Vector<Vector3> lastSyncPositions(NUM_BOXES);
+		bool anyMoved = false;
+		bool positionsMatch = true;
+		for (UINT32 i = 0; i < NUM_STEPS; i++)
+		{
+			gPhysics().fixedUpdate(STEP);
+
+			for (UINT32 j = 0; j < NUM_BOXES; j++)
+			{
+				const Vector3 syncPosition = scenes[0].sceneObjects[j]->getTransform().getPosition();
+				const Vector3 asyncPosition = scenes[1].sceneObjects[j]->getTransform().getPosition();
+
+				if (i > 0)
+				{
+					positionsMatch &= Math::approxEquals(asyncPosition, lastSyncPositions[j], 0.001f);
+					anyMoved |= !Math::approxEquals(syncPosition, lastSyncPositions[j], 0.001f);
+				}
+
+				lastSyncPositions[j] = syncPosition;
+			}
+		}
+
+		BS_TEST_ASSERT(anyMoved);
+		BS_TEST_ASSERT(positionsMatch);
+
+		for (auto& testScene : scenes)
+		{
+			testScene.rigidbodies.clear();
+			testScene.colliders.clear();
+			testScene.ground = nullptr;
+			testScene.scene = nullptr;
+
+			for (auto& so : testScene.sceneObjects)
+				so->destroy(true);
+		}
+
+		SceneManager::shutDown();
+		PhysicsManager::shutDown();
+		GameObjectManager::shutDown();
+	}
 }
 
 using namespace bs;
@@ -174,7 +174,7 @@ namespace bs
 		}
 
 		if(rootBlock == nullptr)
-			rootBlock = getBlock(_name);
+			rootBlock = getBlock(ProfilerSampleId(_name));
 
 		activeBlock = ActiveBlock(ActiveSamplingType::Basic, rootBlock);
 		if (activeBlocks == nullptr)
@@ -234,17 +234,21 @@ namespace bs
 		frameAlloc.clear(); // Note: This never actually frees memory
 	}
 
-	ProfilerCPU::ProfiledBlock* ProfilerCPU::ThreadInfo::getBlock(const char* name)
+	ProfilerCPU::ProfiledBlock* ProfilerCPU::ThreadInfo::getBlock(const ProfilerSampleId& id)
 	{
 		ProfiledBlock* block = frameAlloc.construct<ProfiledBlock>(&frameAlloc);
-		block->name = (char*)frameAlloc.alloc(((UINT32)strlen(name) + 1) * sizeof(char));
-		strcpy(block->name, name);
+		block->name = (char*)frameAlloc.alloc(((UINT32)strlen(id.name) + 1) * sizeof(char));
+		strcpy(block->name, id.name);
+
+		block->hash = id.hash;
+		block->sourceName = id.name;
 
 		return block;
 	}
 
 	void ProfilerCPU::ThreadInfo::releaseBlock(ProfiledBlock* block)
 	{
+		frameAlloc.free((UINT8*)block->childTable);
 		frameAlloc.free((UINT8*)block->name);
 		frameAlloc.free(block);
 	}
@@ -263,15 +267,54 @@ namespace bs
 		children.clear();
 	}
 
-	ProfilerCPU::ProfiledBlock* ProfilerCPU::ProfiledBlock::findChild(const char* name) const
+	ProfilerCPU::ProfiledBlock* ProfilerCPU::ProfiledBlock::findChild(const ProfilerSampleId& id) const
 	{
-		for(auto& child : children)
+		if(childTableSize == 0)
+			return nullptr;
+
+		const UINT32 mask = childTableSize - 1;
+		for(UINT32 i = id.hash & mask; ; i = (i + 1) & mask)
 		{
-			if(strcmp(child->name, name) == 0)
+			ProfiledBlock* child = childTable[i];
+			if(child == nullptr)
+				return nullptr;
+
+			if(child->hash == id.hash && (child->sourceName == id.name || strcmp(child->name, id.name) == 0))
 				return child;
 		}
+	}
+
+	void ProfilerCPU::ProfiledBlock::addChild(ProfiledBlock* child, FrameAlloc* alloc)
+	{
+		children.push_back(child);
+
+		// Keep the load factor at or below one half, so lookups terminate quickly
+		const UINT32 numChildren = (UINT32)children.size();
+		if(numChildren * 2 > childTableSize)
+		{
+			alloc->free((UINT8*)childTable);
+
+			childTableSize = std::max(childTableSize * 2, 8U);
+			childTable = (ProfiledBlock**)alloc->alloc(childTableSize * sizeof(ProfiledBlock*));
+			memset(childTable, 0, childTableSize * sizeof(ProfiledBlock*));
+
+			for(auto& entry : children)
+			{
+				UINT32 i = entry->hash & (childTableSize - 1);
+				while(childTable[i] != nullptr)
+					i = (i + 1) & (childTableSize - 1);
+
+				childTable[i] = entry;
+			}
+		}
+		else
+		{
+			UINT32 i = child->hash & (childTableSize - 1);
+			while(childTable[i] != nullptr)
+				i = (i + 1) & (childTableSize - 1);
 
-		return nullptr;
+			childTable[i] = child;
+		}
 	}
 
 	ProfilerCPU::ProfilerCPU()
@@ -315,38 +358,13 @@ namespace bs
 		ThreadInfo::activeThread->end();
 	}
 
-	void ProfilerCPU::beginSample(const char* name)
+	void ProfilerCPU::beginSample(const ProfilerSampleId& id)
 	{
-		ThreadInfo* thread = ThreadInfo::activeThread;
-		if(thread == nullptr || !thread->isActive)
-		{
-			beginThread("Unknown");
-			thread = ThreadInfo::activeThread;
-		}
-
-		ProfiledBlock* parent = thread->activeBlock.block;
-		ProfiledBlock* block = nullptr;
-		
-		if(parent != nullptr)
-			block = parent->findChild(name);
-
-		if(block == nullptr)
-		{
-			block = thread->getBlock(name);
-
-			if(parent != nullptr)
-				parent->children.push_back(block);
-			else
-				thread->rootBlock->children.push_back(block);
-		}
-
-		thread->activeBlock = ActiveBlock(ActiveSamplingType::Basic, block);
-		thread->activeBlocks->push(thread->activeBlock);
-
+		ProfiledBlock* block = pushBlock(id, ActiveSamplingType::Basic);
 		block->basic.beginSample();
 	}
 
-	void ProfilerCPU::endSample(const char* name)
+	void ProfilerCPU::endSample(const ProfilerSampleId& id)
 	{
 		ThreadInfo* thread = ThreadInfo::activeThread;
 		ProfiledBlock* block = thread->activeBlock.block;
@@ -364,56 +382,28 @@ namespace bs
 			return;
 		}
 
-		if(strcmp(block->name, name) != 0)
+		if(block->hash != id.hash)
 		{
 			LOGWRN("Mismatched CPUProfiler::endSample. Was expecting \"" + String(block->name) + 
-				"\" but got \"" + String(name) + "\". Sampling data will not be valid.");
+				"\" but got \"" + String(id.name) + "\". Sampling data will not be valid.");
 			return;
 		}
 #endif
 
 		block->basic.endSample();
-
-		thread->activeBlocks->pop();
-
-		if (!thread->activeBlocks->empty())
-			thread->activeBlock = thread->activeBlocks->top();
-		else
-			thread->activeBlock = ActiveBlock();
+		popBlock(thread);
 	}
 
-	void ProfilerCPU::beginSamplePrecise(const char* name)
+	void ProfilerCPU::beginSamplePrecise(const ProfilerSampleId& id)
 	{
 		// Note: There is a (small) possibility a context switch will happen during this measurement in which case result will be skewed. 
 		// Increasing thread priority might help. This is generally only a problem with code that executes a long time (10-15+ ms - depending on OS quant length)
 		
-		ThreadInfo* thread = ThreadInfo::activeThread;
-		if(thread == nullptr || !thread->isActive)
-			beginThread("Unknown");
-
-		ProfiledBlock* parent = thread->activeBlock.block;
-		ProfiledBlock* block = nullptr;
-		
-		if(parent != nullptr)
-			block = parent->findChild(name);
-
-		if(block == nullptr)
-		{
-			block = thread->getBlock(name);
-
-			if(parent != nullptr)
-				parent->children.push_back(block);
-			else
-				thread->rootBlock->children.push_back(block);
-		}
-
-		thread->activeBlock = ActiveBlock(ActiveSamplingType::Precise, block);
-		thread->activeBlocks->push(thread->activeBlock);
-
+		ProfiledBlock* block = pushBlock(id, ActiveSamplingType::Precise);
 		block->precise.beginSample();
 	}
 
-	void ProfilerCPU::endSamplePrecise(const char* name)
+	void ProfilerCPU::endSamplePrecise(const ProfilerSampleId& id)
 	{
 		ThreadInfo* thread = ThreadInfo::activeThread;
 		ProfiledBlock* block = thread->activeBlock.block;
@@ -431,16 +421,46 @@ namespace bs
 			return;
 		}
 
-		if (strcmp(block->name, name) != 0)
+		if (block->hash != id.hash)
 		{
 			LOGWRN("Mismatched Profiler::endSamplePrecise. Was expecting \"" + String(block->name) + 
-				"\" but got \"" + String(name) + "\". Sampling data will not be valid.");
+				"\" but got \"" + String(id.name) + "\". Sampling data will not be valid.");
 			return;
 		}
 #endif
 
 		block->precise.endSample();
+		popBlock(thread);
+	}
+
+	ProfilerCPU::ProfiledBlock* ProfilerCPU::pushBlock(const ProfilerSampleId& id, ActiveSamplingType type)
+	{
+		ThreadInfo* thread = ThreadInfo::activeThread;
+		if(thread == nullptr || !thread->isActive)
+		{
+			beginThread("Unknown");
+			thread = ThreadInfo::activeThread;
+		}
 
+		ProfiledBlock* parent = thread->activeBlock.block;
+		if(parent == nullptr)
+			parent = thread->rootBlock;
+
+		ProfiledBlock* block = parent->findChild(id);
+		if(block == nullptr)
+		{
+			block = thread->getBlock(id);
+			parent->addChild(block, &thread->frameAlloc);
+		}
+
+		thread->activeBlock = ActiveBlock(type, block);
+		thread->activeBlocks->push(thread->activeBlock);
+
+		return block;
+	}
+
+	void ProfilerCPU::popBlock(ThreadInfo* thread)
+	{
 		thread->activeBlocks->pop();
 
 		if (!thread->activeBlocks->empty())
@@ -13,10 +13,38 @@ namespace bs
 
 	class CPUProfilerReport;
 
+	/**
+	 * Identifies a CPU profiler sample. Contains the sample name along with its hash, allowing the profiler to find the
+	 * sample data without comparing strings. Use BS_PROFILE_SCOPE to create an identifier whose hash is calculated at
+	 * compile time.
+	 */
+	struct ProfilerSampleId
+	{
+		constexpr ProfilerSampleId(const char* name)
+			:name(name), hash(calcHash(name))
+		{ }
+
+		/** Calculates the FNV-1a hash of a null-terminated string. */
+		static constexpr UINT32 calcHash(const char* name)
+		{
+			UINT32 hash = 2166136261u;
+			for (; *name != 0; ++name)
+				hash = (hash ^ (UINT32)(UINT8)*name) * 16777619u;
+
+			return hash;
+		}
+
+		const char* name;
+		UINT32 hash;
+	};
+
 	/**
 	 * Provides various performance measuring methods.
 	 * 			
 	 * @note	Thread safe. Matching begin* \ end* calls must belong to the same thread though.
+	 * @note	
+	 * Each sample reads the clock twice and records into the sample list of its block, so it is not free. Avoid 
+	 * sampling the innermost iterations of hot loops, and sample the loop as a whole instead.
 	 */
 	class BS_CORE_EXPORT ProfilerCPU : public Module<ProfilerCPU>
 	{
@@ -166,15 +194,29 @@ namespace bs
 			ProfiledBlock(FrameAlloc* alloc);
 			~ProfiledBlock();
 
-			/**	Attempts to find a child block with the specified name. Returns null if not found. */
-			ProfiledBlock* findChild(const char* name) const;
+			/**	Attempts to find a child block with the specified identifier. Returns null if not found. */
+			ProfiledBlock* findChild(const ProfilerSampleId& id) const;
+
+			/** Registers a new child block, growing the child lookup table if needed. */
+			void addChild(ProfiledBlock* child, FrameAlloc* alloc);
 
 			char* name;
+			UINT32 hash = 0;
+
+			/** 
+			 * Name pointer the block was created with. If the same pointer is provided on lookup (as is the case with
+			 * static sample identifiers) the name comparison can be skipped.
+			 */
+			const char* sourceName = nullptr;
 			
 			ProfileData basic;
 			PreciseProfileData precise;
 
 			Vector<ProfiledBlock*, StdFrameAlloc<ProfiledBlock*>> children;
+
+			/** Open-addressed hash table of child blocks, indexed by name hash. Size is always a power of two. */
+			ProfiledBlock** childTable = nullptr;
+			UINT32 childTableSize = 0;
 		};
 
 		/**	CPU sampling type. */
@@ -221,8 +263,8 @@ namespace bs
 			 */
 			void reset();
 
-			/**	Gets the primary profiling block used by the thread. */
-			ProfiledBlock* getBlock(const char* name);
+			/**	Creates a new profiling block with the specified identifier. */
+			ProfiledBlock* getBlock(const ProfilerSampleId& id);
 			
 			/** Deletes the provided block. */
 			void releaseBlock(ProfiledBlock* block);
@@ -257,7 +299,14 @@ namespace bs
 		 *
 		 * @param[in]	name	Unique name for the sample you can later use to find the sampling data.
 		 */
-		void beginSample(const char* name);
+		void beginSample(const char* name) { beginSample(ProfilerSampleId(name)); }
+
+		/** 
+		 * @copydoc beginSample(const char*) 
+		 *
+		 * @note	Faster than the string version as the name hash doesn't need to be calculated. 
+		 */
+		void beginSample(const ProfilerSampleId& id);
 
 		/**
 		 * Ends sample measurement.
@@ -268,7 +317,10 @@ namespace bs
 		 * Unique name is primarily needed to more easily identify mismatched begin/end sample pairs. Otherwise the name in 
 		 * beginSample() would be enough.
 		 */
-		void endSample(const char* name);
+		void endSample(const char* name) { endSample(ProfilerSampleId(name)); }
+
+		/** @copydoc endSample(const char*) */
+		void endSample(const ProfilerSampleId& id);
 
 		/**
 		 * Begins precise sample measurement. Must be followed by endSamplePrecise(). 
@@ -280,7 +332,10 @@ namespace bs
 		 * However due to the way these counters work you should not use this method for larger parts of code. It does not 
 		 * consider context switches so if the OS decides to switch context between measurements you will get invalid data.
 		 */
-		void beginSamplePrecise(const char* name);
+		void beginSamplePrecise(const char* name) { beginSamplePrecise(ProfilerSampleId(name)); }
+
+		/** @copydoc beginSamplePrecise(const char*) */
+		void beginSamplePrecise(const ProfilerSampleId& id);
 
 		/**
 		 * Ends precise sample measurement.
@@ -291,7 +346,10 @@ namespace bs
 		 * Unique name is primarily needed to more easily identify mismatched begin/end sample pairs. Otherwise the name 
 		 * in beginSamplePrecise() would be enough.
 		 */
-		void endSamplePrecise(const char* name);
+		void endSamplePrecise(const char* name) { endSamplePrecise(ProfilerSampleId(name)); }
+
+		/** @copydoc endSamplePrecise(const char*) */
+		void endSamplePrecise(const ProfilerSampleId& id);
 
 		/** Clears all sampling data, and ends any unfinished sampling blocks. */
 		void reset();
@@ -305,6 +363,15 @@ namespace bs
 		CPUProfilerReport generateReport();
 
 	private:
+		/** 
+		 * Finds or creates the child block of the active block with the provided identifier, and makes it the active 
+		 * block. 
+		 */
+		ProfiledBlock* pushBlock(const ProfilerSampleId& id, ActiveSamplingType type);
+
+		/** Removes the active block from the thread's block stack, and makes its parent the active block. */
+		static void popBlock(ThreadInfo* thread);
+
 		/**
 		 * Calculates overhead that the timing and sampling methods themselves introduce so we might get more accurate 
 		 * measurements when creating reports.
@@ -413,6 +480,25 @@ namespace bs
 	/** Provides global access to ProfilerCPU instance. */
 	BS_CORE_EXPORT ProfilerCPU& gProfilerCPU();
 
+	/** Begins a CPU profiler sample when constructed, and ends it when destroyed. */
+	class ProfilerCPUScope
+	{
+	public:
+		explicit ProfilerCPUScope(const ProfilerSampleId& id)
+			:mId(id)
+		{
+			gProfilerCPU().beginSample(mId);
+		}
+
+		~ProfilerCPUScope()
+		{
+			gProfilerCPU().endSample(mId);
+		}
+
+	private:
+		ProfilerSampleId mId;
+	};
+
 	/** Shortcut for profiling a single function call. */
 #define PROFILE_CALL(call, name)					\
 	{												\
@@ -421,5 +507,21 @@ namespace bs
 		bs::gProfilerCPU().endSample(name);			\
 	}
 
+#define BS_PROFILE_CONCAT_INTERNAL(a, b) a##b
+#define BS_PROFILE_CONCAT(a, b) BS_PROFILE_CONCAT_INTERNAL(a, b)
+
+	/** 
+	 * Profiles the remainder of the enclosing scope. Name must be a string literal. The sample identifier is a static
+	 * whose hash is calculated at compile time, making this the cheapest way of profiling frequently executed code. 
+	 *
+	 * @note	A sample still costs roughly 150ns, mostly spent reading the high resolution clock on begin and end. This is
+	 *			well above the 50ns we'd like for profiling inner loops, which would require a cheaper time source and 
+	 *			recording samples into a per-thread event buffer to be resolved when the report is generated. Keep samples 
+	 *			out of the innermost loops until then.
+	 */
+#define BS_PROFILE_SCOPE(name)																			\
+	static constexpr bs::ProfilerSampleId BS_PROFILE_CONCAT(bsProfilerSampleId, __LINE__)(name);		\
+	bs::ProfilerCPUScope BS_PROFILE_CONCAT(bsProfilerScope, __LINE__)(BS_PROFILE_CONCAT(bsProfilerSampleId, __LINE__))
+
 	/** @} */
 }
@@ -0,0 +1,177 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#include "Renderer/BsCullInfo.h"
+#include "Math/BsSIMD.h"
+
+namespace bs { namespace ct
+{
+	void CullInfoSoA::add(const CullInfo& cullInfo)
+	{
+		const UINT32 idx = numEntries;
+		resize(numEntries + 1);
+
+		set(idx, cullInfo);
+	}
+
+	void CullInfoSoA::set(UINT32 idx, const CullInfo& cullInfo)
+	{
+		const Sphere& sphere = cullInfo.bounds.getSphere();
+		const AABox& box = cullInfo.bounds.getBox();
+
+		const Vector3& sphereCenter = sphere.getCenter();
+		const Vector3 boxCenter = box.getCenter();
+		const Vector3 boxExtents = box.getHalfSize();
+
+		layers[idx] = cullInfo.layer;
+		sphereCenterX[idx] = sphereCenter.x;
+		sphereCenterY[idx] = sphereCenter.y;
+		sphereCenterZ[idx] = sphereCenter.z;
+		sphereRadius[idx] = sphere.getRadius();
+		boxCenterX[idx] = boxCenter.x;
+		boxCenterY[idx] = boxCenter.y;
+		boxCenterZ[idx] = boxCenter.z;
+		boxExtentX[idx] = Math::abs(boxExtents.x);
+		boxExtentY[idx] = Math::abs(boxExtents.y);
+		boxExtentZ[idx] = Math::abs(boxExtents.z);
+		cullDistanceFactor[idx] = cullInfo.cullDistanceFactor;
+	}
+
+	void CullInfoSoA::remove(UINT32 idx)
+	{
+		const UINT32 lastIdx = numEntries - 1;
+		if(idx != lastIdx)
+		{
+			layers[idx] = layers[lastIdx];
+			sphereCenterX[idx] = sphereCenterX[lastIdx];
+			sphereCenterY[idx] = sphereCenterY[lastIdx];
+			sphereCenterZ[idx] = sphereCenterZ[lastIdx];
+			sphereRadius[idx] = sphereRadius[lastIdx];
+			boxCenterX[idx] = boxCenterX[lastIdx];
+			boxCenterY[idx] = boxCenterY[lastIdx];
+			boxCenterZ[idx] = boxCenterZ[lastIdx];
+			boxExtentX[idx] = boxExtentX[lastIdx];
+			boxExtentY[idx] = boxExtentY[lastIdx];
+			boxExtentZ[idx] = boxExtentZ[lastIdx];
+			cullDistanceFactor[idx] = cullDistanceFactor[lastIdx];
+		}
+
+		// Last entry becomes padding
+		layers[lastIdx] = 0;
+		resize(lastIdx);
+	}
+
+	void CullInfoSoA::resize(UINT32 count)
+	{
+		numEntries = count;
+
+		const UINT32 paddedCount = Math::divideAndRoundUp(count, BATCH_SIZE) * BATCH_SIZE;
+		if(paddedCount == (UINT32)layers.size())
+			return;
+
+		layers.resize(paddedCount, 0);
+		sphereCenterX.resize(paddedCount, 0.0f);
+		sphereCenterY.resize(paddedCount, 0.0f);
+		sphereCenterZ.resize(paddedCount, 0.0f);
+		sphereRadius.resize(paddedCount, 0.0f);
+		boxCenterX.resize(paddedCount, 0.0f);
+		boxCenterY.resize(paddedCount, 0.0f);
+		boxCenterZ.resize(paddedCount, 0.0f);
+		boxExtentX.resize(paddedCount, 0.0f);
+		boxExtentY.resize(paddedCount, 0.0f);
+		boxExtentZ.resize(paddedCount, 0.0f);
+		cullDistanceFactor.resize(paddedCount, 0.0f);
+	}
+
+	UINT32 cullBatch(const CullInfoSoA& cullInfos, UINT32 idx, const CullView& view)
+	{
+		using namespace simd;
+
+		// Returns a bitmask with one bit set for each object that isn't culled by the provided mask
+		const auto getVisibleMask = [](const mask_float32x4& culled)
+		{
+			// Convert from one bit per byte to one bit per object
+			const UINT32 culledBytes = extract_bits<7>(bit_cast<uint8x16>(culled));
+			const UINT32 culledMask = ((culledBytes >> 3) & 0x1) | ((culledBytes >> 6) & 0x2) | 
+				((culledBytes >> 9) & 0x4) | ((culledBytes >> 12) & 0x8);
+
+			return ~culledMask & 0xF;
+		};
+
+		UINT32 visibleMask = 0;
+		for (UINT32 i = 0; i < CullInfoSoA::BATCH_SIZE; i++)
+		{
+			if ((cullInfos.layers[idx + i] & view.layers) != 0)
+				visibleMask |= 1 << i;
+		}
+
+		if (visibleMask == 0)
+			return 0;
+
+		// Note: All tests below check if the object is culled (rather than visible), so objects with NaN bounds
+		// remain visible, same as with the non-batched intersection tests
+		const float32x4 sphereX = load_u<float32x4>(&cullInfos.sphereCenterX[idx]);
+		const float32x4 sphereY = load_u<float32x4>(&cullInfos.sphereCenterY[idx]);
+		const float32x4 sphereZ = load_u<float32x4>(&cullInfos.sphereCenterZ[idx]);
+		const float32x4 sphereRadius = load_u<float32x4>(&cullInfos.sphereRadius[idx]);
+
+		// Do distance culling
+		const float32x4 toCameraX = sub(sphereX, splat<float32x4>(view.origin.x));
+		const float32x4 toCameraY = sub(sphereY, splat<float32x4>(view.origin.y));
+		const float32x4 toCameraZ = sub(sphereZ, splat<float32x4>(view.origin.z));
+		const float32x4 distanceToCameraSq = add(add(mul(toCameraX, toCameraX), mul(toCameraY, toCameraY)), 
+			mul(toCameraZ, toCameraZ));
+
+		const float32x4 cullDistanceFactor = load_u<float32x4>(&cullInfos.cullDistanceFactor[idx]);
+		const float32x4 maxDistanceToCamera = add(mul(cullDistanceFactor, splat<float32x4>(view.cullDistance)), 
+			sphereRadius);
+
+		mask_float32x4 culled = cmp_gt(distanceToCameraSq, mul(maxDistanceToCamera, maxDistanceToCamera));
+
+		visibleMask &= getVisibleMask(culled);
+		if (visibleMask == 0)
+			return 0;
+
+		// Do frustum culling
+		const float32x4 negSphereRadius = neg(sphereRadius);
+		for (auto& plane : *view.planes)
+		{
+			const float32x4 dist = sub(add(add(
+				mul(sphereX, splat<float32x4>(plane.normal.x)), 
+				mul(sphereY, splat<float32x4>(plane.normal.y))), 
+				mul(sphereZ, splat<float32x4>(plane.normal.z))), 
+				splat<float32x4>(plane.d));
+
+			culled = bit_or(culled, cmp_lt(dist, negSphereRadius));
+		}
+
+		visibleMask &= getVisibleMask(culled);
+		if (visibleMask == 0)
+			return 0;
+
+		// More precise with the box
+		const float32x4 boxX = load_u<float32x4>(&cullInfos.boxCenterX[idx]);
+		const float32x4 boxY = load_u<float32x4>(&cullInfos.boxCenterY[idx]);
+		const float32x4 boxZ = load_u<float32x4>(&cullInfos.boxCenterZ[idx]);
+		const float32x4 boxExtentX = load_u<float32x4>(&cullInfos.boxExtentX[idx]);
+		const float32x4 boxExtentY = load_u<float32x4>(&cullInfos.boxExtentY[idx]);
+		const float32x4 boxExtentZ = load_u<float32x4>(&cullInfos.boxExtentZ[idx]);
+
+		for (auto& plane : *view.planes)
+		{
+			const float32x4 dist = sub(add(add(
+				mul(boxX, splat<float32x4>(plane.normal.x)), 
+				mul(boxY, splat<float32x4>(plane.normal.y))), 
+				mul(boxZ, splat<float32x4>(plane.normal.z))), 
+				splat<float32x4>(plane.d));
+
+			const float32x4 effectiveRadius = add(add(
+				mul(boxExtentX, splat<float32x4>(Math::abs(plane.normal.x))),
+				mul(boxExtentY, splat<float32x4>(Math::abs(plane.normal.y)))),
+				mul(boxExtentZ, splat<float32x4>(Math::abs(plane.normal.z))));
+
+			culled = bit_or(culled, cmp_lt(dist, neg(effectiveRadius)));
+		}
+
+		return visibleMask & getVisibleMask(culled);
+	}
+}}
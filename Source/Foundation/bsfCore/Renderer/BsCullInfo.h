@@ -0,0 +1,92 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#pragma once
+
+#include "BsCorePrerequisites.h"
+#include "Math/BsBounds.h"
+#include "Math/BsPlane.h"
+#include "Math/BsVector3.h"
+
+namespace bs { namespace ct
+{
+	/** @addtogroup Renderer-Internal
+	 *  @{
+	 */
+
+	/** Information used for culling an object against a view. */
+	struct CullInfo
+	{
+		CullInfo(const Bounds& bounds, UINT64 layer = -1, float cullDistanceFactor = 1.0f)
+			:layer(layer), bounds(bounds), cullDistanceFactor(cullDistanceFactor)
+		{ }
+
+		UINT64 layer;
+		Bounds bounds;
+		float cullDistanceFactor;
+	};
+
+	/**
+	 * Contains the same information as a list of CullInfo%s, stored as a structure of arrays so that culling can be
+	 * performed on a batch of objects at once using SIMD instructions. The arrays are always padded to a multiple of
+	 * BATCH_SIZE. Padding entries have no layers set so they are never visible.
+	 */
+	struct BS_CORE_EXPORT CullInfoSoA
+	{
+		/** Number of objects culled together in a single batch. */
+		static constexpr UINT32 BATCH_SIZE = 4;
+
+		/** Appends a new entry to the end of the list. */
+		void add(const CullInfo& cullInfo);
+
+		/** Overwrites the data of an existing entry. */
+		void set(UINT32 idx, const CullInfo& cullInfo);
+
+		/**
+		 * Removes an entry at the specified index by moving the last entry in its place, mirroring how renderer objects
+		 * are removed from the scene.
+		 */
+		void remove(UINT32 idx);
+
+		/** Returns the number of entries, not including the padding. */
+		UINT32 size() const { return numEntries; }
+
+		Vector<UINT64> layers;
+		Vector<float> sphereCenterX;
+		Vector<float> sphereCenterY;
+		Vector<float> sphereCenterZ;
+		Vector<float> sphereRadius;
+		Vector<float> boxCenterX;
+		Vector<float> boxCenterY;
+		Vector<float> boxCenterZ;
+		Vector<float> boxExtentX;
+		Vector<float> boxExtentY;
+		Vector<float> boxExtentZ;
+		Vector<float> cullDistanceFactor;
+		UINT32 numEntries = 0;
+
+	private:
+		/** Resizes all the arrays so they can hold @p count entries, with padding. */
+		void resize(UINT32 count);
+	};
+
+	/** Information about a single view required for culling objects against it. */
+	struct CullView
+	{
+		CullView(UINT64 layers, const Vector<Plane>& planes, const Vector3& origin, float cullDistance)
+			: layers(layers), planes(&planes), origin(origin), cullDistance(cullDistance)
+		{ }
+
+		UINT64 layers;
+		const Vector<Plane>* planes;
+		Vector3 origin;
+		float cullDistance;
+	};
+
+	/**
+	 * Culls a batch of CullInfoSoA::BATCH_SIZE objects starting at @p idx against the provided view, taking into account
+	 * layers, cull distance and the view frustum. Returns a bitmask with a bit set for each visible object in the batch.
+	 */
+	BS_CORE_EXPORT UINT32 cullBatch(const CullInfoSoA& cullInfos, UINT32 idx, const CullView& view);
+
+	/** @} */
+}}
@@ -7,6 +7,9 @@
 
 namespace bs { namespace ct
 {
+	/** Number of frames a released resource is kept in the pool without being reused, before it is removed. */
+	static constexpr UINT64 MAX_UNUSED_FRAMES = 3;
+
 	PooledRenderTexture::PooledRenderTexture(GpuResourcePool* pool)
 		:mPool(pool)
 	{ }
@@ -34,28 +37,38 @@ namespace bs { namespace ct
 
 		for (auto& buffer : mBuffers)
 			buffer.second.lock()->mPool = nullptr;
+
+		mFreeTextures.clear();
+		mFreeBuffers.clear();
 	}
 
 	SPtr<PooledRenderTexture> GpuResourcePool::get(const POOLED_RENDER_TEXTURE_DESC& desc)
 	{
-		for (auto& texturePair : mTextures)
-		{
-			SPtr<PooledRenderTexture> textureData = texturePair.second.lock();
+		const size_t descHash = desc.getHash();
 
-			if (!textureData->mIsFree)
-				continue;
+		auto iterFind = mFreeTextures.find(descHash);
+		if (iterFind != mFreeTextures.end())
+		{
+			Vector<SPtr<PooledRenderTexture>>& freeTextures = iterFind->second;
+			for (auto iter = freeTextures.begin(); iter != freeTextures.end(); ++iter)
+			{
+				// Different descriptors can have the same hash
+				if ((*iter)->texture == nullptr || !matches((*iter)->texture, desc))
+					continue;
 
-			if (textureData->texture == nullptr)
-				continue;
+				SPtr<PooledRenderTexture> textureData = *iter;
+				bs_swap_and_erase(freeTextures, iter);
 
-			if (matches(textureData->texture, desc))
-			{
 				textureData->mIsFree = false;
+				markAsUsed(textureData->mMemorySize);
+
 				return textureData;
 			}
 		}
 
 		SPtr<PooledRenderTexture> newTextureData = bs_shared_ptr_new<PooledRenderTexture>(this);
+		newTextureData->mDescHash = descHash;
+		newTextureData->mMemorySize = desc.getMemorySize();
 		_registerTexture(newTextureData);
 
 		TEXTURE_DESC texDesc;
@@ -102,24 +115,31 @@ namespace bs { namespace ct
 
 	SPtr<PooledStorageBuffer> GpuResourcePool::get(const POOLED_STORAGE_BUFFER_DESC& desc)
 	{
-		for (auto& bufferPair : mBuffers)
-		{
-			SPtr<PooledStorageBuffer> bufferData = bufferPair.second.lock();
+		const size_t descHash = desc.getHash();
 
-			if (!bufferData->mIsFree)
-				continue;
+		auto iterFind = mFreeBuffers.find(descHash);
+		if (iterFind != mFreeBuffers.end())
+		{
+			Vector<SPtr<PooledStorageBuffer>>& freeBuffers = iterFind->second;
+			for (auto iter = freeBuffers.begin(); iter != freeBuffers.end(); ++iter)
+			{
+				// Different descriptors can have the same hash
+				if ((*iter)->buffer == nullptr || !matches((*iter)->buffer, desc))
+					continue;
 
-			if (bufferData->buffer == nullptr)
-				continue;
+				SPtr<PooledStorageBuffer> bufferData = *iter;
+				bs_swap_and_erase(freeBuffers, iter);
 
-			if (matches(bufferData->buffer, desc))
-			{
 				bufferData->mIsFree = false;
+				markAsUsed(bufferData->mMemorySize);
+
 				return bufferData;
 			}
 		}
 
 		SPtr<PooledStorageBuffer> newBufferData = bs_shared_ptr_new<PooledStorageBuffer>(this);
+		newBufferData->mDescHash = descHash;
+		newBufferData->mMemorySize = desc.getMemorySize();
 		_registerBuffer(newBufferData);
 
 		GPU_BUFFER_DESC bufferDesc;
@@ -136,14 +156,58 @@ namespace bs { namespace ct
 
 	void GpuResourcePool::release(const SPtr<PooledRenderTexture>& texture)
 	{
-		auto iterFind = mTextures.find(texture.get());
-		iterFind->second.lock()->mIsFree = true;
+		if (texture->mIsFree)
+			return;
+
+		texture->mIsFree = true;
+		texture->mLastUsedFrame = mFrameIdx;
+		mFreeTextures[texture->mDescHash].push_back(texture);
+		mStats.usedMemory -= texture->mMemorySize;
 	}
 
 	void GpuResourcePool::release(const SPtr<PooledStorageBuffer>& buffer)
 	{
-		auto iterFind = mBuffers.find(buffer.get());
-		iterFind->second.lock()->mIsFree = true;
+		if (buffer->mIsFree)
+			return;
+
+		buffer->mIsFree = true;
+		buffer->mLastUsedFrame = mFrameIdx;
+		mFreeBuffers[buffer->mDescHash].push_back(buffer);
+		mStats.usedMemory -= buffer->mMemorySize;
+	}
+
+	void GpuResourcePool::_beginFrame()
+	{
+		mLastFrameStats = mStats;
+		mStats.peakUsedMemory = mStats.usedMemory;
+
+		mFrameIdx++;
+		removeUnused(mFreeTextures);
+		removeUnused(mFreeBuffers);
+	}
+
+	template<class T>
+	void GpuResourcePool::removeUnused(UnorderedMap<size_t, Vector<SPtr<T>>>& freeResources)
+	{
+		for (auto iter = freeResources.begin(); iter != freeResources.end();)
+		{
+			Vector<SPtr<T>>& resources = iter->second;
+			resources.erase(std::remove_if(resources.begin(), resources.end(), [this](const SPtr<T>& resource)
+			{
+				return (mFrameIdx - resource->mLastUsedFrame) > MAX_UNUSED_FRAMES;
+			}), resources.end());
+
+			if (resources.empty())
+				iter = freeResources.erase(iter);
+			else
+				++iter;
+		}
+	}
+
+	void GpuResourcePool::markAsUsed(UINT64 memorySize)
+	{
+		mStats.usedMemory += memorySize;
+		mStats.peakUsedMemory = std::max(mStats.peakUsedMemory, mStats.usedMemory);
 	}
 
 	bool GpuResourcePool::matches(const SPtr<Texture>& texture, const POOLED_RENDER_TEXTURE_DESC& desc)
@@ -192,20 +256,42 @@ namespace bs { namespace ct
 	void GpuResourcePool::_registerTexture(const SPtr<PooledRenderTexture>& texture)
 	{
 		mTextures.insert(std::make_pair(texture.get(), texture));
+
+		mStats.allocatedMemory += texture->mMemorySize;
+		mStats.numTextures++;
+		markAsUsed(texture->mMemorySize);
 	}
 
 	void GpuResourcePool::_unregisterTexture(PooledRenderTexture* texture)
 	{
+		// Free resources are referenced by the pool, so they can only get here after being removed from the pool
+		if (!texture->mIsFree)
+			mStats.usedMemory -= texture->mMemorySize;
+
+		mStats.allocatedMemory -= texture->mMemorySize;
+		mStats.numTextures--;
+
 		mTextures.erase(texture);
 	}
 
 	void GpuResourcePool::_registerBuffer(const SPtr<PooledStorageBuffer>& buffer)
 	{
 		mBuffers.insert(std::make_pair(buffer.get(), buffer));
+
+		mStats.allocatedMemory += buffer->mMemorySize;
+		mStats.numBuffers++;
+		markAsUsed(buffer->mMemorySize);
 	}
 
 	void GpuResourcePool::_unregisterBuffer(PooledStorageBuffer* buffer)
 	{
+		// Free resources are referenced by the pool, so they can only get here after being removed from the pool
+		if (!buffer->mIsFree)
+			mStats.usedMemory -= buffer->mMemorySize;
+
+		mStats.allocatedMemory -= buffer->mMemorySize;
+		mStats.numBuffers--;
+
 		mBuffers.erase(buffer);
 	}
 
@@ -263,6 +349,43 @@ namespace bs { namespace ct
 		return desc;
 	}
 
+	UINT64 POOLED_RENDER_TEXTURE_DESC::getMemorySize() const
+	{
+		UINT32 numFaces = 1;
+		if (type == TEX_TYPE_CUBE_MAP)
+			numFaces = 6 * arraySize;
+		else if (type != TEX_TYPE_3D)
+			numFaces = arraySize;
+
+		UINT64 faceSize = 0;
+		for (UINT32 i = 0; i <= numMipLevels; i++)
+		{
+			UINT32 mipWidth, mipHeight, mipDepth;
+			PixelUtil::getSizeForMipLevel(width, height, depth, i, mipWidth, mipHeight, mipDepth);
+
+			faceSize += PixelUtil::getMemorySize(mipWidth, mipHeight, mipDepth, format);
+		}
+
+		return faceSize * numFaces * std::max(numSamples, 1U);
+	}
+
+	size_t POOLED_RENDER_TEXTURE_DESC::getHash() const
+	{
+		size_t hash = 0;
+		bs_hash_combine(hash, width);
+		bs_hash_combine(hash, height);
+		bs_hash_combine(hash, depth);
+		bs_hash_combine(hash, numSamples);
+		bs_hash_combine(hash, (UINT32)format);
+		bs_hash_combine(hash, (UINT32)flag);
+		bs_hash_combine(hash, (UINT32)type);
+		bs_hash_combine(hash, hwGamma);
+		bs_hash_combine(hash, arraySize);
+		bs_hash_combine(hash, numMipLevels);
+
+		return hash;
+	}
+
 	POOLED_STORAGE_BUFFER_DESC POOLED_STORAGE_BUFFER_DESC::createStandard(GpuBufferFormat format, UINT32 numElements,
 		GpuBufferUsage usage)
 	{
@@ -288,4 +411,24 @@ namespace bs { namespace ct
 
 		return desc;
 	}
-}}
\ No newline at end of file
+
+	UINT64 POOLED_STORAGE_BUFFER_DESC::getMemorySize() const
+	{
+		if (type == GBT_STANDARD)
+			return (UINT64)numElements * bs::GpuBuffer::getFormatSize(format);
+
+		return (UINT64)numElements * elementSize;
+	}
+
+	size_t POOLED_STORAGE_BUFFER_DESC::getHash() const
+	{
+		size_t hash = 0;
+		bs_hash_combine(hash, (UINT32)type);
+		bs_hash_combine(hash, (UINT32)format);
+		bs_hash_combine(hash, (UINT32)usage);
+		bs_hash_combine(hash, numElements);
+		bs_hash_combine(hash, elementSize);
+
+		return hash;
+	}
+}}
@@ -31,6 +31,9 @@ namespace bs { namespace ct
 
 		GpuResourcePool* mPool;
 		bool mIsFree = false;
+		size_t mDescHash = 0;
+		UINT64 mMemorySize = 0;
+		UINT64 mLastUsedFrame = 0;
 	};
 
 	/**	Contains data about a single storage buffer in the GPU resource pool. */
@@ -46,11 +49,40 @@ namespace bs { namespace ct
 
 		GpuResourcePool* mPool;
 		bool mIsFree = false;
+		size_t mDescHash = 0;
+		UINT64 mMemorySize = 0;
+		UINT64 mLastUsedFrame = 0;
+	};
+
+	/** Information about memory used by resources in a GpuResourcePool. All sizes are in bytes. */
+	struct GpuResourcePoolStats
+	{
+		/** Total size of all textures and buffers in the pool, whether in use or kept around for reuse. */
+		UINT64 allocatedMemory = 0;
+
+		/** Size of all textures and buffers currently in use (retrieved and not yet released). */
+		UINT64 usedMemory = 0;
+
+		/** 
+		 * Maximum value of @p usedMemory during the frame. This is the least amount of memory the pool requires to
+		 * provide all the resources used by the frame, given that released resources get reused.
+		 */
+		UINT64 peakUsedMemory = 0;
+
+		/** Number of textures in the pool. */
+		UINT32 numTextures = 0;
+
+		/** Number of buffers in the pool. */
+		UINT32 numBuffers = 0;
 	};
 
 	/** 
 	 * Contains a pool of textures and buffers meant to accommodate reuse of such resources for the main purpose of using
-	 * them as write targets on the GPU.
+	 * them as write targets on the GPU. Released resources are kept in buckets keyed by their descriptor, so finding a
+	 * free resource matching a descriptor doesn't depend on the number of resources in the pool.
+	 *
+	 * The pool keeps released resources alive so they can be handed out again, even if nothing else references them.
+	 * Released resources that don't get reused for a few frames are removed from the pool by _beginFrame().
 	 */
 	class BS_CORE_EXPORT GpuResourcePool : public Module<GpuResourcePool>
 	{
@@ -75,24 +107,43 @@ namespace bs { namespace ct
 
 		/**
 		 * Releases a texture previously allocated with get(const POOLED_RENDER_TEXTURE_DESC&). The texture is returned to
-		 * the pool so that it may be reused later.
+		 * the pool so that it may be reused later. The pool keeps the texture alive, so the caller may drop its reference
+		 * right away.
 		 *			
 		 * @note	
-		 * The texture will be removed from the pool if the last reference to it is deleted. Normally you would call 
-		 * release(const POOLED_RENDER_TEXTURE_DESC&) but keep a reference if you plan on using it later on.
+		 * If you keep a reference to a released texture its contents can get overwritten by whoever retrieves it next.
+		 * A texture that doesn't get retrieved for a few frames is removed from the pool, and destroyed once the last
+		 * reference to it is deleted.
 		 */
 		void release(const SPtr<PooledRenderTexture>& texture);
 
 		/**
 		 * Releases a buffer previously allocated with get(const POOLED_STORAGE_BUFFER_DESC&). The buffer is returned to the
-		 * pool so that it may be reused later.
+		 * pool so that it may be reused later. The pool keeps the buffer alive, so the caller may drop its reference right
+		 * away.
 		 *			
 		 * @note	
-		 * The buffer will be removed from the pool if the last reference to it is deleted. Normally you would call 
-		 * release(const POOLED_STORAGE_BUFFER_DESC&) but keep a reference if you plan on using it later on.
+		 * If you keep a reference to a released buffer its contents can get overwritten by whoever retrieves it next. 
+		 * A buffer that doesn't get retrieved for a few frames is removed from the pool, and destroyed once the last 
+		 * reference to it is deleted.
 		 */
 		void release(const SPtr<PooledStorageBuffer>& buffer);
 
+		/** Returns memory usage statistics for the last frame, as recorded by the last call to _beginFrame(). */
+		const GpuResourcePoolStats& getLastFrameStats() const { return mLastFrameStats; }
+
+		/** @name Internal
+		 *  @{
+		 */
+
+		/** 
+		 * Records memory usage statistics for the frame that just ended and starts tracking them for a new frame. Also
+		 * removes released resources that haven't been reused for a few frames. Should be called by the renderer once 
+		 * per frame.
+		 */
+		void _beginFrame();
+
+		/** @} */
 	private:
 		friend struct PooledRenderTexture;
 		friend struct PooledStorageBuffer;
@@ -125,8 +176,23 @@ namespace bs { namespace ct
 		 */
 		static bool matches(const SPtr<GpuBuffer>& buffer, const POOLED_STORAGE_BUFFER_DESC& desc);
 
-		Map<PooledRenderTexture*, std::weak_ptr<PooledRenderTexture>> mTextures;
-		Map<PooledStorageBuffer*, std::weak_ptr<PooledStorageBuffer>> mBuffers;
+		/** Updates memory usage statistics after a resource of the provided size was handed out by get(). */
+		void markAsUsed(UINT64 memorySize);
+
+		/** Removes resources from the provided free resource buckets if they haven't been reused for a few frames. */
+		template<class T>
+		void removeUnused(UnorderedMap<size_t, Vector<SPtr<T>>>& freeResources);
+
+		UnorderedMap<PooledRenderTexture*, std::weak_ptr<PooledRenderTexture>> mTextures;
+		UnorderedMap<PooledStorageBuffer*, std::weak_ptr<PooledStorageBuffer>> mBuffers;
+
+		// Resources that aren't in use, grouped by the hash of the descriptor they were created with
+		UnorderedMap<size_t, Vector<SPtr<PooledRenderTexture>>> mFreeTextures;
+		UnorderedMap<size_t, Vector<SPtr<PooledStorageBuffer>>> mFreeBuffers;
+		UINT64 mFrameIdx = 0;
+
+		GpuResourcePoolStats mStats;
+		GpuResourcePoolStats mLastFrameStats;
 	};
 
 	/** Structure used for creating a new pooled render texture. */
@@ -177,6 +243,12 @@ namespace bs { namespace ct
 		static POOLED_RENDER_TEXTURE_DESC createCube(PixelFormat format, UINT32 width, UINT32 height,
 			INT32 usage = TU_STATIC, UINT32 arraySize = 1);
 
+		/** Returns the amount of GPU memory required by a texture created from this descriptor, in bytes. */
+		UINT64 getMemorySize() const;
+
+		/** Returns a hash value that is equal for all descriptors with equal properties. */
+		size_t getHash() const;
+
 	private:
 		friend class GpuResourcePool;
 
@@ -218,6 +290,12 @@ namespace bs { namespace ct
 		static POOLED_STORAGE_BUFFER_DESC createStructured(UINT32 elementSize, UINT32 numElements,
 			GpuBufferUsage usage = GBU_LOADSTORE);
 
+		/** Returns the amount of GPU memory required by a buffer created from this descriptor, in bytes. */
+		UINT64 getMemorySize() const;
+
+		/** Returns a hash value that is equal for all descriptors with equal properties. */
+		size_t getHash() const;
+
 	private:
 		friend class GpuResourcePool;
 
@@ -4,12 +4,14 @@
 #include "Private/RTTI/BsGpuResourceDataRTTI.h"
 #include "CoreThread/BsCoreThread.h"
 #include "Error/BsException.h"
+#include "FileSystem/BsDataStream.h"
 
 namespace bs
 {
 	GpuResourceData::GpuResourceData(const GpuResourceData& copy)
 	{
 		mData = copy.mData;
+		mMappedData = copy.mMappedData;
 		mLocked = copy.mLocked; // TODO - This should be shared by all copies pointing to the same data?
 		mOwnsData = false;
 	}
@@ -22,6 +24,7 @@ namespace bs
 	GpuResourceData& GpuResourceData::operator=(const GpuResourceData& rhs)
 	{
 		mData = rhs.mData;
+		mMappedData = rhs.mMappedData;
 		mLocked = rhs.mLocked; // TODO - This should be shared by all copies pointing to the same data?
 		mOwnsData = false;
 
@@ -64,6 +67,8 @@ namespace bs
 
 	void GpuResourceData::freeInternalBuffer()
 	{
+		mMappedData = nullptr;
+
 		if(mData == nullptr || !mOwnsData)
 			return;
 
@@ -95,6 +100,12 @@ namespace bs
 		mOwnsData = false;
 	}
 
+	void GpuResourceData::setExternalBuffer(const SPtr<MappedFileDataStream>& stream)
+	{
+		setExternalBuffer(stream->getCurrentPtr());
+		mMappedData = stream;
+	}
+
 	void GpuResourceData::_lock() const
 	{
 		mLocked = true;
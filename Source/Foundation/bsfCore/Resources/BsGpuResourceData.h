@@ -66,6 +66,15 @@ namespace bs
 		 */
 		void setExternalBuffer(UINT8* data);
 
+		/**
+		 * Makes the internal data pointer point to the current position of a memory mapped file stream. No copying is
+		 * done, and the mapping is kept alive for as long as this object (or any of its copies) references it. Modifying
+		 * the data is allowed, as the changes are never written back to the file.
+		 *
+		 * @note	If any internal data is allocated, it is freed.
+		 */
+		void setExternalBuffer(const SPtr<MappedFileDataStream>& stream);
+
 		/** Checks if the internal buffer is locked due to some other thread using it. */
 		bool isLocked() const { return mLocked; }
 
@@ -84,6 +93,7 @@ namespace bs
 
 	private:
 		UINT8* mData = nullptr;
+		SPtr<MappedFileDataStream> mMappedData;
 		bool mOwnsData = false;
 		mutable bool mLocked = false;
 
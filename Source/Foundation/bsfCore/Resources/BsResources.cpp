@@ -386,11 +386,27 @@ namespace bs
 	SPtr<Resource> Resources::loadFromDiskAndDeserialize(const Path& filePath, bool loadWithSaveData, 
 		std::atomic<float>& progress)
 	{
-		Lock fileLock = FileScheduler::getLock(filePath);
+		SharedLock fileLock = FileScheduler::getReadLock(filePath);
+
+		// Map the file so large data blocks (e.g. texture and mesh data) can reference the mapped memory directly,
+		// instead of being read and copied. Resources keeping their source data are expected to be saved, possibly to
+		// this same file, which cannot be replaced while mapped on some platforms. Those are read normally instead, as
+		// are files that fail to map. Note that on POSIX platforms truncating the file while it is mapped raises SIGBUS
+		// on access, so resource files must only ever be replaced, never rewritten in place.
+		SPtr<DataStream> stream;
+		if (!loadWithSaveData)
+		{
+			SPtr<MappedFileDataStream> mappedStream = bs_shared_ptr_new<MappedFileDataStream>(filePath);
+			if (mappedStream->isValid())
+				stream = mappedStream;
+		}
 
-		SPtr<DataStream> stream = FileSystem::openFile(filePath, true);
 		if (stream == nullptr)
-			return nullptr;
+		{
+			stream = FileSystem::openFile(filePath, true);
+			if (stream == nullptr)
+				return nullptr;
+		}
 
 		if (stream->size() > std::numeric_limits<UINT32>::max())
 		{
@@ -422,7 +438,19 @@ namespace bs
 				UINT32 objectSize = 0;
 				stream->read(&objectSize, sizeof(objectSize));
 
-				if (metaData->getCompressionMethod() != 0)
+				const auto compressionMethod = (CompressionMethod)metaData->getCompressionMethod();
+				if (compressionMethod == CompressionMethod::Chunked)
+				{
+					// Blocks get decompressed in parallel, as the deserializer reads them
+					stream = bs_shared_ptr_new<CompressedDataStream>(stream);
+
+					BinarySerializer bs;
+					loadedData = bs.decode(stream, objectSize, &serzContext, [&progress](float val)
+					{
+						progress.exchange(val, std::memory_order_relaxed);
+					});
+				}
+				else if (compressionMethod != CompressionMethod::None)
 				{
 					stream = Compression::decompress(stream, [&progress](float val)
 					{
@@ -600,6 +628,11 @@ namespace bs
 	}
 
 	void Resources::save(const HResource& resource, const Path& filePath, bool overwrite, bool compress)
+	{
+		save(resource, filePath, overwrite, compress ? CompressionCodec::Snappy : CompressionCodec::None);
+	}
+
+	void Resources::save(const HResource& resource, const Path& filePath, bool overwrite, CompressionCodec codec)
 	{
 		if (resource == nullptr)
 			return;
@@ -632,20 +665,25 @@ namespace bs
 			mDefaultResourceManifest->registerResource(resource.getUUID(), filePath);
 		}
 
-		_save(resource.getInternalPtr(), filePath, compress);
+		_save(resource.getInternalPtr(), filePath, codec);
 	}
 
 	void Resources::save(const HResource& resource, bool compress)
+	{
+		save(resource, compress ? CompressionCodec::Snappy : CompressionCodec::None);
+	}
+
+	void Resources::save(const HResource& resource, CompressionCodec codec)
 	{
 		if (resource == nullptr)
 			return;
 
 		Path path;
 		if (getFilePathFromUUID(resource.getUUID(), path))
-			save(resource, path, true, compress);
+			save(resource, path, true, codec);
 	}
 
-	void Resources::_save(const SPtr<Resource>& resource, const Path& filePath, bool compress)
+	void Resources::_save(const SPtr<Resource>& resource, const Path& filePath, CompressionCodec codec)
 	{
 		if (!resource->mKeepSourceData)
 		{
@@ -658,9 +696,12 @@ namespace bs
 		for (UINT32 i = 0; i < (UINT32)dependencyList.size(); i++)
 			dependencyUUIDs[i] = dependencyList[i].resource.getUUID();
 
-		UINT32 compressionMethod = (compress && resource->isCompressible()) ? 1 : 0;
+		CompressionMethod compressionMethod = CompressionMethod::None;
+		if (codec != CompressionCodec::None && resource->isCompressible())
+			compressionMethod = CompressionMethod::Chunked;
+
 		SPtr<SavedResourceData> resourceData = bs_shared_ptr_new<SavedResourceData>(dependencyUUIDs, 
-			resource->allowAsyncLoading(), compressionMethod);
+			resource->allowAsyncLoading(), (UINT32)compressionMethod);
 
 		Path parentDir = filePath.getDirectory();
 		if (!FileSystem::exists(parentDir))
@@ -695,7 +736,7 @@ namespace bs
 		else
 			savePath = filePath;
 		
-		Lock fileLock = FileScheduler::getLock(filePath);
+		ExclusiveLock fileLock = FileScheduler::getLock(filePath);
 
 		std::ofstream stream;
 		stream.open(savePath.toPlatformString().c_str(), std::ios::out | std::ios::binary);
@@ -721,10 +762,10 @@ namespace bs
 			UINT8* bytes = ms.encode(resource.get(), numBytes);
 
 			SPtr<MemoryDataStream> objStream = bs_shared_ptr_new<MemoryDataStream>(bytes, numBytes);
-			if (compressionMethod != 0)
+			if (compressionMethod != CompressionMethod::None)
 			{
 				SPtr<DataStream> srcStream = std::static_pointer_cast<DataStream>(objStream);
-				objStream = Compression::compress(srcStream);
+				objStream = Compression::compressChunked(srcStream, codec);
 			}
 
 			stream.write((char*)&numBytes, sizeof(numBytes));
@@ -737,6 +778,19 @@ namespace bs
 		if (fileExists)
 		{
 			FileSystem::remove(filePath);
+
+			// Resources loaded without their source data reference the mapped file, and some platforms don't allow a 
+			// mapped file to be removed. Keep the original intact rather than leaving a partial replace.
+			if (FileSystem::exists(filePath))
+			{
+				LOGERR("Failed to replace the resource file at \"" + filePath.toString() + "\". The file might be in "
+					"use, e.g. by a resource loaded from it without ResourceLoadFlag::KeepSourceData whose data is still "
+					"referenced. Release the resource before saving over its file. The resource was not saved.");
+
+				FileSystem::remove(savePath);
+				return;
+			}
+
 			FileSystem::move(savePath, filePath);
 		}
 	}
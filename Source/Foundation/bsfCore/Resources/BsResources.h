@@ -4,6 +4,7 @@
 
 #include "BsCorePrerequisites.h"
 #include "Utility/BsModule.h"
+#include "Utility/BsCompression.h"
 
 namespace bs
 {
@@ -204,11 +205,30 @@ namespace bs
 		 * If saving a core thread resource this is a potentially very slow operation as we must wait on the core thread 
 		 * and the GPU in order to read the resource.
 		 * @note
+		 * Resources loaded without ResourceLoadFlag::KeepSourceData can reference the memory mapped file they were loaded
+		 * from. On some platforms the file cannot be overwritten while such data is alive, in which case an error is 
+		 * reported and the existing file is left intact.
+		 * @note
 		 * Thread safe if you guarantee the resource isn't being written to from another thread.
 		 */
 		BS_SCRIPT_EXPORT()
 		void save(BS_NORREF const HResource& resource, const Path& filePath, bool overwrite, bool compress = false);
 
+		/**
+		 * Saves the resource at the specified location, compressing it using the specified codec.
+		 *
+		 * @param[in]	resource 	Handle to the resource.
+		 * @param[in]	filePath 	Full pathname of the file to save as.
+		 * @param[in]	overwrite	If true, any existing resource at the specified location will be overwritten.
+		 * @param[in]	codec		Codec to compress the resource with, or CompressionCodec::None to save it 
+		 *							uncompressed. CompressionCodec::LZHuffman saves and loads slower than the default
+		 *							CompressionCodec::Snappy in exchange for a higher ratio. Ignored for resources with
+		 *							already compressed data.
+		 *
+		 * @note	See save(const HResource&, const Path&, bool, bool) for threading notes.
+		 */
+		void save(const HResource& resource, const Path& filePath, bool overwrite, CompressionCodec codec);
+
 		/**
 		 * Saves an existing resource to its previous location.
 		 *
@@ -229,6 +249,17 @@ namespace bs
 		BS_SCRIPT_EXPORT()
 		void save(BS_NORREF const HResource& resource, bool compress = false);
 
+		/**
+		 * Saves an existing resource to its previous location, compressing it using the specified codec.
+		 *
+		 * @param[in]	resource 	Handle to the resource.
+		 * @param[in]	codec		Codec to compress the resource with, or CompressionCodec::None to save it 
+		 *							uncompressed. Ignored for resources with already compressed data.
+		 *
+		 * @note	See save(const HResource&, const Path&, bool, bool) for threading notes.
+		 */
+		void save(const HResource& resource, CompressionCodec codec);
+
 		/**
 		 * Updates an existing resource handle with a new resource. Caller must ensure that new resource type matches the 
 		 * original resource type.
@@ -356,7 +387,7 @@ namespace bs
 		 * Same as save() except it saves the resource without registering it in the default manifest, requiring a handle, 
 		 * or checking for overwrite.
 		 */
-		void _save(const SPtr<Resource>& resource, const Path& filePath, bool compress);
+		void _save(const SPtr<Resource>& resource, const Path& filePath, CompressionCodec codec);
 
 		/** @} */
 	private:
@@ -123,13 +123,25 @@ namespace bs
 
 	void SceneManager::_bindActor(const SPtr<SceneActor>& actor, const HSceneObject& so)
 	{
+		_unbindActor(actor);
+
 		mBoundActors[actor.get()] = BoundActorData(actor, so);
+		so->mBoundActors.add(actor.get());
+
 		actor->_updateState(*so, true);
 	}
 
 	void SceneManager::_unbindActor(const SPtr<SceneActor>& actor)
 	{
-		mBoundActors.erase(actor.get());
+		auto iterFind = mBoundActors.find(actor.get());
+		if (iterFind == mBoundActors.end())
+			return;
+
+		const HSceneObject& so = iterFind->second.so;
+		if (!so.isDestroyed())
+			so->mBoundActors.removeValue(actor.get());
+
+		mBoundActors.erase(iterFind);
 	}
 
 	HSceneObject SceneManager::_getActorSO(const SPtr<SceneActor>& actor) const
@@ -141,6 +153,19 @@ namespace bs
 		return HSceneObject();		
 	}
 
+	void SceneManager::_notifyBoundActorsDirty(const SceneObject& so)
+	{
+		for (auto& entry : so.mBoundActors)
+		{
+			auto iterFind = mBoundActors.find(entry);
+			if (iterFind == mBoundActors.end() || iterFind->second.dirty)
+				continue;
+
+			iterFind->second.dirty = true;
+			mDirtyActors.push_back(entry);
+		}
+	}
+
 	void SceneManager::_registerCamera(const SPtr<Camera>& camera)
 	{
 		mCameras[camera.get()] = camera;
@@ -188,8 +213,19 @@ namespace bs
 
 	void SceneManager::_updateCoreObjectTransforms()
 	{
-		for (auto& entry : mBoundActors)
-			entry.second.actor->_updateState(*entry.second.so);
+		// Only visit actors whose scene objects reported a change. Actors unbound since being queued are skipped.
+		for (auto& entry : mDirtyActors)
+		{
+			auto iterFind = mBoundActors.find(entry);
+			if (iterFind == mBoundActors.end())
+				continue;
+
+			BoundActorData& data = iterFind->second;
+			data.dirty = false;
+			data.actor->_updateState(*data.so);
+		}
+
+		mDirtyActors.clear();
 	}
 
 	SPtr<Camera> SceneManager::getMainCamera() const
@@ -25,6 +25,9 @@ namespace bs
 
 		SPtr<SceneActor> actor;
 		HSceneObject so;
+
+		/** True if the actor has been queued for a state update in the next _updateCoreObjectTransforms() call. */
+		bool dirty = false;
 	};
 
 	/** Possible states components can be in. Controls which component callbacks are triggered. */
@@ -141,8 +144,8 @@ namespace bs
 		void _setRootNode(const HSceneObject& root);
 
 		/** 
-		 * Binds a scene actor with a scene object. Every frame the scene object's transform will be monitored for
-		 * changes and those changes will be automatically transfered to the actor. 
+		 * Binds a scene actor with a scene object. Whenever the scene object's transform or state changes, the changes
+		 * will be automatically transfered to the actor on the next _updateCoreObjectTransforms() call. 
 		 */
 		void _bindActor(const SPtr<SceneActor>& actor, const HSceneObject& so);
 
@@ -152,6 +155,12 @@ namespace bs
 		/** Returns a scene object bound to the provided actor, if any. */
 		HSceneObject _getActorSO(const SPtr<SceneActor>& actor) const;
 
+		/** 
+		 * Notifies the scene manager that the transform or state of a scene object with bound actors changed, queuing 
+		 * the actors for update. 
+		 */
+		void _notifyBoundActorsDirty(const SceneObject& so);
+
 		/**	Notifies the scene manager that a new camera was created. */
 		void _registerCamera(const SPtr<Camera>& camera);
 
@@ -252,6 +261,7 @@ namespace bs
 		SPtr<SceneInstance> mMainScene;
 
 		UnorderedMap<SceneActor*, BoundActorData> mBoundActors;
+		Vector<SceneActor*> mDirtyActors;
 		UnorderedMap<Camera*, SPtr<Camera>> mCameras;
 		Vector<SPtr<Camera>> mMainCameras;
 
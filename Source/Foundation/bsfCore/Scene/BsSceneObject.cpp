@@ -436,6 +436,9 @@ namespace bs
 			mDirtyHash++;
 		}
 
+		if (!mBoundActors.empty())
+			gSceneManager()._notifyBoundActorsDirty(*this);
+
 		// Only send component flags if we haven't removed them all
 		if (componentFlags != 0)
 		{
@@ -709,6 +712,9 @@ namespace bs
 		{
 			mActiveHierarchy = activeHierarchy;
 
+			if (!mBoundActors.empty())
+				gSceneManager()._notifyBoundActorsDirty(*this);
+
 			if (triggerEvents)
 			{
 				if (activeHierarchy)
@@ -313,6 +313,9 @@ namespace bs
 		mutable UINT32 mDirtyFlags = 0xFFFFFFFF;
 		mutable UINT32 mDirtyHash = 0;
 
+		/** Actors bound to this object through SceneManager::_bindActor(). Notified when the transform or state changes. */
+		SmallVector<SceneActor*, 2> mBoundActors;
+
 		/** 
 		 * Notifies components and child scene object that a transform has been changed.  
 		 * 
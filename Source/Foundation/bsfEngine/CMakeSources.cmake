@@ -75,6 +75,8 @@ set(BS_ENGINE_SRC_GUI
 	"bsfEngine/GUI/BsCGUIWidget.cpp"
 	"bsfEngine/GUI/BsGUICanvas.cpp"
 	"bsfEngine/GUI/BsGUINavGroup.cpp"
+	"bsfEngine/GUI/BsGUIGroupGrid.cpp"
+	"bsfEngine/GUI/BsGUIBatching.cpp"
 )
 
 set(BS_ENGINE_INC_PLATFORM
@@ -247,6 +249,8 @@ set(BS_ENGINE_INC_GUI
 	"bsfEngine/GUI/BsShortcutKey.h"
 	"bsfEngine/GUI/BsGUICanvas.h"
 	"bsfEngine/GUI/BsGUINavGroup.h"
+	"bsfEngine/GUI/BsGUIGroupGrid.h"
+	"bsfEngine/GUI/BsGUIBatching.h"
 )
 
 set(BS_ENGINE_SRC_NOFILTER
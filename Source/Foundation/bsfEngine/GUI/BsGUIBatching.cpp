@@ -0,0 +1,240 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#include "GUI/BsGUIBatching.h"
+#include "GUI/BsGUIGroupGrid.h"
+
+namespace bs
+{
+	/** Group of GUI render elements that can be rendered using a single draw call, as it's being built. */
+	struct GUIElementGroup
+	{
+		GUIWidget* widget;
+		UINT32 depth;
+		UINT32 minDepth;
+		Rect2I bounds;
+		FrameVector<UINT32> elements;
+	};
+
+	/** Hashes a pair of a GUI element and an index of one of its render elements. */
+	struct GUIRenderElementHash
+	{
+		size_t operator()(const std::pair<GUIElement*, UINT32>& key) const
+		{
+			size_t hash = 0;
+			bs_hash_combine(hash, key.first);
+			bs_hash_combine(hash, key.second);
+
+			return hash;
+		}
+	};
+
+	void groupGUIElements(GUIMeshElement* elements, UINT32 numElements, bool separateByWidget,
+		FrameVector<GUIMeshGroup>& groups, Vector<UINT32>& groupElements)
+	{
+		Rect2I area;
+		if (numElements > 0)
+			area = elements[0].bounds;
+
+		for (UINT32 i = 0; i < numElements; i++)
+			area.encapsulate(elements[i].bounds);
+
+		FrameVector<GUIElementGroup> elementGroups;
+		FrameUnorderedMap<UINT64, FrameVector<UINT32>> materialGroups;
+		GUIGroupGrid grid(area);
+
+		// Group the elements in such a way so that we end up with a smallest amount of
+		// meshes, without breaking back to front rendering order
+		for (UINT32 i = 0; i < numElements; i++)
+		{
+			const GUIMeshElement& elem = elements[i];
+			FrameVector<UINT32>& groupsPerMaterial = materialGroups[elem.mergeHash];
+
+			// Try to find a group this material will fit in:
+			//  - Group that has a depth value same or one below elements depth will always be a match
+			//  - Otherwise, we search higher depth values as well, but we only use them if no elements in between those depth values
+			//    overlap the current elements bounds.
+			UINT32 foundGroup = (UINT32)-1;
+
+			if (elem.allowBatching)
+			{
+				for (auto groupIter = groupsPerMaterial.rbegin(); groupIter != groupsPerMaterial.rend(); ++groupIter)
+				{
+					const UINT32 groupIdx = *groupIter;
+					const GUIElementGroup& group = elementGroups[groupIdx];
+
+					// If we separate meshes by widget, ignore any groups with widget parents other than mine
+					if (separateByWidget && group.widget != elem.widget)
+						continue;
+
+					if (group.depth == elem.depth)
+					{
+						foundGroup = groupIdx;
+						break;
+					}
+
+					const UINT32 startDepth = elem.depth;
+					const UINT32 endDepth = group.depth;
+
+					Rect2I potentialGroupBounds = group.bounds;
+					potentialGroupBounds.encapsulate(elem.bounds);
+
+					const bool foundOverlap = grid.any(potentialGroupBounds, [&](UINT32 otherIdx)
+					{
+						if (otherIdx == groupIdx)
+							return false;
+
+						const GUIElementGroup& other = elementGroups[otherIdx];
+						if ((other.minDepth >= startDepth && other.minDepth <= endDepth)
+							|| (other.depth >= startDepth && other.depth <= endDepth))
+						{
+							return other.bounds.overlaps(potentialGroupBounds);
+						}
+
+						return false;
+					});
+
+					if (!foundOverlap)
+					{
+						foundGroup = groupIdx;
+						break;
+					}
+				}
+			}
+
+			if (foundGroup == (UINT32)-1)
+			{
+				foundGroup = (UINT32)elementGroups.size();
+				elementGroups.push_back(GUIElementGroup());
+				groupsPerMaterial.push_back(foundGroup);
+
+				GUIElementGroup& group = elementGroups.back();
+				group.widget = elem.widget;
+				group.depth = elem.depth;
+				group.minDepth = elem.depth;
+				group.bounds = elem.bounds;
+				group.elements.push_back(i);
+
+				grid.insert(foundGroup, nullptr, group.bounds);
+			}
+			else
+			{
+				GUIElementGroup& group = elementGroups[foundGroup];
+
+				// It's expected that GUI element doesn't use same material for different mesh types so this should always be true
+				assert(elem.meshType == elements[group.elements[0]].meshType);
+
+				const Rect2I oldBounds = group.bounds;
+				group.bounds.encapsulate(elem.bounds);
+				group.elements.push_back(i);
+				group.minDepth = std::min(group.minDepth, elem.depth);
+
+				if (group.bounds != oldBounds)
+					grid.insert(foundGroup, &oldBounds, group.bounds);
+			}
+		}
+
+		// Sort the groups from farthest to nearest (highest depth to lowest)
+		FrameVector<UINT32> sortedGroups(elementGroups.size());
+		for (UINT32 i = 0; i < (UINT32)elementGroups.size(); i++)
+			sortedGroups[i] = i;
+
+		std::sort(sortedGroups.begin(), sortedGroups.end(), [&elementGroups](UINT32 a, UINT32 b)
+		{
+			return (elementGroups[a].depth > elementGroups[b].depth) ||
+				(elementGroups[a].depth == elementGroups[b].depth && a > b);
+		});
+
+		// Assign each element its location in the mesh buffers
+		groups.resize(elementGroups.size());
+		groupElements.clear();
+		groupElements.reserve(numElements);
+
+		UINT32 vertexOffset[2] = { 0, 0 };
+		UINT32 indexOffset[2] = { 0, 0 };
+
+		for (UINT32 i = 0; i < (UINT32)sortedGroups.size(); i++)
+		{
+			const GUIElementGroup& elementGroup = elementGroups[sortedGroups[i]];
+
+			GUIMeshGroup& group = groups[i];
+			group.firstElement = (UINT32)groupElements.size();
+			group.numElements = (UINT32)elementGroup.elements.size();
+			group.numIndices = 0;
+
+			for (auto& elemIdx : elementGroup.elements)
+			{
+				GUIMeshElement& elem = elements[elemIdx];
+				const UINT32 typeIdx = (UINT32)elem.meshType;
+
+				elem.vertexOffset = vertexOffset[typeIdx];
+				elem.indexOffset = indexOffset[typeIdx];
+
+				vertexOffset[typeIdx] += elem.numVertices;
+				indexOffset[typeIdx] += elem.numIndices;
+				group.numIndices += elem.numIndices;
+
+				groupElements.push_back(elemIdx);
+			}
+		}
+	}
+
+	void fillGUIMeshBuffers(const GUIMeshElement* elements, UINT32 numElements,
+		const Vector<GUIMeshElement>& prevElements, const GUIMeshBuffers& prevBuffers, const UINT32 (&vertexStride)[2],
+		GUIMeshBuffers& buffers, const std::function<bool(const GUIMeshElement&)>& isDirty,
+		const std::function<void(const GUIMeshElement&, GUIMeshBuffers&)>& fill)
+	{
+		UINT32 numVertices[2] = { 0, 0 };
+		UINT32 numIndices[2] = { 0, 0 };
+		for (UINT32 i = 0; i < numElements; i++)
+		{
+			numVertices[(UINT32)elements[i].meshType] += elements[i].numVertices;
+			numIndices[(UINT32)elements[i].meshType] += elements[i].numIndices;
+		}
+
+		for (UINT32 i = 0; i < 2; i++)
+		{
+			buffers.vertices[i].resize(numVertices[i] * vertexStride[i]);
+			buffers.indices[i].resize(numIndices[i]);
+		}
+
+		FrameUnorderedMap<std::pair<GUIElement*, UINT32>, UINT32, GUIRenderElementHash> prevElementLookup;
+		for (UINT32 i = 0; i < (UINT32)prevElements.size(); i++)
+		{
+			const GUIMeshElement& prevElem = prevElements[i];
+			prevElementLookup[std::make_pair(prevElem.element, prevElem.renderElement)] = i;
+		}
+
+		// Elements that didn't change can copy their vertices from the previous buffers, instead of re-generating them
+		for (UINT32 i = 0; i < numElements; i++)
+		{
+			const GUIMeshElement& elem = elements[i];
+			const UINT32 typeIdx = (UINT32)elem.meshType;
+			const UINT32 stride = vertexStride[typeIdx];
+
+			if (!isDirty(elem))
+			{
+				auto iterFind = prevElementLookup.find(std::make_pair(elem.element, elem.renderElement));
+				if (iterFind != prevElementLookup.end())
+				{
+					const GUIMeshElement& prevElem = prevElements[iterFind->second];
+					if (prevElem.meshType == elem.meshType && prevElem.numVertices == elem.numVertices &&
+						prevElem.numIndices == elem.numIndices)
+					{
+						memcpy(buffers.vertices[typeIdx].data() + elem.vertexOffset * stride,
+							prevBuffers.vertices[typeIdx].data() + prevElem.vertexOffset * stride,
+							elem.numVertices * stride);
+
+						const UINT32* srcIndices = prevBuffers.indices[typeIdx].data() + prevElem.indexOffset;
+						UINT32* dstIndices = buffers.indices[typeIdx].data() + elem.indexOffset;
+						for (UINT32 j = 0; j < elem.numIndices; j++)
+							dstIndices[j] = srcIndices[j] - prevElem.vertexOffset + elem.vertexOffset;
+
+						continue;
+					}
+				}
+			}
+
+			fill(elem, buffers);
+		}
+	}
+}
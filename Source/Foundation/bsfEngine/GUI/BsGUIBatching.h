@@ -0,0 +1,107 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Math/BsRect2I.h"
+
+namespace bs
+{
+	/** @addtogroup GUI-Internal
+	 *  @{
+	 */
+
+	/** Information about a single render element of a GUI element, as used for building the GUI meshes. */
+	struct GUIMeshElement
+	{
+		GUIElement* element = nullptr;
+		GUIWidget* widget = nullptr;
+		UINT32 renderElement = 0;
+		UINT32 depth = 0;
+		UINT64 mergeHash = 0;
+		Rect2I bounds;
+		GUIMeshType meshType = GUIMeshType::Triangle;
+		UINT32 numVertices = 0;
+		UINT32 numIndices = 0;
+
+		/** Determines can the element be grouped with other elements that have the same merge hash. */
+		bool allowBatching = true;
+
+		/** Offset of the first vertex of the render element in the vertex buffer of its mesh type. */
+		UINT32 vertexOffset = 0;
+
+		/** Offset of the first index of the render element in the index buffer of its mesh type. */
+		UINT32 indexOffset = 0;
+
+		/** Material used for rendering the element. Only valid during the mesh update. */
+		SpriteMaterial* material = nullptr;
+
+		/** Material parameters used for rendering the element. Only valid during the mesh update. */
+		const SpriteMaterialInfo* matInfo = nullptr;
+	};
+
+	/** Group of GUI render elements that are rendered together, using a single draw call. */
+	struct GUIMeshGroup
+	{
+		/** First entry in the group element list belonging to this group. */
+		UINT32 firstElement = 0;
+
+		/** Number of entries in the group element list belonging to this group. */
+		UINT32 numElements = 0;
+
+		/** Total number of indices of all the elements in the group. */
+		UINT32 numIndices = 0;
+	};
+
+	/** CPU copy of the geometry of all the GUI meshes of a single render target. */
+	struct GUIMeshBuffers
+	{
+		/** Vertices, indexed by GUIMeshType. */
+		Vector<UINT8> vertices[2];
+
+		/** Indices, indexed by GUIMeshType. */
+		Vector<UINT32> indices[2];
+	};
+
+	/**
+	 * Groups GUI render elements into as few meshes as possible without breaking back to front rendering order, and
+	 * assigns each element its location in the mesh buffers. Elements are grouped if they have the same merge hash, and
+	 * no other group between their depths overlaps them.
+	 *
+	 * @param[in, out]	elements			Render elements, sorted from farthest to nearest. Vertex and index offsets of
+	 *										the elements are assigned by this method.
+	 * @param[in]		numElements			Number of entries in the @p elements array.
+	 * @param[in]		separateByWidget	If true, elements belonging to different widgets are never grouped together.
+	 * @param[out]		groups				Groups of elements, sorted from farthest to nearest.
+	 * @param[out]		groupElements		Indices into @p elements, in the order they appear in the meshes. Each group
+	 *										references a contiguous range of entries.
+	 *
+	 * @note	Uses the frame allocator.
+	 */
+	BS_EXPORT void groupGUIElements(GUIMeshElement* elements, UINT32 numElements, bool separateByWidget,
+		FrameVector<GUIMeshGroup>& groups, Vector<UINT32>& groupElements);
+
+	/**
+	 * Fills the mesh buffers after the render elements were assigned new locations by groupGUIElements(). Elements
+	 * that aren't dirty and were present in the previous buffers with the same mesh type and size have their vertices
+	 * copied from the previous buffers, and their indices rebased to their new location. All other elements are filled
+	 * through @p fill.
+	 *
+	 * @param[in]	elements		Render elements, with their new locations.
+	 * @param[in]	numElements		Number of entries in the @p elements array.
+	 * @param[in]	prevElements	Render elements, with the locations they had in @p prevBuffers.
+	 * @param[in]	prevBuffers		Buffers filled during the previous update.
+	 * @param[in]	vertexStride	Size of a single vertex in bytes, indexed by GUIMeshType.
+	 * @param[out]	buffers			Buffers to fill. Resized to fit all the elements.
+	 * @param[in]	isDirty			Returns true if the contents of the render element changed since the previous update.
+	 * @param[in]	fill			Writes the vertices and indices of the render element at its location in the buffers.
+	 *
+	 * @note	Uses the frame allocator.
+	 */
+	BS_EXPORT void fillGUIMeshBuffers(const GUIMeshElement* elements, UINT32 numElements,
+		const Vector<GUIMeshElement>& prevElements, const GUIMeshBuffers& prevBuffers, const UINT32 (&vertexStride)[2],
+		GUIMeshBuffers& buffers, const std::function<bool(const GUIMeshElement&)>& isDirty,
+		const std::function<void(const GUIMeshElement&, GUIMeshBuffers&)>& fill);
+
+	/** @} */
+}
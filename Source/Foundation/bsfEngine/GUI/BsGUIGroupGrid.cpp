@@ -0,0 +1,48 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#include "GUI/BsGUIGroupGrid.h"
+#include "Math/BsMath.h"
+
+namespace bs
+{
+	constexpr INT32 GUIGroupGrid::NUM_CELLS;
+
+	GUIGroupGrid::GUIGroupGrid(const Rect2I& area)
+		:mArea(area), mCells(NUM_CELLS * NUM_CELLS)
+	{
+		mCellWidth = std::max(1U, Math::divideAndRoundUp(area.width, (UINT32)NUM_CELLS));
+		mCellHeight = std::max(1U, Math::divideAndRoundUp(area.height, (UINT32)NUM_CELLS));
+	}
+
+	void GUIGroupGrid::insert(UINT32 group, const Rect2I* oldBounds, const Rect2I& newBounds)
+	{
+		if (group >= (UINT32)mVisited.size())
+			mVisited.resize(group + 1, 0);
+
+		INT32 minX, minY, maxX, maxY;
+		getCellRange(newBounds, minX, minY, maxX, maxY);
+
+		INT32 oldMinX = 0, oldMinY = 0, oldMaxX = -1, oldMaxY = -1;
+		if (oldBounds != nullptr)
+			getCellRange(*oldBounds, oldMinX, oldMinY, oldMaxX, oldMaxY);
+
+		for (INT32 y = minY; y <= maxY; y++)
+		{
+			for (INT32 x = minX; x <= maxX; x++)
+			{
+				if (x >= oldMinX && x <= oldMaxX && y >= oldMinY && y <= oldMaxY)
+					continue;
+
+				mCells[y * NUM_CELLS + x].push_back(group);
+			}
+		}
+	}
+
+	void GUIGroupGrid::getCellRange(const Rect2I& bounds, INT32& minX, INT32& minY, INT32& maxX, INT32& maxY) const
+	{
+		minX = Math::clamp((bounds.x - mArea.x) / (INT32)mCellWidth, 0, NUM_CELLS - 1);
+		minY = Math::clamp((bounds.y - mArea.y) / (INT32)mCellHeight, 0, NUM_CELLS - 1);
+		maxX = Math::clamp((bounds.x + (INT32)bounds.width - mArea.x) / (INT32)mCellWidth, 0, NUM_CELLS - 1);
+		maxY = Math::clamp((bounds.y + (INT32)bounds.height - mArea.y) / (INT32)mCellHeight, 0, NUM_CELLS - 1);
+	}
+}
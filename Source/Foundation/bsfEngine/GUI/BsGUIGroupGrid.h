@@ -0,0 +1,85 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Math/BsRect2I.h"
+
+namespace bs
+{
+	/** @addtogroup GUI-Internal
+	 *  @{
+	 */
+
+	/**
+	 * Uniform grid covering the bounds of all GUI elements of a single render target, used when batching GUI elements
+	 * into meshes. Keeps track of which element groups cover which cells, so that checking a rectangle for overlapping
+	 * groups only needs to consider nearby groups instead of all of them.
+	 *
+	 * @note	Uses the frame allocator, and must be destroyed before the current frame allocator frame is cleared.
+	 */
+	class BS_EXPORT GUIGroupGrid
+	{
+	public:
+		/** Number of cells along each axis of the grid. */
+		static constexpr INT32 NUM_CELLS = 32;
+
+		/** Creates a grid covering the provided area. Bounds of all groups must lie within the area. */
+		GUIGroupGrid(const Rect2I& area);
+
+		/**
+		 * Registers the group with all the cells covered by @p newBounds that aren't covered by @p oldBounds. Group
+		 * bounds are only ever extended, so this is called with the previous bounds of the group whenever they grow, or
+		 * with null @p oldBounds when the group is first created.
+		 *
+		 * @param[in]	group		Sequential index of the group, starting at zero.
+		 * @param[in]	oldBounds	Bounds the group was registered with previously, or null if this is a new group.
+		 * @param[in]	newBounds	Current bounds of the group.
+		 */
+		void insert(UINT32 group, const Rect2I* oldBounds, const Rect2I& newBounds);
+
+		/**
+		 * Calls @p predicate once for each group registered with any of the cells covered by @p bounds, until the
+		 * predicate returns true. Returns true if the predicate returned true for any of the groups.
+		 */
+		template<class T>
+		bool any(const Rect2I& bounds, T predicate)
+		{
+			mQueryIdx++;
+
+			INT32 minX, minY, maxX, maxY;
+			getCellRange(bounds, minX, minY, maxX, maxY);
+
+			for (INT32 y = minY; y <= maxY; y++)
+			{
+				for (INT32 x = minX; x <= maxX; x++)
+				{
+					for (auto& group : mCells[y * NUM_CELLS + x])
+					{
+						if (mVisited[group] == mQueryIdx)
+							continue;
+
+						mVisited[group] = mQueryIdx;
+						if (predicate(group))
+							return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
+	private:
+		/** Returns the range of cells covered by the provided rectangle. */
+		void getCellRange(const Rect2I& bounds, INT32& minX, INT32& minY, INT32& maxX, INT32& maxY) const;
+
+		Rect2I mArea;
+		UINT32 mCellWidth;
+		UINT32 mCellHeight;
+		FrameVector<FrameVector<UINT32>> mCells;
+		FrameVector<UINT32> mVisited;
+		UINT32 mQueryIdx = 0;
+	};
+
+	/** @} */
+}
@@ -42,32 +42,6 @@ using namespace std::placeholders;
 
 namespace bs
 {
-	struct GUIGroupElement
-	{
-		GUIGroupElement()
-		{ }
-
-		GUIGroupElement(GUIElement* _element, UINT32 _renderElement)
-			:element(_element), renderElement(_renderElement)
-		{ }
-
-		GUIElement* element;
-		UINT32 renderElement;
-	};
-
-	struct GUIMaterialGroup
-	{
-		SpriteMaterial* material;
-		SpriteMaterialInfo matInfo;
-		GUIMeshType meshType;
-		UINT32 numVertices;
-		UINT32 numIndices;
-		UINT32 depth;
-		UINT32 minDepth;
-		Rect2I bounds;
-		Vector<GUIGroupElement> elements;
-	};
-
 	const UINT32 GUIManager::DRAG_DISTANCE = 3;
 	const float GUIManager::TOOLTIP_HOVER_TIME = 1.0f;
 
@@ -401,7 +375,8 @@ namespace bs
 
 				for (auto& entry : renderData.cachedMeshes)
 				{
-					const SPtr<Mesh>& mesh = entry.isLine ? renderData.lineMesh : renderData.triangleMesh;
+					const GUIMeshType meshType = entry.isLine ? GUIMeshType::Line : GUIMeshType::Triangle;
+					const SPtr<Mesh>& mesh = renderData.meshes[(UINT32)meshType];
 					if(!mesh)
 						continue;
 
@@ -452,6 +427,8 @@ namespace bs
 
 	void GUIManager::updateMeshes()
 	{
+		const UINT32 vertexStride[2] = { mTriangleVertexDesc->getVertexStride(), mLineVertexDesc->getVertexStride() };
+
 		for(auto& cachedMeshData : mCachedGUIData)
 		{
 			GUIRenderData& renderData = cachedMeshData.second;
@@ -475,267 +452,219 @@ namespace bs
 
 			bs_frame_mark();
 			{
-				// Make a list of all GUI elements, sorted from farthest to nearest (highest depth to lowest)
-				auto elemComp = [](const GUIGroupElement& a, const GUIGroupElement& b)
-				{
-					UINT32 aDepth = a.element->_getRenderElementDepth(a.renderElement);
-					UINT32 bDepth = b.element->_getRenderElementDepth(b.renderElement);
-
-					// Compare pointers just to differentiate between two elements with the same depth, their order doesn't really matter, but std::set
-					// requires all elements to be unique
-					return (aDepth > bDepth) || 
-						(aDepth == bDepth && a.element > b.element) || 
-						(aDepth == bDepth && a.element == b.element && a.renderElement > b.renderElement); 
-				};
-
-				FrameSet<GUIGroupElement, std::function<bool(const GUIGroupElement&, const GUIGroupElement&)>> allElements(elemComp);
-
+				// Make a list of all GUI render elements
+				FrameVector<GUIMeshElement> elements;
 				for (auto& widget : renderData.widgets)
 				{
-					const Vector<GUIElement*>& elements = widget->getElements();
+					const Vector<GUIElement*>& widgetElements = widget->getElements();
 
-					for (auto& element : elements)
+					for (auto& element : widgetElements)
 					{
 						if (!element->_isVisible())
 							continue;
 
+						Rect2I tfrmedBounds = element->_getClippedBounds();
+						tfrmedBounds.transform(widget->getWorldTfrm());
+
 						UINT32 numRenderElems = element->_getNumRenderElements();
 						for (UINT32 i = 0; i < numRenderElems; i++)
 						{
-							allElements.insert(GUIGroupElement(element, i));
+							GUIMeshElement entry;
+							entry.element = element;
+							entry.widget = widget;
+							entry.renderElement = i;
+							entry.depth = element->_getRenderElementDepth(i);
+							entry.bounds = tfrmedBounds;
+							entry.matInfo = &element->_getMaterial(i, &entry.material);
+							assert(entry.material != nullptr);
+
+							entry.mergeHash = entry.material->getMergeHash(*entry.matInfo);
+							entry.allowBatching = entry.material->allowBatching();
+							element->_getMeshInfo(i, entry.numVertices, entry.numIndices, entry.meshType);
+
+							elements.push_back(entry);
 						}
 					}
 				}
 
-				// Group the elements in such a way so that we end up with a smallest amount of
-				// meshes, without breaking back to front rendering order
-				FrameUnorderedMap<UINT64, FrameVector<GUIMaterialGroup>> materialGroups;
-				for (auto& elem : allElements)
+				// Sort the elements from farthest to nearest (highest depth to lowest). Elements with the same depth are
+				// sorted by address, their order doesn't really matter but it needs to be the same between updates so
+				// that the grouping can be re-used
+				std::sort(elements.begin(), elements.end(), [](const GUIMeshElement& a, const GUIMeshElement& b)
 				{
-					GUIElement* guiElem = elem.element;
-					UINT32 renderElemIdx = elem.renderElement;
-					UINT32 elemDepth = guiElem->_getRenderElementDepth(renderElemIdx);
-
-					Rect2I tfrmedBounds = guiElem->_getClippedBounds();
-					tfrmedBounds.transform(guiElem->_getParentWidget()->getWorldTfrm());
-
-					SpriteMaterial* spriteMaterial = nullptr;
-					const SpriteMaterialInfo& matInfo = guiElem->_getMaterial(renderElemIdx, &spriteMaterial);
-					assert(spriteMaterial != nullptr);
-
-					UINT64 hash = spriteMaterial->getMergeHash(matInfo);
-					FrameVector<GUIMaterialGroup>& groupsPerMaterial = materialGroups[hash];
-					
-					// Try to find a group this material will fit in:
-					//  - Group that has a depth value same or one below elements depth will always be a match
-					//  - Otherwise, we search higher depth values as well, but we only use them if no elements in between those depth values
-					//    overlap the current elements bounds.
-					GUIMaterialGroup* foundGroup = nullptr;
-
-					if(spriteMaterial->allowBatching())
-					{
-						for (auto groupIter = groupsPerMaterial.rbegin(); groupIter != groupsPerMaterial.rend(); ++groupIter)
-						{
-							// If we separate meshes by widget, ignore any groups with widget parents other than mine
-							if (mSeparateMeshesByWidget)
-							{
-								if (groupIter->elements.size() > 0)
-								{
-									GUIElement* otherElem = groupIter->elements.begin()->element; // We only need to check the first element
-									if (otherElem->_getParentWidget() != guiElem->_getParentWidget())
-										continue;
-								}
-							}
+					return (a.depth > b.depth) ||
+						(a.depth == b.depth && a.element > b.element) ||
+						(a.depth == b.depth && a.element == b.element && a.renderElement > b.renderElement);
+				});
 
-							GUIMaterialGroup& group = *groupIter;
-							if (group.depth == elemDepth)
-							{
-								foundGroup = &group;
-								break;
-							}
-							else
-							{
-								UINT32 startDepth = elemDepth;
-								UINT32 endDepth = group.depth;
-
-								Rect2I potentialGroupBounds = group.bounds;
-								potentialGroupBounds.encapsulate(tfrmedBounds);
-
-								bool foundOverlap = false;
-								for (auto& material : materialGroups)
-								{
-									for (auto& matGroup : material.second)
-									{
-										if (&matGroup == &group)
-											continue;
-
-										if ((matGroup.minDepth >= startDepth && matGroup.minDepth <= endDepth)
-											|| (matGroup.depth >= startDepth && matGroup.depth <= endDepth))
-										{
-											if (matGroup.bounds.overlaps(potentialGroupBounds))
-											{
-												foundOverlap = true;
-												break;
-											}
-										}
-									}
-								}
-
-								if (!foundOverlap)
-								{
-									foundGroup = &group;
-									break;
-								}
-							}
-						}
-					}
+				const auto isElementDirty = [](const GUIMeshElement& elem)
+				{
+					const Set<GUIElement*>& dirtyElements = elem.widget->_getDirtyElements();
+					return dirtyElements.find(elem.element) != dirtyElements.end();
+				};
 
-					if (foundGroup == nullptr)
-					{
-						groupsPerMaterial.push_back(GUIMaterialGroup());
-						foundGroup = &groupsPerMaterial[groupsPerMaterial.size() - 1];
+				// Writes vertices and indices of a render element to the location assigned to it in the buffers
+				const auto fillElement = [&vertexStride](const GUIMeshElement& elem, GUIMeshBuffers& buffers)
+				{
+					const UINT32 typeIdx = (UINT32)elem.meshType;
+					UINT8* vertices = buffers.vertices[typeIdx].data();
+					UINT32* indices = buffers.indices[typeIdx].data();
 
-						foundGroup->depth = elemDepth;
-						foundGroup->minDepth = elemDepth;
-						foundGroup->bounds = tfrmedBounds;
-						foundGroup->elements.push_back(GUIGroupElement(guiElem, renderElemIdx));
-						foundGroup->matInfo = matInfo.clone();
-						foundGroup->material = spriteMaterial;
+					elem.element->_fillBuffer(vertices, indices, elem.vertexOffset, elem.indexOffset,
+						(UINT32)buffers.vertices[typeIdx].size() / vertexStride[typeIdx],
+						(UINT32)buffers.indices[typeIdx].size(), elem.renderElement);
 
-						guiElem->_getMeshInfo(renderElemIdx, foundGroup->numVertices, foundGroup->numIndices, foundGroup->meshType);
-					}
-					else
-					{
-						foundGroup->bounds.encapsulate(tfrmedBounds);
-						foundGroup->elements.push_back(GUIGroupElement(guiElem, renderElemIdx));
-						foundGroup->minDepth = std::min(foundGroup->minDepth, elemDepth);
-						
-						UINT32 numVertices;
-						UINT32 numIndices;
-						GUIMeshType meshType;
-						guiElem->_getMeshInfo(renderElemIdx, numVertices, numIndices, meshType);
-						assert(meshType == foundGroup->meshType); // It's expected that GUI element doesn't use same material for different mesh types so this should always be true
-
-						foundGroup->numVertices += numVertices;
-						foundGroup->numIndices += numIndices;
-
-						spriteMaterial->merge(foundGroup->matInfo, matInfo);
-					}
-				}
+					const UINT32 indexEnd = elem.indexOffset + elem.numIndices;
+					for (UINT32 i = elem.indexOffset; i < indexEnd; i++)
+						indices[i] += elem.vertexOffset;
+				};
 
-				// Make a list of all GUI elements, sorted from farthest to nearest (highest depth to lowest)
-				auto groupComp = [](GUIMaterialGroup* a, GUIMaterialGroup* b)
+				// If none of the elements changed in a way that influences how they're grouped or where their vertices
+				// are placed, re-use the groups from the last update and only re-fill the elements that changed
+				bool groupingChanged = elements.size() != renderData.elements.size();
+				for (UINT32 i = 0; i < (UINT32)elements.size() && !groupingChanged; i++)
 				{
-					return (a->depth > b->depth) || (a->depth == b->depth && a > b);
-					// Compare pointers just to differentiate between two elements with the same depth, their order doesn't really matter, but std::set
-					// requires all elements to be unique
-				};
+					const GUIMeshElement& a = elements[i];
+					const GUIMeshElement& b = renderData.elements[i];
 
-				UINT32 numMeshes = 0;
-				UINT32 numIndices[2] = { 0, 0 };
-				UINT32 numVertices[2] = { 0, 0 };
+					groupingChanged = a.element != b.element || a.widget != b.widget ||
+						a.renderElement != b.renderElement || a.depth != b.depth || a.mergeHash != b.mergeHash ||
+						a.bounds != b.bounds || a.meshType != b.meshType || a.numVertices != b.numVertices ||
+						a.numIndices != b.numIndices;
+				}
 
-				FrameSet<GUIMaterialGroup*, std::function<bool(GUIMaterialGroup*, GUIMaterialGroup*)>> sortedGroups(groupComp);
-				for(auto& material : materialGroups)
+				if (!groupingChanged)
 				{
-					for(auto& group : material.second)
+					for (UINT32 i = 0; i < (UINT32)elements.size(); i++)
 					{
-						sortedGroups.insert(&group);
-
-						UINT32 typeIdx = (UINT32)group.meshType;
-						numIndices[typeIdx] += group.numIndices;
-						numVertices[typeIdx] += group.numVertices;
-
-						numMeshes++;
+						elements[i].vertexOffset = renderData.elements[i].vertexOffset;
+						elements[i].indexOffset = renderData.elements[i].indexOffset;
 					}
-				}
-
-				renderData.triangleMesh = nullptr;
-				renderData.lineMesh = nullptr;
 
-				renderData.cachedMeshes.resize(numMeshes);
-
-				SPtr<MeshData> meshData[2];
-				SPtr<VertexDataDesc> vertexDesc[2] = { mTriangleVertexDesc, mLineVertexDesc };
+					// Material properties that aren't a part of the merge hash might have changed, so the per-mesh
+					// material data needs to be refreshed
+					for (auto& meshData : renderData.cachedMeshes)
+					{
+						const GUIMeshElement& firstElem = elements[renderData.groupElements[meshData.firstElement]];
+						meshData.matInfo = firstElem.matInfo->clone();
 
-				UINT8* vertices[2] = { nullptr, nullptr };
-				UINT32* indices[2] = { nullptr, nullptr };
+						for (UINT32 i = 1; i < meshData.numElements; i++)
+						{
+							const GUIMeshElement& elem = elements[renderData.groupElements[meshData.firstElement + i]];
+							elem.material->merge(meshData.matInfo, *elem.matInfo);
+						}
+					}
 
-				for(UINT32 i = 0; i < 2; i++)
-				{
-					if(numVertices[i] > 0 && numIndices[i] > 0)
+					for (auto& elem : elements)
 					{
-						meshData[i] = MeshData::create(numVertices[i], numIndices[i], vertexDesc[i]);
-
-						vertices[i] = meshData[i]->getElementData(VES_POSITION);
-						indices[i] = meshData[i]->getIndices32();
+						if (isElementDirty(elem))
+							fillElement(elem, renderData.buffers);
 					}
 				}
+				else
+				{
+					groupElements(renderData, elements);
 
-				// Fill buffers for each group and update their meshes
-				UINT32 meshIdx = 0;
-				UINT32 vertexOffset[2] = { 0, 0 };
-				UINT32 indexOffset[2] = { 0, 0 };
+					// Elements that didn't change copy their vertices from the previous buffers, instead of re-generating
+					// them
+					GUIMeshBuffers prevBuffers;
+					std::swap(prevBuffers, renderData.buffers);
 
-				for(auto& group : sortedGroups)
-				{
-					GUIWidget* widget;
+					fillGUIMeshBuffers(elements.data(), (UINT32)elements.size(), renderData.elements, prevBuffers,
+						vertexStride, renderData.buffers, isElementDirty, fillElement);
+				}
 
-					if (group->elements.size() == 0)
-						widget = nullptr;
-					else
-					{
-						GUIElement* elem = group->elements.begin()->element;
-						widget = elem->_getParentWidget();
-					}
+				renderData.elements.assign(elements.begin(), elements.end());
 
-					GUIMeshData& guiMeshData = renderData.cachedMeshes[meshIdx];
-					guiMeshData.matInfo = group->matInfo;
-					guiMeshData.material = group->material;
-					guiMeshData.widget = widget;
-					guiMeshData.isLine = group->meshType == GUIMeshType::Line;
+				for (auto& widget : renderData.widgets)
+					widget->_clearDirtyElements();
 
-					UINT32 typeIdx = (UINT32)group->meshType;
-					guiMeshData.indexOffset = indexOffset[typeIdx];
+				updateGPUMeshes(renderData);
+			}
 
-					UINT32 groupNumIndices = 0;
-					for(auto& matElement : group->elements)
-					{
-						matElement.element->_fillBuffer(
-							vertices[typeIdx], indices[typeIdx], 
-							vertexOffset[typeIdx], indexOffset[typeIdx], 
-							numVertices[typeIdx], numIndices[typeIdx], matElement.renderElement);
+			bs_frame_clear();
+		}
+	}
 
-						UINT32 elemNumVertices;
-						UINT32 elemNumIndices;
-						GUIMeshType meshType;
-						matElement.element->_getMeshInfo(matElement.renderElement, elemNumVertices, elemNumIndices, meshType);
+	void GUIManager::groupElements(GUIRenderData& renderData, FrameVector<GUIMeshElement>& elements)
+	{
+		FrameVector<GUIMeshGroup> groups;
+		groupGUIElements(elements.data(), (UINT32)elements.size(), mSeparateMeshesByWidget, groups,
+			renderData.groupElements);
 
-						UINT32 indexStart = indexOffset[typeIdx];
-						UINT32 indexEnd = indexStart + elemNumIndices;
+		renderData.cachedMeshes.resize(groups.size());
+		for (UINT32 i = 0; i < (UINT32)groups.size(); i++)
+		{
+			const GUIMeshGroup& group = groups[i];
+			const GUIMeshElement& firstElem = elements[renderData.groupElements[group.firstElement]];
+
+			GUIMeshData& guiMeshData = renderData.cachedMeshes[i];
+			guiMeshData.matInfo = firstElem.matInfo->clone();
+			guiMeshData.material = firstElem.material;
+			guiMeshData.widget = firstElem.widget;
+			guiMeshData.isLine = firstElem.meshType == GUIMeshType::Line;
+			guiMeshData.indexOffset = firstElem.indexOffset;
+			guiMeshData.indexCount = group.numIndices;
+			guiMeshData.firstElement = group.firstElement;
+			guiMeshData.numElements = group.numElements;
+
+			for (UINT32 j = 1; j < group.numElements; j++)
+			{
+				const GUIMeshElement& elem = elements[renderData.groupElements[group.firstElement + j]];
+				elem.material->merge(guiMeshData.matInfo, *elem.matInfo);
+			}
+		}
+	}
 
-						for(UINT32 i = indexStart; i < indexEnd; i++)
-							indices[typeIdx][i] += vertexOffset[typeIdx];
+	void GUIManager::updateGPUMeshes(GUIRenderData& renderData)
+	{
+		const SPtr<VertexDataDesc> vertexDesc[2] = { mTriangleVertexDesc, mLineVertexDesc };
+		const DrawOperationType drawOp[2] = { DOT_TRIANGLE_LIST, DOT_LINE_LIST };
 
-						indexOffset[typeIdx] += elemNumIndices;
-						vertexOffset[typeIdx] += elemNumVertices;
+		for (UINT32 i = 0; i < 2; i++)
+		{
+			const Vector<UINT8>& vertices = renderData.buffers.vertices[i];
+			const Vector<UINT32>& indices = renderData.buffers.indices[i];
 
-						groupNumIndices += elemNumIndices;
-					}
+			const auto numVertices = (UINT32)(vertices.size() / vertexDesc[i]->getVertexStride());
+			const auto numIndices = (UINT32)indices.size();
 
-					guiMeshData.indexCount = groupNumIndices;
+			// Keep any existing mesh around even if it's not used, so it can be re-used once elements of that type appear
+			if (numVertices == 0 || numIndices == 0)
+				continue;
 
-					meshIdx++;
-				}
+			SPtr<Mesh>& mesh = renderData.meshes[i];
+			if (mesh != nullptr)
+			{
+				const MeshProperties& props = mesh->getProperties();
+				if (props.getNumVertices() < numVertices || props.getNumIndices() < numIndices)
+					mesh = nullptr;
+			}
 
-				if(meshData[0])
-					renderData.triangleMesh = Mesh::_createPtr(meshData[0], MU_STATIC, DOT_TRIANGLE_LIST);
+			if (mesh != nullptr)
+			{
+				SPtr<MeshData> meshData = MeshData::create(numVertices, numIndices, vertexDesc[i]);
+				memcpy(meshData->getStreamData(0), vertices.data(), vertices.size());
+				memcpy(meshData->getIndices32(), indices.data(), numIndices * sizeof(UINT32));
 
-				if(meshData[1])
-					renderData.lineMesh = Mesh::_createPtr(meshData[1], MU_STATIC, DOT_LINE_LIST);
+				mesh->writeData(meshData, true);
 			}
+			else
+			{
+				// Leave room for growth, so small changes in the number of elements don't require a new mesh
+				const UINT32 maxVertices = numVertices + numVertices / 2;
+				const UINT32 maxIndices = numIndices + numIndices / 2;
 
-			bs_frame_clear();
+				SPtr<MeshData> meshData = MeshData::create(maxVertices, maxIndices, vertexDesc[i]);
+				memcpy(meshData->getStreamData(0), vertices.data(), vertices.size());
+				memcpy(meshData->getIndices32(), indices.data(), numIndices * sizeof(UINT32));
+
+				MESH_DESC desc;
+				desc.usage = MU_DYNAMIC;
+				desc.subMeshes.push_back(SubMesh(0, maxIndices, drawOp[i]));
+
+				mesh = Mesh::_createPtr(meshData, desc);
+			}
 		}
 	}
 
@@ -16,6 +16,8 @@
 #include "Material/BsMaterialParam.h"
 #include "Renderer/BsParamBlocks.h"
 #include "RenderAPI/BsSubMesh.h"
+#include "Math/BsRect2I.h"
+#include "GUI/BsGUIBatching.h"
 
 namespace bs
 {
@@ -58,6 +60,12 @@ namespace bs
 			SpriteMaterialInfo matInfo;
 			GUIWidget* widget;
 			bool isLine;
+
+			/** First entry in GUIRenderData::groupElements belonging to this mesh. */
+			UINT32 firstElement = 0;
+
+			/** Number of entries in GUIRenderData::groupElements belonging to this mesh. */
+			UINT32 numElements = 0;
 		};
 
 		/**	GUI render data for a single viewport. */
@@ -67,11 +75,23 @@ namespace bs
 				:isDirty(true)
 			{ }
 
-			SPtr<Mesh> triangleMesh;
-			SPtr<Mesh> lineMesh;
+			/** Meshes containing all the GUI geometry of the viewport, indexed by GUIMeshType. */
+			SPtr<Mesh> meshes[2];
 			Vector<GUIMeshData> cachedMeshes;
 			Vector<GUIWidget*> widgets;
 			bool isDirty;
+
+			/**
+			 * Render elements from the last mesh update, sorted from farthest to nearest. Used for detecting whether the
+			 * grouping of elements needs to be recalculated, and for finding vertices that can be reused.
+			 */
+			Vector<GUIMeshElement> elements;
+
+			/** Indices into @p elements, in the order they appear in the meshes. */
+			Vector<UINT32> groupElements;
+
+			/** CPU copy of the geometry in @p meshes. */
+			GUIMeshBuffers buffers;
 		};
 
 		/**	Render data for a single GUI group used for notifying the core GUI renderer. */
@@ -246,6 +266,16 @@ namespace bs
 		/**	Recreates all dirty GUI meshes and makes them ready for rendering. */
 		void updateMeshes();
 
+		/**
+		 * Groups the render elements into as few meshes as possible without breaking back to front rendering order, and
+		 * assigns each element its location in the mesh buffers. Populates GUIRenderData::cachedMeshes and
+		 * GUIRenderData::groupElements.
+		 */
+		void groupElements(GUIRenderData& renderData, FrameVector<GUIMeshElement>& elements);
+
+		/** Uploads the CPU copy of the GUI vertices and indices to the GPU meshes, creating or growing them if needed. */
+		void updateGPUMeshes(GUIRenderData& renderData);
+
 		/**	Recreates the input caret texture. */
 		void updateCaretTexture();
 
@@ -78,6 +78,7 @@ namespace bs
 
 		mElements.clear();
 		mDirtyContents.clear();
+		mDirtyElements.clear();
 	}
 
 	void GUIWidget::setDepth(UINT8 depth)
@@ -267,6 +268,7 @@ namespace bs
 		if (elem->_getType() == GUIElementBase::Type::Element)
 		{
 			mElements.push_back(static_cast<GUIElement*>(elem));
+			mDirtyElements.insert(static_cast<GUIElement*>(elem));
 			mWidgetIsDirty = true;
 		}
 	}
@@ -284,11 +286,17 @@ namespace bs
 		}
 
 		if (elem->_getType() == GUIElementBase::Type::Element)
+		{
 			mDirtyContents.erase(static_cast<GUIElement*>(elem));
+			mDirtyElements.erase(static_cast<GUIElement*>(elem));
+		}
 	}
 
 	void GUIWidget::_markMeshDirty(GUIElementBase* elem)
 	{
+		if (elem->_getType() == GUIElementBase::Type::Element)
+			mDirtyElements.insert(static_cast<GUIElement*>(elem));
+
 		mWidgetIsDirty = true;
 	}
 
@@ -355,7 +363,10 @@ namespace bs
 				mDirtyContentsTemp.swap(mDirtyContents);
 
 				for (auto& dirtyElement : mDirtyContentsTemp)
+				{
 					dirtyElement->_updateRenderElements();
+					mDirtyElements.insert(dirtyElement);
+				}
 
 				mDirtyContentsTemp.clear();
 			}
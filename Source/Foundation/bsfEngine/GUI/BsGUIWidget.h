@@ -133,6 +133,15 @@ namespace bs
 		 */
 		void _markContentDirty(GUIElementBase* elem);
 
+		/**
+		 * Returns elements whose mesh data might have changed since the last call to _clearDirtyElements(), either
+		 * because their contents or their layout changed, or because they were newly registered.
+		 */
+		const Set<GUIElement*>& _getDirtyElements() const { return mDirtyElements; }
+
+		/** Clears the list of elements returned by _getDirtyElements(). */
+		void _clearDirtyElements() { mDirtyElements.clear(); }
+
 		/**	Updates the layout of all child elements, repositioning and resizing them as needed. */
 		void _updateLayout();
 
@@ -196,6 +205,7 @@ namespace bs
 
 		Set<GUIElement*> mDirtyContents;
 		Set<GUIElement*> mDirtyContentsTemp;
+		Set<GUIElement*> mDirtyElements;
 
 		mutable UINT64 mCachedRTId;
 		mutable bool mWidgetIsDirty;
@@ -6,11 +6,90 @@
 #include "Mesh/BsMesh.h"
 #include "Material/BsMaterial.h"
 #include "Renderer/BsRenderElement.h"
-
-using namespace std::placeholders;
+#include "Utility/BsBitwise.h"
 
 namespace bs { namespace ct
 {
+	/** Minimum number of bits the distance must be quantized to, for the sort keys to be used. */
+	static constexpr UINT32 MIN_DISTANCE_BITS = 16;
+
+	/** Returns the number of bits required to store values in range [0, @p maxValue]. */
+	static UINT32 getNumBits(UINT64 maxValue)
+	{
+		if (maxValue == 0)
+			return 0;
+
+		return Bitwise::mostSignificantBit(maxValue) + 1;
+	}
+
+	/** Shifts the value to the left, allowing shifts by the full width of the type (for fields with zero width). */
+	static UINT64 shiftField(UINT64 value, UINT32 shift)
+	{
+		return shift < 64 ? (value << shift) : 0;
+	}
+
+	/** Maps a float to an unsigned integer that retains the ordering of the float values when compared. */
+	static UINT32 floatToOrderedUInt(float value)
+	{
+		// Treat -0 the same as 0
+		if (value == 0.0f)
+			value = 0.0f;
+
+		UINT32 bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		// Flip all bits of negative numbers (reverses their order), and just the sign bit of positive ones
+		return bits ^ ((bits & 0x80000000) ? 0xFFFFFFFF : 0x80000000);
+	}
+
+	/** 
+	 * Sorts the keys in ascending order using a stable LSD radix sort, a byte at a time. Bytes that are the same for all
+	 * keys are skipped. @p scratch must be the same size as @p keys.
+	 */
+	template<class T>
+	static void radixSort(Vector<T>& keys, Vector<T>& scratch)
+	{
+		const auto numKeys = (UINT32)keys.size();
+		if (numKeys < 2)
+			return;
+
+		UINT32 histograms[8][256];
+		bs_zero_out(histograms);
+
+		for (auto& entry : keys)
+		{
+			for (UINT32 i = 0; i < 8; i++)
+				histograms[i][(entry.key >> (i * 8)) & 0xFF]++;
+		}
+
+		T* src = keys.data();
+		T* dst = scratch.data();
+		for (UINT32 i = 0; i < 8; i++)
+		{
+			const UINT32 shift = i * 8;
+			UINT32* histogram = histograms[i];
+
+			if (histogram[(src[0].key >> shift) & 0xFF] == numKeys)
+				continue;
+
+			UINT32 offset = 0;
+			for (UINT32 j = 0; j < 256; j++)
+			{
+				const UINT32 count = histogram[j];
+				histogram[j] = offset;
+				offset += count;
+			}
+
+			for (UINT32 j = 0; j < numKeys; j++)
+				dst[histogram[(src[j].key >> shift) & 0xFF]++] = src[j];
+
+			std::swap(src, dst);
+		}
+
+		if (src != keys.data())
+			memcpy(keys.data(), src, numKeys * sizeof(T));
+	}
+
 	RenderQueue::RenderQueue(StateReduction mode)
 		:mStateReductionMode(mode)
 	{
@@ -21,6 +100,7 @@ namespace bs { namespace ct
 	{
 		mSortableElements.clear();
 		mSortableElementIdx.clear();
+		mSortKeys.clear();
 		mElements.clear();
 
 		mSortedRenderElements.clear();
@@ -73,23 +153,8 @@ namespace bs { namespace ct
 
 	void RenderQueue::sort()
 	{
-		std::function<bool(UINT32, UINT32, const Vector<SortableElement>&)> sortMethod;
-
-		switch (mStateReductionMode)
-		{
-		case StateReduction::None:
-			sortMethod = &elementSorterNoGroup;
-			break;
-		case StateReduction::Material:
-			sortMethod = &elementSorterPreferGroup;
-			break;
-		case StateReduction::Distance:
-			sortMethod = &elementSorterPreferDistance;
-			break;
-		}
-
 		// Sort only indices since we generate an entirely new data set anyway, it doesn't make sense to move sortable elements
-		std::sort(mSortableElementIdx.begin(), mSortableElementIdx.end(), std::bind(sortMethod, _1, _2, mSortableElements));
+		sortIndices();
 
 		UINT32 prevShaderId = (UINT32)-1;
 		UINT32 prevTechniqueIdx = (UINT32)-1;
@@ -147,6 +212,114 @@ namespace bs { namespace ct
 		}
 	}
 
+	void RenderQueue::sortIndices()
+	{
+		if (!generateSortKeys())
+		{
+			sortIndicesComparison();
+			return;
+		}
+
+		mSortKeysScratch.resize(mSortKeys.size());
+		radixSort(mSortKeys, mSortKeysScratch);
+
+		for (UINT32 i = 0; i < (UINT32)mSortKeys.size(); i++)
+			mSortableElementIdx[i] = mSortKeys[i].idx;
+	}
+
+	void RenderQueue::sortIndicesComparison()
+	{
+		const Vector<SortableElement>& lookup = mSortableElements;
+		switch (mStateReductionMode)
+		{
+		case StateReduction::None:
+			std::sort(mSortableElementIdx.begin(), mSortableElementIdx.end(), 
+				[&lookup](UINT32 a, UINT32 b) { return elementSorterNoGroup(a, b, lookup); });
+			break;
+		case StateReduction::Material:
+			std::sort(mSortableElementIdx.begin(), mSortableElementIdx.end(), 
+				[&lookup](UINT32 a, UINT32 b) { return elementSorterPreferGroup(a, b, lookup); });
+			break;
+		case StateReduction::Distance:
+			std::sort(mSortableElementIdx.begin(), mSortableElementIdx.end(), 
+				[&lookup](UINT32 a, UINT32 b) { return elementSorterPreferDistance(a, b, lookup); });
+			break;
+		}
+	}
+
+	bool RenderQueue::generateSortKeys()
+	{
+		const auto numElements = (UINT32)mSortableElements.size();
+		mSortKeys.resize(numElements);
+
+		if (numElements == 0)
+			return true;
+
+		// Find the range of values of each field, to determine how many bits they require
+		INT32 minPriority = std::numeric_limits<INT32>::max();
+		INT32 maxPriority = std::numeric_limits<INT32>::min();
+		UINT32 minShaderId = std::numeric_limits<UINT32>::max();
+		UINT32 maxShaderId = 0;
+		UINT32 maxTechniqueIdx = 0;
+		UINT32 maxPassIdx = 0;
+
+		for (auto& entry : mSortableElements)
+		{
+			minPriority = std::min(minPriority, entry.priority);
+			maxPriority = std::max(maxPriority, entry.priority);
+			minShaderId = std::min(minShaderId, entry.shaderId);
+			maxShaderId = std::max(maxShaderId, entry.shaderId);
+			maxTechniqueIdx = std::max(maxTechniqueIdx, entry.techniqueIdx);
+			maxPassIdx = std::max(maxPassIdx, entry.passIdx);
+		}
+
+		const UINT32 priorityBits = getNumBits((UINT64)((INT64)maxPriority - (INT64)minPriority));
+		const UINT32 passBits = getNumBits(maxPassIdx);
+		const UINT32 techniqueBits = getNumBits(maxTechniqueIdx);
+		const UINT32 shaderBits = getNumBits(maxShaderId - minShaderId);
+
+		UINT32 materialBits = 0;
+		if (mStateReductionMode != StateReduction::None)
+			materialBits = shaderBits + techniqueBits + passBits;
+
+		if (priorityBits + materialBits + MIN_DISTANCE_BITS > 64)
+			return false;
+
+		const UINT32 distanceBits = std::min(32U, 64 - priorityBits - materialBits);
+
+		UINT32 distanceShift = 0;
+		UINT32 materialShift = 0;
+		if (mStateReductionMode == StateReduction::Material)
+			materialShift = distanceBits;
+		else
+			distanceShift = materialBits;
+
+		const UINT32 priorityShift = distanceBits + materialBits;
+
+		for (UINT32 i = 0; i < numElements; i++)
+		{
+			const SortableElement& elem = mSortableElements[i];
+
+			// Higher priority elements go first
+			const auto priority = (UINT64)((INT64)maxPriority - (INT64)elem.priority);
+			const UINT64 distance = floatToOrderedUInt(elem.distFromCamera) >> (32 - distanceBits);
+
+			UINT64 material = 0;
+			if (mStateReductionMode != StateReduction::None)
+			{
+				material = shiftField(elem.shaderId - minShaderId, techniqueBits + passBits) |
+					shiftField(elem.techniqueIdx, passBits) | elem.passIdx;
+			}
+
+			SortKey& sortKey = mSortKeys[i];
+			sortKey.key = shiftField(priority, priorityShift) | shiftField(distance, distanceShift) | 
+				shiftField(material, materialShift);
+			sortKey.idx = i;
+		}
+
+		return true;
+	}
+
 	bool RenderQueue::elementSorterNoGroup(UINT32 aIdx, UINT32 bIdx, const Vector<SortableElement>& lookup)
 	{
 		const SortableElement& a = lookup[aIdx];
@@ -38,17 +38,6 @@ namespace bs { namespace ct
 	 */
 	class BS_EXPORT RenderQueue
 	{
-		/**	Data used for renderable element sorting. Represents a single pass for a single mesh. */
-		struct SortableElement
-		{
-			UINT32 seqIdx;
-			INT32 priority;
-			float distFromCamera;
-			UINT32 shaderId;
-			UINT32 techniqueIdx;
-			UINT32 passIdx;
-		};
-
 	public:
 		RenderQueue(StateReduction grouping = StateReduction::Distance);
 		virtual ~RenderQueue() = default;
@@ -79,6 +68,46 @@ namespace bs { namespace ct
 		void setStateReduction(StateReduction mode) { mStateReductionMode = mode; }
 
 	protected:
+		/**	Data used for renderable element sorting. Represents a single pass for a single mesh. */
+		struct SortableElement
+		{
+			UINT32 seqIdx;
+			INT32 priority;
+			float distFromCamera;
+			UINT32 shaderId;
+			UINT32 techniqueIdx;
+			UINT32 passIdx;
+		};
+
+		/** Sort key of a single sortable element, containing all of its sort criteria packed in a single integer. */
+		struct SortKey
+		{
+			UINT64 key;
+			UINT32 idx;
+		};
+
+		/**
+		 * Sorts the indices in @p mSortableElementIdx according to the current state reduction mode. Packs the sort
+		 * criteria of every element into a 64-bit key and sorts the keys using a radix sort, falling back to
+		 * sortIndicesComparison() if the criteria cannot be packed.
+		 */
+		void sortIndices();
+
+		/** Sorts the indices in @p mSortableElementIdx by comparing individual sort criteria of the elements. */
+		void sortIndicesComparison();
+
+		/**
+		 * Populates @p mSortKeys with a key for each sortable element. The layout of the key depends on the state 
+		 * reduction mode, but from most to least significant bits it always contains the queue priority, followed by
+		 * the distance and the material (shader, technique and pass) in the order determined by the mode (material is
+		 * left out if not grouping by material). Widths of the fields are determined from the range of values present
+		 * in the queue, and the distance is quantized to the bits left over. Sequential index is not part of the key
+		 * since the radix sort is stable.
+		 *
+		 * @return		False if the fields cannot fit in 64 bits, in which case the keys cannot be used for sorting.
+		 */
+		bool generateSortKeys();
+
 		/**	Callback used for sorting elements with no material grouping. */
 		static bool elementSorterNoGroup(UINT32 aIdx, UINT32 bIdx, const Vector<SortableElement>& lookup);
 
@@ -90,6 +119,8 @@ namespace bs { namespace ct
 
 		Vector<SortableElement> mSortableElements;
 		Vector<UINT32> mSortableElementIdx;
+		Vector<SortKey> mSortKeys;
+		Vector<SortKey> mSortKeysScratch;
 		Vector<const RenderElement*> mElements;
 
 		Vector<RenderQueueElement> mSortedRenderElements;
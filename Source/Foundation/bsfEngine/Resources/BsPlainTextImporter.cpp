@@ -24,7 +24,7 @@ namespace bs
 	{
 		WString textData;
 		{
-			Lock fileLock = FileScheduler::getLock(filePath);
+			SharedLock fileLock = FileScheduler::getReadLock(filePath);
 
 			SPtr<DataStream> stream = FileSystem::openFile(filePath);
 			textData = stream->getAsWString();
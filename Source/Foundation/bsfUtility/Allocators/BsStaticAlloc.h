@@ -123,7 +123,7 @@ namespace bs
 			mTotalAllocBytes -= *storedSize;
 #endif
 
-			if(data > mStaticData && data < (mStaticData + BlockSize))
+			if(data >= mStaticData && data < (mStaticData + BlockSize))
 			{
 				if((((UINT8*)data) + allocSize) == (mStaticData + mFreePtr))
 					mFreePtr -= allocSize;
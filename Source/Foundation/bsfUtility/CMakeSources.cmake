@@ -4,6 +4,7 @@ set(BS_UTILITY_INC_THREADING
 	"bsfUtility/Threading/BsSpinLock.h"
 	"bsfUtility/Threading/BsThreadPool.h"
 	"bsfUtility/Threading/BsTaskScheduler.h"
+	"bsfUtility/Threading/BsWorkStealingDeque.h"
 )
 
 set(BS_UTILITY_SRC_THIRDPARTY
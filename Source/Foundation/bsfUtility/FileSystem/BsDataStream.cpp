@@ -4,6 +4,15 @@
 #include "Debug/BsDebug.h"
 #include "String/BsUnicode.h"
 
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+#include "windows.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace bs
 {
 	const UINT32 DataStream::StreamTempSize = 128;
@@ -418,4 +427,126 @@ namespace bs
 			}
 		}
 	}
+
+	/** Memory mapping of a single file, shared by all streams referencing it. */
+	struct MappedFileDataStream::Mapping
+	{
+		~Mapping()
+		{
+			if (data == nullptr)
+				return;
+
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+			UnmapViewOfFile(data);
+#else
+			munmap(data, size);
+#endif
+		}
+
+		UINT8* data = nullptr;
+		size_t size = 0;
+	};
+
+	MappedFileDataStream::MappedFileDataStream(const Path& path)
+		: MemoryDataStream(nullptr, 0, false)
+	{
+		mAccess = READ;
+		mMapping = bs_shared_ptr_new<Mapping>();
+
+		// Note: File handles are closed right away, the mapping keeps its own reference to the file
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+		HANDLE file = CreateFileW(path.toPlatformString().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			LOGWRN("Cannot open file: " + path.toString());
+			return;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+		{
+			HANDLE fileMapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+			if (fileMapping != nullptr)
+			{
+				mMapping->data = (UINT8*)MapViewOfFile(fileMapping, FILE_MAP_COPY, 0, 0, 0);
+				CloseHandle(fileMapping);
+			}
+
+			if (mMapping->data != nullptr)
+				mMapping->size = (size_t)fileSize.QuadPart;
+			else
+				LOGWRN("Cannot map file: " + path.toString());
+		}
+
+		CloseHandle(file);
+#else
+		int file = open(path.toString().c_str(), O_RDONLY);
+		if (file == -1)
+		{
+			LOGWRN("Cannot open file: " + path.toString());
+			return;
+		}
+
+		struct stat fileInfo;
+		if (fstat(file, &fileInfo) == 0 && fileInfo.st_size > 0)
+		{
+			void* data = mmap(nullptr, (size_t)fileInfo.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+			if (data != MAP_FAILED)
+			{
+				mMapping->data = (UINT8*)data;
+				mMapping->size = (size_t)fileInfo.st_size;
+			}
+			else
+				LOGWRN("Cannot map file: " + path.toString());
+		}
+
+		::close(file);
+#endif
+
+		mData = mPos = mMapping->data;
+		mSize = mMapping->size;
+		mEnd = mData + mSize;
+	}
+
+	MappedFileDataStream::MappedFileDataStream(const MappedFileDataStream& source, size_t offset, size_t size)
+		: MemoryDataStream(nullptr, 0, false), mMapping(source.mMapping)
+	{
+		mAccess = READ;
+
+		offset = std::min(offset, source.mSize);
+		size = std::min(size, source.mSize - offset);
+
+		mData = mPos = source.mData + offset;
+		mSize = size;
+		mEnd = mData + mSize;
+	}
+
+	MappedFileDataStream::~MappedFileDataStream()
+	{
+		close();
+	}
+
+	SPtr<MappedFileDataStream> MappedFileDataStream::getView(size_t offset, size_t size) const
+	{
+		return bs_shared_ptr_new<MappedFileDataStream>(*this, offset, size);
+	}
+
+	SPtr<DataStream> MappedFileDataStream::clone(bool copyData) const
+	{
+		return bs_shared_ptr_new<MappedFileDataStream>(*this, 0, mSize);
+	}
+
+	bool MappedFileDataStream::isValid() const
+	{
+		return mMapping != nullptr && mMapping->data != nullptr;
+	}
+
+	void MappedFileDataStream::close()
+	{
+		MemoryDataStream::close();
+
+		mMapping = nullptr;
+		mPos = mEnd = nullptr;
+	}
 }
@@ -50,6 +50,13 @@ namespace bs
 		virtual bool isWriteable() const { return (mAccess & WRITE) != 0; }
 		virtual bool isFile() const = 0;
 
+		/**
+		 * Checks is the stream backed by a memory mapped file. If true the stream can be cast to MappedFileDataStream, 
+		 * allowing its data to be referenced directly instead of being copied. Mapped streams are also memory streams, 
+		 * meaning they report false from isFile() and can be cast to MemoryDataStream.
+		 */
+		virtual bool isMapped() const { return false; }
+
 		/** Reads data from the buffer and copies it to the specified value. */
 		template<typename T> DataStream& operator>>(T& val);
 
@@ -282,6 +289,74 @@ namespace bs
 		bool mFreeOnClose;	
 	};
 
+	/**
+	 * Data stream for reading data from a file mapped into memory. The stream is a read-only memory stream that doesn't
+	 * own its memory, so it can be used anywhere a MemoryDataStream is expected. Reads are performed directly from the 
+	 * mapped pages without going through intermediate buffers, and getView() can be used to create streams referencing a
+	 * part of the file without copying it. The mapping is kept alive for as long as any stream referencing it exists.
+	 *
+	 * The file is mapped copy-on-write. The stream itself is read-only, but if memory referenced by the stream is modified
+	 * the changes are private to the process and never written back to the file. Pages that are never written to are 
+	 * shared with any other process mapping the same file.
+	 *
+	 * @note	On Windows the file cannot be replaced or deleted while it is mapped.
+	 * @note	On other platforms the file can be modified while mapped. If it gets truncated, accessing mapped pages past
+	 *			its new end raises SIGBUS, which terminates the process unless handled. Files that might be truncated by
+	 *			other processes should be read through a regular FileDataStream instead.
+	 */
+	class BS_UTILITY_EXPORT MappedFileDataStream : public MemoryDataStream
+	{
+		struct Mapping;
+
+	public:
+		/**
+		 * Maps the entire file into memory.
+		 *
+		 * @param[in]	filePath	Path of the file to map.
+		 */
+		MappedFileDataStream(const Path& filePath);
+
+		/**
+		 * Creates a stream referencing a range of data from another mapped stream. No data is copied.
+		 *
+		 * @param[in]	source		Stream whose mapping to reference.
+		 * @param[in]	offset		Offset from the start of the @p source stream, in bytes.
+		 * @param[in]	size		Size of the range to reference, in bytes. Clamped to the size of the @p source stream.
+		 */
+		MappedFileDataStream(const MappedFileDataStream& source, size_t offset, size_t size);
+
+		~MappedFileDataStream();
+
+		bool isMapped() const override { return true; }
+
+		/** 
+		 * Checks if the file was successfully mapped. Fails if the file cannot be opened or mapped, or if it is empty. 
+		 * Invalid and closed streams are empty.
+		 */
+		bool isValid() const;
+
+		/**
+		 * Creates a new stream referencing a range of data from this stream, without copying it.
+		 *
+		 * @param[in]	offset		Offset from the start of this stream, in bytes.
+		 * @param[in]	size		Size of the range to reference, in bytes.
+		 */
+		SPtr<MappedFileDataStream> getView(size_t offset, size_t size) const;
+
+		/** 
+		 * @copydoc DataStream::clone 
+		 *
+		 * @note	Mapped data is never copied, the new stream always references the same mapping.
+		 */
+		SPtr<DataStream> clone(bool copyData = true) const override;
+
+		/** @copydoc DataStream::close */
+		void close() override;
+
+	protected:
+		SPtr<Mapping> mMapping;
+	};
+
 	/** @} */
 }
 
@@ -107,5 +107,52 @@ namespace bs
 		FileSystem::moveFile(oldPath, newPath);
 	}
 
-	Mutex FileScheduler::mMutex;
+	void FileScheduler::lock(const Path& path)
+	{
+		getMutex(path).lock();
+	}
+
+	void FileScheduler::unlock(const Path& path)
+	{
+		getMutex(path).unlock();
+	}
+
+	void FileScheduler::lockRead(const Path& path)
+	{
+		getMutex(path).lock_shared();
+	}
+
+	void FileScheduler::unlockRead(const Path& path)
+	{
+		getMutex(path).unlock_shared();
+	}
+
+	ExclusiveLock FileScheduler::getLock(const Path& path)
+	{
+		return ExclusiveLock(getMutex(path));
+	}
+
+	SharedLock FileScheduler::getReadLock(const Path& path)
+	{
+		return SharedLock(getMutex(path));
+	}
+
+	SharedMutex& FileScheduler::getMutex(const Path& path)
+	{
+		// Same file must always map to the same stripe, regardless of how the path was provided. This includes the case
+		// of the path, since on case insensitive file systems the same file can be reached through differently cased 
+		// paths. Only ASCII is case folded, as UTF8::toLower() requires the calling thread to have a MemStack.
+		String pathStr;
+		if (path.isAbsolute())
+			pathStr = path.toString();
+		else
+			pathStr = path.getAbsolute(FileSystem::getWorkingDirectoryPath()).toString();
+
+		StringUtil::toLowerCase(pathStr);
+		const size_t hash = std::hash<String>()(pathStr);
+		return mMutexes[hash % NUM_LOCK_STRIPES];
+	}
+
+	constexpr UINT32 FileScheduler::NUM_LOCK_STRIPES;
+	SharedMutex FileScheduler::mMutexes[NUM_LOCK_STRIPES];
 }
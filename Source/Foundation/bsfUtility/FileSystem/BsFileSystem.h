@@ -140,45 +140,50 @@ namespace bs
 		static void moveFile(const Path& oldPath, const Path& newPath);
 	};
 
-	/** 
-	 * Locks access to files on the same drive, allowing only one file to be read at a time, per drive. This prevents
-	 * multiple threads accessing multiple files on the same drive at once, ruining performance on mechanical drives.
+	/**
+	 * Synchronizes file access between threads. Any number of threads can read a file at once, while writing to a file
+	 * requires exclusive access. Locks are striped by path, so accesses to different files don't block one another
+	 * (other than in the rare case of a hash collision).
 	 */
 	class BS_UTILITY_EXPORT FileScheduler final
 	{
 	public:
 		/** 
-		 * Locks access and doesn't allow other threads to get past this point until access is unlocked. Any scheduled
-		 * file access should happen past this point.
+		 * Locks the file for writing, and doesn't allow other threads to read or write the file until it is unlocked. 
+		 * Any scheduled file access should happen past this point.
 		 */
-		static void lock(const Path& path)
-		{
-			// Note: File path should be analyzed and determined on which drive does the path belong to. Locks can then
-			// be issued on a per-drive basis, instead of having one global lock. This would allow multiple files to be
-			// accessed at the same time, as long as they're on different drives.
-			mMutex.lock();
-		}
+		static void lock(const Path& path);
+
+		/** Unlocks a file previously locked with lock(). Must be provided with the same file path as lock(). */
+		static void unlock(const Path& path);
 
 		/** 
-		 * Unlocks access and allows another thread to lock file access. Must be provided with the same file path as
-		 * lock().
+		 * Locks the file for reading, and doesn't allow other threads to write to the file until it is unlocked. Other
+		 * threads are still allowed to read the file.
+		 */
+		static void lockRead(const Path& path);
+
+		/** Unlocks a file previously locked with lockRead(). Must be provided with the same file path as lockRead(). */
+		static void unlockRead(const Path& path);
+
+		/**
+		 * Returns a lock object that immediately locks the file for writing (same as lock()), and then calls unlock() 
+		 * when it goes out of scope.
 		 */
-		static void unlock(const Path& path)
-		{
-			mMutex.unlock();
-		}
+		static ExclusiveLock getLock(const Path& path);
 
 		/**
-		 * Returns a lock object that immediately locks access (same as lock()), and then calls unlock() when it goes
-		 * out of scope.
+		 * Returns a lock object that immediately locks the file for reading (same as lockRead()), and then calls 
+		 * unlockRead() when it goes out of scope.
 		 */
-		static Lock getLock(const Path& path)
-		{
-			return Lock(mMutex);
-		}
+		static SharedLock getReadLock(const Path& path);
 
 	private:
-		static Mutex mMutex;
+		/** Returns the lock stripe responsible for the provided path. */
+		static SharedMutex& getMutex(const Path& path);
+
+		static constexpr UINT32 NUM_LOCK_STRIPES = 64;
+		static SharedMutex mMutexes[NUM_LOCK_STRIPES];
 	};
 
 	/** @} */
@@ -138,6 +138,7 @@ namespace bs
 	class DynLibManager;
 	class DataStream;
 	class MemoryDataStream;
+	class MappedFileDataStream;
 	class FileDataStream;
 	class MeshData;
 	class FileSystem;
@@ -46,6 +46,7 @@ namespace bs
 
 		enum { id = 0 /**< Unique id for the serializable type. */ };
 		enum { hasDynamicSize = 0 /**< 0 (Object has static size less than 255 bytes, for example int) or 1 (Dynamic size with no size restriction, for example string) */ };
+		enum { isMemcpySerializable = 1 /**< 1 if toMemory() and fromMemory() are a plain memcpy of sizeof(T) bytes, 0 or omitted otherwise. */ };
 
 		/** Serializes the provided object into the provided pre-allocated memory buffer. */
 		static void toMemory(const T& data, char* memory)
@@ -70,6 +71,24 @@ namespace bs
 		}
 	};
 
+	/**
+	 * Checks if the RTTIPlainType specialization for a type serializes it by directly copying its memory. Arrays of such
+	 * types can be serialized as a single contiguous block of memory. Specializations opt in by defining 
+	 * isMemcpySerializable.
+	 */
+	template<class T, class = void>
+	struct RTTIPlainTypeIsMemcpy : std::false_type
+	{ };
+
+	/** @cond SPECIALIZATIONS */
+
+	template<class T>
+	struct RTTIPlainTypeIsMemcpy<T, typename std::enable_if<RTTIPlainType<T>::isMemcpySerializable != 0>::type> 
+		: std::integral_constant<bool, RTTIPlainType<T>::hasDynamicSize == 0>
+	{ };
+
+	/** @endcond */
+
 	/**
 	 * Helper method when serializing known data types that have valid
 	 * RTTIPlainType specialization.
@@ -181,6 +200,7 @@ namespace bs
 						#type " is not trivially copyable");			\
 	template<> struct RTTIPlainType<type>								\
 	{	enum { id=0 }; enum { hasDynamicSize = 0 };						\
+		enum { isMemcpySerializable = 1 };								\
 		static void toMemory(const type& data, char* memory)			\
 		{ memcpy(memory, &data, sizeof(type)); }						\
 		static UINT32 fromMemory(type& data, char* memory)				\
@@ -5,6 +5,8 @@
 #include "Debug/BsDebug.h"
 #include "Error/BsException.h"
 #include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Threading/BsThreading.h"
 
 #include <algorithm>
 #include <fstream>
@@ -84,6 +86,8 @@ namespace bs
 		BS_ADD_TEST(FileSystemTestSuite::testGetChildren);
 		BS_ADD_TEST(FileSystemTestSuite::testGetLastModifiedTime);
 		BS_ADD_TEST(FileSystemTestSuite::testGetTempDirectoryPath);
+		BS_ADD_TEST(FileSystemTestSuite::testMappedFileDataStream);
+		BS_ADD_TEST(FileSystemTestSuite::testFileSchedulerPathCase);
 	}
 
 	void FileSystemTestSuite::testExists_yes_file()
@@ -299,4 +303,73 @@ namespace bs
 		/* No judging. */
 		BS_TEST_ASSERT(!path.toString().empty());
 	}
+
+	void FileSystemTestSuite::testMappedFileDataStream()
+	{
+		Path path = mTestDirectory + "mapped-file";
+		createFile(path, "0123456789");
+
+		SPtr<MappedFileDataStream> stream = bs_shared_ptr_new<MappedFileDataStream>(path);
+		BS_TEST_ASSERT(stream->isMapped());
+		BS_TEST_ASSERT(stream->size() == 10);
+
+		char data[4] = { 0 };
+		BS_TEST_ASSERT(stream->read(data, 3) == 3);
+		BS_TEST_ASSERT(memcmp(data, "012", 3) == 0);
+		BS_TEST_ASSERT(stream->tell() == 3);
+
+		// Mapped streams can be used wherever a non-file stream is expected to be a read-only memory stream
+		BS_TEST_ASSERT(!stream->isFile());
+		BS_TEST_ASSERT(!stream->isWriteable());
+		SPtr<MemoryDataStream> memStream = std::static_pointer_cast<MemoryDataStream>(stream->clone());
+		BS_TEST_ASSERT(memStream->getPtr() == stream->getPtr());
+		BS_TEST_ASSERT(memStream->write("x", 1) == 0);
+		memStream = nullptr;
+
+		// Views reference the same memory and keep it alive after the source stream is gone
+		SPtr<MappedFileDataStream> view = stream->getView(4, 100);
+		BS_TEST_ASSERT(view->size() == 6);
+		BS_TEST_ASSERT(view->getPtr() == stream->getPtr() + 4);
+
+		stream = nullptr;
+		BS_TEST_ASSERT(memcmp(view->getPtr(), "456789", 6) == 0);
+
+		// Changes to the mapped memory are never written back to the file
+		view->getPtr()[0] = 'x';
+		view = nullptr;
+		BS_TEST_ASSERT(readFile(path) == "0123456789");
+
+		SPtr<MappedFileDataStream> emptyStream = bs_shared_ptr_new<MappedFileDataStream>(mTestDirectory + "no-such-file");
+		BS_TEST_ASSERT(emptyStream->size() == 0);
+		BS_TEST_ASSERT(emptyStream->eof());
+		BS_TEST_ASSERT(emptyStream->read(data, 1) == 0);
+
+		FileSystem::remove(path);
+	}
+
+	void FileSystemTestSuite::testFileSchedulerPathCase()
+	{
+		// Paths differing only in case refer to the same file on case insensitive file systems, so they must use the 
+		// same lock
+		const Path writePath = mTestDirectory + "Locked/File.asset";
+		const Path readPath = mTestDirectory + "locked/FILE.Asset";
+		BS_TEST_ASSERT(writePath == readPath);
+
+		std::atomic<bool> readLocked(false);
+		Thread reader;
+		{
+			ExclusiveLock writeLock = FileScheduler::getLock(writePath);
+			reader = Thread([&readPath, &readLocked]()
+			{
+				SharedLock readLock = FileScheduler::getReadLock(readPath);
+				readLocked = true;
+			});
+
+			BS_THREAD_SLEEP(50);
+			BS_TEST_ASSERT(!readLocked);
+		}
+
+		reader.join();
+		BS_TEST_ASSERT(readLocked);
+	}
 }
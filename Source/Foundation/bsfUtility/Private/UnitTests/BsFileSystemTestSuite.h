@@ -35,6 +35,8 @@ namespace bs
 		void testGetChildren();
 		void testGetLastModifiedTime();
 		void testGetTempDirectoryPath();
+		void testMappedFileDataStream();
+		void testFileSchedulerPathCase();
 
 		Path mTestDirectory;
 	};
@@ -10,6 +10,11 @@
 #include "Utility/BsQuadtree.h"
 #include "Utility/BsBitstream.h"
 #include "Utility/BsUSPtr.h"
+#include "Threading/BsTaskScheduler.h"
+#include "Reflection/BsRTTIType.h"
+#include "Serialization/BsMemorySerializer.h"
+#include "Utility/BsCompression.h"
+#include "Utility/BsTime.h"
 
 namespace bs
 {
@@ -78,14 +83,84 @@ namespace bs
 	};
 
 	typedef Quadtree<UINT32, DebugQuadtreeOptions> DebugQuadtree;
+
+	/** Object containing plain arrays that go through the different array serialization paths. */
+	class TestPlainArrays : public IReflectable
+	{
+	public:
+		Vector<UINT32> direct; // Memcpy serializable, with direct access to storage
+		Vector<UINT64> indexed; // Memcpy serializable, accessed per element
+		Vector<String> strings; // Dynamically sized
+
+		friend class TestPlainArraysRTTI;
+		static RTTITypeBase* getRTTIStatic();
+		RTTITypeBase* getRTTI() const override;
+	};
+
+	class TestPlainArraysRTTI : public RTTIType<TestPlainArrays, IReflectable, TestPlainArraysRTTI>
+	{
+	private:
+		BS_BEGIN_RTTI_MEMBERS
+			BS_RTTI_MEMBER_PLAIN_ARRAY(direct, 0)
+			BS_RTTI_MEMBER_PLAIN_ARRAY(strings, 2)
+		BS_END_RTTI_MEMBERS
+
+		UINT64& getIndexed(TestPlainArrays* obj, UINT32 idx) { return obj->indexed[idx]; }
+		void setIndexed(TestPlainArrays* obj, UINT32 idx, UINT64& value) { obj->indexed[idx] = value; }
+		UINT32 getNumIndexed(TestPlainArrays* obj) { return (UINT32)obj->indexed.size(); }
+		void setNumIndexed(TestPlainArrays* obj, UINT32 size) { obj->indexed.resize(size); }
+
+	public:
+		TestPlainArraysRTTI()
+		{
+			addPlainArrayField("indexed", 1, &TestPlainArraysRTTI::getIndexed, &TestPlainArraysRTTI::getNumIndexed,
+				&TestPlainArraysRTTI::setIndexed, &TestPlainArraysRTTI::setNumIndexed);
+		}
+
+		const String& getRTTIName() override
+		{
+			static String name = "TestPlainArrays";
+			return name;
+		}
+
+		UINT32 getRTTIId() override
+		{
+			return 0xFFFF0001;
+		}
+
+		SPtr<IReflectable> newRTTIObject() override
+		{
+			return bs_shared_ptr_new<TestPlainArrays>();
+		}
+	};
+
+	RTTITypeBase* TestPlainArrays::getRTTIStatic()
+	{
+		return TestPlainArraysRTTI::instance();
+	}
+
+	RTTITypeBase* TestPlainArrays::getRTTI() const
+	{
+		return getRTTIStatic();
+	}
+
 	void UtilityTestSuite::startUp()
 	{
 		SPtr<TestSuite> fileSystemTests = create<FileSystemTestSuite>();
 		add(fileSystemTests);
+
+		MemStack::beginThread();
+		Time::startUp();
+		ThreadPool::startUp<TThreadPool<>>(4);
+		TaskScheduler::startUp();
 	}
 
 	void UtilityTestSuite::shutDown()
 	{
+		TaskScheduler::shutDown();
+		ThreadPool::shutDown();
+		Time::shutDown();
+		MemStack::endThread();
 	}
 
 	UtilityTestSuite::UtilityTestSuite()
@@ -99,6 +174,12 @@ namespace bs
 		BS_ADD_TEST(UtilityTestSuite::testQuadtree)
 		BS_ADD_TEST(UtilityTestSuite::testVarInt)
 		BS_ADD_TEST(UtilityTestSuite::testBitStream)
+		BS_ADD_TEST(UtilityTestSuite::testTaskScheduler)
+		BS_ADD_TEST(UtilityTestSuite::testTaskPool)
+		BS_ADD_TEST(UtilityTestSuite::testParallelFor)
+		BS_ADD_TEST(UtilityTestSuite::testPlainArraySerialization)
+		BS_ADD_TEST(UtilityTestSuite::testChunkedCompression)
+		BS_ADD_TEST(UtilityTestSuite::testLZHuffmanCompression)
 	}
 
 	void UtilityTestSuite::testBitfield()
@@ -174,6 +255,26 @@ namespace bs
 		// Find
 		BS_TEST_ASSERT(bitfield.find(true) == 0);
 		BS_TEST_ASSERT(bitfield.find(false) == 5);
+
+		// Resize
+		bitfield.resize(curCount + 70, true);
+		for (UINT32 j = curCount; j < curCount + 70; j++)
+			BS_TEST_ASSERT(bitfield[j] == true);
+
+		BS_TEST_ASSERT(bitfield[5] == false);
+
+		bitfield.resize(10);
+		BS_TEST_ASSERT(bitfield.size() == 10);
+
+		// Combine
+		Bitfield other(false, 10);
+		other[3] = true;
+		other[5] = true;
+
+		bitfield |= other;
+		BS_TEST_ASSERT(bitfield[5] == true);
+		BS_TEST_ASSERT(bitfield[6] == false);
+		BS_TEST_ASSERT(bitfield.count(true) == 9);
 	}
 
 	void UtilityTestSuite::testOctree()
@@ -223,48 +324,71 @@ namespace bs
 			}
 		}
 
-		DebugOctreeElem manualElems[3];
+		DebugOctreeElem manualElems[5];
 		manualElems[0].box = AABox(Vector3(100.0f, 100.0f, 100.f), Vector3(110.0f, 115.0f, 110.0f));
 		manualElems[1].box = AABox(Vector3(200.0f, 100.0f, 100.f), Vector3(250.0f, 150.0f, 150.0f));
 		manualElems[2].box = AABox(Vector3(90.0f, 90.0f, 90.f), Vector3(105.0f, 105.0f, 110.0f));
 
-		
-		for(UINT32 i = 0; i < 3; i++)
+		// Partially and fully outside of the root node
+		manualElems[3].box = AABox(Vector3(780.0f, 0.0f, 0.f), Vector3(900.0f, 10.0f, 10.0f));
+		manualElems[4].box = AABox(Vector3(1000.0f, 0.0f, 0.f), Vector3(1010.0f, 10.0f, 10.0f));
+
+		for(UINT32 i = 0; i < 5; i++)
 		{
 			UINT32 elemIdx = (UINT32)octreeData.elements.size();
 			octreeData.elements.push_back(manualElems[i]);
 			octree.addElement(elemIdx);
 		}
 
-		AABox queryBounds = manualElems[0].box;
-		DebugOctree::BoxIntersectIterator interIter(octree, queryBounds);
-
-		Vector<UINT32> overlapElements;
-		while(interIter.moveNext())
+		Vector<bool> removed(octreeData.elements.size(), false);
+		auto checkQuery = [this, &octree, &octreeData, &removed](const AABox& queryBounds)
 		{
-			UINT32 element = interIter.getElement();
-			overlapElements.push_back(element);
+			DebugOctree::BoxIntersectIterator interIter(octree, queryBounds);
 
-			// Manually check for intersections
-			BS_TEST_ASSERT(octreeData.elements[element].box.intersects(queryBounds));
-		}
+			Vector<UINT32> overlapElements;
+			while(interIter.moveNext())
+			{
+				UINT32 element = interIter.getElement();
+				overlapElements.push_back(element);
 
-		// Ensure that all we have found all possible overlaps by manually testing all elements
-		UINT32 elemIdx = 0;
-		for(auto& entry : octreeData.elements)
-		{
-			if(entry.box.intersects(queryBounds))
+				// Manually check for intersections
+				BS_TEST_ASSERT(!removed[element]);
+				BS_TEST_ASSERT(octreeData.elements[element].box.intersects(queryBounds));
+			}
+
+			// Ensure that all we have found all possible overlaps by manually testing all elements
+			UINT32 elemIdx = 0;
+			for(auto& entry : octreeData.elements)
 			{
-				auto iterFind = std::find(overlapElements.begin(), overlapElements.end(), elemIdx);
-				BS_TEST_ASSERT(iterFind != overlapElements.end());
+				if(!removed[elemIdx] && entry.box.intersects(queryBounds))
+				{
+					auto iterFind = std::find(overlapElements.begin(), overlapElements.end(), elemIdx);
+					BS_TEST_ASSERT(iterFind != overlapElements.end());
+				}
+
+				elemIdx++;
 			}
+		};
 
-			elemIdx++;
+		checkQuery(manualElems[0].box);
+		checkQuery(AABox(Vector3(850.0f, 0.0f, 0.0f), Vector3(1005.0f, 5.0f, 5.0f)));
+
+		// Remove half of the elements and make sure the remaining ones can still be found
+		for(UINT32 i = 0; i < (UINT32)octreeData.elements.size(); i += 2)
+		{
+			octree.removeElement(octreeData.elements[i].octreeId);
+			removed[i] = true;
 		}
 
+		checkQuery(manualElems[1].box);
+		checkQuery(AABox(Vector3(-300.0f, -300.0f, -300.0f), Vector3(300.0f, 300.0f, 300.0f)));
+
 		// Ensure nothing goes wrong during element removal
-		for(auto& entry : octreeData.elements)
-			octree.removeElement(entry.octreeId);
+		for(UINT32 i = 0; i < (UINT32)octreeData.elements.size(); i++)
+		{
+			if(!removed[i])
+				octree.removeElement(octreeData.elements[i].octreeId);
+		}
 	}
 
 	void UtilityTestSuite::testSmallVector()
@@ -844,4 +968,534 @@ namespace bs
 		bs.read(ulv);
 		BS_TEST_ASSERT(ulv == v11);
 	}
+
+	void UtilityTestSuite::testTaskScheduler()
+	{
+		// Tasks of various priorities, some chained through dependencies
+		std::atomic<UINT32> numExecuted{0};
+		std::atomic<UINT32> chainIdx{0};
+		bool chainInOrder = true;
+
+		Vector<SPtr<Task>> tasks;
+		SPtr<Task> lastChained;
+		for(UINT32 i = 0; i < 500; i++)
+		{
+			SPtr<Task> task;
+			if(i % 10 == 0)
+			{
+				const UINT32 expectedIdx = i / 10;
+				auto worker = [&numExecuted, &chainIdx, &chainInOrder, expectedIdx]()
+				{
+					if(chainIdx++ != expectedIdx)
+						chainInOrder = false;
+
+					numExecuted++;
+				};
+
+				task = Task::create("TestChain", worker, TaskPriority::Normal, lastChained);
+				lastChained = task;
+			}
+			else
+				task = Task::create("Test", [&numExecuted]() { numExecuted++; }, (TaskPriority)(98 + i % 5));
+
+			TaskScheduler::instance().addTask(task);
+			tasks.push_back(task);
+		}
+
+		// Tasks queued from within another task
+		auto outerWorker = [&numExecuted]()
+		{
+			Vector<SPtr<Task>> innerTasks;
+			for(UINT32 i = 0; i < 50; i++)
+			{
+				SPtr<Task> task = Task::create("TestInner", [&numExecuted]() { numExecuted++; });
+				TaskScheduler::instance().addTask(task);
+
+				innerTasks.push_back(task);
+			}
+
+			for(auto& entry : innerTasks)
+				entry->wait();
+		};
+
+		SPtr<Task> outerTask = Task::create("TestOuter", outerWorker, TaskPriority::High);
+		TaskScheduler::instance().addTask(outerTask);
+
+		// Task group
+		SPtr<TaskGroup> taskGroup = TaskGroup::create("TestGroup", [&numExecuted](UINT32) { numExecuted++; }, 100);
+		TaskScheduler::instance().addTaskGroup(taskGroup);
+
+		// Cancelling a dependency cancels its dependants
+		SPtr<Task> canceledDependency = Task::create("TestCanceled", [&numExecuted]() { numExecuted += 1000; });
+		SPtr<Task> canceledTask = Task::create("TestCanceledDependant", [&numExecuted]() { numExecuted += 1000; },
+			TaskPriority::Normal, canceledDependency);
+
+		TaskScheduler::instance().addTask(canceledTask);
+		canceledDependency->cancel();
+
+		for(auto& entry : tasks)
+			entry->wait();
+
+		outerTask->wait();
+		taskGroup->wait();
+		canceledTask->wait();
+
+		BS_TEST_ASSERT(numExecuted == 650);
+		BS_TEST_ASSERT(chainInOrder);
+		BS_TEST_ASSERT(canceledTask->isCanceled());
+
+		// Tasks waiting on a dependency that never executes are released on shutdown, along with the dependency
+		TaskScheduler* scheduler = bs_new<TaskScheduler>();
+
+		std::weak_ptr<Task> parkedDependency;
+		std::weak_ptr<Task> parkedTask;
+		{
+			SPtr<Task> dependency = Task::create("TestNeverQueued", [&numExecuted]() { numExecuted += 1000; });
+			SPtr<Task> task = Task::create("TestParked", [&numExecuted]() { numExecuted += 1000; }, 
+				TaskPriority::Normal, dependency);
+
+			scheduler->addTask(task);
+
+			parkedDependency = dependency;
+			parkedTask = task;
+		}
+
+		bs_delete(scheduler);
+
+		BS_TEST_ASSERT(parkedDependency.expired());
+		BS_TEST_ASSERT(parkedTask.expired());
+
+		// Scheduler created while every thread in the pool is busy must still execute its tasks, once a thread frees up
+		Vector<HThread> busyThreads;
+		const UINT32 numAvailable = ThreadPool::instance().getNumAvailable();
+		for(UINT32 i = 0; i < numAvailable; i++)
+		{
+			busyThreads.push_back(ThreadPool::instance().run("TestBusy", 
+				[]() { std::this_thread::sleep_for(std::chrono::milliseconds(100)); }));
+		}
+
+		scheduler = bs_new<TaskScheduler>();
+
+		SPtr<Task> exhaustedTask = Task::create("TestExhausted", [&numExecuted]() { numExecuted++; });
+		scheduler->addTask(exhaustedTask);
+		exhaustedTask->wait();
+
+		BS_TEST_ASSERT(exhaustedTask->isComplete());
+		BS_TEST_ASSERT(numExecuted == 651);
+
+		bs_delete(scheduler);
+
+		for(auto& entry : busyThreads)
+			entry.blockUntilComplete();
+	}
+
+	void UtilityTestSuite::testTaskPool()
+	{
+		TaskPool pool("TestPooled");
+		std::atomic<UINT32> numExecuted(0);
+
+		// Tasks still referenced by the scheduler are in use, and a new task must be created
+		std::atomic<bool> release(false);
+		SPtr<Task> blocked = pool.getTask([&release, &numExecuted]()
+		{
+			while(!release)
+				std::this_thread::yield();
+
+			numExecuted++;
+		});
+
+		TaskScheduler::instance().addTask(blocked);
+
+		SPtr<Task> first = pool.getTask([&numExecuted]() { numExecuted++; });
+		BS_TEST_ASSERT(first != blocked);
+		BS_TEST_ASSERT(pool.getNumTasks() == 2);
+
+		TaskScheduler::instance().addTask(first);
+		first->wait();
+
+		// Scheduler releases its reference shortly after the task completes, after which only the pool and this test
+		// reference it
+		while(first.use_count() > 2)
+			std::this_thread::yield();
+
+		Task* firstPtr = first.get();
+		first = nullptr;
+
+		// Free tasks are reused instead of new ones being created, and run the newly provided worker
+		for(UINT32 i = 0; i < 100; i++)
+		{
+			SPtr<Task> reused = pool.getTask([&numExecuted]() { numExecuted += 10; });
+			BS_TEST_ASSERT(reused.get() == firstPtr);
+
+			TaskScheduler::instance().addTask(reused);
+			reused->wait();
+
+			while(reused.use_count() > 2)
+				std::this_thread::yield();
+		}
+
+		BS_TEST_ASSERT(pool.getNumTasks() == 2);
+		BS_TEST_ASSERT(numExecuted == 1001);
+
+		release = true;
+		blocked->wait();
+
+		BS_TEST_ASSERT(numExecuted == 1002);
+	}
+
+	void UtilityTestSuite::testParallelFor()
+	{
+		// Every index gets processed exactly once
+		for(UINT32 count : { 1000U, 10000U, 100000U })
+		{
+			Vector<UINT32> numVisits(count, 0);
+			TaskScheduler::instance().parallelFor(0, count, 16, [&numVisits](UINT32 idx) { numVisits[idx]++; });
+
+			bool allVisitedOnce = true;
+			for(auto& entry : numVisits)
+				allVisitedOnce &= entry == 1;
+
+			BS_TEST_ASSERT(allVisitedOnce);
+		}
+
+		// Nested calls
+		std::atomic<UINT32> numProcessed{0};
+		TaskScheduler::instance().parallelFor(0, 64, 1, [&numProcessed](UINT32)
+		{
+			TaskScheduler::instance().parallelFor(0, 100, 4, [&numProcessed](UINT32) { numProcessed++; });
+		});
+
+		BS_TEST_ASSERT(numProcessed == 6400);
+
+		// Empty range
+		TaskScheduler::instance().parallelFor(10, 10, 1, [&numProcessed](UINT32) { numProcessed++; });
+		BS_TEST_ASSERT(numProcessed == 6400);
+	}
+
+	void UtilityTestSuite::testPlainArraySerialization()
+	{
+		// Large enough for the per-element array to be decoded in multiple chunks
+		static constexpr UINT32 NUM_ELEMENTS = 5000;
+
+		TestPlainArrays original;
+		for(UINT32 i = 0; i < NUM_ELEMENTS; i++)
+		{
+			original.direct.push_back(i * 7919);
+			original.indexed.push_back((UINT64)i << 33 | i);
+		}
+
+		original.strings = { "first", "", "third" };
+
+		MemorySerializer serializer;
+		UINT32 size = 0;
+		UINT8* data = serializer.encode(&original, size);
+
+		SPtr<TestPlainArrays> decoded = std::static_pointer_cast<TestPlainArrays>(serializer.decode(data, size));
+		bs_free(data);
+
+		BS_TEST_ASSERT(decoded != nullptr);
+		BS_TEST_ASSERT(decoded->direct == original.direct);
+		BS_TEST_ASSERT(decoded->indexed == original.indexed);
+		BS_TEST_ASSERT(decoded->strings == original.strings);
+
+		// Empty arrays
+		TestPlainArrays empty;
+		data = serializer.encode(&empty, size);
+		decoded = std::static_pointer_cast<TestPlainArrays>(serializer.decode(data, size));
+		bs_free(data);
+
+		BS_TEST_ASSERT(decoded != nullptr);
+		BS_TEST_ASSERT(decoded->direct.empty() && decoded->indexed.empty() && decoded->strings.empty());
+	}
+
+	void UtilityTestSuite::testChunkedCompression()
+	{
+		// Multiple blocks with a partial last block, half of them compressible and half not
+		static constexpr UINT32 SIZE = Compression::CHUNK_SIZE * 7 + 1234;
+
+		SPtr<MemoryDataStream> original = bs_shared_ptr_new<MemoryDataStream>(SIZE);
+		UINT8* originalData = original->getPtr();
+		UINT32 seed = 12345;
+		for(UINT32 i = 0; i < SIZE; i++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			originalData[i] = ((i / Compression::CHUNK_SIZE) % 2) ? (UINT8)(seed >> 24) : (UINT8)(i / 64);
+		}
+
+		SPtr<DataStream> input = original;
+		SPtr<MemoryDataStream> compressed = Compression::compressChunked(input);
+		BS_TEST_ASSERT(compressed != nullptr);
+
+		// Sequential reads of varying sizes
+		SPtr<DataStream> decompressed = bs_shared_ptr_new<CompressedDataStream>(compressed);
+		BS_TEST_ASSERT(decompressed->size() == SIZE);
+		BS_TEST_ASSERT(compressed->eof());
+
+		Vector<UINT8> output(SIZE);
+		UINT32 numRead = 0;
+		for(UINT32 readSize = 1; numRead < SIZE; readSize = readSize * 3 + 1)
+			numRead += (UINT32)decompressed->read(output.data() + numRead, std::min(readSize, SIZE - numRead));
+
+		BS_TEST_ASSERT(decompressed->eof());
+		BS_TEST_ASSERT(memcmp(output.data(), originalData, SIZE) == 0);
+
+		// Random access over block boundaries, on a clone
+		SPtr<DataStream> clone = decompressed->clone();
+		decompressed = nullptr;
+
+		UINT8 value[16];
+		clone->seek(Compression::CHUNK_SIZE * 5 - 8);
+		BS_TEST_ASSERT(clone->read(value, sizeof(value)) == sizeof(value));
+		BS_TEST_ASSERT(memcmp(value, originalData + Compression::CHUNK_SIZE * 5 - 8, sizeof(value)) == 0);
+
+		clone->seek(SIZE - 4);
+		BS_TEST_ASSERT(clone->read(value, sizeof(value)) == 4);
+		BS_TEST_ASSERT(memcmp(value, originalData + SIZE - 4, 4) == 0);
+
+		// Corrupt data is rejected
+		compressed->seek(0);
+		compressed->getPtr()[0] ^= 0xFF;
+
+		SPtr<DataStream> corrupt = bs_shared_ptr_new<CompressedDataStream>(compressed);
+		BS_TEST_ASSERT(corrupt->size() == 0);
+		BS_TEST_ASSERT(corrupt->read(value, 1) == 0);
+	}
+
+	void UtilityTestSuite::testLZHuffmanCompression()
+	{
+		// Text-like data built from a small, unevenly used vocabulary, where entropy coding should pay off over Snappy
+		static constexpr UINT32 TEXT_SIZE = Compression::CHUNK_SIZE * 2 + 777;
+		static const char* WORDS[] = { "the ", "shader ", "texture ", "mesh ", "of ", "material ", "and ", "render ", 
+			"a ", "scene\n" };
+
+		SPtr<MemoryDataStream> text = bs_shared_ptr_new<MemoryDataStream>(TEXT_SIZE);
+		UINT8* textData = text->getPtr();
+		UINT32 seed = 54321;
+		for(UINT32 i = 0; i < TEXT_SIZE; )
+		{
+			seed = seed * 1664525 + 1013904223;
+
+			// Squaring skews the distribution towards the first words
+			const UINT32 random = (seed >> 16) & 0xFF;
+			const char* word = WORDS[(random * random * 10) >> 16];
+
+			for(UINT32 j = 0; word[j] != 0 && i < TEXT_SIZE; j++)
+				textData[i++] = (UINT8)word[j];
+		}
+
+		SPtr<DataStream> input = text;
+		SPtr<MemoryDataStream> snappyCompressed = Compression::compressChunked(input, CompressionCodec::Snappy);
+
+		text->seek(0);
+		SPtr<MemoryDataStream> compressed = Compression::compressChunked(input, CompressionCodec::LZHuffman);
+		BS_TEST_ASSERT(compressed != nullptr && snappyCompressed != nullptr);
+		BS_TEST_ASSERT(compressed->size() * 3 < snappyCompressed->size() * 2);
+
+		SPtr<DataStream> decompressed = bs_shared_ptr_new<CompressedDataStream>(compressed);
+		BS_TEST_ASSERT(decompressed->size() == TEXT_SIZE);
+
+		Vector<UINT8> output(TEXT_SIZE);
+		BS_TEST_ASSERT(decompressed->read(output.data(), TEXT_SIZE) == TEXT_SIZE);
+		BS_TEST_ASSERT(memcmp(output.data(), textData, TEXT_SIZE) == 0);
+
+		// Long repeats and matches overlapping their source, mixed with blocks that don't compress and are stored as is,
+		// and a block with geometrically distributed bytes, whose Huffman codes would exceed the maximum length
+		static constexpr UINT32 SIZE = Compression::CHUNK_SIZE * 4 + 5;
+
+		SPtr<MemoryDataStream> original = bs_shared_ptr_new<MemoryDataStream>(SIZE);
+		UINT8* originalData = original->getPtr();
+		for(UINT32 i = 0; i < SIZE; i++)
+		{
+			seed = seed * 1664525 + 1013904223;
+
+			if (i < Compression::CHUNK_SIZE)
+				originalData[i] = (i % 3000) < 1500 ? 7 : (UINT8)(i % 5);
+			else if (i < Compression::CHUNK_SIZE * 2)
+				originalData[i] = (UINT8)(seed >> 24);
+			else if (i < Compression::CHUNK_SIZE * 3)
+				originalData[i] = (UINT8)((i / 4096) ^ (i % 13));
+			else
+			{
+				// Groups of four bytes, a geometrically distributed value followed by the group index split into three
+				// digits, so the data has next to no matches and the rare values end up deep in the Huffman tree
+				const UINT32 offset = i - Compression::CHUNK_SIZE * 3;
+				if (offset % 4 == 0)
+				{
+					UINT8 value = 0;
+					while (value < 24 && ((seed >> (31 - value)) & 1) != 0)
+						value++;
+
+					originalData[i] = 64 + value;
+				}
+				else
+					originalData[i] = (UINT8)(((offset / 4) >> (6 * (offset % 4 - 1))) & 63);
+			}
+		}
+
+		input = original;
+		compressed = Compression::compressChunked(input, CompressionCodec::LZHuffman);
+		BS_TEST_ASSERT(compressed != nullptr);
+		BS_TEST_ASSERT(compressed->size() < SIZE);
+
+		decompressed = bs_shared_ptr_new<CompressedDataStream>(compressed);
+		BS_TEST_ASSERT(decompressed->size() == SIZE);
+
+		output.resize(SIZE);
+		BS_TEST_ASSERT(decompressed->read(output.data(), SIZE) == SIZE);
+		BS_TEST_ASSERT(memcmp(output.data(), originalData, SIZE) == 0);
+
+		// Corrupt code lengths are rejected. First block starts after the 24 byte header and the index of five blocks.
+		const size_t firstBlockOffset = 24 + 5 * (sizeof(UINT32) + sizeof(UINT8));
+		compressed->getPtr()[firstBlockOffset] ^= 0xFF;
+		compressed->seek(0);
+
+		decompressed = bs_shared_ptr_new<CompressedDataStream>(compressed);
+		BS_TEST_ASSERT(decompressed->read(output.data(), SIZE) == 0);
+
+		// Damaged blocks are rejected without reading or writing out of bounds. Streams with a single block are built
+		// by taking the header of a stream of the same size and following it with the index and data of the new block.
+		const auto buildSingleBlock = [](const SPtr<MemoryDataStream>& chunked, const UINT8* blockData, UINT32 blockSize)
+		{
+			static constexpr size_t HEADER_SIZE = 24;
+			const CompressionCodec codec = CompressionCodec::LZHuffman;
+
+			SPtr<MemoryDataStream> output = bs_shared_ptr_new<MemoryDataStream>(HEADER_SIZE + sizeof(UINT32) + 
+				sizeof(UINT8) + blockSize);
+			output->write(chunked->getPtr(), HEADER_SIZE);
+			output->write(&blockSize, sizeof(blockSize));
+			output->write(&codec, sizeof(codec));
+			output->write(blockData, blockSize);
+			output->seek(0);
+
+			return output;
+		};
+
+		const auto decompressAll = [](const SPtr<MemoryDataStream>& chunked, UINT8* output, size_t size)
+		{
+			SPtr<DataStream> stream = bs_shared_ptr_new<CompressedDataStream>(chunked);
+			return stream->read(output, size);
+		};
+
+		SPtr<DataStream> textBlock = bs_shared_ptr_new<MemoryDataStream>(textData, Compression::CHUNK_SIZE, false);
+		compressed = Compression::compressChunked(textBlock, CompressionCodec::LZHuffman);
+		BS_TEST_ASSERT(compressed != nullptr);
+
+		const size_t singleBlockOffset = 24 + sizeof(UINT32) + sizeof(UINT8);
+		UINT32 blockSize;
+		memcpy(&blockSize, compressed->getPtr() + 24, sizeof(blockSize));
+		BS_TEST_ASSERT(compressed->getPtr()[24 + sizeof(UINT32)] == (UINT8)CompressionCodec::LZHuffman);
+
+		Vector<UINT8> block(compressed->getPtr() + singleBlockOffset, compressed->getPtr() + singleBlockOffset + blockSize);
+		output.resize(Compression::CHUNK_SIZE);
+
+		BS_TEST_ASSERT(decompressAll(buildSingleBlock(compressed, block.data(), blockSize), output.data(), 
+			Compression::CHUNK_SIZE) == Compression::CHUNK_SIZE);
+
+		// Truncated data
+		for(UINT32 truncatedSize : { blockSize - 1, blockSize / 2, 100U, 1U, 0U })
+		{
+			BS_TEST_ASSERT(decompressAll(buildSingleBlock(compressed, block.data(), truncatedSize), output.data(), 
+				Compression::CHUNK_SIZE) == 0);
+		}
+
+		// Flipped bits. Blocks have no checksum, so flips that still decode to a block of the right size go unnoticed,
+		// but the rest must be rejected.
+		UINT32 numDetected = 0;
+		for(UINT32 i = 0; i < 64; i++)
+		{
+			seed = seed * 1664525 + 1013904223;
+			const UINT32 bit = (seed >> 8) % (blockSize * 8);
+
+			block[bit / 8] ^= 1 << (bit % 8);
+
+			const size_t numRead = decompressAll(buildSingleBlock(compressed, block.data(), blockSize), output.data(), 
+				Compression::CHUNK_SIZE);
+			BS_TEST_ASSERT(numRead == 0 || numRead == Compression::CHUNK_SIZE);
+
+			if(numRead == 0)
+				numDetected++;
+
+			block[bit / 8] ^= 1 << (bit % 8);
+		}
+
+		BS_TEST_ASSERT(numDetected > 0);
+
+		// Hand written blocks. Code lengths are four bits each, 277 for literals and lengths, followed by 64 for
+		// distances. Codes are written least significant bit first, with their bits reversed.
+		struct BitWriter
+		{
+			void write(UINT32 value, UINT32 count)
+			{
+				for(UINT32 i = 0; i < count; i++, numBits++)
+				{
+					if((numBits % 8) == 0)
+						data.push_back(0);
+
+					data.back() |= ((value >> i) & 1) << (numBits % 8);
+				}
+			}
+
+			Vector<UINT8> data;
+			UINT32 numBits = 0;
+		};
+
+		// Literal 'A' (code 0), end of block (code 01) and shortest match (code 11). Distance of one (code 0), two
+		// (code 01) and the largest distance slot (code 11).
+		const auto writeCodeLengths = [](BitWriter& writer, UINT32 litLenLength)
+		{
+			for(UINT32 i = 0; i < 277; i++)
+			{
+				if(i == 'A')
+					writer.write(litLenLength, 4);
+				else if(i == 256 || i == 257)
+					writer.write(2, 4);
+				else
+					writer.write(0, 4);
+			}
+
+			for(UINT32 i = 0; i < 64; i++)
+				writer.write(i == 0 ? 1 : (i == 1 || i == 63) ? 2 : 0, 4);
+		};
+
+		SPtr<DataStream> shortInput = bs_shared_ptr_new<MemoryDataStream>(textData, 5, false);
+		SPtr<MemoryDataStream> shortCompressed = Compression::compressChunked(shortInput, CompressionCodec::None);
+		BS_TEST_ASSERT(shortCompressed != nullptr);
+
+		// "AAAAA" as a literal followed by a match of length four at distance one, to validate the blocks below
+		BitWriter valid;
+		writeCodeLengths(valid, 1);
+		valid.write(0, 1);
+		valid.write(3, 2);
+		valid.write(0, 1);
+		valid.write(1, 2);
+
+		BS_TEST_ASSERT(decompressAll(buildSingleBlock(shortCompressed, valid.data.data(), (UINT32)valid.data.size()), 
+			output.data(), 5) == 5);
+		BS_TEST_ASSERT(memcmp(output.data(), "AAAAA", 5) == 0);
+
+		// More codes than fit into their lengths. Lengths can't exceed the fifteen bit maximum, since they're stored in 
+		// four bits, so over-long headers show up as an over-subscribed code instead.
+		BitWriter overSubscribed;
+		writeCodeLengths(overSubscribed, 1);
+		for(UINT32 i = 0; i < 277; i++)
+			overSubscribed.data[i / 2] |= 1 << ((i % 2) * 4);
+
+		BS_TEST_ASSERT(decompressAll(buildSingleBlock(shortCompressed, overSubscribed.data.data(), 
+			(UINT32)overSubscribed.data.size()), output.data(), 5) == 0);
+
+		// Match distances reaching before the start of the block
+		for(UINT32 distanceSlot : { 1U, 63U })
+		{
+			BitWriter outOfRange;
+			writeCodeLengths(outOfRange, 1);
+			outOfRange.write(0, 1);
+			outOfRange.write(3, 2);
+			outOfRange.write(distanceSlot == 1 ? 1 : 3, 2);
+			outOfRange.write(distanceSlot == 1 ? 0 : 0x3FFFFFFF, distanceSlot == 1 ? 0 : 30);
+			outOfRange.write(1, 2);
+
+			BS_TEST_ASSERT(decompressAll(buildSingleBlock(shortCompressed, outOfRange.data.data(), 
+				(UINT32)outOfRange.data.size()), output.data(), 5) == 0);
+		}
+	}
 }
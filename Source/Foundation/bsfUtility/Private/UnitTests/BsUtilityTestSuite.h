@@ -23,5 +23,11 @@ namespace bs
 		void testQuadtree();
 		void testVarInt();
 		void testBitStream();
+		void testTaskScheduler();
+		void testTaskPool();
+		void testParallelFor();
+		void testPlainArraySerialization();
+		void testChunkedCompression();
+		void testLZHuffmanCompression();
 	};
 }
@@ -94,6 +94,37 @@ namespace bs
 		 * location and contains the proper type.
 		 */
 		virtual void arrayElemFromBuffer(RTTITypeBase* rtti, void* object, int index, void* buffer) = 0;
+
+		/**
+		 * Returns true if values of the field's type are serialized by directly copying their memory. Arrays of such
+		 * types are stored as a single contiguous block, and support the bulk array methods below.
+		 */
+		virtual bool isMemcpySerializable()
+		{
+			return false;
+		}
+
+		/**
+		 * Returns a pointer to the contiguous storage of the array managed by the field, or null if the field doesn't
+		 * provide direct access to its storage. Only supported for memcpy serializable types. Array must be resized 
+		 * beforehand to the required size.
+		 */
+		virtual void* getArrayData(RTTITypeBase* rtti, void* object)
+		{
+			return nullptr;
+		}
+
+		/**
+		 * Copies @p count array elements starting at @p index into the buffer, one after another. Only supported for
+		 * memcpy serializable types. It does not check if buffer is large enough.
+		 */
+		virtual void arrayElemsToBuffer(RTTITypeBase* rtti, void* object, UINT32 index, UINT32 count, void* buffer) = 0;
+
+		/**
+		 * Sets @p count array elements starting at @p index from values stored one after another in the buffer. Only 
+		 * supported for memcpy serializable types. It does not check the value in the buffer in any way.
+		 */
+		virtual void arrayElemsFromBuffer(RTTITypeBase* rtti, void* object, UINT32 index, UINT32 count, void* buffer) = 0;
 	};
 
 	/** Represents a plain class field containing a specific type. */
@@ -107,6 +138,7 @@ namespace bs
 		typedef void (InterfaceType::*ArraySetterType)(ObjectType*, UINT32, DataType&);
 		typedef UINT32(InterfaceType::*ArrayGetSizeType)(ObjectType*);
 		typedef void(InterfaceType::*ArraySetSizeType)(ObjectType*, UINT32);
+		typedef DataType* (InterfaceType::*ArrayGetDataType)(ObjectType*);
 
 		/**
 		 * Initializes a plain field containing a single value.
@@ -145,9 +177,13 @@ namespace bs
 		 * @param[in]	setter  	The setter method for the field.
 		 * @param[in]	setSize 	Setter method that allows you to resize an array. Can be null.
 		 * @param[in]	info		Various optional information about the field.
+		 * @param[in]	getData		Optional method returning the contiguous storage of the array. If provided and the
+		 *							type is memcpy serializable, the array is serialized directly from and into the
+		 *							storage.
 		 */
 		void initArray(String name, UINT16 uniqueId, ArrayGetterType getter,
-			ArrayGetSizeType getSize, ArraySetterType setter, ArraySetSizeType setSize, const RTTIFieldInfo& info)
+			ArrayGetSizeType getSize, ArraySetterType setter, ArraySetSizeType setSize, const RTTIFieldInfo& info,
+			ArrayGetDataType getData = nullptr)
 		{
 			static_assert((RTTIPlainType<DataType>::id != 0) || true, ""); // Just making sure provided type has a type ID
 
@@ -159,6 +195,7 @@ namespace bs
 			arraySetter = setter;
 			arrayGetSize = getSize;
 			arraySetSize = setSize;
+			arrayGetData = getData;
 
 			init(std::move(name), uniqueId, true, SerializableFT_Plain, info);
 		}
@@ -300,6 +337,68 @@ namespace bs
 			(rttiObject->*arraySetter)(castObject, index, value);
 		}
 
+		/** @copydoc RTTIPlainFieldBase::isMemcpySerializable */
+		bool isMemcpySerializable() override
+		{
+			return RTTIPlainTypeIsMemcpy<DataType>::value;
+		}
+
+		/** @copydoc RTTIPlainFieldBase::getArrayData */
+		void* getArrayData(RTTITypeBase* rtti, void* object) override
+		{
+			checkIsArray(true);
+
+			if(!RTTIPlainTypeIsMemcpy<DataType>::value || !arrayGetData)
+				return nullptr;
+
+			InterfaceType* rttiObject = static_cast<InterfaceType*>(rtti);
+			ObjectType* castObject = static_cast<ObjectType*>(object);
+			return (rttiObject->*arrayGetData)(castObject);
+		}
+
+		/** @copydoc RTTIPlainFieldBase::arrayElemsToBuffer */
+		void arrayElemsToBuffer(RTTITypeBase* rtti, void* object, UINT32 index, UINT32 count, void* buffer) override
+		{
+			checkIsArray(true);
+
+			InterfaceType* rttiObject = static_cast<InterfaceType*>(rtti);
+			ObjectType* castObject = static_cast<ObjectType*>(object);
+
+			char* dst = (char*)buffer;
+			for(UINT32 i = 0; i < count; i++)
+			{
+				const DataType& value = (rttiObject->*arrayGetter)(castObject, index + i);
+				RTTIPlainType<DataType>::toMemory(value, dst);
+
+				dst += sizeof(DataType);
+			}
+		}
+
+		/** @copydoc RTTIPlainFieldBase::arrayElemsFromBuffer */
+		void arrayElemsFromBuffer(RTTITypeBase* rtti, void* object, UINT32 index, UINT32 count, void* buffer) override
+		{
+			checkIsArray(true);
+
+			if(!arraySetter)
+			{
+				BS_EXCEPT(InternalErrorException, 
+					"Specified field (" + mName + ") has no setter.");
+			}
+
+			InterfaceType* rttiObject = static_cast<InterfaceType*>(rtti);
+			ObjectType* castObject = static_cast<ObjectType*>(object);
+
+			char* src = (char*)buffer;
+			for(UINT32 i = 0; i < count; i++)
+			{
+				DataType value;
+				RTTIPlainType<DataType>::fromMemory(value, src);
+
+				(rttiObject->*arraySetter)(castObject, index + i, value);
+				src += sizeof(DataType);
+			}
+		}
+
 	private:
 		union
 		{
@@ -316,6 +415,7 @@ namespace bs
 
 				ArrayGetSizeType arrayGetSize;
 				ArraySetSizeType arraySetSize;
+				ArrayGetDataType arrayGetData;
 			};
 		};
 	};
@@ -75,6 +75,7 @@ data->seek(data->tell() - size);										\
 mTotalBytesRead -= size;												\
 
 	constexpr UINT32 BinarySerializer::REPORT_AFTER_BYTES;
+	constexpr UINT32 BinarySerializer::PLAIN_ARRAY_CHUNK_SIZE;
 
 	BinarySerializer::BinarySerializer()
 		:mAlloc(&gFrameAlloc())
@@ -338,6 +339,20 @@ mTotalBytesRead -= size;												\
 						{
 							RTTIPlainFieldBase* curField = static_cast<RTTIPlainFieldBase*>(curGenericField);
 
+							if(curField->isMemcpySerializable())
+							{
+								buffer = plainArrayToBuffer(curField, rttiInstance, object, arrayNumElems, buffer, 
+									bufferLength, bytesWritten, flushBufferCallback);
+
+								if (buffer == nullptr || bufferLength == 0)
+								{
+									cleanup();
+									return nullptr;
+								}
+
+								break;
+							}
+
 							for(UINT32 arrIdx = 0; arrIdx < arrayNumElems; arrIdx++)
 							{
 								UINT32 typeSize = 0;
@@ -728,6 +743,33 @@ mTotalBytesRead -= size;												\
 				{
 					RTTIPlainFieldBase* curField = static_cast<RTTIPlainFieldBase*>(curGenericField);
 
+					// Elements are stored back to back, so read them as a single block
+					if (curField != nullptr && !hasDynamicSize && curField->isMemcpySerializable())
+					{
+						auto* arrayData = (UINT8*)curField->getArrayData(rttiInstance, output.get());
+						if (arrayData != nullptr)
+						{
+							READ_FROM_BUFFER(arrayData, (UINT32)arrayNumElems * fieldSize)
+						}
+						else
+						{
+							const UINT32 numElemsPerChunk = std::max(PLAIN_ARRAY_CHUNK_SIZE / fieldSize, 1U);
+							auto* chunk = (UINT8*)bs_stack_alloc(std::min(numElemsPerChunk, (UINT32)arrayNumElems) * fieldSize);
+
+							for (UINT32 i = 0; i < (UINT32)arrayNumElems; i += numElemsPerChunk)
+							{
+								const UINT32 numElems = std::min(numElemsPerChunk, (UINT32)arrayNumElems - i);
+								READ_FROM_BUFFER(chunk, numElems * fieldSize)
+
+								curField->arrayElemsFromBuffer(rttiInstance, output.get(), i, numElems, chunk);
+							}
+
+							bs_stack_free(chunk);
+						}
+
+						break;
+					}
+
 					for (int i = 0; i < arrayNumElems; i++)
 					{
 						UINT32 typeSize = fieldSize;
@@ -885,6 +927,16 @@ mTotalBytesRead -= size;												\
 							// Seek past the data (use original offset in case the field read from the stream)
 							data->seek(dataBlockOffset + dataBlockSize);
 						}
+						else if (data->isMapped()) // Reference the mapped memory directly, without copying
+						{
+							auto mappedData = std::static_pointer_cast<MappedFileDataStream>(data);
+							SPtr<DataStream> stream = mappedData->getView(mappedData->tell(), dataBlockSize);
+							if (stream->size() != dataBlockSize)
+								BS_EXCEPT(InternalErrorException, "Error decoding data.");
+
+							curField->setValue(rttiInstance, output.get(), stream, dataBlockSize);
+							SKIP_READ(dataBlockSize)
+						}
 						else
 						{
 							UINT8* dataBlockBuffer = (UINT8*)bs_alloc(dataBlockSize);
@@ -1048,6 +1100,47 @@ mTotalBytesRead -= size;												\
 		return buffer;
 	}
 
+	UINT8* BinarySerializer::plainArrayToBuffer(RTTIPlainFieldBase* field, RTTITypeBase* rtti, void* object, 
+		UINT32 numElements, UINT8* buffer, UINT32& bufferLength, UINT32* bytesWritten, 
+		std::function<UINT8*(UINT8* buffer, UINT32 bytesWritten, UINT32& newBufferSize)> flushBufferCallback)
+	{
+		const UINT32 typeSize = field->getTypeSize();
+
+		auto* arrayData = (UINT8*)field->getArrayData(rtti, object);
+		if (arrayData != nullptr)
+			return dataBlockToBuffer(arrayData, numElements * typeSize, buffer, bufferLength, bytesWritten, flushBufferCallback);
+
+		UINT32 elemIdx = 0;
+		while (elemIdx < numElements)
+		{
+			// Write as many elements as fit in the remaining buffer space directly
+			const UINT32 numElems = std::min((bufferLength - *bytesWritten) / typeSize, numElements - elemIdx);
+			if (numElems > 0)
+			{
+				field->arrayElemsToBuffer(rtti, object, elemIdx, numElems, buffer);
+				buffer += numElems * typeSize;
+				*bytesWritten += numElems * typeSize;
+				elemIdx += numElems;
+			}
+			else
+			{
+				// Element straddles the end of the buffer
+				UINT8* tempBuffer = (UINT8*)bs_stack_alloc(typeSize);
+				field->arrayElemsToBuffer(rtti, object, elemIdx, 1, tempBuffer);
+
+				buffer = dataBlockToBuffer(tempBuffer, typeSize, buffer, bufferLength, bytesWritten, flushBufferCallback);
+				bs_stack_free(tempBuffer);
+
+				if (buffer == nullptr || bufferLength == 0)
+					return nullptr;
+
+				elemIdx++;
+			}
+		}
+
+		return buffer;
+	}
+
 	UINT32 BinarySerializer::findOrCreatePersistentId(IReflectable* object)
 	{
 		void* ptrAddress = (void*)object;
@@ -15,6 +15,7 @@ namespace bs
 	class IReflectable;
 	struct RTTIReflectableFieldBase;
 	struct RTTIReflectablePtrFieldBase;
+	struct RTTIPlainFieldBase;
 	struct SerializationContext;
 
 	/**
@@ -78,6 +79,9 @@ namespace bs
 		/** Determines how many bytes need to be read before the progress report callback is triggered. */
 		static constexpr UINT32 REPORT_AFTER_BYTES = 32768;
 
+		/** Size of the chunks used when decoding plain arrays that can't be decoded directly into their storage. */
+		static constexpr UINT32 PLAIN_ARRAY_CHUNK_SIZE = 16384;
+
 		struct ObjectMetaData
 		{
 			UINT32 objectMeta;
@@ -121,6 +125,14 @@ namespace bs
 		UINT8* dataBlockToBuffer(UINT8* data, UINT32 size, UINT8* buffer, UINT32& bufferLength, UINT32* bytesWritten,
 			std::function<UINT8*(UINT8* buffer, UINT32 bytesWritten, UINT32& newBufferSize)> flushBufferCallback);
 
+		/**
+		 * Helper method for encoding an array of memcpy serializable plain types to a buffer. Elements are written one
+		 * after another, the same as if they were encoded individually.
+		 */
+		UINT8* plainArrayToBuffer(RTTIPlainFieldBase* field, RTTITypeBase* rtti, void* object, UINT32 numElements, 
+			UINT8* buffer, UINT32& bufferLength, UINT32* bytesWritten, 
+			std::function<UINT8*(UINT8* buffer, UINT32 bytesWritten, UINT32& newBufferSize)> flushBufferCallback);
+
 		/**	Finds an existing, or creates a unique unique identifier for the specified object. */
 		UINT32 findOrCreatePersistentId(IReflectable* object);
 
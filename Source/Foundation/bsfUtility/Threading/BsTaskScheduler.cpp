@@ -37,6 +37,8 @@ namespace bs
 	void Task::cancel()
 	{
 		mState = 3;
+
+		TaskScheduler::cancelDependents(this);
 	}
 
 	TaskGroup::TaskGroup(const PrivatelyConstruct& dummy, String name, std::function<void(UINT32)> taskWorker, 
@@ -65,63 +67,133 @@ namespace bs
 			mParent->waitUntilComplete(this);
 	}
 
-	TaskScheduler::TaskScheduler()
-		:mTaskQueue(&TaskScheduler::taskCompare)
-	{
-		mMaxActiveTasks = BS_THREAD_HARDWARE_CONCURRENCY;
+	TaskPool::TaskPool(String name, TaskPriority priority)
+		:mName(std::move(name)), mPriority(priority)
+	{ }
 
-		mTaskSchedulerThread = ThreadPool::instance().run("TaskScheduler", std::bind(&TaskScheduler::runMain, this));
+	TaskPool::~TaskPool()
+	{
+		clear();
 	}
 
-	TaskScheduler::~TaskScheduler()
+	SPtr<Task> TaskPool::getTask(std::function<void()> worker)
 	{
-		// Wait until all tasks complete
+		// The scheduler keeps a reference to each task while it is queued or running, so a task referenced only by the
+		// pool is free to be queued again
+		const auto numEntries = (UINT32)mEntries.size();
+		for(UINT32 i = 0; i < numEntries; i++)
 		{
-			Lock activeTaskLock(mReadyMutex);
+			Entry* entry = mEntries[mNextEntry];
+			mNextEntry = (mNextEntry + 1) % numEntries;
 
-			while (mActiveTasks.size() > 0)
+			if(entry->task.use_count() == 1)
 			{
-				SPtr<Task> task = mActiveTasks[0];
-				activeTaskLock.unlock();
+				// Synchronize with the release of the reference by the worker that last ran the task
+				std::atomic_thread_fence(std::memory_order_acquire);
 
-				task->wait();
-				activeTaskLock.lock();
+				entry->worker = std::move(worker);
+				return entry->task;
 			}
 		}
 
-		// Start shutdown of the main queue worker and wait until it exits
+		auto entry = bs_new<Entry>();
+		entry->worker = std::move(worker);
+		entry->task = Task::create(mName, [entry]() { entry->worker(); }, mPriority);
+
+		mEntries.push_back(entry);
+		return entry->task;
+	}
+
+	void TaskPool::clear()
+	{
+		for(auto& entry : mEntries)
+			bs_delete(entry);
+
+		mEntries.clear();
+		mNextEntry = 0;
+	}
+
+	BS_THREADLOCAL TaskScheduler::Worker* TaskScheduler::CurrentWorker = nullptr;
+
+	TaskScheduler::TaskScheduler()
+	{
+		for(auto& entry : mSubmitted)
+			entry.store(nullptr, std::memory_order_relaxed);
+
+		mMaxActiveTasks = (INT32)BS_THREAD_HARDWARE_CONCURRENCY;
+	}
+
+	TaskScheduler::~TaskScheduler()
+	{
+		// Stop all the workers (any tasks currently executing will finish first)
 		{
 			Lock lock(mReadyMutex);
 
 			mShutdown = true;
+			mWorkEpoch++;
+		}
+
+		mTaskReadyCond.notify_all();
+
+		UINT32 numWorkers = mNumWorkers.load(std::memory_order_acquire);
+		for(UINT32 i = 0; i < numWorkers; i++)
+			mWorkers[i]->thread.blockUntilComplete();
+
+		// Release any tasks that never got to execute
+		for(UINT32 i = 0; i < NUM_PRIORITY_LANES; i++)
+		{
+			Task* task = mSubmitted[i].exchange(nullptr);
+			while(task != nullptr)
+			{
+				Task* next = task->mNextSubmitted;
+				releaseDependents(task);
+				releaseTask(task);
+
+				task = next;
+			}
+
+			for(UINT32 j = 0; j < numWorkers; j++)
+			{
+				while(mWorkers[j]->queues[i].steal(task))
+				{
+					releaseDependents(task);
+					releaseTask(task);
+				}
+			}
+		}
+
+		// Release tasks still waiting on dependencies that never executed. Each holds a reference to its dependency,
+		// which in turn holds a reference to it.
+		for(auto& entry : mParkedDependencies)
+		{
+			SPtr<Task> dependency = entry.lock();
+			if(dependency != nullptr)
+				releaseDependents(dependency.get());
 		}
 
-		mTaskReadyCond.notify_one();
+		mParkedDependencies.clear();
 
-		mTaskSchedulerThread.blockUntilComplete();
+		for(UINT32 i = 0; i < numWorkers; i++)
+			bs_delete(mWorkers[i]);
 	}
 
 	void TaskScheduler::addTask(SPtr<Task> task)
 	{
-		Lock lock(mReadyMutex);
-
 		assert(task->mState != 1 && "Task is already executing, it cannot be executed again until it finishes.");
+		assert(task->mSelf == nullptr && "Task is already queued.");
 
 		task->mParent = this;
-		task->mTaskId = mNextTaskId++;
 		task->mState.store(0); // Reset state in case the task is getting re-queued
 
-		mCheckTasks = true;
-		mTaskQueue.insert(std::move(task));
-
-		// Wake main scheduler thread
-		mTaskReadyCond.notify_one();
+		if(queueTask(std::move(task)))
+			wakeWorkers(1);
 	}
 
 	void TaskScheduler::addTaskGroup(const SPtr<TaskGroup>& taskGroup)
 	{
-		Lock lock(mReadyMutex);
+		taskGroup->mParent = this;
 
+		UINT32 numQueued = 0;
 		for(UINT32 i = 0; i < taskGroup->mCount; i++)
 		{
 			const auto worker = [i, taskGroup] 
@@ -132,118 +204,492 @@ namespace bs
 
 			SPtr<Task> task = Task::create(taskGroup->mName, worker, taskGroup->mPriority, taskGroup->mTaskDependency);
 			task->mParent = this;
-			task->mTaskId = mNextTaskId++;
-			task->mState.store(0); // Reset state in case the task is getting re-queued
 
-			mCheckTasks = true;
-			mTaskQueue.insert(std::move(task));
+			if(queueTask(std::move(task)))
+				numQueued++;
 		}
 
-		taskGroup->mParent = this;
-
-		// Wake main scheduler thread
-		mTaskReadyCond.notify_one();
+		wakeWorkers(numQueued);
 	}
 
 	void TaskScheduler::addWorker()
 	{
-		Lock lock(mReadyMutex);
-
 		mMaxActiveTasks++;
 
-		// A spot freed up, queue new tasks on main scheduler thread if they exist
-		mTaskReadyCond.notify_one();
+		// A slot freed up, let a sleeping worker pick up a queued task if there is one
+		wakeWorkers(1);
 	}
 
 	void TaskScheduler::removeWorker()
 	{
-		Lock lock(mReadyMutex);
-
-		if(mMaxActiveTasks > 0)
-			mMaxActiveTasks--;
+		mMaxActiveTasks--;
 	}
 
-	void TaskScheduler::runMain()
+	void TaskScheduler::runWorker(Worker* worker)
 	{
+		CurrentWorker = worker;
+
 		while(true)
 		{
+			UINT64 epoch = mWorkEpoch.load();
+			if(mShutdown)
+				break;
+
+			if(tryAcquireSlot())
+			{
+				// Someone is blocked waiting on a parallelFor() call, help out first
+				if(mNumParallelJobs.load() > 0 && helpParallelJobs())
+				{
+					releaseSlot();
+					continue;
+				}
+
+				Task* task = findTask(worker);
+				if(task != nullptr)
+				{
+					// Other tasks remain, make sure they get picked up by someone else while we're busy
+					if(mNumQueuedTasks.load() > 0)
+						wakeWorkers(1);
+
+					runTask(task);
+					releaseSlot();
+
+					continue;
+				}
+
+				releaseSlot();
+			}
+
+			// Nothing to do, sleep until new tasks get queued or a slot frees up
 			Lock lock(mReadyMutex);
 
-			while((!mCheckTasks || (UINT32)mActiveTasks.size() >= mMaxActiveTasks) && !mShutdown)
+			mNumSleepingWorkers++;
+			while(mWorkEpoch.load() == epoch && !mShutdown)
 				mTaskReadyCond.wait(lock);
+			mNumSleepingWorkers--;
+		}
 
-			mCheckTasks = false;
+		CurrentWorker = nullptr;
+	}
 
-			if(mShutdown)
+	void TaskScheduler::runParallelFor(UINT32 begin, UINT32 end, UINT32 grainSize, ParallelForFunc func, void* context)
+	{
+		if(begin >= end)
+			return;
+
+		grainSize = std::max(grainSize, 1U);
+
+		const UINT32 count = end - begin;
+		const UINT32 numWorkers = getNumWorkers();
+
+		// Not worth splitting
+		if(count <= grainSize || numWorkers == 0)
+		{
+			func(context, begin, end);
+			return;
+		}
+
+		ParallelJob* job = nullptr;
+		for(auto& entry : mParallelJobs)
+		{
+			bool inUse = false;
+			if(entry.inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+			{
+				job = &entry;
 				break;
+			}
+		}
 
-			for(auto iter = mTaskQueue.begin(); iter != mTaskQueue.end();)
+		// Out of job slots, just run everything on this thread
+		if(job == nullptr)
+		{
+			func(context, begin, end);
+			return;
+		}
+
+		job->next.store(begin, std::memory_order_relaxed);
+		job->numRemaining.store(count, std::memory_order_relaxed);
+		job->end = end;
+		job->grainSize = grainSize;
+		job->numParticipants = numWorkers + 1;
+		job->func = func;
+		job->context = context;
+		job->state.store(PARALLEL_JOB_OPEN, std::memory_order_release);
+
+		mNumParallelJobs++;
+
+		const UINT32 numChunks = (count + grainSize - 1) / grainSize;
+		wakeWorkers(std::min(numChunks - 1, numWorkers));
+
+		processParallelJob(*job);
+
+		// Wait for the helpers to finish any chunks they're still processing
+		if(job->numRemaining.load() > 0)
+		{
+			Lock lock(mCompleteMutex);
+			mNumWaiters++;
+
+			while(job->numRemaining.load() > 0)
 			{
-				if ((UINT32)mActiveTasks.size() >= mMaxActiveTasks)
-					break;	
+				addWorker();
+				mTaskCompleteCond.wait(lock);
+				removeWorker();
+			}
+
+			mNumWaiters--;
+		}
+
+		// Stop new helpers from joining, and wait until the current ones let go of the job before releasing the slot
+		job->state.fetch_and(~PARALLEL_JOB_OPEN);
+		mNumParallelJobs--;
 
-				SPtr<Task> curTask = *iter;
+		while((job->state.load(std::memory_order_acquire) & ~PARALLEL_JOB_OPEN) != 0)
+			std::this_thread::yield();
 
-				if(curTask->isCanceled())
+		job->inUse.store(false, std::memory_order_release);
+	}
+
+	bool TaskScheduler::helpParallelJobs()
+	{
+		bool helped = false;
+		for(auto& job : mParallelJobs)
+		{
+			UINT32 state = job.state.load(std::memory_order_relaxed);
+			while((state & PARALLEL_JOB_OPEN) != 0)
+			{
+				if(job.state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, 
+					std::memory_order_relaxed))
 				{
-					iter = mTaskQueue.erase(iter);
-					continue;
+					processParallelJob(job);
+					job.state.fetch_sub(1, std::memory_order_release);
+
+					helped = true;
+					break;
+				}
+			}
+		}
+
+		return helped;
+	}
+
+	void TaskScheduler::processParallelJob(ParallelJob& job)
+	{
+		UINT32 chunkBegin = job.next.load(std::memory_order_relaxed);
+		while(chunkBegin < job.end)
+		{
+			// Take large chunks while there's a lot of work remaining, reducing towards the grain size as the range 
+			// depletes so all participants finish at roughly the same time
+			const UINT32 remaining = job.end - chunkBegin;
+			const UINT32 chunkSize = std::min(std::max(job.grainSize, remaining / (job.numParticipants * 2)), remaining);
+
+			if(!job.next.compare_exchange_weak(chunkBegin, chunkBegin + chunkSize, std::memory_order_relaxed))
+				continue;
+
+			job.func(job.context, chunkBegin, chunkBegin + chunkSize);
+
+			if(job.numRemaining.fetch_sub(chunkSize) == chunkSize)
+				notifyTaskComplete();
+
+			chunkBegin = job.next.load(std::memory_order_relaxed);
+		}
+	}
+
+	void TaskScheduler::runTask(Task* task)
+	{
+		task->mState.store(1);
+		task->mTaskWorker();
+
+		Vector<SPtr<Task>> dependents;
+		{
+			ScopedSpinLock lock(task->mDependentsLock);
+
+			task->mState.store(2);
+			std::swap(dependents, task->mDependents);
+		}
+
+		notifyTaskComplete();
+
+		UINT32 numQueued = 0;
+		for(auto& entry : dependents)
+		{
+			if(queueTask(std::move(entry)))
+				numQueued++;
+		}
+
+		wakeWorkers(numQueued);
+		releaseTask(task);
+	}
+
+	bool TaskScheduler::queueTask(SPtr<Task> task)
+	{
+		Task* dependency = task->mTaskDependency.get();
+		if(dependency != nullptr)
+		{
+			ScopedSpinLock lock(dependency->mDependentsLock);
+
+			const UINT32 state = dependency->mState.load();
+			if(state == 3)
+			{
+				task->mState.store(3);
+				return false;
+			}
+
+			// Dependency not done, it will queue this task once it completes
+			if(state != 2)
+			{
+				const bool firstDependent = dependency->mDependents.empty();
+				std::weak_ptr<Task> dependencyRef = task->mTaskDependency;
+				dependency->mDependents.push_back(std::move(task));
+
+				if(firstDependent)
+				{
+					ScopedSpinLock parkedLock(mParkedDependenciesLock);
+
+					// Forget dependencies that have since executed or been destroyed, so the list doesn't keep growing
+					if((UINT32)mParkedDependencies.size() >= mParkedDependenciesPruneSize)
+					{
+						const auto isDone = [](const std::weak_ptr<Task>& entry)
+						{
+							SPtr<Task> parked = entry.lock();
+							return parked == nullptr || parked->mState.load() >= 2;
+						};
+
+						mParkedDependencies.erase(std::remove_if(mParkedDependencies.begin(), mParkedDependencies.end(), 
+							isDone), mParkedDependencies.end());
+						mParkedDependenciesPruneSize = std::max(64U, (UINT32)mParkedDependencies.size() * 2);
+					}
+
+					mParkedDependencies.push_back(std::move(dependencyRef));
 				}
 
-				if(curTask->mTaskDependency != nullptr && !curTask->mTaskDependency->isComplete())
+				return false;
+			}
+		}
+
+		pushReadyTask(std::move(task));
+		return true;
+	}
+
+	void TaskScheduler::pushReadyTask(SPtr<Task> task)
+	{
+		Task* taskPtr = task.get();
+		const UINT32 lane = getLane(taskPtr->mPriority);
+
+		// Scheduler keeps a reference to the task while it is queued
+		taskPtr->mSelf = std::move(task);
+		mNumQueuedTasks++;
+
+		// Workers queue on their own queue, where the task will most likely be picked up by the same worker
+		Worker* worker = CurrentWorker;
+		if(worker != nullptr)
+		{
+			worker->queues[lane].push(taskPtr);
+			return;
+		}
+
+		Task* head = mSubmitted[lane].load(std::memory_order_relaxed);
+		do
+		{
+			taskPtr->mNextSubmitted = head;
+		} while(!mSubmitted[lane].compare_exchange_weak(head, taskPtr, std::memory_order_release, 
+			std::memory_order_relaxed));
+	}
+
+	Task* TaskScheduler::findTask(Worker* worker)
+	{
+		const UINT32 numWorkers = mNumWorkers.load(std::memory_order_acquire);
+
+		for(INT32 lane = NUM_PRIORITY_LANES - 1; lane >= 0; lane--)
+		{
+			Task* task = nullptr;
+			while(true)
+			{
+				// Our own queue first
+				if(worker->queues[lane].pop(task))
+					break;
+
+				// Then tasks submitted from outside of workers. Take the entire list and move it into our own queue, from
+				// where other workers can steal the tasks.
+				if(mSubmitted[lane].load(std::memory_order_relaxed) != nullptr)
 				{
-					++iter;
-					continue;
+					Task* head = mSubmitted[lane].exchange(nullptr, std::memory_order_acquire);
+					if(head != nullptr)
+					{
+						// List is in reverse submission order. Push it so the oldest task ends up at the bottom of the 
+						// queue, and execute that one right away.
+						while(head->mNextSubmitted != nullptr)
+						{
+							Task* next = head->mNextSubmitted;
+							head->mNextSubmitted = nullptr;
+
+							worker->queues[lane].push(head);
+							head = next;
+						}
+
+						task = head;
+						break;
+					}
 				}
 
-				// Spin until a thread becomes available. This happens primarily because our mActiveTask count and
-				// ThreadPool's thread idle count aren't synced, so while the task manager thinks it's free to run new
-				// tasks, the ThreadPool might still have those threads as running, meaning their allocation will fail.
-				// So we just spin here for a bit, in that rare case.
-				if(ThreadPool::instance().getNumAvailable() == 0)
+				// Finally try stealing from other workers
+				for(UINT32 i = 1; i < numWorkers; i++)
 				{
-					mCheckTasks = true;
-					break;
+					Worker* victim = mWorkers[(worker->index + i) % numWorkers];
+					if(victim->queues[lane].steal(task))
+						break;
+
+					task = nullptr;
 				}
 
-				iter = mTaskQueue.erase(iter);
+				break;
+			}
 
-				curTask->mState.store(1);
-				mActiveTasks.push_back(curTask);
+			if(task == nullptr)
+				continue;
 
-				ThreadPool::instance().run(curTask->mName, std::bind(&TaskScheduler::runTask, this, curTask));
+			mNumQueuedTasks--;
+
+			if(task->isCanceled())
+			{
+				notifyTaskComplete();
+				releaseTask(task);
+
+				// Look for another task
+				lane = NUM_PRIORITY_LANES;
+				continue;
 			}
+
+			return task;
 		}
+
+		return nullptr;
 	}
 
-	void TaskScheduler::runTask(SPtr<Task> task)
+	bool TaskScheduler::tryAcquireSlot()
 	{
-		task->mTaskWorker();
+		INT32 numActive = mNumActiveTasks.load(std::memory_order_relaxed);
+		while(numActive < mMaxActiveTasks.load(std::memory_order_relaxed))
+		{
+			if(mNumActiveTasks.compare_exchange_weak(numActive, numActive + 1))
+				return true;
+		}
 
+		return false;
+	}
+
+	void TaskScheduler::releaseSlot()
+	{
+		mNumActiveTasks--;
+	}
+
+	void TaskScheduler::spawnWorkers(UINT32 count)
+	{
+		if(mNumWorkers.load() >= (UINT32)std::max(mMaxActiveTasks.load(), 0))
+			return;
+
+		Lock lock(mWorkerSpawnMutex);
+
+		UINT32 numWorkers = mNumWorkers.load();
+		for(UINT32 i = 0; i < count; i++)
 		{
-			Lock lock(mReadyMutex);
+			if(numWorkers >= MAX_WORKERS || numWorkers >= (UINT32)std::max(mMaxActiveTasks.load(), 0))
+				break;
+
+			// Don't go over the thread pool limit, existing workers will have to handle the load. If there are no
+			// workers, queued tasks would never execute, so wait until a pool thread frees up instead.
+			if(ThreadPool::instance().getNumAvailable() == 0)
+			{
+				if(numWorkers > 0)
+					break;
+
+				while(ThreadPool::instance().getNumAvailable() == 0 && !mShutdown)
+					std::this_thread::yield();
+
+				if(mShutdown)
+					break;
+			}
+
+			Worker* worker = bs_new<Worker>();
+			worker->index = numWorkers;
+
+			mWorkers[numWorkers] = worker;
+			mNumWorkers.store(++numWorkers, std::memory_order_release);
 
-			auto findIter = std::find(mActiveTasks.begin(), mActiveTasks.end(), task);
-			if (findIter != mActiveTasks.end())
-				mActiveTasks.erase(findIter);
+			worker->thread = ThreadPool::instance().run("TaskWorker", [this, worker]() { runWorker(worker); });
 		}
+	}
 
-		{
-			Lock lock(mCompleteMutex);
-			task->mState.store(2);
+	void TaskScheduler::wakeWorkers(UINT32 count)
+	{
+		if(count == 0)
+			return;
+
+		mWorkEpoch++;
+
+		// Threads are created on demand, when there are no idle workers to pick up the work
+		const UINT32 numSleeping = mNumSleepingWorkers.load();
+		if(numSleeping < count)
+			spawnWorkers(count - numSleeping);
 
-			mTaskCompleteCond.notify_all();
+		if(numSleeping == 0)
+			return;
+
+		Lock lock(mReadyMutex);
+
+		if(count == 1)
+			mTaskReadyCond.notify_one();
+		else
+			mTaskReadyCond.notify_all();
+	}
+
+	void TaskScheduler::notifyTaskComplete()
+	{
+		if(mNumWaiters.load() == 0)
+			return;
+
+		Lock lock(mCompleteMutex);
+		mTaskCompleteCond.notify_all();
+	}
+
+	void TaskScheduler::cancelDependents(Task* task)
+	{
+		Vector<SPtr<Task>> dependents;
+		{
+			ScopedSpinLock lock(task->mDependentsLock);
+			std::swap(dependents, task->mDependents);
 		}
 
-		// Wake the main scheduler thread in case there are other tasks waiting or this task was someone's dependency
+		for(auto& entry : dependents)
+			entry->cancel();
+	}
+
+	void TaskScheduler::releaseTask(Task* task)
+	{
+		// Move out first, as releasing the reference might destroy the task
+		SPtr<Task> self = std::move(task->mSelf);
+	}
+
+	void TaskScheduler::releaseDependents(Task* task)
+	{
+		Vector<SPtr<Task>> dependents;
 		{
-			Lock lock(mReadyMutex);
+			ScopedSpinLock lock(task->mDependentsLock);
+			std::swap(dependents, task->mDependents);
+		}
 
-			mCheckTasks = true;
-			mTaskReadyCond.notify_one();
+		for(auto& entry : dependents)
+		{
+			entry->mTaskDependency = nullptr;
+			releaseDependents(entry.get());
 		}
 	}
 
+	UINT32 TaskScheduler::getLane(TaskPriority priority)
+	{
+		const INT32 lane = (INT32)priority - (INT32)TaskPriority::VeryLow;
+		return (UINT32)std::min(std::max(lane, 0), (INT32)NUM_PRIORITY_LANES - 1);
+	}
+
 	void TaskScheduler::waitUntilComplete(const Task* task)
 	{
 		if(task->isCanceled())
@@ -251,19 +697,23 @@ namespace bs
 
 		{
 			Lock lock(mCompleteMutex);
+			mNumWaiters++;
 
-			while(!task->isComplete())
+			while(!task->isComplete() && !task->isCanceled())
 			{
 				addWorker();
 				mTaskCompleteCond.wait(lock);
 				removeWorker();
 			}
+
+			mNumWaiters--;
 		}
 	}
 
 	void TaskScheduler::waitUntilComplete(const TaskGroup* taskGroup)
 	{
 		Lock lock(mCompleteMutex);
+		mNumWaiters++;
 
 		while (taskGroup->mNumRemainingTasks > 0)
 		{
@@ -271,15 +721,7 @@ namespace bs
 			mTaskCompleteCond.wait(lock);
 			removeWorker();
 		}
-	}
-
-	bool TaskScheduler::taskCompare(const SPtr<Task>& lhs, const SPtr<Task>& rhs)
-	{
-		// If priority is the same, sort by the order the tasks were queued
-		if(lhs->mPriority == rhs->mPriority)
-			return lhs->mTaskId < rhs->mTaskId;
 
-		// Otherwise the task with the higher priority always goes first
-		return lhs->mPriority > rhs->mPriority;
+		mNumWaiters--;
 	}
 }
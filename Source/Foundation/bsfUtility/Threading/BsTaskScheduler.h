@@ -5,6 +5,8 @@
 #include "Prerequisites/BsPrerequisitesUtil.h"
 #include "Utility/BsModule.h"
 #include "Threading/BsThreadPool.h"
+#include "Threading/BsSpinLock.h"
+#include "Threading/BsWorkStealingDeque.h"
 
 namespace bs
 {
@@ -69,12 +71,16 @@ namespace bs
 
 		String mName;
 		TaskPriority mPriority;
-		UINT32 mTaskId = 0;
 		std::function<void()> mTaskWorker;
 		SPtr<Task> mTaskDependency;
 		std::atomic<UINT32> mState{0}; /**< 0 - Inactive, 1 - In progress, 2 - Completed, 3 - Canceled */
 
 		TaskScheduler* mParent = nullptr;
+
+		SPtr<Task> mSelf; /**< Keeps the task alive while it is referenced only by the scheduler queues. */
+		Task* mNextSubmitted = nullptr; /**< Link in the scheduler's lock-free submission list. */
+		Vector<SPtr<Task>> mDependents; /**< Tasks waiting for this task to complete before they can be queued. */
+		SpinLock mDependentsLock;
 	};
 
 	/**
@@ -127,6 +133,52 @@ namespace bs
 		TaskScheduler* mParent = nullptr;
 	};
 
+	/**
+	 * Hands out reusable tasks, for code that queues many small tasks and would otherwise allocate a new task for each 
+	 * one. A task is handed out again once the scheduler has released it after execution, and the only remaining 
+	 * reference to it is the one held by the pool.
+	 *
+	 * @note	Not thread safe.
+	 */
+	class BS_UTILITY_EXPORT TaskPool
+	{
+		/** Pooled task, along with the worker method it runs the next time it executes. */
+		struct Entry
+		{
+			SPtr<Task> task;
+			std::function<void()> worker;
+		};
+
+	public:
+		/** 
+		 * Constructs a new pool.
+		 *
+		 * @param[in]	name		Name of all the tasks created by the pool.
+		 * @param[in]	priority	Priority of all the tasks created by the pool.
+		 */
+		TaskPool(String name, TaskPriority priority = TaskPriority::Normal);
+		~TaskPool();
+
+		/** 
+		 * Returns a task that executes @p worker, ready to be queued in the TaskScheduler. Reuses a free task from the
+		 * pool if there is one, or creates a new one otherwise.
+		 */
+		SPtr<Task> getTask(std::function<void()> worker);
+
+		/** Returns the number of tasks created by the pool, both free and in use. */
+		UINT32 getNumTasks() const { return (UINT32)mEntries.size(); }
+
+		/** Releases all the pooled tasks. Must not be called while any of them are queued or running. */
+		void clear();
+
+	private:
+		String mName;
+		TaskPriority mPriority;
+
+		Vector<Entry*> mEntries;
+		UINT32 mNextEntry = 0;
+	};
+
 	/**
 	 * Represents a task scheduler running on multiple threads. You may queue tasks on it from any thread and they will be
 	 * executed in user specified order on any available thread.
@@ -134,12 +186,15 @@ namespace bs
 	 * @note
 	 * Thread safe.
 	 * @note
-	 * This type of task scheduler uses a global queue and is best used for coarse granularity of tasks. (Number of tasks
-	 * in the order of hundreds. Higher number of tasks might require different queuing and locking mechanism, potentially
-	 * at the cost of flexibility.)
+	 * Scheduler uses a set of long-lived worker threads, each owning a lock-free work-stealing queue per task priority.
+	 * Tasks queued from a worker thread are pushed on that worker's own queue (and executed most-recent first), while
+	 * tasks queued from other threads are pushed on a lock-free submission list that idle workers drain. Idle workers
+	 * steal tasks from other workers, always preferring tasks of higher priority. Tasks with dependencies are not queued
+	 * until their dependency completes. This makes the scheduler suitable for large numbers of fine grained tasks. There
+	 * is no strict ordering between tasks of the same priority.
 	 * @note
-	 * By default the task scheduler will create as many threads as there are physical CPU cores. You may add or remove
-	 * threads using addWorker()/removeWorker() methods.
+	 * By default the task scheduler will allow as many tasks to execute simultaneously as there are physical CPU cores.
+	 * You may change that number using addWorker()/removeWorker() methods.
 	 */
 	class BS_UTILITY_EXPORT TaskScheduler : public Module<TaskScheduler>
 	{
@@ -153,23 +208,148 @@ namespace bs
 		/** Queues a new task group. */
 		void addTaskGroup(const SPtr<TaskGroup>& taskGroup);
 
-		/**	Adds a new worker thread which will be used for executing queued tasks. */
+		/**	Allows one more task to execute simultaneously. New worker threads are created as required. */
 		void addWorker();
 
-		/**	Removes a worker thread (as soon as its current task is finished). */
+		/**	Allows one less task to execute simultaneously (as soon as a currently executing task finishes). */
 		void removeWorker();
 
+		/**
+		 * Executes @p worker for each index in range [@p begin, @p end), spreading the work across the worker threads.
+		 * The calling thread participates in the work, and the method returns once all the indices have been processed.
+		 *
+		 * The range is split into chunks adaptively, starting with large chunks and getting smaller as the range is
+		 * being depleted, so the work stays balanced between threads. No memory is allocated by this call.
+		 *
+		 * @param[in]	begin		Index of the first element to process.
+		 * @param[in]	end			Index one past the last element to process.
+		 * @param[in]	grainSize	Minimum number of indices to process as a single unit of work. Increase this if the
+		 *							work per index is very small.
+		 * @param[in]	worker		Callable with a void(UINT32 index) signature, called once for each index in the range.
+		 *							Will be called from multiple threads simultaneously.
+		 */
+		template<class T>
+		void parallelFor(UINT32 begin, UINT32 end, UINT32 grainSize, const T& worker)
+		{
+			const auto processRange = [](void* context, UINT32 rangeBegin, UINT32 rangeEnd)
+			{
+				const T& func = *(const T*)context;
+				for(UINT32 i = rangeBegin; i < rangeEnd; i++)
+					func(i);
+			};
+
+			runParallelFor(begin, end, grainSize, processRange, (void*)&worker);
+		}
+
 		/** Returns the maximum available worker threads (maximum number of tasks that can be executed simultaneously). */
-		UINT32 getNumWorkers() const { return mMaxActiveTasks; }
+		UINT32 getNumWorkers() const { return (UINT32)std::max(mMaxActiveTasks.load(std::memory_order_relaxed), 0); }
 	protected:
 		friend class Task;
 		friend class TaskGroup;
 
-		/**	Main task scheduler method that dispatches tasks to other threads. */
-		void runMain();
+		/** Maximum number of worker threads the scheduler will create. */
+		static constexpr UINT32 MAX_WORKERS = 64;
+
+		/** Number of distinct queues per worker, one for each value in TaskPriority. */
+		static constexpr UINT32 NUM_PRIORITY_LANES = 5;
+
+		/** Maximum number of parallelFor() calls that can be distributed across workers at once. */
+		static constexpr UINT32 MAX_PARALLEL_JOBS = 32;
+
+		/** Bit in ParallelJob::state signifying that new helpers may join the job. */
+		static constexpr UINT32 PARALLEL_JOB_OPEN = 1U << 31;
+
+		/** Function that processes a range of indices for a parallelFor() call. */
+		typedef void(*ParallelForFunc)(void* /*context*/, UINT32 /*begin*/, UINT32 /*end*/);
+
+		/** State of a single parallelFor() call that workers can help with. */
+		struct ParallelJob
+		{
+			std::atomic<bool> inUse{false};
+			std::atomic<UINT32> state{0}; /**< PARALLEL_JOB_OPEN flag combined with the number of helpers. */
+			std::atomic<UINT32> next{0};
+			std::atomic<UINT32> numRemaining{0};
+
+			UINT32 end = 0;
+			UINT32 grainSize = 1;
+			UINT32 numParticipants = 1;
+			ParallelForFunc func = nullptr;
+			void* context = nullptr;
+		};
+
+		/** Information about a single worker thread. */
+		struct Worker
+		{
+			UINT32 index = 0;
+			HThread thread;
+			WorkStealingDeque<Task*> queues[NUM_PRIORITY_LANES];
+		};
+
+		/**	Main loop ran by each of the worker threads. */
+		void runWorker(Worker* worker);
+
+		/** Non-templated implementation of parallelFor(). */
+		void runParallelFor(UINT32 begin, UINT32 end, UINT32 grainSize, ParallelForFunc func, void* context);
+
+		/** 
+		 * Helps out with any parallelFor() calls currently in progress. Returns true if the worker managed to join at
+		 * least one of them.
+		 */
+		bool helpParallelJobs();
+
+		/** Processes chunks of the provided parallel job until there are none left. */
+		void processParallelJob(ParallelJob& job);
+
+		/**	Executes a single task and schedules any tasks depending on it. */
+		void runTask(Task* task);
+
+		/** 
+		 * Queues a task for execution on one of the workers (or registers it with its dependency, if the dependency hasn't
+		 * finished yet). Caller is responsible for waking up the workers.
+		 *
+		 * @return		True if the task was queued for immediate execution.
+		 */
+		bool queueTask(SPtr<Task> task);
+
+		/** Pushes a task that is ready for execution onto a worker or submission queue. */
+		void pushReadyTask(SPtr<Task> task);
+
+		/** Finds the next task to execute on the provided worker. Returns null if no task is available. */
+		Task* findTask(Worker* worker);
 
-		/**	Worker method that runs a single task. */
-		void runTask(SPtr<Task> task);
+		/** Attempts to reserve one of the slots for active tasks. */
+		bool tryAcquireSlot();
+
+		/** Releases a slot previously acquired through tryAcquireSlot(). */
+		void releaseSlot();
+
+		/** 
+		 * Creates up to @p count new worker threads, as long as the total number of workers doesn't exceed the number of
+		 * active task slots. If there are no workers yet and the thread pool has no free threads, blocks until one frees
+		 * up, so that queued tasks always have a worker to execute them.
+		 */
+		void spawnWorkers(UINT32 count);
+
+		/** Wakes up to @p count sleeping workers so they can check for new tasks. */
+		void wakeWorkers(UINT32 count);
+
+		/** Notifies any threads blocked in waitUntilComplete() that a task has finished. */
+		void notifyTaskComplete();
+
+		/** Cancels all tasks depending on the provided task, and releases the scheduler's reference to them. */
+		static void cancelDependents(Task* task);
+
+		/** Releases the scheduler's reference to a task, potentially destroying it. */
+		static void releaseTask(Task* task);
+
+		/** 
+		 * Releases all tasks waiting on the provided task, and their references back to it, so a task that will never 
+		 * execute doesn't keep itself and its dependents alive through a reference cycle. 
+		 */
+		static void releaseDependents(Task* task);
+
+		/** Converts a priority to the index of the queue tasks with that priority are stored in. */
+		static UINT32 getLane(TaskPriority priority);
 
 		/**	Blocks the calling thread until the specified task has completed. */
 		void waitUntilComplete(const Task* task);
@@ -177,17 +357,30 @@ namespace bs
 		/**	Blocks the calling thread until all the tasks in the provided task group have completed. */
 		void waitUntilComplete(const TaskGroup* taskGroup);
 
-		/**	Method used for sorting tasks. */
-		static bool taskCompare(const SPtr<Task>& lhs, const SPtr<Task>& rhs);
+		static BS_THREADLOCAL Worker* CurrentWorker; /**< Worker ran by the current thread, if any. */
+
+		Worker* mWorkers[MAX_WORKERS];
+		std::atomic<UINT32> mNumWorkers{0};
+		std::atomic<Task*> mSubmitted[NUM_PRIORITY_LANES];
+		std::atomic<INT32> mNumQueuedTasks{0};
+
+		ParallelJob mParallelJobs[MAX_PARALLEL_JOBS];
+		std::atomic<UINT32> mNumParallelJobs{0};
+
+		std::atomic<INT32> mMaxActiveTasks{0};
+		std::atomic<INT32> mNumActiveTasks{0};
+		std::atomic<bool> mShutdown{false};
+
+		std::atomic<UINT64> mWorkEpoch{0};
+		std::atomic<UINT32> mNumSleepingWorkers{0};
+		std::atomic<UINT32> mNumWaiters{0};
 
-		HThread mTaskSchedulerThread;
-		Set<SPtr<Task>, std::function<bool(const SPtr<Task>&, const SPtr<Task>&)>> mTaskQueue;
-		Vector<SPtr<Task>> mActiveTasks;
-		UINT32 mMaxActiveTasks = 0;
-		UINT32 mNextTaskId = 0;
-		bool mShutdown = false;
-		bool mCheckTasks = false;
+		/** Tasks that had other tasks waiting on them at some point, whose dependents must be released on shutdown. */
+		Vector<std::weak_ptr<Task>> mParkedDependencies;
+		UINT32 mParkedDependenciesPruneSize = 64;
+		SpinLock mParkedDependenciesLock;
 
+		Mutex mWorkerSpawnMutex;
 		Mutex mReadyMutex;
 		Mutex mCompleteMutex;
 		Signal mTaskReadyCond;
@@ -7,6 +7,7 @@
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include "Threading/BsSpinLock.h"
 
@@ -29,6 +30,9 @@ using Mutex = std::mutex;
 /** Wrapper for the C++ std::recursive_mutex. */
 using RecursiveMutex = std::recursive_mutex;
 
+/** Wrapper for the C++ std::shared_timed_mutex. */
+using SharedMutex = std::shared_timed_mutex;
+
 /** Wrapper for the C++ std::condition_variable. */
 using Signal = std::condition_variable;
 
@@ -44,6 +48,12 @@ using Lock = std::unique_lock<Mutex>;
 /** Wrapper for the C++ std::unique_lock<std::recursive_mutex>. */
 using RecursiveLock = std::unique_lock<RecursiveMutex>;
 
+/** Wrapper for the C++ std::shared_lock<std::shared_timed_mutex>. */
+using SharedLock = std::shared_lock<SharedMutex>;
+
+/** Wrapper for the C++ std::unique_lock<std::shared_timed_mutex>. */
+using ExclusiveLock = std::unique_lock<SharedMutex>;
+
 /** @} */
 
 namespace bs
@@ -0,0 +1,202 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#pragma once
+
+#include "Prerequisites/BsPrerequisitesUtil.h"
+#include <atomic>
+
+namespace bs
+{
+	/** @addtogroup Internal-Utility
+	 *  @{
+	 */
+
+	/** @addtogroup Threading-Internal
+	 *  @{
+	 */
+
+	/**
+	 * Lock-free double ended queue for use in work-stealing schedulers (Chase-Lev). A single owner thread pushes and pops
+	 * elements at the bottom of the queue (in LIFO order), while any number of other threads may concurrently steal
+	 * elements from the top of the queue (in FIFO order). The queue grows automatically as elements are pushed.
+	 *
+	 * @tparam	T	Type of element stored in the queue. Must be trivially copyable (normally a pointer).
+	 *
+	 * @note
+	 * push() and pop() must only be called from the thread that owns the queue. steal(), isEmpty() and size() may be
+	 * called from any thread.
+	 */
+	template<class T>
+	class WorkStealingDeque
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Work stealing queue elements must be trivially copyable.");
+
+		/** Circular array holding the queue elements. */
+		struct Buffer
+		{
+			Buffer(INT64 capacity, Buffer* previous)
+				:capacity(capacity), mask(capacity - 1), previous(previous)
+			{
+				data = bs_newN<std::atomic<T>>((size_t)capacity);
+			}
+
+			~Buffer()
+			{
+				bs_deleteN(data, (size_t)capacity);
+			}
+
+			T get(INT64 idx) const { return data[idx & mask].load(std::memory_order_relaxed); }
+			void put(INT64 idx, T value) { data[idx & mask].store(value, std::memory_order_relaxed); }
+
+			INT64 capacity;
+			INT64 mask;
+			std::atomic<T>* data;
+			Buffer* previous;
+		};
+
+	public:
+		/**
+		 * Constructs a new queue.
+		 *
+		 * @param[in]	capacity	Initial number of elements the queue can hold before it needs to grow. Must be a power
+		 *							of two.
+		 */
+		WorkStealingDeque(UINT32 capacity = 256)
+		{
+			assert(capacity > 0 && (capacity & (capacity - 1)) == 0 && "Capacity must be a power of two.");
+
+			mBuffer.store(bs_new<Buffer>((INT64)capacity, nullptr), std::memory_order_relaxed);
+		}
+
+		~WorkStealingDeque()
+		{
+			Buffer* buffer = mBuffer.load(std::memory_order_relaxed);
+			while(buffer != nullptr)
+			{
+				Buffer* previous = buffer->previous;
+				bs_delete(buffer);
+
+				buffer = previous;
+			}
+		}
+
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+		/** Pushes a new element to the bottom of the queue. Must only be called by the owner thread. */
+		void push(T value)
+		{
+			INT64 bottom = mBottom.load(std::memory_order_relaxed);
+			INT64 top = mTop.load(std::memory_order_acquire);
+			Buffer* buffer = mBuffer.load(std::memory_order_relaxed);
+
+			if(bottom - top > buffer->capacity - 1)
+				buffer = grow(buffer, bottom, top);
+
+			buffer->put(bottom, value);
+			mBottom.store(bottom + 1, std::memory_order_release);
+		}
+
+		/**
+		 * Attempts to pop an element from the bottom of the queue. Returns false if the queue is empty. Must only be
+		 * called by the owner thread.
+		 */
+		bool pop(T& output)
+		{
+			INT64 bottom = mBottom.load(std::memory_order_relaxed) - 1;
+			Buffer* buffer = mBuffer.load(std::memory_order_relaxed);
+			mBottom.store(bottom, std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			INT64 top = mTop.load(std::memory_order_relaxed);
+
+			if(top > bottom)
+			{
+				// Empty queue
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			T value = buffer->get(bottom);
+			if(top == bottom)
+			{
+				// Last element, race against any thieves for it
+				bool won = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+					std::memory_order_relaxed);
+
+				mBottom.store(bottom + 1, std::memory_order_relaxed);
+
+				if(!won)
+					return false;
+			}
+
+			output = value;
+			return true;
+		}
+
+		/**
+		 * Attempts to steal an element from the top of the queue. Returns false if the queue is empty or if another thread
+		 * took the element first. Can be called from any thread.
+		 */
+		bool steal(T& output)
+		{
+			INT64 top = mTop.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			INT64 bottom = mBottom.load(std::memory_order_acquire);
+
+			if(top >= bottom)
+				return false;
+
+			Buffer* buffer = mBuffer.load(std::memory_order_acquire);
+			T value = buffer->get(top);
+
+			if(!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return false;
+
+			output = value;
+			return true;
+		}
+
+		/** Returns true if the queue currently holds no elements. Result is only approximate if called from a thief. */
+		bool isEmpty() const
+		{
+			INT64 bottom = mBottom.load(std::memory_order_relaxed);
+			INT64 top = mTop.load(std::memory_order_relaxed);
+
+			return bottom <= top;
+		}
+
+		/** Returns the number of elements in the queue. Result is only approximate if called from a thief. */
+		UINT32 size() const
+		{
+			INT64 bottom = mBottom.load(std::memory_order_relaxed);
+			INT64 top = mTop.load(std::memory_order_relaxed);
+
+			return bottom > top ? (UINT32)(bottom - top) : 0;
+		}
+
+	private:
+		/**
+		 * Replaces the current buffer with one twice the size. Old buffer is kept alive until the queue is destroyed, as
+		 * thieves might still be reading from it.
+		 */
+		Buffer* grow(Buffer* buffer, INT64 bottom, INT64 top)
+		{
+			Buffer* newBuffer = bs_new<Buffer>(buffer->capacity * 2, buffer);
+			for(INT64 i = top; i < bottom; i++)
+				newBuffer->put(i, buffer->get(i));
+
+			mBuffer.store(newBuffer, std::memory_order_release);
+			return newBuffer;
+		}
+
+		// Padding keeps the thief and owner ends on separate cache lines
+		std::atomic<INT64> mTop{0};
+		UINT8 mPadding0[64 - sizeof(std::atomic<INT64>)];
+		std::atomic<INT64> mBottom{0};
+		std::atomic<Buffer*> mBuffer{nullptr};
+	};
+
+	/** @} */
+	/** @} */
+}
@@ -268,6 +268,49 @@ namespace bs
 			return index;
 		}
 
+		/** 
+		 * Changes the number of bits in the bitfield to @p count. If the bitfield grows the new bits are set to @p value.
+		 */
+		void resize(uint32_t count, bool value = false)
+		{
+			if(count > mMaxBits)
+				realloc(count);
+
+			if(count > mNumBits)
+			{
+				// Set the bits in the partially filled dword one by one, then the remaining dwords in bulk
+				uint32_t bitIdx = mNumBits;
+				mNumBits = count;
+
+				for(; bitIdx < count && (bitIdx & (BITS_PER_DWORD - 1)) != 0; bitIdx++)
+					(*this)[bitIdx] = value;
+
+				if(bitIdx < count)
+				{
+					const uint32_t firstDword = bitIdx >> BITS_PER_DWORD_LOG2;
+					const uint32_t numDwords = Math::divideAndRoundUp(count, BITS_PER_DWORD) - firstDword;
+					memset(&mData[firstDword], value ? 0xFF : 0, numDwords * sizeof(uint32_t));
+				}
+			}
+			else
+				mNumBits = count;
+		}
+
+		/** 
+		 * Sets each bit that is set in @p other, leaving the remaining bits as is. Both bitfields must have the same 
+		 * number of bits.
+		 */
+		Bitfield& operator|=(const Bitfield& other)
+		{
+			assert(mNumBits == other.mNumBits);
+
+			const uint32_t numDwords = Math::divideAndRoundUp(mNumBits, BITS_PER_DWORD);
+			for(uint32_t i = 0; i < numDwords; i++)
+				mData[i] |= other.mData[i];
+
+			return *this;
+		}
+
 		/** Removes a bit at the specified index. */
 		void remove(uint32_t index)
 		{
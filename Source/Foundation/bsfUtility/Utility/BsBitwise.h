@@ -174,7 +174,7 @@ namespace bs
 			}
 #endif // BS_ARCH_TYPE
 #elif BS_COMPILER == BS_COMPILER_GNUC || BS_COMPILER == BS_COMPILER_CLANG
-			return 31 - __builtin_clzll(val);
+			return 63 - __builtin_clzll(val);
 #else // BS_COMPILER
 			static_assert(false, "Not implemented");
 #endif // BS_COMPILER
@@ -293,7 +293,7 @@ namespace bs
 		{
 			if (value <= 0.0f) return 0;
 			if (value >= 1.0f) return (1 << bits) - 1;
-			return Math::roundToInt(value * (1 << bits));
+			return Math::roundToInt(value * ((1 << bits) - 1));
 		}
 
 		/** 
@@ -326,7 +326,7 @@ namespace bs
 		{
 			if (value <= 0.0f) return 0;
 			if (value >= 1.0f) return (1 << bits) - 1;
-			return Math::roundToInt(value * (1 << bits));
+			return Math::roundToInt(value * ((1 << bits) - 1));
 		}
 
 		/** 
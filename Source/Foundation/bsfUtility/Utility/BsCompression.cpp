@@ -2,6 +2,8 @@
 //*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
 #include "Utility/BsCompression.h"
 #include "FileSystem/BsDataStream.h"
+#include "Threading/BsTaskScheduler.h"
+#include "Utility/BsBitwise.h"
 
 // Third party
 #include "snappy.h"
@@ -20,7 +22,9 @@ namespace bs
 			mTotal = mStream->size() - mStream->tell();
 			mRemaining = mTotal;
 
-			if (mStream->isFile())
+			if (mStream->isMapped())
+				mMappedData = (char*)std::static_pointer_cast<MappedFileDataStream>(mStream)->getCurrentPtr();
+			else if (mStream->isFile())
 				mReadBuffer = (char*)bs_alloc(32768);
 		}
 
@@ -37,7 +41,12 @@ namespace bs
 
 		const char* Peek(size_t* len) override
 		{
-			if (!mStream->isFile())
+			if (mMappedData != nullptr)
+			{
+				*len = Available();
+				return mMappedData + mBufferOffset;
+			}
+			else if (!mStream->isFile())
 			{
 				SPtr<MemoryDataStream> memStream = std::static_pointer_cast<MemoryDataStream>(mStream);
 
@@ -76,6 +85,9 @@ namespace bs
 		size_t mTotal;
 		size_t mBufferOffset = 0;
 
+		// Mapped streams only
+		char* mMappedData = nullptr;
+
 		// File streams only
 		char* mReadBuffer = nullptr;
 		size_t mReadBufferContentSize = 0;
@@ -198,4 +210,998 @@ namespace bs
 
 		return dst.GetOutput();
 	}
+
+	/** Identifier at the start of data in the CompressionMethod::Chunked format ("CHNK"). */
+	static constexpr UINT32 CHUNKED_MAGIC = 0x4B4E4843;
+
+	/** Number of blocks compressChunked() reads and compresses at once, per worker thread. */
+	static constexpr UINT32 CHUNKED_BLOCKS_PER_WORKER = 4;
+
+	/** 
+	 * Header at the start of data in the CompressionMethod::Chunked format. Followed by the compressed size of each
+	 * block (UINT32 each), the codec of each block (UINT8 each), and finally the compressed data of all the blocks.
+	 */
+	struct ChunkedHeader
+	{
+		UINT32 magic;
+		UINT32 blockSize;
+		UINT64 size;
+		UINT32 numBlocks;
+		UINT32 reserved;
+	};
+
+	/** Shortest match encoded by the LZHuffman codec. */
+	static constexpr UINT32 LZH_MIN_MATCH = 4;
+
+	/** Longest match encoded by the LZHuffman codec. Match lengths are encoded relative to LZH_MIN_MATCH. */
+	static constexpr UINT32 LZH_MAX_MATCH = LZH_MIN_MATCH + 1023;
+
+	/** Matches at least this long are taken right away, without checking if a longer one starts at the next byte. */
+	static constexpr UINT32 LZH_GOOD_MATCH = 32;
+
+	/** Maximum number of earlier positions with the same hash examined when looking for a match. */
+	static constexpr UINT32 LZH_MAX_CHAIN = 64;
+
+	/** Number of bits in the hash used for finding matches. */
+	static constexpr UINT32 LZH_HASH_BITS = 16;
+
+	/** Maximum length of a Huffman code, in bits. */
+	static constexpr UINT32 LZH_MAX_CODE_LENGTH = 15;
+
+	/** Symbol marking the end of the block in the literal/length alphabet. */
+	static constexpr UINT32 LZH_END_OF_BLOCK = 256;
+
+	/** Number of symbols in the literal/length alphabet: literals, end of block, and a slot for each match length range. */
+	static constexpr UINT32 LZH_NUM_LITLEN_SYMBOLS = LZH_END_OF_BLOCK + 1 + 20;
+
+	/** Number of symbols in the distance alphabet, a slot for each distance range. Covers any 32-bit distance. */
+	static constexpr UINT32 LZH_NUM_DIST_SYMBOLS = 64;
+
+	/** 
+	 * Splits a value into a slot and extra bits. Slots cover ranges that double in size every two slots, and the extra
+	 * bits select the value within the range.
+	 */
+	static void lzhEncodeSlot(UINT32 value, UINT32& slot, UINT32& numExtraBits, UINT32& extraBits)
+	{
+		if (value < 4)
+		{
+			slot = value;
+			numExtraBits = 0;
+			extraBits = 0;
+			return;
+		}
+
+		const UINT32 msb = Bitwise::mostSignificantBit(value);
+		const UINT32 half = (value >> (msb - 1)) & 1;
+
+		slot = msb * 2 + half;
+		numExtraBits = msb - 1;
+		extraBits = value - ((2 | half) << (msb - 1));
+	}
+
+	/** Inverse of lzhEncodeSlot(). Returns the first value of the range covered by the slot. */
+	static UINT32 lzhDecodeSlot(UINT32 slot, UINT32& numExtraBits)
+	{
+		if (slot < 4)
+		{
+			numExtraBits = 0;
+			return slot;
+		}
+
+		const UINT32 msb = slot / 2;
+		numExtraBits = msb - 1;
+
+		return (2 | (slot & 1)) << (msb - 1);
+	}
+
+	/** Writes bits into a buffer, starting at the least significant bit of each byte. */
+	struct LZHBitWriter
+	{
+		LZHBitWriter(UINT8* data, size_t capacity)
+			:data(data), capacity(capacity)
+		{ }
+
+		/** Writes @p count lowest bits of @p value. @p count must not be larger than 32. */
+		void write(UINT32 value, UINT32 count)
+		{
+			bits |= (UINT64)value << numBits;
+			numBits += count;
+
+			while (numBits >= 8)
+			{
+				if (size < capacity)
+					data[size] = (UINT8)bits;
+				else
+					overflow = true;
+
+				size++;
+				bits >>= 8;
+				numBits -= 8;
+			}
+		}
+
+		/** Writes out any partially filled byte. */
+		void flush()
+		{
+			if (numBits > 0)
+				write(0, 8 - numBits);
+		}
+
+		UINT8* data;
+		size_t capacity;
+		size_t size = 0;
+		bool overflow = false;
+
+		UINT64 bits = 0;
+		UINT32 numBits = 0;
+	};
+
+	/** Reads bits written by LZHBitWriter. Reading past the end of the data yields zeroes, and is detected by overrun(). */
+	struct LZHBitReader
+	{
+		LZHBitReader(const UINT8* data, size_t size)
+			:data(data), size(size)
+		{ }
+
+		/** Returns the next @p count bits, without consuming them. @p count must not be larger than 32. */
+		UINT32 peek(UINT32 count)
+		{
+			while (numBits <= 56)
+			{
+				if (pos < size)
+					bits |= (UINT64)data[pos] << numBits;
+
+				pos++;
+				numBits += 8;
+			}
+
+			return (UINT32)(bits & ((1ULL << count) - 1));
+		}
+
+		/** Advances past @p count bits previously returned by peek(). */
+		void consume(UINT32 count)
+		{
+			bits >>= count;
+			numBits -= count;
+		}
+
+		/** Reads and consumes the next @p count bits. */
+		UINT32 read(UINT32 count)
+		{
+			const UINT32 value = peek(count);
+			consume(count);
+
+			return value;
+		}
+
+		/** Checks if more bits were consumed than there are in the data. */
+		bool overrun() const
+		{
+			return pos * 8 - numBits > size * 8;
+		}
+
+		const UINT8* data;
+		size_t size;
+		size_t pos = 0;
+
+		UINT64 bits = 0;
+		UINT32 numBits = 0;
+	};
+
+	/**
+	 * Calculates lengths of Huffman codes for the provided symbol frequencies, limited to LZH_MAX_CODE_LENGTH bits. If
+	 * the tree ends up too deep the frequencies are flattened and the tree rebuilt, which slightly reduces the ratio but
+	 * only happens for very skewed frequencies.
+	 */
+	static void lzhBuildCodeLengths(const UINT32* frequencies, UINT32 numSymbols, UINT8* lengths)
+	{
+		Vector<UINT32> symbols;
+		Vector<UINT64> weights;
+		for (UINT32 i = 0; i < numSymbols; i++)
+		{
+			lengths[i] = 0;
+
+			if (frequencies[i] > 0)
+			{
+				symbols.push_back(i);
+				weights.push_back(frequencies[i]);
+			}
+		}
+
+		const auto numLeaves = (UINT32)symbols.size();
+		if (numLeaves == 0)
+			return;
+
+		// Every symbol needs at least one bit, even if it's the only one
+		if (numLeaves == 1)
+		{
+			lengths[symbols[0]] = 1;
+			return;
+		}
+
+		using Node = std::pair<UINT64, UINT32>;
+		Vector<UINT32> parents(numLeaves * 2 - 1);
+		Vector<UINT32> depths(numLeaves * 2 - 1);
+
+		while (true)
+		{
+			// Leaves are nodes [0, numLeaves), internal nodes follow in the order they were created, so a parent always
+			// comes after its children
+			std::priority_queue<Node, Vector<Node>, std::greater<Node>> queue;
+			for (UINT32 i = 0; i < numLeaves; i++)
+				queue.push(Node(weights[i], i));
+
+			UINT32 nextNode = numLeaves;
+			while (queue.size() > 1)
+			{
+				const Node a = queue.top();
+				queue.pop();
+
+				const Node b = queue.top();
+				queue.pop();
+
+				parents[a.second] = nextNode;
+				parents[b.second] = nextNode;
+				queue.push(Node(a.first + b.first, nextNode));
+
+				nextNode++;
+			}
+
+			UINT32 maxDepth = 0;
+			depths[nextNode - 1] = 0;
+			for (INT32 i = (INT32)nextNode - 2; i >= 0; i--)
+			{
+				depths[i] = depths[parents[i]] + 1;
+
+				if ((UINT32)i < numLeaves)
+					maxDepth = std::max(maxDepth, depths[i]);
+			}
+
+			if (maxDepth <= LZH_MAX_CODE_LENGTH)
+				break;
+
+			for (auto& entry : weights)
+				entry = (entry >> 1) | 1;
+		}
+
+		for (UINT32 i = 0; i < numLeaves; i++)
+			lengths[symbols[i]] = (UINT8)depths[i];
+	}
+
+	/** 
+	 * Assigns canonical Huffman codes to symbols with the provided code lengths. Codes are bit-reversed, so they can be
+	 * written least significant bit first. Returns false if the lengths don't describe a valid prefix code.
+	 */
+	static bool lzhBuildCodes(const UINT8* lengths, UINT32 numSymbols, UINT16* codes)
+	{
+		UINT32 lengthCounts[LZH_MAX_CODE_LENGTH + 1] = { 0 };
+		for (UINT32 i = 0; i < numSymbols; i++)
+			lengthCounts[lengths[i]]++;
+
+		lengthCounts[0] = 0;
+
+		UINT32 nextCode[LZH_MAX_CODE_LENGTH + 1] = { 0 };
+		UINT32 code = 0;
+		for (UINT32 i = 1; i <= LZH_MAX_CODE_LENGTH; i++)
+		{
+			code = (code + lengthCounts[i - 1]) << 1;
+			nextCode[i] = code;
+
+			if (code + lengthCounts[i] > (1U << i))
+				return false;
+		}
+
+		for (UINT32 i = 0; i < numSymbols; i++)
+		{
+			const UINT32 length = lengths[i];
+			if (length == 0)
+			{
+				codes[i] = 0;
+				continue;
+			}
+
+			const UINT32 value = nextCode[length]++;
+
+			UINT32 reversed = 0;
+			for (UINT32 j = 0; j < length; j++)
+				reversed |= ((value >> j) & 1) << (length - 1 - j);
+
+			codes[i] = (UINT16)reversed;
+		}
+
+		return true;
+	}
+
+	/** 
+	 * Table for decoding Huffman codes. Indexed by the next LZH_MAX_CODE_LENGTH bits of input, each entry contains the
+	 * decoded symbol in the upper bits and the length of its code in the lowest four bits. Entries with zero length are
+	 * not valid codes.
+	 */
+	struct LZHDecodeTable
+	{
+		/** Builds the table from the code lengths of all the symbols. Returns false if the lengths are not valid. */
+		bool build(const UINT8* lengths, UINT32 numSymbols)
+		{
+			UINT16 codes[LZH_NUM_LITLEN_SYMBOLS];
+			if (!lzhBuildCodes(lengths, numSymbols, codes))
+				return false;
+
+			entries.assign(1 << LZH_MAX_CODE_LENGTH, 0);
+			for (UINT32 i = 0; i < numSymbols; i++)
+			{
+				const UINT32 length = lengths[i];
+				if (length == 0)
+					continue;
+
+				const auto entry = (UINT16)((i << 4) | length);
+				for (UINT32 j = codes[i]; j < (1U << LZH_MAX_CODE_LENGTH); j += 1 << length)
+					entries[j] = entry;
+			}
+
+			return true;
+		}
+
+		/** Decodes the next symbol. Returns false if the input doesn't contain a valid code. */
+		bool decode(LZHBitReader& reader, UINT32& symbol) const
+		{
+			const UINT16 entry = entries[reader.peek(LZH_MAX_CODE_LENGTH)];
+			const UINT32 length = entry & 0xF;
+
+			if (length == 0)
+				return false;
+
+			reader.consume(length);
+			symbol = entry >> 4;
+
+			return true;
+		}
+
+		Vector<UINT16> entries;
+	};
+
+	/**
+	 * Compresses data using the LZHuffman codec. Matches with earlier data are found using hash chains, with one step of
+	 * lazy evaluation, and the resulting literals, match lengths and match distances are encoded using Huffman codes
+	 * built for the block. Returns the compressed size, or 0 if the output didn't fit in @p capacity bytes.
+	 */
+	static size_t lzhCompress(const UINT8* data, UINT32 size, UINT8* output, size_t capacity)
+	{
+		/** A single literal (if distance is zero), or a match. */
+		struct Token
+		{
+			UINT32 value;
+			UINT32 distance;
+		};
+
+		Vector<INT32> head(1 << LZH_HASH_BITS, -1);
+		Vector<INT32> prev(size);
+
+		const auto hash = [data](UINT32 pos)
+		{
+			UINT32 value;
+			memcpy(&value, data + pos, sizeof(value));
+
+			return (value * 2654435761U) >> (32 - LZH_HASH_BITS);
+		};
+
+		const auto insert = [&](UINT32 pos)
+		{
+			if (pos + LZH_MIN_MATCH > size)
+				return;
+
+			const UINT32 hashValue = hash(pos);
+			prev[pos] = head[hashValue];
+			head[hashValue] = (INT32)pos;
+		};
+
+		const auto findMatch = [&](UINT32 pos, UINT32& bestLength, UINT32& bestDistance)
+		{
+			bestLength = 0;
+			bestDistance = 0;
+
+			if (pos + LZH_MIN_MATCH > size)
+				return;
+
+			const UINT32 maxLength = std::min(LZH_MAX_MATCH, size - pos);
+			INT32 candidate = head[hash(pos)];
+			for (UINT32 i = 0; i < LZH_MAX_CHAIN && candidate >= 0; i++, candidate = prev[candidate])
+			{
+				const UINT8* a = data + candidate;
+				const UINT8* b = data + pos;
+
+				if (a[bestLength] != b[bestLength])
+					continue;
+
+				UINT32 length = 0;
+				while (length < maxLength && a[length] == b[length])
+					length++;
+
+				if (length > bestLength)
+				{
+					bestLength = length;
+					bestDistance = pos - (UINT32)candidate;
+
+					if (length == maxLength)
+						break;
+				}
+			}
+
+			if (bestLength < LZH_MIN_MATCH)
+				bestLength = 0;
+		};
+
+		Vector<Token> tokens;
+		tokens.reserve(size / 2);
+
+		UINT32 litLenFrequencies[LZH_NUM_LITLEN_SYMBOLS] = { 0 };
+		UINT32 distFrequencies[LZH_NUM_DIST_SYMBOLS] = { 0 };
+
+		UINT32 pos = 0;
+		while (pos < size)
+		{
+			UINT32 length, distance;
+			findMatch(pos, length, distance);
+			insert(pos);
+
+			// Prefer a literal followed by a longer match, if one starts at the next byte
+			if (length > 0 && length < LZH_GOOD_MATCH)
+			{
+				UINT32 nextLength, nextDistance;
+				findMatch(pos + 1, nextLength, nextDistance);
+
+				if (nextLength > length)
+					length = 0;
+			}
+
+			UINT32 slot, numExtraBits, extraBits;
+			if (length > 0)
+			{
+				tokens.push_back({ length, distance });
+
+				lzhEncodeSlot(length - LZH_MIN_MATCH, slot, numExtraBits, extraBits);
+				litLenFrequencies[LZH_END_OF_BLOCK + 1 + slot]++;
+
+				lzhEncodeSlot(distance - 1, slot, numExtraBits, extraBits);
+				distFrequencies[slot]++;
+
+				for (UINT32 i = 1; i < length; i++)
+					insert(pos + i);
+
+				pos += length;
+			}
+			else
+			{
+				tokens.push_back({ data[pos], 0 });
+				litLenFrequencies[data[pos]]++;
+
+				pos++;
+			}
+		}
+
+		litLenFrequencies[LZH_END_OF_BLOCK]++;
+
+		UINT8 litLenLengths[LZH_NUM_LITLEN_SYMBOLS];
+		UINT8 distLengths[LZH_NUM_DIST_SYMBOLS];
+		lzhBuildCodeLengths(litLenFrequencies, LZH_NUM_LITLEN_SYMBOLS, litLenLengths);
+		lzhBuildCodeLengths(distFrequencies, LZH_NUM_DIST_SYMBOLS, distLengths);
+
+		UINT16 litLenCodes[LZH_NUM_LITLEN_SYMBOLS];
+		UINT16 distCodes[LZH_NUM_DIST_SYMBOLS];
+		lzhBuildCodes(litLenLengths, LZH_NUM_LITLEN_SYMBOLS, litLenCodes);
+		lzhBuildCodes(distLengths, LZH_NUM_DIST_SYMBOLS, distCodes);
+
+		LZHBitWriter writer(output, capacity);
+		for (auto& entry : litLenLengths)
+			writer.write(entry, 4);
+
+		for (auto& entry : distLengths)
+			writer.write(entry, 4);
+
+		for (auto& entry : tokens)
+		{
+			if (entry.distance == 0)
+			{
+				writer.write(litLenCodes[entry.value], litLenLengths[entry.value]);
+				continue;
+			}
+
+			UINT32 slot, numExtraBits, extraBits;
+			lzhEncodeSlot(entry.value - LZH_MIN_MATCH, slot, numExtraBits, extraBits);
+
+			const UINT32 litLenSymbol = LZH_END_OF_BLOCK + 1 + slot;
+			writer.write(litLenCodes[litLenSymbol], litLenLengths[litLenSymbol]);
+			writer.write(extraBits, numExtraBits);
+
+			lzhEncodeSlot(entry.distance - 1, slot, numExtraBits, extraBits);
+			writer.write(distCodes[slot], distLengths[slot]);
+			writer.write(extraBits, numExtraBits);
+
+			if (writer.overflow)
+				return 0;
+		}
+
+		writer.write(litLenCodes[LZH_END_OF_BLOCK], litLenLengths[LZH_END_OF_BLOCK]);
+		writer.flush();
+
+		return writer.overflow ? 0 : writer.size;
+	}
+
+	/** Decompresses data compressed by lzhCompress(). Returns false if the data is corrupt. */
+	static bool lzhDecompress(const UINT8* data, size_t size, UINT8* output, UINT32 outputSize)
+	{
+		LZHBitReader reader(data, size);
+
+		UINT8 litLenLengths[LZH_NUM_LITLEN_SYMBOLS];
+		UINT8 distLengths[LZH_NUM_DIST_SYMBOLS];
+		for (auto& entry : litLenLengths)
+			entry = (UINT8)reader.read(4);
+
+		for (auto& entry : distLengths)
+			entry = (UINT8)reader.read(4);
+
+		LZHDecodeTable litLenTable;
+		LZHDecodeTable distTable;
+		if (!litLenTable.build(litLenLengths, LZH_NUM_LITLEN_SYMBOLS) || 
+			!distTable.build(distLengths, LZH_NUM_DIST_SYMBOLS))
+		{
+			return false;
+		}
+
+		UINT32 pos = 0;
+		while (true)
+		{
+			UINT32 symbol;
+			if (!litLenTable.decode(reader, symbol))
+				return false;
+
+			if (symbol < LZH_END_OF_BLOCK)
+			{
+				if (pos >= outputSize)
+					return false;
+
+				output[pos++] = (UINT8)symbol;
+				continue;
+			}
+
+			if (symbol == LZH_END_OF_BLOCK)
+				break;
+
+			UINT32 numExtraBits;
+			const UINT32 length = lzhDecodeSlot(symbol - LZH_END_OF_BLOCK - 1, numExtraBits) + 
+				reader.read(numExtraBits) + LZH_MIN_MATCH;
+
+			if (!distTable.decode(reader, symbol))
+				return false;
+
+			const UINT64 distance = (UINT64)lzhDecodeSlot(symbol, numExtraBits) + reader.read(numExtraBits) + 1;
+			if (distance > pos || length > outputSize - pos)
+				return false;
+
+			// Source and destination overlap when repeating a pattern shorter than the match
+			const UINT8* src = output + pos - distance;
+			UINT8* dst = output + pos;
+			for (UINT32 i = 0; i < length; i++)
+				dst[i] = src[i];
+
+			pos += length;
+		}
+
+		return pos == outputSize && !reader.overrun();
+	}
+
+	constexpr UINT32 Compression::CHUNK_SIZE;
+
+	SPtr<MemoryDataStream> Compression::compressChunked(SPtr<DataStream>& input, CompressionCodec codec,
+		std::function<void(float)> reportProgress)
+	{
+		struct CompressedBlock
+		{
+			UINT8* data = nullptr;
+			UINT32 size = 0;
+			CompressionCodec codec = CompressionCodec::None;
+		};
+
+		const UINT64 size = input->size() - input->tell();
+		const auto numBlocks = (UINT32)((size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+		const bool parallel = TaskScheduler::isStarted();
+		const UINT32 numWorkers = parallel ? std::max(TaskScheduler::instance().getNumWorkers(), 1U) : 1;
+		const UINT32 blocksPerBatch = std::min(numWorkers * CHUNKED_BLOCKS_PER_WORKER, std::max(numBlocks, 1U));
+
+		Vector<CompressedBlock> blocks(numBlocks);
+		auto* inputBuffer = (UINT8*)bs_alloc((size_t)blocksPerBatch * CHUNK_SIZE);
+
+		// Input is read a batch of blocks at a time, so it never needs to be in memory as a whole
+		for (UINT32 batchStart = 0; batchStart < numBlocks; batchStart += blocksPerBatch)
+		{
+			const UINT32 batchEnd = std::min(batchStart + blocksPerBatch, numBlocks);
+			const UINT64 batchOffset = (UINT64)batchStart * CHUNK_SIZE;
+			const auto batchSize = (size_t)std::min((UINT64)(batchEnd - batchStart) * CHUNK_SIZE, size - batchOffset);
+
+			if (input->read(inputBuffer, batchSize) != batchSize)
+			{
+				LOGERR("Compression failed, unable to read the input data.");
+
+				for (auto& entry : blocks)
+					bs_free(entry.data);
+
+				bs_free(inputBuffer);
+				return nullptr;
+			}
+
+			const auto compressBlock = [&blocks, inputBuffer, batchStart, batchSize, codec](UINT32 idx)
+			{
+				const size_t blockOffset = (size_t)(idx - batchStart) * CHUNK_SIZE;
+				const auto blockSize = (UINT32)std::min((size_t)CHUNK_SIZE, batchSize - blockOffset);
+				const char* blockData = (const char*)inputBuffer + blockOffset;
+
+				CompressedBlock& block = blocks[idx];
+				if (codec == CompressionCodec::Snappy)
+				{
+					block.data = (UINT8*)bs_alloc(snappy::MaxCompressedLength(blockSize));
+
+					size_t compressedSize = 0;
+					snappy::RawCompress(blockData, blockSize, (char*)block.data, &compressedSize);
+
+					if (compressedSize < blockSize)
+					{
+						block.size = (UINT32)compressedSize;
+						block.codec = CompressionCodec::Snappy;
+						return;
+					}
+
+					bs_free(block.data);
+				}
+				else if (codec == CompressionCodec::LZHuffman)
+				{
+					// Output that wouldn't be smaller than the input is abandoned early, and the block stored as is
+					block.data = (UINT8*)bs_alloc(blockSize);
+
+					const size_t compressedSize = lzhCompress((const UINT8*)blockData, blockSize, block.data, 
+						blockSize - 1);
+
+					if (compressedSize > 0)
+					{
+						block.size = (UINT32)compressedSize;
+						block.codec = CompressionCodec::LZHuffman;
+						return;
+					}
+
+					bs_free(block.data);
+				}
+
+				block.data = (UINT8*)bs_alloc(blockSize);
+				block.size = blockSize;
+				block.codec = CompressionCodec::None;
+				memcpy(block.data, blockData, blockSize);
+			};
+
+			if (parallel)
+				TaskScheduler::instance().parallelFor(batchStart, batchEnd, 1, compressBlock);
+			else
+			{
+				for (UINT32 i = batchStart; i < batchEnd; i++)
+					compressBlock(i);
+			}
+
+			if (reportProgress)
+				reportProgress(batchEnd / (float)numBlocks);
+		}
+
+		bs_free(inputBuffer);
+
+		size_t outputSize = sizeof(ChunkedHeader) + numBlocks * (sizeof(UINT32) + sizeof(UINT8));
+		for (auto& entry : blocks)
+			outputSize += entry.size;
+
+		ChunkedHeader header;
+		header.magic = CHUNKED_MAGIC;
+		header.blockSize = CHUNK_SIZE;
+		header.size = size;
+		header.numBlocks = numBlocks;
+		header.reserved = 0;
+
+		SPtr<MemoryDataStream> output = bs_shared_ptr_new<MemoryDataStream>(outputSize);
+		output->write(&header, sizeof(header));
+
+		for (auto& entry : blocks)
+			output->write(&entry.size, sizeof(entry.size));
+
+		for (auto& entry : blocks)
+			output->write(&entry.codec, sizeof(entry.codec));
+
+		for (auto& entry : blocks)
+		{
+			output->write(entry.data, entry.size);
+			bs_free(entry.data);
+		}
+
+		output->seek(0);
+		return output;
+	}
+
+	/** State of a CompressedDataStream, shared with its clones and the workers decompressing its blocks. */
+	struct CompressedDataStream::State
+	{
+		/** Possible states of a single block. */
+		enum BlockState
+		{
+			BlockPending,
+			BlockDecompressing,
+			BlockDone,
+			BlockFailed
+		};
+
+		/** Information about a single compressed block. */
+		struct Block
+		{
+			const UINT8* compressedData;
+			UINT32 compressedSize;
+			UINT32 size;
+			CompressionCodec codec;
+		};
+
+		State(UINT32 numBlocks)
+			:blocks(numBlocks), blockStates(numBlocks)
+		{ }
+
+		~State()
+		{
+			if (data != nullptr)
+				bs_free(data);
+
+			if (compressedBuffer != nullptr)
+				bs_free(compressedBuffer);
+		}
+
+		/** Decompresses the block at the specified index, unless another thread has already started doing so. */
+		void decompressBlock(UINT32 idx)
+		{
+			UINT32 expected = BlockPending;
+			if (!blockStates[idx].compare_exchange_strong(expected, BlockDecompressing))
+				return;
+
+			const Block& block = blocks[idx];
+			UINT8* output = data + (size_t)idx * blockSize;
+
+			bool success = false;
+			switch (block.codec)
+			{
+			case CompressionCodec::None:
+				if (block.compressedSize == block.size)
+				{
+					memcpy(output, block.compressedData, block.size);
+					success = true;
+				}
+				break;
+			case CompressionCodec::Snappy:
+			{
+				size_t uncompressedSize = 0;
+				const auto* compressedData = (const char*)block.compressedData;
+
+				if (snappy::GetUncompressedLength(compressedData, block.compressedSize, &uncompressedSize) &&
+					uncompressedSize == block.size)
+				{
+					success = snappy::RawUncompress(compressedData, block.compressedSize, (char*)output);
+				}
+			}
+				break;
+			case CompressionCodec::LZHuffman:
+				success = lzhDecompress(block.compressedData, block.compressedSize, output, block.size);
+				break;
+			}
+
+			if (!success)
+				LOGERR("Decompression failed, corrupt data.");
+
+			{
+				Lock lock(mutex);
+				blockStates[idx].store(success ? BlockDone : BlockFailed);
+			}
+
+			signal.notify_all();
+		}
+
+		/** 
+		 * Ensures the block at the specified index is decompressed, either by decompressing it on the calling thread, or
+		 * by waiting on a worker that is already decompressing it. Returns false if the block failed to decompress.
+		 */
+		bool waitBlock(UINT32 idx)
+		{
+			if (blockStates[idx].load() < BlockDone)
+			{
+				decompressBlock(idx);
+
+				if (blockStates[idx].load() < BlockDone)
+				{
+					Lock lock(mutex);
+					signal.wait(lock, [this, idx]() { return blockStates[idx].load() >= BlockDone; });
+				}
+			}
+
+			return blockStates[idx].load() == BlockDone;
+		}
+
+		Vector<Block> blocks;
+		Vector<std::atomic<UINT32>> blockStates;
+		std::atomic<UINT32> nextBlock{0};
+
+		SPtr<DataStream> source;
+		UINT8* compressedBuffer = nullptr;
+		UINT8* data = nullptr;
+		UINT32 blockSize = 0;
+
+		Mutex mutex;
+		Signal signal;
+	};
+
+	CompressedDataStream::CompressedDataStream(const SPtr<DataStream>& source)
+		:DataStream(READ)
+	{
+		ChunkedHeader header;
+		if (source->read(&header, sizeof(header)) != sizeof(header) || header.magic != CHUNKED_MAGIC || 
+			header.blockSize == 0 || header.size > std::numeric_limits<size_t>::max() ||
+			header.numBlocks != (header.size + header.blockSize - 1) / header.blockSize)
+		{
+			LOGERR("Decompression failed, corrupt data.");
+			return;
+		}
+
+		const UINT32 numBlocks = header.numBlocks;
+		SPtr<State> state = bs_shared_ptr_new<State>(numBlocks);
+
+		Vector<UINT32> compressedSizes(numBlocks);
+		Vector<CompressionCodec> codecs(numBlocks);
+		const size_t indexSize = numBlocks * (sizeof(UINT32) + sizeof(UINT8));
+		if (source->read(compressedSizes.data(), numBlocks * sizeof(UINT32)) +
+			source->read(codecs.data(), numBlocks * sizeof(UINT8)) != indexSize)
+		{
+			LOGERR("Decompression failed, corrupt data.");
+			return;
+		}
+
+		size_t compressedSize = 0;
+		for (auto& entry : compressedSizes)
+			compressedSize += entry;
+
+		// Reference mapped data directly, otherwise bring the compressed data into memory so the blocks can be accessed
+		// from multiple threads
+		const UINT8* compressedData;
+		if (source->isMapped())
+		{
+			auto mappedSource = std::static_pointer_cast<MappedFileDataStream>(source);
+			if (mappedSource->size() - mappedSource->tell() < compressedSize)
+			{
+				LOGERR("Decompression failed, corrupt data.");
+				return;
+			}
+
+			compressedData = mappedSource->getCurrentPtr();
+			state->source = source;
+			source->skip(compressedSize);
+		}
+		else
+		{
+			state->compressedBuffer = (UINT8*)bs_alloc(compressedSize);
+			compressedData = state->compressedBuffer;
+
+			if (source->read(state->compressedBuffer, compressedSize) != compressedSize)
+			{
+				LOGERR("Decompression failed, corrupt data.");
+				return;
+			}
+		}
+
+		for (UINT32 i = 0; i < numBlocks; i++)
+		{
+			State::Block& block = state->blocks[i];
+			block.compressedData = compressedData;
+			block.compressedSize = compressedSizes[i];
+			block.size = (UINT32)std::min((UINT64)header.blockSize, header.size - (UINT64)i * header.blockSize);
+			block.codec = codecs[i];
+
+			compressedData += block.compressedSize;
+		}
+
+		state->blockSize = header.blockSize;
+		if (header.size > 0)
+			state->data = (UINT8*)bs_alloc((size_t)header.size);
+
+		mState = state;
+		mSize = (size_t)header.size;
+
+		// Decompress ahead on worker threads, in block order so the blocks read first become available first. Workers 
+		// only keep a weak reference, so they stop once the stream and all its clones are gone.
+		if (numBlocks > 1 && TaskScheduler::isStarted())
+		{
+			const UINT32 numTasks = std::min(TaskScheduler::instance().getNumWorkers(), numBlocks - 1);
+			const WeakSPtr<State> weakState = state;
+
+			for (UINT32 i = 0; i < numTasks; i++)
+			{
+				SPtr<Task> task = Task::create("DecompressBlocks", [weakState]()
+				{
+					while (true)
+					{
+						SPtr<State> state = weakState.lock();
+						if (state == nullptr)
+							break;
+
+						const UINT32 idx = state->nextBlock.fetch_add(1);
+						if (idx >= (UINT32)state->blocks.size())
+							break;
+
+						state->decompressBlock(idx);
+					}
+				});
+
+				TaskScheduler::instance().addTask(task);
+			}
+		}
+	}
+
+	CompressedDataStream::~CompressedDataStream()
+	{
+		close();
+	}
+
+	size_t CompressedDataStream::read(void* buf, size_t count)
+	{
+		if (mState == nullptr)
+			return 0;
+
+		count = std::min(count, mSize - std::min(mPos, mSize));
+
+		size_t numRead = 0;
+		while (numRead < count)
+		{
+			const auto blockIdx = (UINT32)(mPos / mState->blockSize);
+			if (!mState->waitBlock(blockIdx))
+				break;
+
+			const size_t blockEnd = std::min((size_t)(blockIdx + 1) * mState->blockSize, mSize);
+			const size_t numToCopy = std::min(count - numRead, blockEnd - mPos);
+
+			memcpy((UINT8*)buf + numRead, mState->data + mPos, numToCopy);
+			mPos += numToCopy;
+			numRead += numToCopy;
+		}
+
+		return numRead;
+	}
+
+	void CompressedDataStream::skip(size_t count)
+	{
+		assert(mPos + count <= mSize);
+		mPos += count;
+	}
+
+	void CompressedDataStream::seek(size_t pos)
+	{
+		assert(pos <= mSize);
+		mPos = pos;
+	}
+
+	size_t CompressedDataStream::tell() const
+	{
+		return mPos;
+	}
+
+	bool CompressedDataStream::eof() const
+	{
+		return mPos >= mSize;
+	}
+
+	SPtr<DataStream> CompressedDataStream::clone(bool copyData) const
+	{
+		SPtr<CompressedDataStream> clone = bs_shared_ptr_new<CompressedDataStream>(*this);
+		clone->mPos = 0;
+
+		return clone;
+	}
+
+	void CompressedDataStream::close()
+	{
+		mState = nullptr;
+	}
 }
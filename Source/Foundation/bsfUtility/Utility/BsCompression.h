@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Prerequisites/BsPrerequisitesUtil.h"
+#include "FileSystem/BsDataStream.h"
 
 namespace bs
 {
@@ -10,10 +11,41 @@ namespace bs
 	 *  @{
 	 */
 
+	/** Formats in which compressed data can be stored. Values are persisted along with the data and must not change. */
+	enum class CompressionMethod
+	{
+		/** Data is not compressed. */
+		None = 0,
+		/** Data is compressed as a single Snappy stream. Output by Compression::compress(). */
+		Snappy = 1,
+		/** 
+		 * Data is split into independently compressed blocks, prefixed by a block index. Output by 
+		 * Compression::compressChunked() and read through CompressedDataStream.
+		 */
+		Chunked = 2
+	};
+
+	/** Codecs that can be used for compressing individual blocks in the CompressionMethod::Chunked format. */
+	enum class CompressionCodec : UINT8
+	{
+		/** Block data is stored without compression. Used automatically for blocks that don't compress. */
+		None = 0,
+		/** Block data is compressed using Snappy. Fast to compress and decompress, with a moderate ratio. */
+		Snappy = 1,
+		/** 
+		 * Block data is compressed using LZ77 with Huffman coded output. Compresses several times slower than Snappy and
+		 * decompresses slower as well, in exchange for a higher ratio on typical data.
+		 */
+		LZHuffman = 2
+	};
+
 	/** Performs generic compression and decompression on raw data. */
 	class BS_UTILITY_EXPORT Compression
 	{
 	public:
+		/** Size of a single block in the CompressionMethod::Chunked format, in bytes (before compression). */
+		static constexpr UINT32 CHUNK_SIZE = 256 * 1024;
+
 		/** 
 		 * Compresses the data from the provided data stream and outputs the new stream with compressed data. Accepts
 		 * an optional callback to be triggered during the process to report progress in range [0, 1].
@@ -27,6 +59,72 @@ namespace bs
 		 */
 		static SPtr<MemoryDataStream> decompress(SPtr<DataStream>& input, 
 			std::function<void(float)> reportProgress = nullptr);
+
+		/**
+		 * Compresses the data from the provided data stream in the CompressionMethod::Chunked format. Data is split into
+		 * blocks of CHUNK_SIZE bytes which are compressed independently, in parallel if the TaskScheduler is running. 
+		 * Input is read incrementally, a few blocks at a time. The output can be read using CompressedDataStream.
+		 *
+		 * @param[in]	input			Stream to compress, from its current position until its end.
+		 * @param[in]	codec			Codec to compress the blocks with. Blocks that don't compress are always stored
+		 *								uncompressed.
+		 * @param[in]	reportProgress	Optional callback triggered during the process to report progress in range [0, 1].
+		 */
+		static SPtr<MemoryDataStream> compressChunked(SPtr<DataStream>& input, 
+			CompressionCodec codec = CompressionCodec::Snappy, std::function<void(float)> reportProgress = nullptr);
+	};
+
+	/**
+	 * Stream that decompresses data stored in the CompressionMethod::Chunked format. Blocks are decompressed on demand as
+	 * they are read, so the stream supports random access and reading can start as soon as the first block is 
+	 * available, rather than after the entire data has been decompressed. If the TaskScheduler is running, blocks are 
+	 * also decompressed ahead of the read position on worker threads.
+	 *
+	 * @note	Not thread safe. Clones of the stream can be read from different threads.
+	 */
+	class BS_UTILITY_EXPORT CompressedDataStream : public DataStream
+	{
+		struct State;
+
+	public:
+		/**
+		 * Creates a stream decompressing data from @p source, starting at its current position. The source stream is
+		 * advanced past the compressed data. If the source stream is mapped the compressed data is referenced directly, 
+		 * otherwise it is read into memory.
+		 */
+		CompressedDataStream(const SPtr<DataStream>& source);
+		~CompressedDataStream();
+
+		bool isFile() const override { return false; }
+
+		/** @copydoc DataStream::read */
+		size_t read(void* buf, size_t count) override;
+
+		/** @copydoc DataStream::skip */
+		void skip(size_t count) override;
+
+		/** @copydoc DataStream::seek */
+		void seek(size_t pos) override;
+
+		/** @copydoc DataStream::tell */
+		size_t tell() const override;
+
+		/** @copydoc DataStream::eof */
+		bool eof() const override;
+
+		/** 
+		 * @copydoc DataStream::clone 
+		 *
+		 * @note	Decompressed data is never copied, the new stream shares it with this stream.
+		 */
+		SPtr<DataStream> clone(bool copyData = true) const override;
+
+		/** @copydoc DataStream::close */
+		void close() override;
+
+	private:
+		SPtr<State> mState;
+		size_t mPos = 0;
 	};
 
 	/** @} */
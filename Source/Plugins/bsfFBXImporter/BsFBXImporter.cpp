@@ -479,7 +479,7 @@ namespace bs
 		int lSDKMajor,  lSDKMinor,  lSDKRevision;
 		FbxManager::GetFileFormatVersion(lSDKMajor, lSDKMinor, lSDKRevision);
 
-		Lock fileLock = FileScheduler::getLock(filePath);
+		SharedLock fileLock = FileScheduler::getReadLock(filePath);
 		FbxImporter* importer = FbxImporter::Create(mFBXManager, "");
 		bool importStatus = importer->Initialize(filePath.toString().c_str(), -1, mFBXManager->GetIOSettings());
 		
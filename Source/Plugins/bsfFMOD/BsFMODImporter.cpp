@@ -45,7 +45,7 @@ namespace bs
 
 		FMOD::Sound* sound;
 		{
-			Lock fileLock = FileScheduler::getLock(filePath);
+			SharedLock fileLock = FileScheduler::getReadLock(filePath);
 
 			String pathStr = filePath.toString();
 			if (gFMODAudio()._getFMOD()->createSound(pathStr.c_str(), FMOD_CREATESAMPLE, nullptr, &sound) != FMOD_OK)
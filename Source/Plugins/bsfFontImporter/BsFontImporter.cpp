@@ -56,7 +56,7 @@ namespace bs
 		FT_Face face;
 
 		{
-			Lock fileLock = FileScheduler::getLock(filePath);
+			SharedLock fileLock = FileScheduler::getReadLock(filePath);
 			error = FT_New_Face(library, filePath.toString().c_str(), 0, &face);
 		}
 
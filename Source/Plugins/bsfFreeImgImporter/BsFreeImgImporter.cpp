@@ -222,7 +222,7 @@ namespace bs
 		UPtr<MemoryDataStream> memStream;
 		FREE_IMAGE_FORMAT imageFormat;
 		{
-			Lock lock = FileScheduler::getLock(filePath);
+			SharedLock lock = FileScheduler::getReadLock(filePath);
 
 			SPtr<DataStream> fileData = FileSystem::openFile(filePath, true);
 			if (fileData->size() > std::numeric_limits<UINT32>::max())
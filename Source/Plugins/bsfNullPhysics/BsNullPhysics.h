@@ -224,6 +224,13 @@ namespace bs
 		bool convexOverlapAny(const HPhysicsMesh& mesh, const Vector3& position, const Quaternion& rotation,
 			UINT64 layer = BS_ALL_LAYERS) const override { return false; }
 
+		/** @copydoc PhysicsScene::queryBatch */
+		void queryBatch(const PhysicsQueryBatch& batch, PhysicsQueryResult* results) const override
+		{
+			for (UINT32 i = 0; i < batch.getNumQueries(); i++)
+				results[i].numHits = 0;
+		}
+
 		/** @copydoc PhysicsScene::getGravity */
 		Vector3 getGravity() const override { return mGravity; }
 
@@ -248,6 +255,9 @@ namespace bs
 		/** @copydoc PhysicsScene::setMaxTesselationEdgeLength */
 		void setMaxTesselationEdgeLength(float length) override { mTesselationLength = length; }
 
+		/** @copydoc PhysicsScene::_executeQuery */
+		void _executeQuery(const PhysicsQuery& query, PhysicsQueryResult& result) const override { result.numHits = 0; }
+
 		/** @copydoc PhysicsScene::_boxOverlap */
 		Vector<Collider*> _boxOverlap(const AABox& box, const Quaternion& rotation,
 			UINT64 layer = BS_ALL_LAYERS) const override { return {}; }
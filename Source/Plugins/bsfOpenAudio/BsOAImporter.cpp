@@ -44,7 +44,7 @@ namespace bs
 		UINT32 bufferSize;
 		UINT8* sampleBuffer;
 		{
-			Lock fileLock = FileScheduler::getLock(filePath);
+			SharedLock fileLock = FileScheduler::getReadLock(filePath);
 			SPtr<DataStream> stream = FileSystem::openFile(filePath);
 
 			String extension = filePath.getExtension();
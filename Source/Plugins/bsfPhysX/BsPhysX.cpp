@@ -284,26 +284,46 @@ namespace bs
 		}
 	};
 
+	/** 
+	 * Runs PhysX tasks on the framework's task scheduler. PhysX submits many small tasks every simulation step, so the
+	 * framework tasks are pooled and reused instead of being allocated for each submitted task.
+	 */
 	class PhysXCPUDispatcher : public PxCpuDispatcher
 	{
 	public:
+		PhysXCPUDispatcher()
+			:mTaskPool("PhysX")
+		{ }
+
 		void submitTask(PxBaseTask& physxTask) override
 		{
-			// Note: Framework's task scheduler is pretty low granularity. Consider a better task manager in case PhysX ends
-			// up submitting many tasks.
-			// - PhysX's task manager doesn't seem much lighter either. But perhaps I can at least create a task pool to 
-			//   avoid allocating them constantly.
+			Lock lock(mMutex);
 
-			auto runTask = [&]() { physxTask.run(); physxTask.release(); };
-			SPtr<Task> task = Task::create("PhysX", runTask);
+			// Queue while holding the lock, so the task cannot be handed out again before the scheduler references it
+			SPtr<Task> task = mTaskPool.getTask([&physxTask]()
+			{
+				physxTask.run();
+				physxTask.release();
+			});
 
-			TaskScheduler::instance().addTask(task);
+			TaskScheduler::instance().addTask(std::move(task));
 		}
 
 		PxU32 getWorkerCount() const override
 		{
 			return (PxU32)TaskScheduler::instance().getNumWorkers();
 		}
+
+		/** Releases all pooled tasks. Must not be called while any PhysX tasks are queued or running. */
+		void clear()
+		{
+			Lock lock(mMutex);
+			mTaskPool.clear();
+		}
+
+	private:
+		TaskPool mTaskPool;
+		Mutex mMutex;
 	};
 
 	class PhysXBroadPhaseCallback : public PxBroadPhaseCallback
@@ -479,6 +499,29 @@ namespace bs
 		}
 	};
 
+	/** Overlap query callback that writes the overlapping colliders to a caller provided buffer, without allocating. */
+	struct PhysXBatchOverlapCallback : PxOverlapCallback
+	{
+		static const int MAX_HITS = 32;
+		PxOverlapHit buffer[MAX_HITS];
+
+		Collider** output;
+		UINT32 maxOutput;
+		UINT32 numOutput = 0;
+
+		PhysXBatchOverlapCallback(Collider** output, UINT32 maxOutput)
+			:PxOverlapCallback(buffer, MAX_HITS), output(output), maxOutput(maxOutput)
+		{ }
+
+		PxAgain processTouches(const PxOverlapHit* buffer, PxU32 nbHits) override
+		{
+			for (PxU32 i = 0; i < nbHits && numOutput < maxOutput; i++)
+				output[numOutput++] = (Collider*)buffer[i].shape->userData;
+
+			return numOutput < maxOutput;
+		}
+	};
+
 	static PhysXAllocator gPhysXAllocator;
 	static PhysXErrorCallback gPhysXErrorHandler;
 	static PhysXCPUDispatcher gPhysXCPUDispatcher;
@@ -515,6 +558,8 @@ namespace bs
 	{
 		assert(mScenes.empty() && "All scenes must be freed before physics system shutdown");
 
+		gPhysXCPUDispatcher.clear();
+
 		if (mCooking != nullptr)
 			mCooking->release();
 
@@ -529,13 +574,19 @@ namespace bs
 
 		mUpdateInProgress = true;
 
-		// Note: Consider delaying fetchResults one frame. This could improve performance because Physics update would be
-		//       able to run parallel to the simulation thread, but at a cost to input latency.
+		// Steps started asynchronously during the last fixed update complete here, before anything else runs. This is the
+		// only point at which their results are reported.
+		for(auto& scene : mScenes)
+			completeAsyncSimulation(*scene);
+
 		bs_frame_mark();
 		UINT8* scratchBuffer = bs_frame_alloc_aligned(SCRATCH_BUFFER_SIZE, 16);
 
 		for(auto& scene : mScenes)
 		{
+			if (scene->hasFlag(PhysicsFlag::AsyncSimulation))
+				continue;
+
 			scene->mScene->simulate(step, nullptr, scratchBuffer, SCRATCH_BUFFER_SIZE);
 
 			UINT32 errorState;
@@ -549,25 +600,22 @@ namespace bs
 		// Update rigidbodies with new transforms
 		for(auto& scene : mScenes)
 		{
-			PxU32 numActiveTransforms;
-			const PxActiveTransform* activeTransforms = scene->mScene->getActiveTransforms(numActiveTransforms);
-
-			for (PxU32 i = 0; i < numActiveTransforms; i++)
-			{
-				Rigidbody* rigidbody = static_cast<Rigidbody*>(activeTransforms[i].userData);
+			if (!scene->hasFlag(PhysicsFlag::AsyncSimulation))
+				updateTransforms(*scene);
+		}
 
-				// Note: This should never happen, as actors gets their userData set to null when they're destroyed. However
-				// in some cases PhysX seems to keep those actors alive for a frame or few, and reports their state here. Until
-				// I find out why I need to perform this check.
-				if (activeTransforms[i].actor->userData == nullptr)
-					continue;
+		// Start the asynchronous steps last, since scene state cannot be read while they are running. They keep running 
+		// in parallel with the rest of the frame, until the next fixed update.
+		for(auto& scene : mScenes)
+		{
+			if (!scene->hasFlag(PhysicsFlag::AsyncSimulation))
+				continue;
 
-				const PxTransform& transform = activeTransforms[i].actor2World;
+			if (scene->mScratchBuffer == nullptr)
+				scene->mScratchBuffer = (UINT8*)bs_alloc_aligned(SCRATCH_BUFFER_SIZE, 16);
 
-				// Note: Make this faster, avoid dereferencing Rigidbody and attempt to access pos/rot destination directly,
-				//       use non-temporal writes
-				rigidbody->_setTransform(fromPxVector(transform.p), fromPxQuaternion(transform.q));
-			}
+			scene->mScene->simulate(step, nullptr, scene->mScratchBuffer, SCRATCH_BUFFER_SIZE);
+			scene->mAsyncSimulationInProgress = true;
 		}
 
 		// Note: Consider extrapolating for the remaining "simulationAmount" value
@@ -576,6 +624,44 @@ namespace bs
 		triggerEvents();
 	}
 
+	void PhysX::updateTransforms(PhysXScene& scene)
+	{
+		PxU32 numActiveTransforms;
+		const PxActiveTransform* activeTransforms = scene.mScene->getActiveTransforms(numActiveTransforms);
+
+		for (PxU32 i = 0; i < numActiveTransforms; i++)
+		{
+			Rigidbody* rigidbody = static_cast<Rigidbody*>(activeTransforms[i].userData);
+
+			// Note: This should never happen, as actors gets their userData set to null when they're destroyed. However
+			// in some cases PhysX seems to keep those actors alive for a frame or few, and reports their state here. Until
+			// I find out why I need to perform this check.
+			if (activeTransforms[i].actor->userData == nullptr)
+				continue;
+
+			const PxTransform& transform = activeTransforms[i].actor2World;
+
+			// Note: Make this faster, avoid dereferencing Rigidbody and attempt to access pos/rot destination directly,
+			//       use non-temporal writes
+			rigidbody->_setTransform(fromPxVector(transform.p), fromPxQuaternion(transform.q));
+		}
+	}
+
+	bool PhysX::completeAsyncSimulation(PhysXScene& scene)
+	{
+		if (!scene.mAsyncSimulationInProgress)
+			return false;
+
+		UINT32 errorState;
+		if (!scene.mScene->fetchResults(true, &errorState))
+			LOGWRN("Physics simulation failed. Error code: " + toString(errorState));
+
+		scene.mAsyncSimulationInProgress = false;
+
+		updateTransforms(scene);
+		return true;
+	}
+
 	void PhysX::update()
 	{
 		// Note: Potentially interpolate (would mean a one frame delay needs to be introduced)
@@ -602,6 +688,10 @@ namespace bs
 
 		for(auto& entry : mTriggerEvents)
 		{
+			// Trigger might have been destroyed while an asynchronous simulation step was running
+			if (entry.trigger == nullptr)
+				continue;
+
 			data.colliders[0] = entry.trigger;
 			data.colliders[1] = entry.other;
 
@@ -726,6 +816,21 @@ namespace bs
 
 	void PhysX::setPaused(bool paused)
 	{
+		// Complete any running steps, so objects don't keep waiting on buffered changes and stale state while paused
+		if (paused && !mPaused)
+		{
+			mUpdateInProgress = true;
+
+			bool anyCompleted = false;
+			for (auto& scene : mScenes)
+				anyCompleted |= completeAsyncSimulation(*scene);
+
+			mUpdateInProgress = false;
+
+			if (anyCompleted)
+				triggerEvents();
+		}
+
 		mPaused = paused;
 	}
 
@@ -774,10 +879,19 @@ namespace bs
 
 		// Character controller
 		mCharManager = PxCreateControllerManager(*mScene);
+
+		setFlag(input.flags, true);
 	}
 
 	PhysXScene::~PhysXScene()
 	{
+		// Scene cannot be released while it is being simulated
+		if (mAsyncSimulationInProgress)
+			mScene->fetchResults(true);
+
+		if (mScratchBuffer != nullptr)
+			bs_free_aligned(mScratchBuffer);
+
 		mCharManager->release();
 		mScene->release();
 
@@ -1133,6 +1247,81 @@ namespace bs
 		return overlapAny(geometry, transform, layer);
 	}
 
+	void PhysXScene::queryBatch(const PhysicsQueryBatch& batch, PhysicsQueryResult* results) const
+	{
+		// Apply pending changes to the query structures up front, rather than having the queries running in parallel
+		// contend over who updates them
+		if (!mAsyncSimulationInProgress)
+			mScene->flushQueryUpdates();
+
+		PhysicsScene::queryBatch(batch, results);
+	}
+
+	void PhysXScene::_executeQuery(const PhysicsQuery& query, PhysicsQueryResult& result) const
+	{
+		result.numHits = 0;
+
+		PxQueryFilterData filterData;
+		memcpy(&filterData.data.word0, &query.layer, sizeof(query.layer));
+
+		if (query.type == PhysicsQueryType::RayCast)
+		{
+			PxRaycastBuffer output;
+			if (mScene->raycast(toPxVector(query.position), toPxVector(query.unitDir), query.maxDist, output, 
+				PxHitFlag::eDEFAULT | PxHitFlag::eUV, filterData))
+			{
+				parseHit(output.block, result.hit);
+				result.numHits = 1;
+			}
+
+			return;
+		}
+
+		// Note: Only box geometry is rotated, same as with the individual query methods
+		PxGeometryHolder geometry;
+		PxTransform transform = toPxTransform(query.position, Quaternion::IDENTITY);
+
+		switch (query.type)
+		{
+		case PhysicsQueryType::BoxCast:
+		case PhysicsQueryType::BoxOverlap:
+			geometry.storeAny(PxBoxGeometry(toPxVector(query.size)));
+			transform = toPxTransform(query.position, query.rotation);
+			break;
+		case PhysicsQueryType::SphereCast:
+		case PhysicsQueryType::SphereOverlap:
+			geometry.storeAny(PxSphereGeometry(query.size.x));
+			break;
+		case PhysicsQueryType::CapsuleCast:
+		case PhysicsQueryType::CapsuleOverlap:
+			geometry.storeAny(PxCapsuleGeometry(query.size.x, query.size.y * 0.5f));
+			break;
+		default:
+			return;
+		}
+
+		const bool isCast = query.type == PhysicsQueryType::BoxCast || query.type == PhysicsQueryType::SphereCast ||
+			query.type == PhysicsQueryType::CapsuleCast;
+
+		if (isCast)
+		{
+			PxSweepBuffer output;
+			if (mScene->sweep(geometry.any(), transform, toPxVector(query.unitDir), query.maxDist, output,
+				PxHitFlag::eDEFAULT | PxHitFlag::eUV, filterData))
+			{
+				parseHit(output.block, result.hit);
+				result.numHits = 1;
+			}
+		}
+		else
+		{
+			PhysXBatchOverlapCallback output(query.overlaps, query.maxOverlaps);
+			mScene->overlap(geometry.any(), transform, output, filterData);
+
+			result.numHits = output.numOutput;
+		}
+	}
+
 	bool PhysXScene::sweep(const PxGeometry& geometry, const PxTransform& tfrm, const Vector3& unitDir,
 		PhysicsQueryHit& hit, UINT64 layer, float maxDist) const
 	{
@@ -109,6 +109,15 @@ namespace bs
 		/** Sends out all events recorded during simulation to the necessary physics objects. */
 		void triggerEvents();
 
+		/** Updates rigidbodies with the transforms calculated by the last completed simulation step of the scene. */
+		void updateTransforms(PhysXScene& scene);
+
+		/** 
+		 * Blocks until the simulation step running asynchronously in the scene completes, and reports its results. 
+		 * Returns false if no step was running. 
+		 */
+		bool completeAsyncSimulation(PhysXScene& scene);
+
 		PHYSICS_INIT_DESC mInitDesc;
 		bool mPaused = false;
 
@@ -250,6 +259,9 @@ namespace bs
 		bool convexOverlapAny(const HPhysicsMesh& mesh, const Vector3& position, const Quaternion& rotation,
 			UINT64 layer = BS_ALL_LAYERS) const override;
 
+		/** @copydoc PhysicsScene::queryBatch */
+		void queryBatch(const PhysicsQueryBatch& batch, PhysicsQueryResult* results) const override;
+
 		/** @copydoc PhysicsScene::getGravity */
 		Vector3 getGravity() const override;
 
@@ -274,6 +286,9 @@ namespace bs
 		/** @copydoc PhysicsScene::setMaxTesselationEdgeLength */
 		void setMaxTesselationEdgeLength(float length) override;
 
+		/** @copydoc PhysicsScene::_executeQuery */
+		void _executeQuery(const PhysicsQuery& query, PhysicsQueryResult& result) const override;
+
 		/** @copydoc PhysicsScene::_boxOverlap */
 		Vector<Collider*> _boxOverlap(const AABox& box, const Quaternion& rotation,
 			UINT64 layer = BS_ALL_LAYERS) const override;
@@ -330,6 +345,10 @@ namespace bs
 		physx::PxPhysics* mPhysics = nullptr;
 		physx::PxScene* mScene = nullptr;
 		physx::PxControllerManager* mCharManager = nullptr;
+
+		/** Scratch memory used by asynchronous simulation steps, which outlive the frame allocator. */
+		UINT8* mScratchBuffer = nullptr;
+		bool mAsyncSimulationInProgress = false;
 	};
 
 	/** Provides easier access to PhysX. */
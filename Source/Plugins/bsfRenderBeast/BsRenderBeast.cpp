@@ -361,6 +361,8 @@ namespace bs { namespace ct
 		gProfilerGPU().beginFrame();
 		gProfilerCPU().beginSample("Render");
 
+		GpuResourcePool::instance()._beginFrame();
+
 		const SceneInfo& sceneInfo = mScene->getSceneInfo();
 
 		// Note: I'm iterating over all sampler states every frame. If this ends up being a performance
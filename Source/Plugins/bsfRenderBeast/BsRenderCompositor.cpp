@@ -692,10 +692,7 @@ namespace bs { namespace ct
 				}
 			};
 
-			SPtr<TaskGroup> sortTask = TaskGroup::create("ParticleSort", worker, (UINT32)systemsToSort.size());
-
-			TaskScheduler::instance().addTaskGroup(sortTask);
-			sortTask->wait();
+			TaskScheduler::instance().parallelFor(0, (UINT32)systemsToSort.size(), 1, worker);
 		}
 		bs_frame_clear();
 	}
@@ -1245,6 +1242,8 @@ namespace bs { namespace ct
 
 			// Makes sure light accumulation can be read by following passes
 			rapi.setRenderTarget(nullptr);
+
+			resPool.release(iblRadianceTex);
 		}
 	}
 
@@ -1816,7 +1815,7 @@ namespace bs { namespace ct
 					settings.autoExposure,
 					settings.exposureScale);
 
-				SPtr<Texture> downsampleInput = luminanceTex->texture;
+				SPtr<PooledRenderTexture> downsampleInput = luminanceTex;
 				luminanceTex = nullptr;
 
 				// Downsample some more
@@ -1824,10 +1823,13 @@ namespace bs { namespace ct
 				{
 					DownsampleMat* downsampleMat = DownsampleMat::getVariation(1, false);
 					SPtr<PooledRenderTexture> downsampledLuminance = 
-						resPool.get(DownsampleMat::getOutputDesc(downsampleInput));
+						resPool.get(DownsampleMat::getOutputDesc(downsampleInput->texture));
+
+					downsampleMat->execute(downsampleInput->texture, downsampledLuminance->renderTexture);
 
-					downsampleMat->execute(downsampleInput, downsampledLuminance->renderTexture);
-					downsampleInput = downsampledLuminance->texture;
+					// Return the previous level to the pool, instead of re-creating it every frame
+					resPool.release(downsampleInput);
+					downsampleInput = downsampledLuminance;
 				}
 
 				// Generate eye adaptation value
@@ -1839,12 +1841,14 @@ namespace bs { namespace ct
 
 				output = resPool.get(EyeAdaptationBasicMat::getOutputDesc());
 				eyeAdaptationMat->execute(
-					downsampleInput,
+					downsampleInput->texture,
 					prevFrameEyeAdaptation,
 					output->renderTexture,
 					inputs.frameInfo.timeDelta,
 					settings.autoExposure,
 					settings.exposureScale);
+
+				resPool.release(downsampleInput);
 			}
 		}
 		else
@@ -2698,9 +2702,20 @@ namespace bs { namespace ct
 			const Color tint = Color::White * (settings.bloom.intensity / (float)numSteps);
 			filterMat->execute(downsamplePyramid[srcIdx]->texture, FILTER_SIZE_PER_STEP[i], filterOutput->renderTexture, 
 				tint, additiveInput);
+
+			if(prevOutput)
+				resPool.release(prevOutput);
+
 			prevOutput = filterOutput;
 		}
 
+		// Return intermediate textures to the pool so later passes can reuse them
+		if(clipOutput)
+			resPool.release(clipOutput);
+
+		for(UINT32 i = 1; i < NUM_DOWNSAMPLE_LEVELS; i++)
+			resPool.release(downsamplePyramid[i]);
+
 		mPooledOutput = prevOutput;
 		output = mPooledOutput->texture;
 	}
@@ -156,6 +156,7 @@ namespace bs {	namespace ct
 
 				mInfo.radialLights.push_back(RendererLight(light));
 				mInfo.radialLightWorldBounds.push_back(light->getBounds());
+				mInfo.radialLightSpatialIndex.add(light->getBounds());
 			}
 			else // Spot
 			{
@@ -164,6 +165,7 @@ namespace bs {	namespace ct
 
 				mInfo.spotLights.push_back(RendererLight(light));
 				mInfo.spotLightWorldBounds.push_back(light->getBounds());
+				mInfo.spotLightSpatialIndex.add(light->getBounds());
 			}
 		}
 	}
@@ -173,9 +175,15 @@ namespace bs {	namespace ct
 		UINT32 lightId = light->getRendererId();
 
 		if (light->getType() == LightType::Radial)
+		{
 			mInfo.radialLightWorldBounds[lightId] = light->getBounds();
+			mInfo.radialLightSpatialIndex.update(lightId, light->getBounds());
+		}
 		else if(light->getType() == LightType::Spot)
+		{
 			mInfo.spotLightWorldBounds[lightId] = light->getBounds();
+			mInfo.spotLightSpatialIndex.update(lightId, light->getBounds());
+		}
 	}
 
 	void RendererScene::unregisterLight(Light* light)
@@ -215,6 +223,7 @@ namespace bs {	namespace ct
 				// Last element is the one we want to erase
 				mInfo.radialLights.erase(mInfo.radialLights.end() - 1);
 				mInfo.radialLightWorldBounds.erase(mInfo.radialLightWorldBounds.end() - 1);
+				mInfo.radialLightSpatialIndex.remove(lightId);
 			}
 			else // Spot
 			{
@@ -233,6 +242,7 @@ namespace bs {	namespace ct
 				// Last element is the one we want to erase
 				mInfo.spotLights.erase(mInfo.spotLights.end() - 1);
 				mInfo.spotLightWorldBounds.erase(mInfo.spotLightWorldBounds.end() - 1);
+				mInfo.spotLightSpatialIndex.remove(lightId);
 			}
 		}
 	}
@@ -245,6 +255,8 @@ namespace bs {	namespace ct
 
 		mInfo.renderables.push_back(bs_new<RendererRenderable>());
 		mInfo.renderableCullInfos.push_back(CullInfo(renderable->getBounds(), renderable->getLayer(), renderable->getCullDistanceFactor()));
+		mInfo.renderableCullData.add(mInfo.renderableCullInfos.back());
+		mInfo.renderableSpatialIndex.add(mInfo.renderableCullInfos.back().bounds.getBox());
 
 		RendererRenderable* rendererRenderable = mInfo.renderables.back();
 		rendererRenderable->renderable = renderable;
@@ -437,6 +449,8 @@ namespace bs {	namespace ct
 		mInfo.renderables[renderableId]->updatePerObjectBuffer();
 		mInfo.renderableCullInfos[renderableId].bounds = renderable->getBounds();
 		mInfo.renderableCullInfos[renderableId].cullDistanceFactor = renderable->getCullDistanceFactor();
+		mInfo.renderableCullData.set(renderableId, mInfo.renderableCullInfos[renderableId]);
+		mInfo.renderableSpatialIndex.update(renderableId, mInfo.renderableCullInfos[renderableId].bounds.getBox());
 	}
 
 	void RendererScene::unregisterRenderable(Renderable* renderable)
@@ -465,6 +479,8 @@ namespace bs {	namespace ct
 		// Last element is the one we want to erase
 		mInfo.renderables.erase(mInfo.renderables.end() - 1);
 		mInfo.renderableCullInfos.erase(mInfo.renderableCullInfos.end() - 1);
+		mInfo.renderableCullData.remove(renderableId);
+		mInfo.renderableSpatialIndex.remove(renderableId);
 
 		bs_delete(rendererRenderable);
 	}
@@ -478,6 +494,7 @@ namespace bs {	namespace ct
 		RendererReflectionProbe& probeInfo = mInfo.reflProbes.back();
 
 		mInfo.reflProbeWorldBounds.push_back(probe->getBounds());
+		mInfo.reflProbeSpatialIndex.add(probe->getBounds());
 
 		// Find a spot in cubemap array
 		UINT32 numArrayEntries = (UINT32)mInfo.reflProbeCubemapArrayUsedSlots.size();
@@ -510,6 +527,7 @@ namespace bs {	namespace ct
 		// Should only get called if transform changes, any other major changes and ReflProbeInfo entry gets rebuild
 		UINT32 probeId = probe->getRendererId();
 		mInfo.reflProbeWorldBounds[probeId] = probe->getBounds();
+		mInfo.reflProbeSpatialIndex.update(probeId, probe->getBounds());
 
 		if (texture)
 		{
@@ -541,6 +559,7 @@ namespace bs {	namespace ct
 		// Last element is the one we want to erase
 		mInfo.reflProbes.erase(mInfo.reflProbes.end() - 1);
 		mInfo.reflProbeWorldBounds.erase(mInfo.reflProbeWorldBounds.end() - 1);
+		mInfo.reflProbeSpatialIndex.remove(probeId);
 	}
 
 	void RendererScene::setReflectionProbeArrayIndex(UINT32 probeIdx, UINT32 arrayIdx, bool markAsClean)
@@ -590,6 +609,7 @@ namespace bs {	namespace ct
 
 		mInfo.particleSystems.push_back(RendererParticles());
 		mInfo.particleSystemCullInfos.push_back(CullInfo(Bounds(), particleSystem->getLayer()));
+		mInfo.particleSystemCullData.add(mInfo.particleSystemCullInfos.back());
 
 		RendererParticles& rendererParticles = mInfo.particleSystems.back();
 		rendererParticles.particleSystem = particleSystem;
@@ -924,6 +944,7 @@ namespace bs {	namespace ct
 		// Last element is the one we want to erase
 		mInfo.particleSystems.erase(mInfo.particleSystems.end() - 1);
 		mInfo.particleSystemCullInfos.erase(mInfo.particleSystemCullInfos.end() - 1);
+		mInfo.particleSystemCullData.remove(rendererId);
 	}
 
 	void RendererScene::registerDecal(Decal* decal)
@@ -933,6 +954,8 @@ namespace bs {	namespace ct
 
 		mInfo.decals.emplace_back();
 		mInfo.decalCullInfos.push_back(CullInfo(decal->getBounds(), decal->getLayer()));
+		mInfo.decalCullData.add(mInfo.decalCullInfos.back());
+		mInfo.decalSpatialIndex.add(mInfo.decalCullInfos.back().bounds.getBox());
 
 		RendererDecal& rendererDecal = mInfo.decals.back();
 		rendererDecal.decal = decal;
@@ -1008,6 +1031,8 @@ namespace bs {	namespace ct
 
 		mInfo.decals[rendererId].updatePerObjectBuffer();
 		mInfo.decalCullInfos[rendererId].bounds = decal->getBounds();
+		mInfo.decalCullData.set(rendererId, mInfo.decalCullInfos[rendererId]);
+		mInfo.decalSpatialIndex.update(rendererId, mInfo.decalCullInfos[rendererId].bounds.getBox());
 	}
 
 	void RendererScene::unregisterDecal(Decal* decal)
@@ -1035,6 +1060,8 @@ namespace bs {	namespace ct
 		// Last element is the one we want to erase
 		mInfo.decals.erase(mInfo.decals.end() - 1);
 		mInfo.decalCullInfos.erase(mInfo.decalCullInfos.end() - 1);
+		mInfo.decalCullData.remove(rendererId);
+		mInfo.decalSpatialIndex.remove(rendererId);
 	}
 
 	void RendererScene::setOptions(const SPtr<RenderBeastOptions>& options)
@@ -1327,6 +1354,7 @@ namespace bs {	namespace ct
 
 			const Sphere worldSphere(worldAABox.getCenter(), worldAABox.getRadius());
 			mInfo.particleSystemCullInfos[rendererId].bounds = Bounds(worldAABox, worldSphere);
+			mInfo.particleSystemCullData.set(rendererId, mInfo.particleSystemCullInfos[rendererId]);
 		}
 	}
 
@@ -8,6 +8,7 @@
 #include "BsRendererParticles.h"
 #include "Shading/BsLightProbes.h"
 #include "Utility/BsSamplerOverrides.h"
+#include "Utility/BsSceneSpatialIndex.h"
 
 namespace bs 
 { 
@@ -38,6 +39,8 @@ namespace bs
 		// Renderables
 		Vector<RendererRenderable*> renderables;
 		Vector<CullInfo> renderableCullInfos;
+		CullInfoSoA renderableCullData;
+		SceneSpatialIndex renderableSpatialIndex;
 
 		// Lights
 		Vector<RendererLight> directionalLights;
@@ -45,10 +48,13 @@ namespace bs
 		Vector<RendererLight> spotLights;
 		Vector<Sphere> radialLightWorldBounds;
 		Vector<Sphere> spotLightWorldBounds;
+		SceneSpatialIndex radialLightSpatialIndex;
+		SceneSpatialIndex spotLightSpatialIndex;
 
 		// Reflection probes
 		Vector<RendererReflectionProbe> reflProbes;
 		Vector<Sphere> reflProbeWorldBounds;
+		SceneSpatialIndex reflProbeSpatialIndex;
 		Vector<bool> reflProbeCubemapArrayUsedSlots;
 		SPtr<Texture> reflProbeCubemapsTex;
 
@@ -58,10 +64,13 @@ namespace bs
 		// Particles
 		Vector<RendererParticles> particleSystems;
 		Vector<CullInfo> particleSystemCullInfos;
+		CullInfoSoA particleSystemCullData;
 
 		// Decals
 		Vector<RendererDecal> decals;
 		Vector<CullInfo> decalCullInfos;
+		CullInfoSoA decalCullData;
+		SceneSpatialIndex decalSpatialIndex;
 
 		// Sky
 		Skybox* skybox = nullptr;
@@ -10,6 +10,7 @@
 #include "BsRendererLight.h"
 #include "BsRendererScene.h"
 #include "BsRenderBeast.h"
+#include "Threading/BsTaskScheduler.h"
 #include <BsRendererDecal.h>
 
 namespace bs { namespace ct
@@ -60,6 +61,14 @@ namespace bs { namespace ct
 		viewProjTransform = src.projTransform * src.viewTransform;
 	}
 
+	/** Returns information required for culling objects against the provided view. */
+	CullView getCullView(const RendererView& view)
+	{
+		const RendererViewProperties& props = view.getProperties();
+		return CullView(props.visibleLayers, props.cullFrustum.getPlanes(), props.viewOrigin, 
+			view.getRenderSettings().cullDistance);
+	}
+
 	RendererView::RendererView()
 		: mCamera(nullptr), mRenderSettingsHash(0), mViewIdx(-1)
 	{
@@ -179,11 +188,11 @@ namespace bs { namespace ct
 		mDecalQueue->clear();
 	}
 
-	void RendererView::determineVisible(const Vector<RendererRenderable*>& renderables, const Vector<CullInfo>& cullInfos,
-		Vector<bool>* visibility)
+	void RendererView::determineVisible(const Vector<RendererRenderable*>& renderables, const CullInfoSoA& cullInfos,
+		Bitfield* visibility)
 	{
 		mVisibility.renderables.clear();
-		mVisibility.renderables.resize(renderables.size(), false);
+		mVisibility.renderables.resize((UINT32)renderables.size(), false);
 
 		if (mRenderSettings->overlayOnly)
 			return;
@@ -191,21 +200,14 @@ namespace bs { namespace ct
 		calculateVisibility(cullInfos, mVisibility.renderables);
 
 		if(visibility != nullptr)
-		{
-			for (UINT32 i = 0; i < (UINT32)renderables.size(); i++)
-			{
-				bool visible = (*visibility)[i];
-
-				(*visibility)[i] = visible || mVisibility.renderables[i];
-			}
-		}
+			*visibility |= mVisibility.renderables;
 	}
 
-	void RendererView::determineVisible(const Vector<RendererParticles>& particleSystems, const Vector<CullInfo>& cullInfos, 
-		Vector<bool>* visibility)
+	void RendererView::determineVisible(const Vector<RendererParticles>& particleSystems, const CullInfoSoA& cullInfos,
+		Bitfield* visibility)
 	{
 		mVisibility.particleSystems.clear();
-		mVisibility.particleSystems.resize(particleSystems.size(), false);
+		mVisibility.particleSystems.resize((UINT32)particleSystems.size(), false);
 
 		if (mRenderSettings->overlayOnly)
 			return;
@@ -213,21 +215,14 @@ namespace bs { namespace ct
 		calculateVisibility(cullInfos, mVisibility.particleSystems);
 
 		if(visibility != nullptr)
-		{
-			for (UINT32 i = 0; i < (UINT32)particleSystems.size(); i++)
-			{
-				bool visible = (*visibility)[i];
-
-				(*visibility)[i] = visible || mVisibility.particleSystems[i];
-			}
-		}
+			*visibility |= mVisibility.particleSystems;
 	}
 
-	void RendererView::determineVisible(const Vector<RendererDecal>& decals, const Vector<CullInfo>& cullInfos, 
-		Vector<bool>* visibility)
+	void RendererView::determineVisible(const Vector<RendererDecal>& decals, const CullInfoSoA& cullInfos,
+		Bitfield* visibility)
 	{
 		mVisibility.decals.clear();
-		mVisibility.decals.resize(decals.size(), false);
+		mVisibility.decals.resize((UINT32)decals.size(), false);
 
 		if (mRenderSettings->overlayOnly)
 			return;
@@ -235,14 +230,7 @@ namespace bs { namespace ct
 		calculateVisibility(cullInfos, mVisibility.decals);
 
 		if(visibility != nullptr)
-		{
-			for (UINT32 i = 0; i < (UINT32)decals.size(); i++)
-			{
-				bool visible = (*visibility)[i];
-
-				(*visibility)[i] = visible || mVisibility.decals[i];
-			}
-		}
+			*visibility |= mVisibility.decals;
 	}
 
 	void RendererView::determineVisible(const Vector<RendererLight>& lights, const Vector<Sphere>& bounds, 
@@ -289,40 +277,234 @@ namespace bs { namespace ct
 		}
 	}
 
-	void RendererView::calculateVisibility(const Vector<CullInfo>& cullInfos, Vector<bool>& visibility) const
+	void RendererView::calculateVisibility(const CullInfoSoA& cullInfos, Bitfield& visibility) const
 	{
-		UINT64 cameraLayers = mProperties.visibleLayers;
-		const ConvexVolume& worldFrustum = mProperties.cullFrustum;
-		const Vector3& worldCameraPosition = mProperties.viewOrigin;
-		float baseCullDistance = mRenderSettings->cullDistance;
+		const CullView cullView = getCullView(*this);
+
+		const UINT32 numEntries = cullInfos.size();
+		for (UINT32 i = 0; i < numEntries; i += CullInfoSoA::BATCH_SIZE)
+		{
+			UINT32 visibleMask = cullBatch(cullInfos, i, cullView);
+			while (visibleMask != 0)
+			{
+				const UINT32 j = Bitwise::leastSignificantBit(visibleMask);
+				visibility[i + j] = true;
+
+				visibleMask &= visibleMask - 1;
+			}
+		}
+	}
+
+	void RendererView::determineVisibleMultiView(RendererView* const* views, UINT32 numViews, const SceneInfo& sceneInfo,
+		VisibilityInfo* visibility)
+	{
+		// Objects are processed in blocks so that no two threads ever write to the same dword of a Bitfield
+		static constexpr UINT32 BLOCK_SIZE = 32;
+		static_assert(BLOCK_SIZE % CullInfoSoA::BATCH_SIZE == 0, "Block size must be a multiple of the batch size.");
 
-		for (UINT32 i = 0; i < (UINT32)cullInfos.size(); i++)
+		SmallVector<RendererView*, 8> activeViews;
+		SmallVector<CullView, 8> cullViews;
+		SmallVector<VisibilityInfo*, 8> viewVisibility;
+		for (UINT32 i = 0; i < numViews; i++)
 		{
-			if ((cullInfos[i].layer & cameraLayers) == 0)
+			VisibilityInfo& output = views[i]->mVisibility;
+			output.renderables.clear();
+			output.renderables.resize((UINT32)sceneInfo.renderables.size(), false);
+
+			output.particleSystems.clear();
+			output.particleSystems.resize((UINT32)sceneInfo.particleSystems.size(), false);
+
+			output.decals.clear();
+			output.decals.resize((UINT32)sceneInfo.decals.size(), false);
+
+			if (views[i]->mRenderSettings->overlayOnly)
 				continue;
 
-			// Do distance culling
-			const Sphere& boundingSphere = cullInfos[i].bounds.getSphere();
-			const Vector3& worldRenderablePosition = boundingSphere.getCenter();
+			activeViews.add(views[i]);
+			cullViews.add(getCullView(*views[i]));
+			viewVisibility.add(&output);
+		}
+
+		if (cullViews.empty())
+			return;
+
+		const auto numCullViews = (UINT32)cullViews.size();
+		const auto cullObjects = [&activeViews, &cullViews, &viewVisibility, numCullViews](const CullInfoSoA& cullInfos, 
+			const SceneSpatialIndex* spatialIndex, Bitfield VisibilityInfo::* field, Bitfield* groupVisibility)
+		{
+			const UINT32 numEntries = cullInfos.size();
+
+			// Tests a single batch against all the views, so its bounds are only read once
+			const auto cullBatchAllViews = [&](UINT32 first)
+			{
+				UINT32 groupMask = 0;
+				for (UINT32 j = 0; j < numCullViews; j++)
+				{
+					UINT32 visibleMask = cullBatch(cullInfos, first, cullViews[j]);
+					groupMask |= visibleMask;
+
+					Bitfield& output = viewVisibility[j]->*field;
+					while (visibleMask != 0)
+					{
+						const UINT32 k = Bitwise::leastSignificantBit(visibleMask);
+						output[first + k] = true;
+
+						visibleMask &= visibleMask - 1;
+					}
+				}
+
+				if (groupVisibility != nullptr)
+				{
+					while (groupMask != 0)
+					{
+						const UINT32 k = Bitwise::leastSignificantBit(groupMask);
+						(*groupVisibility)[first + k] = true;
+
+						groupMask &= groupMask - 1;
+					}
+				}
+			};
+
+			// Only batches containing objects from the spatial index nodes overlapping at least one of the views are 
+			// culled, so the cost depends on the number of objects near the views rather than on the number of objects 
+			// in the scene. Batches overlapped by multiple views are still only culled once.
+			if (spatialIndex != nullptr)
+			{
+				TaskScheduler::instance().parallelFor(0, numCullViews, 1, [&](UINT32 i)
+				{
+					Vector<UINT32>& batches = activeViews[i]->mCullBatches;
+					batches.clear();
 
-			float distanceToCameraSq = worldCameraPosition.squaredDistance(worldRenderablePosition);
-			float correctedCullDistance = cullInfos[i].cullDistanceFactor * baseCullDistance;
-			float maxDistanceToCamera = correctedCullDistance + boundingSphere.getRadius();
+					spatialIndex->visitCandidates(activeViews[i]->mProperties.cullFrustum, 
+						[&batches](UINT32 idx) { batches.push_back(idx / CullInfoSoA::BATCH_SIZE); });
+
+					std::sort(batches.begin(), batches.end());
+					batches.erase(std::unique(batches.begin(), batches.end()), batches.end());
+				});
+
+				Vector<UINT32> candidateBatches;
+				for (UINT32 i = 0; i < numCullViews; i++)
+				{
+					const Vector<UINT32>& batches = activeViews[i]->mCullBatches;
+					candidateBatches.insert(candidateBatches.end(), batches.begin(), batches.end());
+				}
+
+				if (numCullViews > 1)
+				{
+					std::sort(candidateBatches.begin(), candidateBatches.end());
+					candidateBatches.erase(std::unique(candidateBatches.begin(), candidateBatches.end()), 
+						candidateBatches.end());
+				}
 
-			if (distanceToCameraSq > maxDistanceToCamera * maxDistanceToCamera)
+				// Group the batches by block, so that no two threads write to the same dword of a Bitfield
+				static constexpr UINT32 BATCHES_PER_BLOCK = BLOCK_SIZE / CullInfoSoA::BATCH_SIZE;
+
+				Vector<UINT32> blockStarts;
+				for (UINT32 i = 0; i < (UINT32)candidateBatches.size(); i++)
+				{
+					if (i == 0 || candidateBatches[i] / BATCHES_PER_BLOCK != candidateBatches[i - 1] / BATCHES_PER_BLOCK)
+						blockStarts.push_back(i);
+				}
+
+				const auto numCandidateBlocks = (UINT32)blockStarts.size();
+				blockStarts.push_back((UINT32)candidateBatches.size());
+
+				TaskScheduler::instance().parallelFor(0, numCandidateBlocks, 8, [&](UINT32 blockIdx)
+				{
+					for (UINT32 i = blockStarts[blockIdx]; i < blockStarts[blockIdx + 1]; i++)
+						cullBatchAllViews(candidateBatches[i] * CullInfoSoA::BATCH_SIZE);
+				});
+
+				return;
+			}
+
+			const UINT32 numBlocks = Math::divideAndRoundUp(numEntries, BLOCK_SIZE);
+			const auto worker = [&](UINT32 blockIdx)
+			{
+				const UINT32 blockEnd = std::min((blockIdx + 1) * BLOCK_SIZE, numEntries);
+				for (UINT32 i = blockIdx * BLOCK_SIZE; i < blockEnd; i += CullInfoSoA::BATCH_SIZE)
+					cullBatchAllViews(i);
+			};
+
+			TaskScheduler::instance().parallelFor(0, numBlocks, 8, worker);
+		};
+
+		cullObjects(sceneInfo.renderableCullData, &sceneInfo.renderableSpatialIndex, &VisibilityInfo::renderables, 
+			visibility ? &visibility->renderables : nullptr);
+
+		// Note: Particle system bounds change every frame, so they're not kept in a spatial index
+		cullObjects(sceneInfo.particleSystemCullData, nullptr, &VisibilityInfo::particleSystems, 
+			visibility ? &visibility->particleSystems : nullptr);
+		cullObjects(sceneInfo.decalCullData, &sceneInfo.decalSpatialIndex, &VisibilityInfo::decals, 
+			visibility ? &visibility->decals : nullptr);
+	}
+
+	void RendererView::determineVisibleMultiView(RendererView* const* views, UINT32 numViews, 
+		const Vector<RendererLight>& lights, const Vector<Sphere>& bounds, const SceneSpatialIndex* spatialIndex,
+		LightType lightType, Vector<bool>* visibility)
+	{
+		// Special case for directional lights, they're always visible
+		if(lightType == LightType::Directional)
+		{
+			if (visibility)
+				visibility->assign(lights.size(), true);
+
+			return;
+		}
+
+		SmallVector<const ConvexVolume*, 8> frustums;
+		SmallVector<Vector<bool>*, 8> viewVisibility;
+		for (UINT32 i = 0; i < numViews; i++)
+		{
+			Vector<bool>& output = lightType == LightType::Radial ? 
+				views[i]->mVisibility.radialLights : views[i]->mVisibility.spotLights;
+
+			output.clear();
+			output.resize(lights.size(), false);
+
+			if (views[i]->mRenderSettings->overlayOnly)
 				continue;
 
-			// Do frustum culling
-			// Note: This is bound to be a bottleneck at some point. When it is ensure that intersect methods use vector
-			// operations, as it is trivial to update them. Also consider spatial partitioning.
-			if (worldFrustum.intersects(boundingSphere))
+			frustums.add(&views[i]->mProperties.cullFrustum);
+			viewVisibility.add(&output);
+		}
+
+		if (spatialIndex != nullptr)
+		{
+			for (UINT32 i = 0; i < frustums.size(); i++)
 			{
-				// More precise with the box
-				const AABox& boundingBox = cullInfos[i].bounds.getBox();
+				const ConvexVolume& frustum = *frustums[i];
+				Vector<bool>& output = *viewVisibility[i];
 
-				if (worldFrustum.intersects(boundingBox))
-					visibility[i] = true;
+				spatialIndex->visitCandidates(frustum, [&frustum, &output, &bounds, visibility](UINT32 idx)
+				{
+					if (frustum.intersects(bounds[idx]))
+					{
+						output[idx] = true;
+
+						if (visibility != nullptr)
+							(*visibility)[idx] = true;
+					}
+				});
 			}
+
+			return;
+		}
+
+		for (UINT32 i = 0; i < (UINT32)bounds.size(); i++)
+		{
+			bool visibleFromAny = false;
+			for (UINT32 j = 0; j < frustums.size(); j++)
+			{
+				if (frustums[j]->intersects(bounds[i]))
+				{
+					(*viewVisibility[j])[i] = true;
+					visibleFromAny = true;
+				}
+			}
+
+			if (visibility != nullptr && visibleFromAny)
+				(*visibility)[i] = true;
 		}
 	}
 
@@ -337,6 +519,18 @@ namespace bs { namespace ct
 		}
 	}
 
+	void RendererView::calculateVisibility(const Vector<Sphere>& bounds, const SceneSpatialIndex& spatialIndex, 
+		Vector<bool>& visibility) const
+	{
+		const ConvexVolume& worldFrustum = mProperties.cullFrustum;
+
+		spatialIndex.visitCandidates(worldFrustum, [&worldFrustum, &bounds, &visibility](UINT32 idx)
+		{
+			if (worldFrustum.intersects(bounds[idx]))
+				visibility[idx] = true;
+		});
+	}
+
 	void RendererView::calculateVisibility(const Vector<AABox>& bounds, Vector<bool>& visibility) const
 	{
 		const ConvexVolume& worldFrustum = mProperties.cullFrustum;
@@ -691,22 +885,17 @@ namespace bs { namespace ct
 		if (allViewsOverlay)
 			return;
 
-		// Calculate renderable visibility per view
-		mVisibility.renderables.resize(sceneInfo.renderables.size(), false);
-		mVisibility.renderables.assign(sceneInfo.renderables.size(), false);
+		// Calculate renderable visibility for all views at once
+		mVisibility.renderables.clear();
+		mVisibility.renderables.resize((UINT32)sceneInfo.renderables.size(), false);
 
-		mVisibility.particleSystems.resize(sceneInfo.particleSystems.size(), false);
-		mVisibility.particleSystems.assign(sceneInfo.particleSystems.size(), false);
+		mVisibility.particleSystems.clear();
+		mVisibility.particleSystems.resize((UINT32)sceneInfo.particleSystems.size(), false);
 
-		mVisibility.decals.resize(sceneInfo.decals.size(), false);
-		mVisibility.decals.assign(sceneInfo.decals.size(), false);
+		mVisibility.decals.clear();
+		mVisibility.decals.resize((UINT32)sceneInfo.decals.size(), false);
 
-		for(UINT32 i = 0; i < numViews; i++)
-		{
-			mViews[i]->determineVisible(sceneInfo.renderables, sceneInfo.renderableCullInfos, &mVisibility.renderables);
-			mViews[i]->determineVisible(sceneInfo.particleSystems, sceneInfo.particleSystemCullInfos, &mVisibility.particleSystems);
-			mViews[i]->determineVisible(sceneInfo.decals, sceneInfo.decalCullInfos, &mVisibility.decals);
-		}
+		RendererView::determineVisibleMultiView(mViews.data(), numViews, sceneInfo, &mVisibility);
 		
 		// Generate render queues per camera
 		for(UINT32 i = 0; i < numViews; i++)
@@ -721,17 +910,13 @@ namespace bs { namespace ct
 		mVisibility.spotLights.resize(numSpotLights, false);
 		mVisibility.spotLights.assign(numSpotLights, false);
 
-		for (UINT32 i = 0; i < numViews; i++)
-		{
-			if (mViews[i]->getRenderSettings().overlayOnly)
-				continue;
-
-			mViews[i]->determineVisible(sceneInfo.radialLights, sceneInfo.radialLightWorldBounds, LightType::Radial,
-				&mVisibility.radialLights);
+		RendererView::determineVisibleMultiView(mViews.data(), numViews, sceneInfo.radialLights, 
+			sceneInfo.radialLightWorldBounds, &sceneInfo.radialLightSpatialIndex, LightType::Radial, 
+			&mVisibility.radialLights);
 
-			mViews[i]->determineVisible(sceneInfo.spotLights, sceneInfo.spotLightWorldBounds, LightType::Spot,
-				&mVisibility.spotLights);
-		}
+		RendererView::determineVisibleMultiView(mViews.data(), numViews, sceneInfo.spotLights, 
+			sceneInfo.spotLightWorldBounds, &sceneInfo.spotLightSpatialIndex, LightType::Spot, 
+			&mVisibility.spotLights);
 
 		// Calculate refl. probe visibility for all views
 		const auto numProbes = (UINT32)sceneInfo.reflProbes.size();
@@ -747,7 +932,8 @@ namespace bs { namespace ct
 			if (viewProps.capturingReflections)
 				continue;
 
-			mViews[i]->calculateVisibility(sceneInfo.reflProbeWorldBounds, mVisibility.reflProbes);
+			mViews[i]->calculateVisibility(sceneInfo.reflProbeWorldBounds, sceneInfo.reflProbeSpatialIndex, 
+				mVisibility.reflProbes);
 		}
 
 		// Organize light and refl. probe visibility infomation in a more GPU friendly manner
@@ -8,6 +8,8 @@
 #include "Renderer/BsRenderSettings.h"
 #include "Math/BsBounds.h"
 #include "Math/BsConvexVolume.h"
+#include "Utility/BsBitfield.h"
+#include "Renderer/BsCullInfo.h"
 #include "Shading/BsLightGrid.h"
 #include "Shading/BsShadowRendering.h"
 #include "BsRendererView.h"
@@ -20,6 +22,7 @@ namespace bs { namespace ct
 {
 	struct SceneInfo;
 	class RendererLight;
+	class SceneSpatialIndex;
 
 	/** @addtogroup RenderBeast
 	 *  @{
@@ -190,24 +193,12 @@ namespace bs { namespace ct
 	/** Information whether certain scene objects are visible in a view, per object type. */
 	struct VisibilityInfo
 	{
-		Vector<bool> renderables;
+		Bitfield renderables;
 		Vector<bool> radialLights;
 		Vector<bool> spotLights;
 		Vector<bool> reflProbes;
-		Vector<bool> particleSystems;
-		Vector<bool> decals;
-	};
-
-	/** Information used for culling an object against a view. */
-	struct CullInfo
-	{
-		CullInfo(const Bounds& bounds, UINT64 layer = -1, float cullDistanceFactor = 1.0f)
-			:layer(layer), bounds(bounds), cullDistanceFactor(cullDistanceFactor)
-		{ }
-
-		UINT64 layer;
-		Bounds bounds;
-		float cullDistanceFactor;
+		Bitfield particleSystems;
+		Bitfield decals;
 	};
 
 	/**	Renderer information specific to a single render target. */
@@ -286,8 +277,8 @@ namespace bs { namespace ct
 		 *									As a side-effect, per-view visibility data is also calculated and can be
 		 *									retrieved by calling getVisibilityMask().
 		 */
-		void determineVisible(const Vector<RendererRenderable*>& renderables, const Vector<CullInfo>& cullInfos,
-			Vector<bool>* visibility = nullptr);
+		void determineVisible(const Vector<RendererRenderable*>& renderables, const CullInfoSoA& cullInfos,
+			Bitfield* visibility = nullptr);
 
 		/**
 		 * Populates view render queues by determining visible particle systems. 
@@ -303,8 +294,8 @@ namespace bs { namespace ct
 		 *									As a side-effect, per-view visibility data is also calculated and can be
 		 *									retrieved by calling getVisibilityMask().
 		 */
-		void determineVisible(const Vector<RendererParticles>& particleSystems, const Vector<CullInfo>& cullInfos,
-			Vector<bool>* visibility = nullptr);
+		void determineVisible(const Vector<RendererParticles>& particleSystems, const CullInfoSoA& cullInfos,
+			Bitfield* visibility = nullptr);
 
 		/**
 		 * Populates view render queues by determining visible decals. 
@@ -320,8 +311,8 @@ namespace bs { namespace ct
 		 *									As a side-effect, per-view visibility data is also calculated and can be
 		 *									retrieved by calling getVisibilityMask().
 		 */
-		void determineVisible(const Vector<RendererDecal>& decals, const Vector<CullInfo>& cullInfos,
-			Vector<bool>* visibility = nullptr);
+		void determineVisible(const Vector<RendererDecal>& decals, const CullInfoSoA& cullInfos,
+			Bitfield* visibility = nullptr);
 
 		/**
 		 * Calculates the visibility masks for all the lights of the provided type.
@@ -342,10 +333,52 @@ namespace bs { namespace ct
 			Vector<bool>* visibility = nullptr);
 
 		/**
-		 * Culls the provided set of bounds against the current frustum and outputs a set of visibility flags determining
-		 * which entry is or isn't visible by this view. Both inputs must be arrays of the same size.
+		 * Determines visible renderables, particle systems and decals for multiple views at once. Equivalent to calling
+		 * determineVisible() for each object type on each of the views, except that the bounds of each object are read
+		 * only once and then tested against all the views, and the work is spread over multiple threads. Object types
+		 * that have a spatial index in @p sceneInfo are first culled hierarchically, so objects far outside of the views
+		 * are never tested individually.
+		 *
+		 * @param[in]	views				Views to determine visibility for. Per-view visibility can be retrieved by
+		 *									calling getVisibilityMasks() on each view.
+		 * @param[in]	numViews			Number of entries in the @p views array.
+		 * @param[in]	sceneInfo			Scene containing the objects to determine visibility for.
+		 * @param[out]	visibility			Optional output parameter that will have the true bit set for any object
+		 *									visible from at least one of the views. Bits that are already set will never
+		 *									be cleared. Bitfields must be the same size as the relevant object arrays in
+		 *									@p sceneInfo.
 		 */
-		void calculateVisibility(const Vector<CullInfo>& cullInfos, Vector<bool>& visibility) const;
+		static void determineVisibleMultiView(RendererView* const* views, UINT32 numViews, const SceneInfo& sceneInfo,
+			VisibilityInfo* visibility = nullptr);
+
+		/**
+		 * Calculates the visibility masks for all the lights of the provided type, for multiple views at once. Equivalent
+		 * to calling determineVisible() for the lights on each of the views, except that the bounds of each light are 
+		 * read only once, or if a spatial index is provided, only lights in parts of the index overlapping the view are
+		 * tested.
+		 *
+		 * @param[in]	views				Views to determine visibility for. Per-view visibility can be retrieved by
+		 *									calling getVisibilityMasks() on each view.
+		 * @param[in]	numViews			Number of entries in the @p views array.
+		 * @param[in]	lights				A set of lights to determine visibility for.
+		 * @param[in]	bounds				Bounding sphere for each provided light. Must be the same size as the @p lights
+		 *									array.
+		 * @param[in]	spatialIndex		Optional spatial index containing the bounds of the provided lights.
+		 * @param[in]	type				Type of all the lights in the @p lights array.
+		 * @param[out]	visibility			Optional output parameter that will have the true bit set for any light
+		 *									visible from at least one of the views. Must be the same size as the
+		 *									@p lights array.
+		 */
+		static void determineVisibleMultiView(RendererView* const* views, UINT32 numViews, 
+			const Vector<RendererLight>& lights, const Vector<Sphere>& bounds, const SceneSpatialIndex* spatialIndex,
+			LightType type, Vector<bool>* visibility = nullptr);
+
+		/**
+		 * Culls the provided set of objects against the current frustum, taking into account layers and cull distance,
+		 * and sets the bits for objects visible by this view. Objects are processed in batches using SIMD instructions.
+		 * The bitfield must be the same size as the @p cullInfos array.
+		 */
+		void calculateVisibility(const CullInfoSoA& cullInfos, Bitfield& visibility) const;
 
 		/**
 		 * Culls the provided set of bounds against the current frustum and outputs a set of visibility flags determining
@@ -353,6 +386,15 @@ namespace bs { namespace ct
 		 */
 		void calculateVisibility(const Vector<Sphere>& bounds, Vector<bool>& visibility) const;
 
+		/**
+		 * Culls the provided set of bounds against the current frustum and outputs a set of visibility flags determining
+		 * which entry is or isn't visible by this view. Only the entries in parts of the spatial index overlapping the
+		 * frustum are tested. @p spatialIndex must contain the same objects as @p bounds, and both must be the same size
+		 * as @p visibility.
+		 */
+		void calculateVisibility(const Vector<Sphere>& bounds, const SceneSpatialIndex& spatialIndex, 
+			Vector<bool>& visibility) const;
+
 		/**
 		 * Culls the provided set of bounds against the current frustum and outputs a set of visibility flags determining
 		 * which entry is or isn't visible by this view. Both inputs must be arrays of the same size.
@@ -447,6 +489,7 @@ namespace bs { namespace ct
 
 		SPtr<GpuParamBlockBuffer> mParamBuffer;
 		VisibilityInfo mVisibility;
+		Vector<UINT32> mCullBatches;
 		LightGrid mLightGrid;
 		UINT32 mViewIdx;
 	};
@@ -11,6 +11,7 @@
 #include "Renderer/BsRendererUtility.h"
 #include "Renderer/BsSkybox.h"
 #include "Utility/BsRendererTextures.h"
+#include "Threading/BsTaskScheduler.h"
 
 namespace bs { namespace ct 
 {
@@ -221,10 +222,47 @@ namespace bs { namespace ct
 		float padding[3];
 	};
 
+	/** 
+	 * Tetrahedron volume built from a set of light probes. Contains only CPU data, allowing it to be built on a worker
+	 * thread, after which it is used for updating the GPU resources on the core thread.
+	 */
+	struct LightProbes::TetrahedronBuild
+	{
+		/** 
+		 * World positions of all active probes. Once built, followed by the vertices of the volume used for
+		 * extrapolating probes outside of the tetrahedra.
+		 */
+		Vector<Vector3> positions;
+
+		/** Index of the SH coefficients of each probe in the global coefficient texture. */
+		Vector<UINT32> bufferIndices;
+
+		/** Location of the SH coefficients of each probe in the coefficient texture of its volume. */
+		Vector<Vector2I> bufferOffsets;
+
+		/** Mesh representing the tetrahedron volume. */
+		SPtr<MeshData> meshData;
+
+		/** Valid tetrahedra, followed by the outer faces. */
+		Vector<TetrahedronDataGPU> tetrahedra;
+
+		/** Additional information about outer faces. */
+		Vector<TetrahedronFaceDataGPU> faces;
+
+		/** Number of entries in @p tetrahedra that are tetrahedra and not outer faces. */
+		UINT32 numValidTetrahedra = 0;
+	};
+
 	LightProbes::LightProbes()
 		:mTetrahedronVolumeDirty(false), mMaxCoefficientRows(0), mMaxTetrahedra(0), mMaxFaces(0), mNumValidTetrahedra(0)
 	{ }
 
+	LightProbes::~LightProbes()
+	{
+		if (mBuildTask != nullptr)
+			mBuildTask->wait();
+	}
+
 	void LightProbes::notifyAdded(LightProbeVolume* volume)
 	{
 		UINT32 handle = (UINT32)mVolumes.size();
@@ -269,35 +307,59 @@ namespace bs { namespace ct
 
 	void LightProbes::updateProbes()
 	{
+		if (mBuildTask != nullptr)
+		{
+			// Keep using the current volume until the new one is built, unless there is no current volume
+			if (mVolumeMesh != nullptr && !mBuildTask->isComplete())
+				return;
+
+			finishBuild();
+		}
+
 		if (!mTetrahedronVolumeDirty)
 			return;
 
-		// Move all coefficients into the global buffer
-		UINT32 numRows = 0;
-		for(auto& entry : mVolumes)
+		mTetrahedronVolumeDirty = false;
+
+		if (mBuild == nullptr)
+			mBuild = bs_shared_ptr_new<TetrahedronBuild>();
+
+		TetrahedronBuild& build = *mBuild;
+		gatherProbes(build);
+
+		// If no probes were moved, added or removed (e.g. only their coefficients changed), keep the current volume
+		if (mVolumeMesh != nullptr && build.bufferIndices == mBuiltBufferIndices && build.positions == mBuiltPositions)
 		{
-			SPtr<Texture> localTexture = entry.volume->getCoefficientsTexture();
-			numRows += localTexture->getProperties().getHeight();
+			copyCoefficients();
+			return;
 		}
 
-		if(numRows > mMaxCoefficientRows)
-			resizeCoefficientTexture(numRows + 4);
-
-		UINT32 rowIdx = 0;
-		for(auto& entry : mVolumes)
+		// Tetrahedralization can take a long time for large numbers of probes, so perform it on a worker thread
+		if (TaskScheduler::isStarted())
 		{
-			TEXTURE_COPY_DESC copyDesc;
-			copyDesc.dstPosition = Vector3I(0, rowIdx, 0);
+			SPtr<TetrahedronBuild> buildPtr = mBuild;
+			mBuildTask = Task::create("LightProbeTetrahedralize", [buildPtr]() { buildTetrahedronVolume(*buildPtr); });
 
-			SPtr<Texture> localTexture = entry.volume->getCoefficientsTexture();
-			localTexture->copy(mProbeCoefficientsGPU, copyDesc);
-			
-			rowIdx += localTexture->getProperties().getHeight();
+			TaskScheduler::instance().addTask(mBuildTask);
+
+			// Nothing to render until the build completes, so wait for it
+			if (mVolumeMesh == nullptr)
+				finishBuild();
 		}
+		else
+		{
+			buildTetrahedronVolume(build);
+			applyBuild();
+		}
+	}
+
+	void LightProbes::gatherProbes(TetrahedronBuild& build) const
+	{
+		build.positions.clear();
+		build.bufferIndices.clear();
+		build.bufferOffsets.clear();
 
-		// Gather all positions
 		UINT32 bufferOffset = 0;
-		rowIdx = 0;
 		for(auto& entry : mVolumes)
 		{
 			const Vector<LightProbeInfo>& infos = entry.volume->getLightProbeInfos();
@@ -316,265 +378,293 @@ namespace bs { namespace ct
 			{
 				Vector3 localPos = positions[i];
 				Vector3 transformedPos = rotation.rotate(localPos) + offset;
-				mTempTetrahedronPositions.push_back(transformedPos);
+				build.positions.push_back(transformedPos);
 
-				mTempTetrahedronBufferIndices.push_back(bufferOffset + infos[i].bufferIdx);
+				build.bufferIndices.push_back(bufferOffset + infos[i].bufferIdx);
 
 				Vector2I offset = IBLUtility::getSHCoeffXYFromIdx(infos[i].bufferIdx, 3);
-				mTempTetrahedronBufferOffsets.push_back(offset);
+				build.bufferOffsets.push_back(offset);
 			}
 
+			bufferOffset += (UINT32)positions.size();
+		}
+	}
+
+	void LightProbes::copyCoefficients()
+	{
+		// Move all coefficients into the global buffer
+		UINT32 numRows = 0;
+		for(auto& entry : mVolumes)
+		{
 			SPtr<Texture> localTexture = entry.volume->getCoefficientsTexture();
+			numRows += localTexture->getProperties().getHeight();
+		}
+
+		if(numRows > mMaxCoefficientRows)
+			resizeCoefficientTexture(numRows + 4);
+
+		UINT32 rowIdx = 0;
+		for(auto& entry : mVolumes)
+		{
+			TEXTURE_COPY_DESC copyDesc;
+			copyDesc.dstPosition = Vector3I(0, rowIdx, 0);
+
+			SPtr<Texture> localTexture = entry.volume->getCoefficientsTexture();
+			localTexture->copy(mProbeCoefficientsGPU, copyDesc);
+			
 			rowIdx += localTexture->getProperties().getHeight();
-			bufferOffset += (UINT32)positions.size();
 		}
+	}
 
-		mTetrahedronInfos.clear();
+	void LightProbes::finishBuild()
+	{
+		mBuildTask->wait();
+		mBuildTask = nullptr;
 
-		Vector<TetrahedronFaceData> outerFaces;
-		generateTetrahedronData(mTempTetrahedronPositions, mTetrahedronInfos, outerFaces, true);
+		// Probes changed while the build was running, making its results out of date. A new build will be started.
+		if (mTetrahedronVolumeDirty)
+			return;
 
-		// Find valid tetrahedrons
-		UINT32 numTetrahedra = (UINT32)mTetrahedronInfos.size();
+		applyBuild();
+	}
 
-		bool* validTets = (bool*)bs_stack_alloc(sizeof(bool) * numTetrahedra);
-		mNumValidTetrahedra = 0;
-		for (UINT32 i = 0; i < (UINT32)mTetrahedronInfos.size(); i++)
-		{
-			const TetrahedronData& entry = mTetrahedronInfos[i];
+	void LightProbes::applyBuild()
+	{
+		TetrahedronBuild& build = *mBuild;
 
-			const Vector3& P1 = mTempTetrahedronPositions[entry.volume.vertices[0]];
-			const Vector3& P2 = mTempTetrahedronPositions[entry.volume.vertices[1]];
-			const Vector3& P3 = mTempTetrahedronPositions[entry.volume.vertices[2]];
-			const Vector3& P4 = mTempTetrahedronPositions[entry.volume.vertices[3]];
+		// Volumes haven't changed since the build was started, so the coefficient layout matches the build
+		copyCoefficients();
 
-			Vector3 E1 = P1 - P4;
-			Vector3 E2 = P2 - P4;
-			Vector3 E3 = P3 - P4;
+		mVolumeMesh = Mesh::create(build.meshData);
+		mNumValidTetrahedra = build.numValidTetrahedra;
 
-			// If tetrahedron is co-planar just ignore it, shader will use some other nearby one instead. We can't
-			// handle coplanar tetrahedrons because the matrix is not invertible, and for nearly co-planar ones the
-			// math breaks down because of precision issues.
-			validTets[i] = fabs(Vector3::dot(Vector3::normalize(Vector3::cross(E1, E2)), E3)) > 0.0001f;
+		const auto numTetrahedra = (UINT32)build.tetrahedra.size();
+		if (numTetrahedra > mMaxTetrahedra)
+		{
+			UINT32 newSize = Math::divideAndRoundUp(numTetrahedra, 64U) * 64U;
+			resizeTetrahedronBuffer(newSize);
+		}
 
-			if (validTets[i])
-				mNumValidTetrahedra++;
+		if (numTetrahedra > 0)
+		{
+			void* dst = mTetrahedronInfosGPU->lock(0, mTetrahedronInfosGPU->getSize(), GBL_WRITE_ONLY_DISCARD);
+			memcpy(dst, build.tetrahedra.data(), numTetrahedra * sizeof(TetrahedronDataGPU));
+			mTetrahedronInfosGPU->unlock();
 		}
 
-		UINT32 numValidFaces = 0;
-		for(auto& entry : outerFaces)
+		const auto numFaces = (UINT32)build.faces.size();
+		if (numFaces > mMaxFaces)
 		{
-			if (validTets[entry.tetrahedron])
-				numValidFaces++;
+			UINT32 newSize = Math::divideAndRoundUp(numFaces, 64U) * 64U;
+			resizeTetrahedronFaceBuffer(newSize);
 		}
 
-		// Generate a mesh out of all the tetrahedron triangles
-		// Note: Currently the entire volume is rendered as a single large mesh, which will isn't optimal as we can't
-		// perform frustum culling. A better option would be to split the mesh into multiple smaller volumes, do
-		// frustum culling and possibly even sort by distance from camera.
-		UINT32 numVertices = mNumValidTetrahedra * 4 * 3 + numValidFaces * 9 * 3;
+		if (numFaces > 0)
+		{
+			void* faceDst = mTetrahedronFaceInfosGPU->lock(0, mTetrahedronFaceInfosGPU->getSize(), 
+				GBL_WRITE_ONLY_DISCARD);
+			memcpy(faceDst, build.faces.data(), numFaces * sizeof(TetrahedronFaceDataGPU));
+			mTetrahedronFaceInfosGPU->unlock();
+		}
 
-		SPtr<VertexDataDesc> vertexDesc = bs_shared_ptr_new<VertexDataDesc>();
-		vertexDesc->addVertElem(VET_FLOAT3, VES_POSITION);
-		vertexDesc->addVertElem(VET_UINT1, VES_TEXCOORD);
+		// Remember the probes the volume was built from, so the build can be skipped if they don't change
+		mBuiltPositions.assign(build.positions.begin(), build.positions.begin() + build.bufferIndices.size());
+		mBuiltBufferIndices = build.bufferIndices;
 
-		SPtr<MeshData> meshData = MeshData::create(numVertices, numVertices, vertexDesc);
-		auto posIter = meshData->getVec3DataIter(VES_POSITION);
-		auto idIter = meshData->getDWORDDataIter(VES_TEXCOORD);
-		UINT32* indices = meshData->getIndices32();
+		build.meshData = nullptr;
+	}
 
-		// Insert inner tetrahedron triangles
-		UINT32 tetIdx = 0;
-		for (UINT32 i = 0; i < (UINT32)mTetrahedronInfos.size(); i++)
+	void LightProbes::buildTetrahedronVolume(TetrahedronBuild& build)
+	{
+		bs_frame_mark();
 		{
-			if (!validTets[i])
-				continue;
+			Vector<Vector3>& positions = build.positions;
 
-			const Tetrahedron& volume = mTetrahedronInfos[i].volume;
+			Vector<TetrahedronData> tetrahedra;
+			Vector<TetrahedronFaceData> outerFaces;
+			generateTetrahedronData(positions, tetrahedra, outerFaces, true);
 
-			Vector3 center(BsZero);
-			for(UINT32 j = 0; j < 4; j++)
-				center += mTempTetrahedronPositions[volume.vertices[j]];
-
-			center /= 4.0f;
-
-			static const UINT32 Permutations[4][3] = 
-			{
-				{ 0, 1, 2 },
-				{ 0, 1, 3 },
-				{ 0, 2, 3 },
-				{ 1, 2, 3 }
-			};
+			// Find valid tetrahedrons
+			UINT32 numTetrahedra = (UINT32)tetrahedra.size();
 
-			for(UINT32 j = 0; j < 4; j++)
+			FrameVector<bool> validTets(numTetrahedra);
+			UINT32 numValidTetrahedra = 0;
+			for (UINT32 i = 0; i < numTetrahedra; i++)
 			{
-				Vector3 A = mTempTetrahedronPositions[volume.vertices[Permutations[j][0]]];
-				Vector3 B = mTempTetrahedronPositions[volume.vertices[Permutations[j][1]]];
-				Vector3 C = mTempTetrahedronPositions[volume.vertices[Permutations[j][2]]];
+				const TetrahedronData& entry = tetrahedra[i];
 
-				// Make sure the triangle is clockwise, facing away from the center
-				Vector3 e0 = A - C;
-				Vector3 e1 = B - C;
-
-				Vector3 normal = e0.cross(e1);
-				if (normal.dot(A - center) > 0.0f)
-					std::swap(B, C);
+				const Vector3& P1 = positions[entry.volume.vertices[0]];
+				const Vector3& P2 = positions[entry.volume.vertices[1]];
+				const Vector3& P3 = positions[entry.volume.vertices[2]];
+				const Vector3& P4 = positions[entry.volume.vertices[3]];
 
-				posIter.addValue(A);
-				posIter.addValue(B);
-				posIter.addValue(C);
+				Vector3 E1 = P1 - P4;
+				Vector3 E2 = P2 - P4;
+				Vector3 E3 = P3 - P4;
 
-				idIter.addValue(tetIdx);
-				idIter.addValue(tetIdx);
-				idIter.addValue(tetIdx);
+				// If tetrahedron is co-planar just ignore it, shader will use some other nearby one instead. We can't
+				// handle coplanar tetrahedrons because the matrix is not invertible, and for nearly co-planar ones the
+				// math breaks down because of precision issues.
+				validTets[i] = fabs(Vector3::dot(Vector3::normalize(Vector3::cross(E1, E2)), E3)) > 0.0001f;
 
-				indices[0] = tetIdx * 4 * 3 + j * 3 + 0;
-				indices[1] = tetIdx * 4 * 3 + j * 3 + 1;
-				indices[2] = tetIdx * 4 * 3 + j * 3 + 2;
+				if (validTets[i])
+					numValidTetrahedra++;
+			}
 
-				indices += 3;
+			UINT32 numValidFaces = 0;
+			for(auto& entry : outerFaces)
+			{
+				if (validTets[entry.tetrahedron])
+					numValidFaces++;
 			}
 
-			tetIdx++;
-		}
+			// Generate a mesh out of all the tetrahedron triangles
+			// Note: Currently the entire volume is rendered as a single large mesh, which will isn't optimal as we can't
+			// perform frustum culling. A better option would be to split the mesh into multiple smaller volumes, do
+			// frustum culling and possibly even sort by distance from camera.
+			UINT32 numVertices = numValidTetrahedra * 4 * 3 + numValidFaces * 9 * 3;
 
-		// Generate an edge map for outer faces (required for step below)
-		struct Edge
-		{
-			UINT32 vertInner[2];
-			UINT32 vertOuter[2];
-			UINT32 face[2];
-		};
+			SPtr<VertexDataDesc> vertexDesc = bs_shared_ptr_new<VertexDataDesc>();
+			vertexDesc->addVertElem(VET_FLOAT3, VES_POSITION);
+			vertexDesc->addVertElem(VET_UINT1, VES_TEXCOORD);
 
-		FrameUnorderedMap<std::pair<INT32, INT32>, Edge, pair_hash> edgeMap;
-		for(UINT32 i = 0; i < (UINT32)outerFaces.size(); i++)
-		{
-			if (!validTets[outerFaces[i].tetrahedron])
-				continue;
+			SPtr<MeshData> meshData = MeshData::create(numVertices, numVertices, vertexDesc);
+			auto posIter = meshData->getVec3DataIter(VES_POSITION);
+			auto idIter = meshData->getDWORDDataIter(VES_TEXCOORD);
+			UINT32* indices = meshData->getIndices32();
 
-			for (UINT32 j = 0; j < 3; ++j)
+			// Insert inner tetrahedron triangles
+			UINT32 tetIdx = 0;
+			for (UINT32 i = 0; i < (UINT32)tetrahedra.size(); i++)
 			{
-				UINT32 v0 = outerFaces[i].innerVertices[j];
-				UINT32 v1 = outerFaces[i].innerVertices[(j + 1) % 3];
+				if (!validTets[i])
+					continue;
 
-				// Keep the same ordering so other faces can find the same edge
-				if (v0 > v1)
-					std::swap(v0, v1);
+				const Tetrahedron& volume = tetrahedra[i].volume;
 
-				auto iterFind = edgeMap.find(std::make_pair((INT32)v0, (INT32)v1));
-				if (iterFind != edgeMap.end())
-				{
-					iterFind->second.face[1] = i;
-				}
-				else
+				Vector3 center(BsZero);
+				for(UINT32 j = 0; j < 4; j++)
+					center += positions[volume.vertices[j]];
+
+				center /= 4.0f;
+
+				static const UINT32 Permutations[4][3] = 
 				{
-					Edge edge;
-					edge.vertInner[0] = outerFaces[i].innerVertices[j];
-					edge.vertInner[1] = outerFaces[i].innerVertices[(j + 1) % 3];
-					edge.vertOuter[0] = outerFaces[i].outerVertices[j];
-					edge.vertOuter[1] = outerFaces[i].outerVertices[(j + 1) % 3];
-					edge.face[0] = i;
-					edge.face[1] = -1;
-
-					edgeMap.insert(std::make_pair(std::make_pair((INT32)v0, (INT32)v1), edge));
-				}
-			}
-		}
+					{ 0, 1, 2 },
+					{ 0, 1, 3 },
+					{ 0, 2, 3 },
+					{ 1, 2, 3 }
+				};
 
-		// Generate front and back triangles for extruded outer faces
-		UINT32 faceIdx = 0;
-		for(UINT32 i = 0; i < (UINT32)outerFaces.size(); i++)
-		{
-			if (!validTets[outerFaces[i].tetrahedron])
-				continue;
+				for(UINT32 j = 0; j < 4; j++)
+				{
+					Vector3 A = positions[volume.vertices[Permutations[j][0]]];
+					Vector3 B = positions[volume.vertices[Permutations[j][1]]];
+					Vector3 C = positions[volume.vertices[Permutations[j][2]]];
 
-			const TetrahedronFaceData& entry = outerFaces[i];
+					// Make sure the triangle is clockwise, facing away from the center
+					Vector3 e0 = A - C;
+					Vector3 e1 = B - C;
 
-			static const UINT32 Permutations[2][3] = { {0, 1, 2 }, { 3, 4, 5} };
+					Vector3 normal = e0.cross(e1);
+					if (normal.dot(A - center) > 0.0f)
+						std::swap(B, C);
 
-			// Make sure the triangle is clockwise, facing away from the center
-			Vector3 center(BsZero);
-			for (UINT32 k = 0; k < 3; k++)
-			{
-				center += mTempTetrahedronPositions[entry.innerVertices[k]];
-				center += mTempTetrahedronPositions[entry.outerVertices[k]];
-			}
+					posIter.addValue(A);
+					posIter.addValue(B);
+					posIter.addValue(C);
 
-			center /= 6.0f;
+					idIter.addValue(tetIdx);
+					idIter.addValue(tetIdx);
+					idIter.addValue(tetIdx);
 
-			for(UINT32 j = 0; j < 2; ++j)
-			{
-				UINT32 idxA = Permutations[j][0];
-				UINT32 idxB = Permutations[j][1];
-				UINT32 idxC = Permutations[j][2];
+					indices[0] = tetIdx * 4 * 3 + j * 3 + 0;
+					indices[1] = tetIdx * 4 * 3 + j * 3 + 1;
+					indices[2] = tetIdx * 4 * 3 + j * 3 + 2;
 
-				idxA = idxA > 2 ? entry.outerVertices[idxA - 3] : entry.innerVertices[idxA];
-				idxB = idxB > 2 ? entry.outerVertices[idxB - 3] : entry.innerVertices[idxB];
-				idxC = idxC > 2 ? entry.outerVertices[idxC - 3] : entry.innerVertices[idxC];
-				
-				Vector3 A = mTempTetrahedronPositions[idxA];
-				Vector3 B = mTempTetrahedronPositions[idxB];
-				Vector3 C = mTempTetrahedronPositions[idxC];
+					indices += 3;
+				}
 
-				Vector3 e0 = A - C;
-				Vector3 e1 = B - C;
+				tetIdx++;
+			}
 
-				Vector3 normal = e0.cross(e1);
-				if (normal.dot(A - center) > 0.0f)
-					std::swap(A, B);
+			// Generate an edge map for outer faces (required for step below)
+			struct Edge
+			{
+				UINT32 vertInner[2];
+				UINT32 vertOuter[2];
+				UINT32 face[2];
+			};
 
-				posIter.addValue(A);
-				posIter.addValue(B);
-				posIter.addValue(C);
+			FrameUnorderedMap<std::pair<INT32, INT32>, Edge, pair_hash> edgeMap;
+			for(UINT32 i = 0; i < (UINT32)outerFaces.size(); i++)
+			{
+				if (!validTets[outerFaces[i].tetrahedron])
+					continue;
 
-				idIter.addValue(tetIdx + faceIdx);
-				idIter.addValue(tetIdx + faceIdx);
-				idIter.addValue(tetIdx + faceIdx);
+				for (UINT32 j = 0; j < 3; ++j)
+				{
+					UINT32 v0 = outerFaces[i].innerVertices[j];
+					UINT32 v1 = outerFaces[i].innerVertices[(j + 1) % 3];
 
-				indices[0] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + j * 3 + 0;
-				indices[1] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + j * 3 + 1;
-				indices[2] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + j * 3 + 2;
+					// Keep the same ordering so other faces can find the same edge
+					if (v0 > v1)
+						std::swap(v0, v1);
 
-				indices += 3;
+					auto iterFind = edgeMap.find(std::make_pair((INT32)v0, (INT32)v1));
+					if (iterFind != edgeMap.end())
+					{
+						iterFind->second.face[1] = i;
+					}
+					else
+					{
+						Edge edge;
+						edge.vertInner[0] = outerFaces[i].innerVertices[j];
+						edge.vertInner[1] = outerFaces[i].innerVertices[(j + 1) % 3];
+						edge.vertOuter[0] = outerFaces[i].outerVertices[j];
+						edge.vertOuter[1] = outerFaces[i].outerVertices[(j + 1) % 3];
+						edge.face[0] = i;
+						edge.face[1] = -1;
+
+						edgeMap.insert(std::make_pair(std::make_pair((INT32)v0, (INT32)v1), edge));
+					}
+				}
 			}
 
-			faceIdx++;
-		}
+			// Generate front and back triangles for extruded outer faces
+			UINT32 faceIdx = 0;
+			for(UINT32 i = 0; i < (UINT32)outerFaces.size(); i++)
+			{
+				if (!validTets[outerFaces[i].tetrahedron])
+					continue;
 
-		// Generate sides for extruded outer faces
-		UINT32 sideIdx = 0;
-		for(auto& entry : edgeMap)
-		{
-			const Edge& edge = entry.second;
+				const TetrahedronFaceData& entry = outerFaces[i];
 
-			for (UINT32 i = 0; i < 2; i++)
-			{
-				const TetrahedronFaceData& face = outerFaces[edge.face[i]];
+				static const UINT32 Permutations[2][3] = { {0, 1, 2 }, { 3, 4, 5} };
 
 				// Make sure the triangle is clockwise, facing away from the center
 				Vector3 center(BsZero);
 				for (UINT32 k = 0; k < 3; k++)
 				{
-					center += mTempTetrahedronPositions[face.innerVertices[k]];
-					center += mTempTetrahedronPositions[face.outerVertices[k]];
+					center += positions[entry.innerVertices[k]];
+					center += positions[entry.outerVertices[k]];
 				}
 
 				center /= 6.0f;
 
-				static const UINT32 Permutations[2][3] = { {0, 1, 2 }, { 1, 2, 3} };
 				for(UINT32 j = 0; j < 2; ++j)
 				{
 					UINT32 idxA = Permutations[j][0];
 					UINT32 idxB = Permutations[j][1];
 					UINT32 idxC = Permutations[j][2];
 
-					idxA = idxA > 1 ? edge.vertOuter[idxA - 2] : edge.vertInner[idxA];
-					idxB = idxB > 1 ? edge.vertOuter[idxB - 2] : edge.vertInner[idxB];
-					idxC = idxC > 1 ? edge.vertOuter[idxC - 2] : edge.vertInner[idxC];
-					
-					Vector3 A = mTempTetrahedronPositions[idxA];
-					Vector3 B = mTempTetrahedronPositions[idxB];
-					Vector3 C = mTempTetrahedronPositions[idxC];
+					idxA = idxA > 2 ? entry.outerVertices[idxA - 3] : entry.innerVertices[idxA];
+					idxB = idxB > 2 ? entry.outerVertices[idxB - 3] : entry.innerVertices[idxB];
+					idxC = idxC > 2 ? entry.outerVertices[idxC - 3] : entry.innerVertices[idxC];
+				
+					Vector3 A = positions[idxA];
+					Vector3 B = positions[idxB];
+					Vector3 C = positions[idxC];
 
 					Vector3 e0 = A - C;
 					Vector3 e1 = B - C;
@@ -587,161 +677,194 @@ namespace bs { namespace ct
 					posIter.addValue(B);
 					posIter.addValue(C);
 
-					idIter.addValue(tetIdx + edge.face[i]);
-					idIter.addValue(tetIdx + edge.face[i]);
-					idIter.addValue(tetIdx + edge.face[i]);
+					idIter.addValue(tetIdx + faceIdx);
+					idIter.addValue(tetIdx + faceIdx);
+					idIter.addValue(tetIdx + faceIdx);
 
-					indices[0] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + sideIdx * 2 * 3 + j * 3 + 0;
-					indices[1] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + sideIdx * 2 * 3 + j * 3 + 1;
-					indices[2] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + sideIdx * 2 * 3 + j * 3 + 2;
+					indices[0] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + j * 3 + 0;
+					indices[1] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + j * 3 + 1;
+					indices[2] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + j * 3 + 2;
 
 					indices += 3;
 				}
 
-				sideIdx++;
+				faceIdx++;
 			}
-		}
 
-		// Generate "caps" on the end of the extruded volume
-		UINT32 capIdx = 0;
-		for(UINT32 i = 0; i < (UINT32)outerFaces.size(); i++)
-		{
-			if (!validTets[outerFaces[i].tetrahedron])
-				continue;
+			// Generate sides for extruded outer faces
+			UINT32 sideIdx = 0;
+			for(auto& entry : edgeMap)
+			{
+				const Edge& edge = entry.second;
 
-			const TetrahedronFaceData& entry = outerFaces[i];
+				for (UINT32 i = 0; i < 2; i++)
+				{
+					const TetrahedronFaceData& face = outerFaces[edge.face[i]];
 
-			Vector3 A = mTempTetrahedronPositions[entry.outerVertices[0]];
-			Vector3 B = mTempTetrahedronPositions[entry.outerVertices[1]];
-			Vector3 C = mTempTetrahedronPositions[entry.outerVertices[2]];
+					// Make sure the triangle is clockwise, facing away from the center
+					Vector3 center(BsZero);
+					for (UINT32 k = 0; k < 3; k++)
+					{
+						center += positions[face.innerVertices[k]];
+						center += positions[face.outerVertices[k]];
+					}
 
-			// Make sure the triangle is clockwise, facing toward the center
-			const Tetrahedron& tet = mTetrahedronInfos[entry.tetrahedron].volume;
+					center /= 6.0f;
 
-			Vector3 center(BsZero);
-			for(UINT32 j = 0; j < 4; j++)
-				center += mTempTetrahedronPositions[tet.vertices[j]];
+					static const UINT32 Permutations[2][3] = { {0, 1, 2 }, { 1, 2, 3} };
+					for(UINT32 j = 0; j < 2; ++j)
+					{
+						UINT32 idxA = Permutations[j][0];
+						UINT32 idxB = Permutations[j][1];
+						UINT32 idxC = Permutations[j][2];
 
-			center /= 4.0f;
+						idxA = idxA > 1 ? edge.vertOuter[idxA - 2] : edge.vertInner[idxA];
+						idxB = idxB > 1 ? edge.vertOuter[idxB - 2] : edge.vertInner[idxB];
+						idxC = idxC > 1 ? edge.vertOuter[idxC - 2] : edge.vertInner[idxC];
+					
+						Vector3 A = positions[idxA];
+						Vector3 B = positions[idxB];
+						Vector3 C = positions[idxC];
 
-			Vector3 e0 = A - C;
-			Vector3 e1 = B - C;
+						Vector3 e0 = A - C;
+						Vector3 e1 = B - C;
 
-			Vector3 normal = e0.cross(e1);
-			if (normal.dot(A - center) < 0.0f)
-				std::swap(B, C);
+						Vector3 normal = e0.cross(e1);
+						if (normal.dot(A - center) > 0.0f)
+							std::swap(A, B);
 
-			posIter.addValue(A);
-			posIter.addValue(B);
-			posIter.addValue(C);
+						posIter.addValue(A);
+						posIter.addValue(B);
+						posIter.addValue(C);
 
-			idIter.addValue(-1);
-			idIter.addValue(-1);
-			idIter.addValue(-1);
+						idIter.addValue(tetIdx + edge.face[i]);
+						idIter.addValue(tetIdx + edge.face[i]);
+						idIter.addValue(tetIdx + edge.face[i]);
 
-			indices[0] = tetIdx * 4 * 3 + faceIdx * 8 * 3 + capIdx * 3 + 0;
-			indices[1] = tetIdx * 4 * 3 + faceIdx * 8 * 3 + capIdx * 3 + 1;
-			indices[2] = tetIdx * 4 * 3 + faceIdx * 8 * 3 + capIdx * 3 + 2;
+						indices[0] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + sideIdx * 2 * 3 + j * 3 + 0;
+						indices[1] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + sideIdx * 2 * 3 + j * 3 + 1;
+						indices[2] = tetIdx * 4 * 3 + faceIdx * 2 * 3 + sideIdx * 2 * 3 + j * 3 + 2;
 
-			indices += 3;
-			capIdx++;
-		}
+						indices += 3;
+					}
 
-		mVolumeMesh = Mesh::create(meshData);
+					sideIdx++;
+				}
+			}
 
-		// Map vertices to actual SH coefficient indices, and write GPU buffer with tetrahedron information
-		if ((mNumValidTetrahedra + numValidFaces) > mMaxTetrahedra)
-		{
-			UINT32 newSize = Math::divideAndRoundUp(mNumValidTetrahedra + numValidFaces, 64U) * 64U;
-			resizeTetrahedronBuffer(newSize);
-		}
+			// Generate "caps" on the end of the extruded volume
+			UINT32 capIdx = 0;
+			for(UINT32 i = 0; i < (UINT32)outerFaces.size(); i++)
+			{
+				if (!validTets[outerFaces[i].tetrahedron])
+					continue;
 
-		TetrahedronDataGPU* dst = (TetrahedronDataGPU*)mTetrahedronInfosGPU->lock(0, mTetrahedronInfosGPU->getSize(), 
-			GBL_WRITE_ONLY_DISCARD);
+				const TetrahedronFaceData& entry = outerFaces[i];
 
-		// Write inner tetrahedron data
-		for (UINT32 i = 0; i < (UINT32)mTetrahedronInfos.size(); i++)
-		{
-			if (!validTets[i])
-				continue;
+				Vector3 A = positions[entry.outerVertices[0]];
+				Vector3 B = positions[entry.outerVertices[1]];
+				Vector3 C = positions[entry.outerVertices[2]];
 
-			TetrahedronData& entry = mTetrahedronInfos[i];
+				// Make sure the triangle is clockwise, facing toward the center
+				const Tetrahedron& tet = tetrahedra[entry.tetrahedron].volume;
 
-			Vector2I offsets[4];
-			for(UINT32 j = 0; j < 4; ++j)
-			{
-				entry.volume.vertices[j] = mTempTetrahedronBufferIndices[entry.volume.vertices[j]];
-				offsets[j] = mTempTetrahedronBufferOffsets[entry.volume.vertices[j]];
-			}
+				Vector3 center(BsZero);
+				for(UINT32 j = 0; j < 4; j++)
+					center += positions[tet.vertices[j]];
 
-			memcpy(dst->indices, entry.volume.vertices, sizeof(UINT32) * 4);
-			memcpy(dst->offsets, &offsets, sizeof(offsets));
-			memcpy(&dst->transform, &entry.transform, sizeof(float) * 12);
+				center /= 4.0f;
 
-			dst++;
-		}
+				Vector3 e0 = A - C;
+				Vector3 e1 = B - C;
 
-		// Write extruded face data
-		for (UINT32 i = 0; i < (UINT32)outerFaces.size(); i++)
-		{
-			if (!validTets[outerFaces[i].tetrahedron])
-				continue;
+				Vector3 normal = e0.cross(e1);
+				if (normal.dot(A - center) < 0.0f)
+					std::swap(B, C);
 
-			const TetrahedronFaceData& entry = outerFaces[i];
+				posIter.addValue(A);
+				posIter.addValue(B);
+				posIter.addValue(C);
 
-			UINT32 indices[4];
-			Vector2I offsets[4];
-			for(UINT32 j = 0; j < 3; j++)
-			{
-				indices[j] = mTempTetrahedronBufferIndices[entry.innerVertices[j]];
-				offsets[j] = mTempTetrahedronBufferOffsets[entry.innerVertices[j]];
-			}
+				idIter.addValue(-1);
+				idIter.addValue(-1);
+				idIter.addValue(-1);
 
-			indices[3] = -1;
+				indices[0] = tetIdx * 4 * 3 + faceIdx * 8 * 3 + capIdx * 3 + 0;
+				indices[1] = tetIdx * 4 * 3 + faceIdx * 8 * 3 + capIdx * 3 + 1;
+				indices[2] = tetIdx * 4 * 3 + faceIdx * 8 * 3 + capIdx * 3 + 2;
 
-			memcpy(dst->indices, indices, sizeof(UINT32) * 4);
-			memcpy(dst->offsets, offsets, sizeof(offsets));
-			memcpy(&dst->transform, &entry.transform, sizeof(float) * 12);
+				indices += 3;
+				capIdx++;
+			}
 
-			dst++;
-		}
+			build.meshData = meshData;
+			build.numValidTetrahedra = numValidTetrahedra;
 
-		mTetrahedronInfosGPU->unlock();
+			// Map vertices to actual SH coefficient indices, and generate tetrahedron information in the GPU format
+			build.tetrahedra.clear();
+			build.faces.clear();
 
-		// Write data specific to faces
-		if (numValidFaces > mMaxFaces)
-		{
-			UINT32 newSize = Math::divideAndRoundUp(numValidFaces, 64U) * 64U;
-			resizeTetrahedronFaceBuffer(newSize);
-		}
+			// Write inner tetrahedron data
+			for (UINT32 i = 0; i < numTetrahedra; i++)
+			{
+				if (!validTets[i])
+					continue;
 
-		TetrahedronFaceDataGPU* faceDst = (TetrahedronFaceDataGPU*)mTetrahedronFaceInfosGPU->lock(0, 
-			mTetrahedronFaceInfosGPU->getSize(), GBL_WRITE_ONLY_DISCARD);
+				TetrahedronData& entry = tetrahedra[i];
 
-		for (UINT32 i = 0; i < (UINT32)outerFaces.size(); i++)
-		{
-			if (!validTets[outerFaces[i].tetrahedron])
-				continue;
+				Vector2I offsets[4];
+				for(UINT32 j = 0; j < 4; ++j)
+				{
+					entry.volume.vertices[j] = build.bufferIndices[entry.volume.vertices[j]];
+					offsets[j] = build.bufferOffsets[entry.volume.vertices[j]];
+				}
 
-			const TetrahedronFaceData& entry = outerFaces[i];
+				TetrahedronDataGPU dst;
+				memcpy(dst.indices, entry.volume.vertices, sizeof(UINT32) * 4);
+				memcpy(dst.offsets, &offsets, sizeof(offsets));
+				memcpy(&dst.transform, &entry.transform, sizeof(float) * 12);
 
-			for (UINT32 j = 0; j < 3; j++)
-			{
-				faceDst->corners[j] = mTempTetrahedronPositions[entry.innerVertices[j]];
-				faceDst->normals[j] = entry.normals[j];
+				build.tetrahedra.push_back(dst);
 			}
 
-			faceDst->isQuadratic = entry.quadratic ? 1 : 0;
-			faceDst++;
-		}
+			// Write extruded face data
+			for (UINT32 i = 0; i < (UINT32)outerFaces.size(); i++)
+			{
+				if (!validTets[outerFaces[i].tetrahedron])
+					continue;
 
-		mTetrahedronFaceInfosGPU->unlock();
+				const TetrahedronFaceData& entry = outerFaces[i];
 
-		bs_stack_free(validTets);
+				UINT32 indices[4];
+				Vector2I offsets[4];
+				for(UINT32 j = 0; j < 3; j++)
+				{
+					indices[j] = build.bufferIndices[entry.innerVertices[j]];
+					offsets[j] = build.bufferOffsets[entry.innerVertices[j]];
+				}
 
-		mTempTetrahedronPositions.clear();
-		mTempTetrahedronBufferIndices.clear();
-		mTetrahedronVolumeDirty = false;
+				indices[3] = -1;
+
+				TetrahedronDataGPU dst;
+				memcpy(dst.indices, indices, sizeof(UINT32) * 4);
+				memcpy(dst.offsets, offsets, sizeof(offsets));
+				memcpy(&dst.transform, &entry.transform, sizeof(float) * 12);
+
+				build.tetrahedra.push_back(dst);
+
+				// Write data specific to faces
+				TetrahedronFaceDataGPU faceDst;
+				for (UINT32 j = 0; j < 3; j++)
+				{
+					faceDst.corners[j] = positions[entry.innerVertices[j]];
+					faceDst.normals[j] = entry.normals[j];
+				}
+
+				faceDst.isQuadratic = entry.quadratic ? 1 : 0;
+				build.faces.push_back(faceDst);
+			}
+		}
+		bs_frame_clear();
 	}
 
 	bool LightProbes::hasAnyProbes() const
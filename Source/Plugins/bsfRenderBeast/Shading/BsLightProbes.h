@@ -213,8 +213,12 @@ namespace bs { namespace ct
 			UINT32 tetrahedron;
 			bool quadratic;
 		};
+
+		/** CPU data required for building the tetrahedron volume, on the core thread or on a worker thread. */
+		struct TetrahedronBuild;
 	public:
 		LightProbes();
+		~LightProbes();
 
 		/** Notifies sthe manager that the provided light probe volume has been added. */
 		void notifyAdded(LightProbeVolume* volume);
@@ -225,7 +229,12 @@ namespace bs { namespace ct
 		/** Notifies the manager that all the probes in the provided volume have been removed. */
 		void notifyRemoved(LightProbeVolume* volume);
 
-		/** Updates light probe tetrahedron data after probes changed (added/removed/moved). */
+		/** 
+		 * Updates light probe tetrahedron data after probes changed (added/removed/moved). If the task scheduler is
+		 * running the tetrahedron volume is built on a worker thread, and the previous volume remains in use until a
+		 * later call finds the build complete. If the probes were only modified without being moved, the previous
+		 * volume is kept and only the probe coefficients are updated.
+		 */
 		void updateProbes();
 
 		/** Returns true if there are any registered light probes. */
@@ -253,9 +262,27 @@ namespace bs { namespace ct
 		 * @param[in]		generateExtrapolationVolume	If true, the tetrahedron volume will be surrounded with points
 		 *												at "infinity" (technically just far away).
 		 */
-		void generateTetrahedronData(Vector<Vector3>& positions, Vector<TetrahedronData>& tetrahedra, 
+		static void generateTetrahedronData(Vector<Vector3>& positions, Vector<TetrahedronData>& tetrahedra, 
 			Vector<TetrahedronFaceData>& faces, bool generateExtrapolationVolume = false);
 
+		/** Populates the probe positions and coefficient locations of @p build from all active probes. */
+		void gatherProbes(TetrahedronBuild& build) const;
+
+		/** 
+		 * Generates the tetrahedron volume, its mesh, and the GPU tetrahedron and face data, from the probes in
+		 * @p build. Doesn't touch any GPU resources, so it can be called from any thread.
+		 */
+		static void buildTetrahedronVolume(TetrahedronBuild& build);
+
+		/** Waits until the currently running build task completes, and applies its results unless they're out of date. */
+		void finishBuild();
+
+		/** Updates the GPU resources with the data from the last completed build. */
+		void applyBuild();
+
+		/** Copies SH coefficients from all volumes into the global coefficient texture. */
+		void copyCoefficients();
+
 		/** Resizes the GPU buffer used for holding tetrahedron data, to the specified size (in number of tetraheda). */
 		void resizeTetrahedronBuffer(UINT32 count);
 
@@ -275,18 +302,18 @@ namespace bs { namespace ct
 		UINT32 mMaxTetrahedra;
 		UINT32 mMaxFaces;
 
-		Vector<TetrahedronData> mTetrahedronInfos;
-
 		SPtr<Texture> mProbeCoefficientsGPU;
 		SPtr<GpuBuffer> mTetrahedronInfosGPU;
 		SPtr<GpuBuffer> mTetrahedronFaceInfosGPU;
 		SPtr<Mesh> mVolumeMesh;
 		UINT32 mNumValidTetrahedra;
 
-		// Temporary buffers
-		Vector<Vector3> mTempTetrahedronPositions;
-		Vector<UINT32> mTempTetrahedronBufferIndices;
-		Vector<Vector2I> mTempTetrahedronBufferOffsets;
+		SPtr<TetrahedronBuild> mBuild;
+		SPtr<Task> mBuildTask;
+
+		// Probes the current volume was built from
+		Vector<Vector3> mBuiltPositions;
+		Vector<UINT32> mBuiltBufferIndices;
 	};
 
 	/** @} */
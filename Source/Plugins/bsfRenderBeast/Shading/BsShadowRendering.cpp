@@ -12,6 +12,7 @@
 #include "RenderAPI/BsVertexDataDesc.h"
 #include "Renderer/BsRenderer.h"
 #include "BsRendererRenderable.h"
+#include "Threading/BsTaskScheduler.h"
 
 namespace bs { namespace ct
 {
@@ -460,8 +461,19 @@ namespace bs { namespace ct
 			UINT32 mask : 6;
 		};
 
+		/**
+		 * Renders all shadow casters intersecting the volume described by @p opt.
+		 *
+		 * @param[in]	scene		Scene whose renderables to render.
+		 * @param[in]	frameInfo	Information about the current frame.
+		 * @param[in]	opt			Options describing the shadow map being rendered.
+		 * @param[in]	casters		Optional list of renderable indices, sorted in increasing order, that potentially
+		 *							intersect the volume described by @p opt. If not provided the renderable spatial index
+		 *							is queried instead.
+		 */
 		template<class Options>
-		static void execute(RendererScene& scene, const FrameInfo& frameInfo, const Options& opt)
+		static void execute(RendererScene& scene, const FrameInfo& frameInfo, const Options& opt, 
+			const Vector<UINT32>* casters = nullptr)
 		{
 			static_assert((UINT32)RenderableAnimType::Count == 4, "RenderableAnimType is expected to have four sequential entries.");
 
@@ -469,15 +481,32 @@ namespace bs { namespace ct
 
 			bs_frame_mark();
 			{
+				FrameVector<UINT32> visibleCasters;
+				const auto testCaster = [&sceneInfo, &opt, &visibleCasters](UINT32 idx)
+				{
+					if (opt.intersects(sceneInfo.renderableCullInfos[idx].bounds.getSphere()))
+						visibleCasters.push_back(idx);
+				};
+
+				if (casters != nullptr)
+				{
+					for (auto& idx : *casters)
+						testCaster(idx);
+				}
+				else
+				{
+					sceneInfo.renderableSpatialIndex.visitCandidates(opt.boundingVolume, testCaster);
+
+					// Keep the draw order independent of the octree layout
+					std::sort(visibleCasters.begin(), visibleCasters.end());
+				}
+
 				FrameVector<Command> commands[4];
 
-				// Make a list of relevant renderables and prepare them for rendering
-				for (UINT32 i = 0; i < sceneInfo.renderables.size(); i++)
+				// Prepare the relevant renderables for rendering
+				for (auto& i : visibleCasters)
 				{
 					const Sphere& bounds = sceneInfo.renderableCullInfos[i].bounds.getSphere();
-					if (!opt.intersects(bounds))
-						continue;
-
 					scene.prepareRenderable(i, frameInfo);
 
 					Command renderableCommand;
@@ -907,16 +936,117 @@ namespace bs { namespace ct
 				renderCascadedShadowMaps(*viewGroup.getView(j), i, scene, frameInfo);
 		}
 
-		for(auto& entry : mSpotLightShadowOptions)
+		gatherShadowCasters(sceneInfo);
+
+		const auto numSpotShadows = (UINT32)mSpotLightShadowOptions.size();
+		for (UINT32 i = 0; i < numSpotShadows; i++)
+		{
+			const ShadowMapOptions& entry = mSpotLightShadowOptions[i];
+			renderSpotShadowMap(sceneInfo.spotLights[entry.lightIdx], entry, scene, frameInfo, mShadowCasters[i]);
+		}
+
+		for (UINT32 i = 0; i < (UINT32)mRadialLightShadowOptions.size(); i++)
+		{
+			const ShadowMapOptions& entry = mRadialLightShadowOptions[i];
+			renderRadialShadowMap(sceneInfo.radialLights[entry.lightIdx], entry, scene, frameInfo, 
+				mShadowCasters[numSpotShadows + i]);
+		}
+	}
+
+	/** 
+	 * Calculates the world space frustum used for culling shadow casters of a spot light. 
+	 *
+	 * @param[in]	light		Light to calculate the frustum for.
+	 * @param[out]	view		View matrix of the shadow map.
+	 * @param[out]	proj		Projection matrix of the shadow map, not yet converted for use by the render API.
+	 * @return					Frustum of the shadow map, in world space.
+	 */
+	ConvexVolume getSpotShadowFrustum(const RendererLight& light, Matrix4& view, Matrix4& proj)
+	{
+		const Light* internal = light.internal;
+
+		view = Matrix4::view(light.getShiftedLightPosition(), internal->getTransform().getRotation());
+		proj = Matrix4::projectionPerspective(internal->getSpotAngle(), 1.0f, 0.05f, internal->getAttenuationRadius());
+
+		ConvexVolume localFrustum = ConvexVolume(proj);
+
+		const Vector<Plane>& frustumPlanes = localFrustum.getPlanes();
+		Matrix4 worldMatrix = view.inverseAffine();
+
+		Vector<Plane> worldPlanes(frustumPlanes.size());
+		UINT32 j = 0;
+		for (auto& plane : frustumPlanes)
+		{
+			worldPlanes[j] = worldMatrix.multiplyAffine(plane);
+			j++;
+		}
+
+		return ConvexVolume(worldPlanes);
+	}
+
+	/** Calculates an axis aligned box used for culling shadow casters of a radial light, covering all cubemap faces. */
+	ConvexVolume getRadialShadowVolume(const RendererLight& light)
+	{
+		const Vector3 lightPos = light.internal->getTransform().getPosition();
+		const float radius = light.internal->getAttenuationRadius();
+
+		// Plane normals point towards the inside of the volume
+		Vector<Plane> planes(6);
+		for (UINT32 i = 0; i < 3; i++)
 		{
-			UINT32 lightIdx = entry.lightIdx;
-			renderSpotShadowMap(sceneInfo.spotLights[lightIdx], entry, scene, frameInfo);
+			Vector3 axis = Vector3::ZERO;
+			axis[i] = 1.0f;
+
+			planes[i * 2 + 0] = Plane(axis, lightPos - axis * radius);
+			planes[i * 2 + 1] = Plane(-axis, lightPos + axis * radius);
 		}
 
-		for (auto& entry : mRadialLightShadowOptions)
+		return ConvexVolume(planes);
+	}
+
+	void ShadowRendering::gatherShadowCasters(const SceneInfo& sceneInfo)
+	{
+		const auto numSpotShadows = (UINT32)mSpotLightShadowOptions.size();
+		const UINT32 numShadows = numSpotShadows + (UINT32)mRadialLightShadowOptions.size();
+
+		// Never shrink, so the lists keep their memory between frames
+		if (mShadowCasters.size() < numShadows)
+			mShadowCasters.resize(numShadows);
+
+		const auto worker = [this, &sceneInfo, numSpotShadows](UINT32 i)
+		{
+			ConvexVolume volume;
+			if (i < numSpotShadows)
+			{
+				Matrix4 view, proj;
+				volume = getSpotShadowFrustum(sceneInfo.spotLights[mSpotLightShadowOptions[i].lightIdx], view, proj);
+			}
+			else
+			{
+				const UINT32 lightIdx = mRadialLightShadowOptions[i - numSpotShadows].lightIdx;
+				volume = getRadialShadowVolume(sceneInfo.radialLights[lightIdx]);
+			}
+
+			Vector<UINT32>& casters = mShadowCasters[i];
+			casters.clear();
+
+			sceneInfo.renderableSpatialIndex.visitCandidates(volume, [&sceneInfo, &volume, &casters](UINT32 idx)
+			{
+				if (volume.intersects(sceneInfo.renderableCullInfos[idx].bounds.getSphere()))
+					casters.push_back(idx);
+			});
+
+			// Keep the draw order independent of the octree layout
+			std::sort(casters.begin(), casters.end());
+		};
+
+		// Each light only touches its own list, so lights can be processed in parallel
+		if (TaskScheduler::isStarted() && numShadows > 1)
+			TaskScheduler::instance().parallelFor(0, numShadows, 1, worker);
+		else
 		{
-			UINT32 lightIdx = entry.lightIdx;
-			renderRadialShadowMap(sceneInfo.radialLights[lightIdx], entry, scene, frameInfo);
+			for (UINT32 i = 0; i < numShadows; i++)
+				worker(i);
 		}
 	}
 
@@ -1349,7 +1479,7 @@ namespace bs { namespace ct
 	}
 
 	void ShadowRendering::renderSpotShadowMap(const RendererLight& rendererLight, const ShadowMapOptions& options,
-		RendererScene& scene, const FrameInfo& frameInfo)
+		RendererScene& scene, const FrameInfo& frameInfo, const Vector<UINT32>& casters)
 	{
 		Light* light = rendererLight.internal;
 
@@ -1401,12 +1531,8 @@ namespace bs { namespace ct
 		mapInfo.depthBias = getDepthBias(*light, light->getBounds().getRadius(), mapInfo.depthRange, options.mapSize);
 		mapInfo.subjectBounds = light->getBounds();
 
-		Quaternion lightRotation = light->getTransform().getRotation();
-
-		Matrix4 view = Matrix4::view(rendererLight.getShiftedLightPosition(), lightRotation);
-		Matrix4 proj = Matrix4::projectionPerspective(light->getSpotAngle(), 1.0f, 0.05f, light->getAttenuationRadius());
-
-		ConvexVolume localFrustum = ConvexVolume(proj);
+		Matrix4 view, proj;
+		ConvexVolume worldFrustum = getSpotShadowFrustum(rendererLight, view, proj);
 		RenderAPI::instance().convertProjectionMatrix(proj, proj);
 
 		mapInfo.shadowVPTransform = proj * view;
@@ -1416,25 +1542,12 @@ namespace bs { namespace ct
 		gShadowParamsDef.gMatViewProj.set(shadowParamsBuffer, mapInfo.shadowVPTransform);
 		gShadowParamsDef.gNDCZToDeviceZ.set(shadowParamsBuffer, RendererView::getNDCZToDeviceZ());
 
-		const Vector<Plane>& frustumPlanes = localFrustum.getPlanes();
-		Matrix4 worldMatrix = view.inverseAffine();
-
-		Vector<Plane> worldPlanes(frustumPlanes.size());
-		UINT32 j = 0;
-		for (auto& plane : frustumPlanes)
-		{
-			worldPlanes[j] = worldMatrix.multiplyAffine(plane);
-			j++;
-		}
-
-		ConvexVolume worldFrustum(worldPlanes);
-
 		// Render all renderables into the shadow map
 		ShadowRenderQueueSpotOptions spotOptions(
 			worldFrustum,
 			shadowParamsBuffer);
 
-		ShadowRenderQueue::execute(scene, frameInfo, spotOptions);
+		ShadowRenderQueue::execute(scene, frameInfo, spotOptions, &casters);
 
 		// Restore viewport
 		rapi.setViewport(Rect2(0.0f, 0.0f, 1.0f, 1.0f));
@@ -1446,7 +1559,7 @@ namespace bs { namespace ct
 	}
 
 	void ShadowRendering::renderRadialShadowMap(const RendererLight& rendererLight, 
-		const ShadowMapOptions& options, RendererScene& scene, const FrameInfo& frameInfo)
+		const ShadowMapOptions& options, RendererScene& scene, const FrameInfo& frameInfo, const Vector<UINT32>& casters)
 	{
 		Light* light = rendererLight.internal;
 
@@ -1619,7 +1732,7 @@ namespace bs { namespace ct
 						shadowParamsBuffer
 				);
 
-				ShadowRenderQueue::execute(scene, frameInfo, cubeOptions);
+				ShadowRenderQueue::execute(scene, frameInfo, cubeOptions, &casters);
 			}
 		}
 
@@ -1638,7 +1751,7 @@ namespace bs { namespace ct
 					shadowCubeMasksBuffer
 			);
 
-			ShadowRenderQueue::execute(scene, frameInfo, cubeOptions);
+			ShadowRenderQueue::execute(scene, frameInfo, cubeOptions, &casters);
 		}
 
 		LightShadows& lightShadows = mRadialLightShadows[options.lightIdx];
@@ -17,6 +17,7 @@ namespace bs { namespace ct
 	struct FrameInfo;
 	class RendererLight;
 	class RendererScene;
+	struct SceneInfo;
 	struct ShadowInfo;
 
 	/** @addtogroup RenderBeast
@@ -551,13 +552,27 @@ namespace bs { namespace ct
 		void renderCascadedShadowMaps(const RendererView& view, UINT32 lightIdx, RendererScene& scene, 
 			const FrameInfo& frameInfo);
 
-		/** Renders shadow maps for the provided spot light. */
+		/** 
+		 * Renders shadow maps for the provided spot light. @p casters must contain indices of all renderables that
+		 * potentially intersect the light's shadow frustum, as found by gatherShadowCasters().
+		 */
 		void renderSpotShadowMap(const RendererLight& light, const ShadowMapOptions& options, RendererScene& scene,
-			const FrameInfo& frameInfo);
+			const FrameInfo& frameInfo, const Vector<UINT32>& casters);
 
-		/** Renders shadow maps for the provided radial light. */
+		/** 
+		 * Renders shadow maps for the provided radial light. @p casters must contain indices of all renderables that
+		 * potentially intersect the light's shadow volume, as found by gatherShadowCasters().
+		 */
 		void renderRadialShadowMap(const RendererLight& light, const ShadowMapOptions& options, RendererScene& scene, 
-			const FrameInfo& frameInfo);
+			const FrameInfo& frameInfo, const Vector<UINT32>& casters);
+
+		/**
+		 * Finds renderables that potentially cast shadows for every spot and radial light in mSpotLightShadowOptions and
+		 * mRadialLightShadowOptions, by querying the renderable spatial index. Each light writes to its own list in
+		 * mShadowCasters, allowing the lights to be processed in parallel. Lists for spot lights come first, followed by
+		 * lists for radial lights, in the same order as the entries in the option arrays.
+		 */
+		void gatherShadowCasters(const SceneInfo& sceneInfo);
 
 		/** 
 		 * Calculates optimal shadow map size, taking into account all views in the scene. Also calculates a fade value
@@ -688,6 +703,7 @@ namespace bs { namespace ct
 		Vector<bool> mRenderableVisibility; // Transient
 		Vector<ShadowMapOptions> mSpotLightShadowOptions; // Transient
 		Vector<ShadowMapOptions> mRadialLightShadowOptions; // Transient
+		Vector<Vector<UINT32>> mShadowCasters; // Transient
 	};
 
 	/* @} */
@@ -0,0 +1,104 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#include "BsSceneSpatialIndex.h"
+
+namespace bs { namespace ct
+{
+	/** Extent of the octree root node. Objects outside of it are still supported, but are kept in the root node. */
+	static constexpr float ROOT_EXTENT = 65536.0f;
+
+	simd::AABox SceneOctreeOptions::getBounds(UINT32 elem, void* context)
+	{
+		const auto* index = (const SceneSpatialIndex*)context;
+		return index->mBounds[elem];
+	}
+
+	void SceneOctreeOptions::setElementId(UINT32 elem, const OctreeElementId& id, void* context)
+	{
+		auto* index = (SceneSpatialIndex*)context;
+		index->mElementIds[elem] = id;
+	}
+
+	SceneSpatialIndex::SceneSpatialIndex()
+		:mOctree(Vector3::ZERO, ROOT_EXTENT, this)
+	{ }
+
+	void SceneSpatialIndex::add(const AABox& bounds)
+	{
+		const auto idx = (UINT32)mBounds.size();
+		mBounds.push_back(toOctreeBounds(bounds));
+		mElementIds.push_back(OctreeElementId());
+
+		mOctree.addElement(idx);
+	}
+
+	void SceneSpatialIndex::add(const Sphere& bounds)
+	{
+		const Vector3 radius(bounds.getRadius(), bounds.getRadius(), bounds.getRadius());
+		add(AABox(bounds.getCenter() - radius, bounds.getCenter() + radius));
+	}
+
+	void SceneSpatialIndex::update(UINT32 idx, const AABox& bounds)
+	{
+		const simd::AABox octreeBounds = toOctreeBounds(bounds);
+
+		// Objects often get updated for reasons other than movement, avoid touching the tree in that case
+		const simd::AABox& oldBounds = mBounds[idx];
+		if (oldBounds.center == octreeBounds.center && oldBounds.extents == octreeBounds.extents)
+			return;
+
+		mOctree.removeElement(mElementIds[idx]);
+
+		mBounds[idx] = octreeBounds;
+		mOctree.addElement(idx);
+	}
+
+	void SceneSpatialIndex::update(UINT32 idx, const Sphere& bounds)
+	{
+		const Vector3 radius(bounds.getRadius(), bounds.getRadius(), bounds.getRadius());
+		update(idx, AABox(bounds.getCenter() - radius, bounds.getCenter() + radius));
+	}
+
+	void SceneSpatialIndex::remove(UINT32 idx)
+	{
+		mOctree.removeElement(mElementIds[idx]);
+
+		// The octree stores object indices, so the last object needs to be re-inserted under its new index
+		const auto lastIdx = (UINT32)mBounds.size() - 1;
+		if (idx != lastIdx)
+		{
+			mOctree.removeElement(mElementIds[lastIdx]);
+
+			mBounds[idx] = mBounds[lastIdx];
+			mOctree.addElement(idx);
+		}
+
+		mBounds.erase(mBounds.end() - 1);
+		mElementIds.erase(mElementIds.end() - 1);
+	}
+
+	simd::AABox SceneSpatialIndex::toOctreeBounds(const AABox& bounds)
+	{
+		static constexpr float MAX_COORD = std::numeric_limits<float>::max();
+
+		const Vector3 center = bounds.getCenter();
+		const Vector3 extents = bounds.getHalfSize();
+
+		// Note: Comparisons written so that NaN values fail them as well
+		bool isFinite = true;
+		for (UINT32 i = 0; i < 3; i++)
+		{
+			if (!(Math::abs(center[i]) < MAX_COORD) || !(Math::abs(extents[i]) < MAX_COORD))
+				isFinite = false;
+		}
+
+		if (!isFinite)
+			return simd::AABox(Vector3::ZERO, MAX_COORD);
+
+		simd::AABox output;
+		output.center = Vector4(center);
+		output.extents = Vector4(Math::abs(extents.x), Math::abs(extents.y), Math::abs(extents.z), 0.0f);
+
+		return output;
+	}
+}}
@@ -0,0 +1,117 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#pragma once
+
+#include "BsRenderBeastPrerequisites.h"
+#include "Utility/BsOctree.h"
+#include "Math/BsConvexVolume.h"
+
+namespace bs { namespace ct
+{
+	class SceneSpatialIndex;
+
+	/** @addtogroup RenderBeast
+	 *  @{
+	 */
+
+	/** Options for the octree used by SceneSpatialIndex. */
+	struct SceneOctreeOptions
+	{
+		enum { LoosePadding = 4 };
+		enum { MinElementsPerNode = 8 };
+		enum { MaxElementsPerNode = 16 };
+		enum { MaxDepth = 16 };
+
+		static simd::AABox getBounds(UINT32 elem, void* context);
+		static void setElementId(UINT32 elem, const OctreeElementId& id, void* context);
+	};
+
+	/**
+	 * Keeps the bounds of all scene objects of a single type (e.g. renderables) in a loose octree, allowing the objects
+	 * to be culled hierarchically. Objects are identified by their index in the relevant SceneInfo array, and the index
+	 * is expected to be kept in sync with that array: new objects are appended at the end, and when an object is removed
+	 * the last object is moved into its slot.
+	 */
+	class SceneSpatialIndex : public INonCopyable
+	{
+	public:
+		SceneSpatialIndex();
+
+		/** Adds a new object at the end of the index. */
+		void add(const AABox& bounds);
+
+		/** Adds a new object at the end of the index. */
+		void add(const Sphere& bounds);
+
+		/** Updates the bounds of the object at the specified index. */
+		void update(UINT32 idx, const AABox& bounds);
+
+		/** Updates the bounds of the object at the specified index. */
+		void update(UINT32 idx, const Sphere& bounds);
+
+		/** Removes the object at the specified index, moving the last object into its slot. */
+		void remove(UINT32 idx);
+
+		/** Returns the number of objects in the index. */
+		UINT32 size() const { return (UINT32)mBounds.size(); }
+
+		/**
+		 * Calls @p visitor with the index of every object that might intersect the provided volume. Objects are culled at
+		 * the granularity of octree nodes (a node's loose bounds are tested, and if they intersect the volume all objects
+		 * in the node are reported), meaning the caller still needs to test the reported objects individually. Objects
+		 * in nodes outside of the volume are never touched.
+		 */
+		template<class T>
+		void visitCandidates(const ConvexVolume& volume, T visitor) const;
+
+	private:
+		friend struct SceneOctreeOptions;
+		using Octree = bs::Octree<UINT32, SceneOctreeOptions>;
+
+		/**
+		 * Converts the provided bounds into the form stored by the octree. Objects with infinite or invalid bounds are
+		 * assigned bounds that cannot fit in any child node, ensuring they are kept in the root which is never culled.
+		 */
+		static simd::AABox toOctreeBounds(const AABox& bounds);
+
+		Octree mOctree;
+		Vector<simd::AABox> mBounds;
+		Vector<OctreeElementId> mElementIds;
+	};
+
+	template<class T>
+	void SceneSpatialIndex::visitCandidates(const ConvexVolume& volume, T visitor) const
+	{
+		Octree::NodeIterator nodeIter(mOctree);
+
+		// Root node holds elements that don't fit within its bounds, so it is never culled
+		bool isRoot = true;
+		while (nodeIter.moveNext())
+		{
+			const Octree::HNode& node = nodeIter.getCurrent();
+			if (!isRoot)
+			{
+				const simd::AABox& nodeBounds = node.getBounds().getBounds();
+				const Vector3 center(nodeBounds.center.x, nodeBounds.center.y, nodeBounds.center.z);
+				const Vector3 extents(nodeBounds.extents.x, nodeBounds.extents.y, nodeBounds.extents.z);
+
+				if (!volume.intersects(AABox(center - extents, center + extents)))
+					continue;
+			}
+
+			isRoot = false;
+
+			Octree::ElementIterator elemIter(node.getNode());
+			while (elemIter.moveNext())
+				visitor(elemIter.getCurrentElem());
+
+			for (UINT32 i = 0; i < 8; i++)
+			{
+				if (node.getNode()->hasChild(i))
+					nodeIter.pushChild(i);
+			}
+		}
+	}
+
+	/** @} */
+}}
@@ -479,6 +479,8 @@ ParseState* parseStateCreate()
 	parseState->nodeStack = 0;
 	parseState->includeStack = 0;
 	parseState->includes = 0;
+	parseState->includeSources = 0;
+	parseState->missingInclude = 0;
 	parseState->rawCodeBlock[0] = 0;
 	parseState->rawCodeBlock[1] = 0;
 	parseState->numRawCodeBlocks[0] = 0;
@@ -220,6 +220,8 @@ struct tagParseState
 	NodeLink* nodeStack;
 	IncludeLink* includeStack;
 	IncludeLink* includes;
+	const void* includeSources;
+	char* missingInclude;
 	RawCode* rawCodeBlock[RCT_Count];
 	int numRawCodeBlocks[RCT_Count];
 	int numOpenBrackets;
@@ -18,20 +18,38 @@ char* includePush(ParseState* state, const char* filename, int line, int column,
 	memcpy(filenameNoQuote, filename + 1, filenameQuotesLen - 2);
 	filenameNoQuote[filenameQuotesLen - 2] = '\0';
 
-	HShaderInclude include = ShaderManager::instance().findInclude(filenameNoQuote);
+	// Includes can be resolved before parsing, in which case the parse doesn't access the shader manager and can run
+	// on any thread
+	const String* includeSource = nullptr;
+	HShaderInclude include;
+	if (state->includeSources != nullptr)
+	{
+		const auto& includeSources = *(const UnorderedMap<String, String>*)state->includeSources;
+
+		auto iterFind = includeSources.find(filenameNoQuote);
+		if (iterFind != includeSources.end())
+			includeSource = &iterFind->second;
+		else // Let the caller look the include up and parse again
+			state->missingInclude = mmalloc_strdup(state->memContext, filenameNoQuote);
+	}
+	else
+	{
+		include = ShaderManager::instance().findInclude(filenameNoQuote);
 
-	if (include != nullptr)
-		include.blockUntilLoaded();
+		if (include != nullptr)
+			include.blockUntilLoaded();
+
+		if (include.isLoaded())
+			includeSource = &include->getString();
+	}
 
 	int filenameLen = (int)strlen(filenameNoQuote);
-	if (include.isLoaded())
+	if (includeSource != nullptr)
 	{
-		String includeSource = include->getString();
-
-		*size = (int)includeSource.size() + 2;
+		*size = (int)includeSource->size() + 2;
 		char* output = (char*)mmalloc(state->memContext, *size);
 
-		memcpy(output, includeSource.data(), *size - 2);
+		memcpy(output, includeSource->data(), *size - 2);
 		output[*size - 2] = 0;
 		output[*size - 1] = 0;
 
@@ -18,6 +18,8 @@
 #include "Renderer/BsRendererManager.h"
 #include "FileSystem/BsFileSystem.h"
 #include "FileSystem/BsDataStream.h"
+#include "Threading/BsTaskScheduler.h"
+#include "BsSLProgramCache.h"
 
 #define XSC_ENABLE_LANGUAGE_EXT 1
 #include "Xsc/Xsc.h"
@@ -28,6 +30,11 @@ extern "C" {
 #define YY_NO_UNISTD_H 1
 #include "BsParserFX.h"
 #include "BsLexerFX.h"
+
+// Identifies the version of the shader cross-compiler, provided by the build system
+#ifndef BS_XSC_BUILD_ID
+#define BS_XSC_BUILD_ID "unknown"
+#endif
 }
 
 using namespace std;
@@ -355,7 +362,7 @@ namespace bs
 		}
 	}
 
-	SPtr<SamplerState> parseSamplerState(const Xsc::Reflection::SamplerState& sampState)
+	SAMPLER_STATE_DESC parseSamplerState(const Xsc::Reflection::SamplerState& sampState)
 	{
 		SAMPLER_STATE_DESC desc;
 
@@ -434,85 +441,64 @@ namespace bs
 			break;
 		}
 
-		return SamplerState::create(desc);
+		return desc;
 	}
 
-	void parseParameters(const Xsc::Reflection::ReflectionData& reflData, SHADER_DESC& desc)
+	/** Converts the parameters reported by reflection into a list of parameters to register with a shader. */
+	void reflectParameters(const Xsc::Reflection::ReflectionData& reflData, Vector<BSLReflectedParam>& output)
 	{
 		for(auto& entry : reflData.uniforms)
 		{
 			if ((entry.flags & Xsc::Reflection::Uniform::Flags::Internal) != 0)
 				continue;
 
-			String ident = entry.ident.c_str();
+			BSLReflectedParam param;
+			param.name = entry.ident.c_str();
+
 			switch(entry.type)
 			{
 			case Xsc::Reflection::VariableType::UniformBuffer:
-				desc.setParamBlockAttribs(entry.ident.c_str(), false, GBU_STATIC);
+				param.type = BSLReflectedParamType::ParamBlock;
 				break;
 			case Xsc::Reflection::VariableType::Buffer:
 				{
-					GpuParamObjectType objType = ReflTypeToTextureType((Xsc::Reflection::BufferType)entry.baseType);
-					if(objType != GPOT_UNKNOWN)
+					param.objectType = ReflTypeToTextureType((Xsc::Reflection::BufferType)entry.baseType);
+					if(param.objectType != GPOT_UNKNOWN)
 					{
-						// Ignore parameters that were already registered in some previous variation. Note that this implies
-						// you cannot have same names for different parameters in different variations.
-						if (desc.textureParams.find(ident) != desc.textureParams.end())
-							continue;
-
-						if (entry.defaultValue == -1)
-							desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, objType));
-						else
+						param.type = BSLReflectedParamType::Texture;
+
+						if (entry.defaultValue != -1)
 						{
 							const Xsc::Reflection::DefaultValue& defVal = reflData.defaultValues[entry.defaultValue];
-							desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, objType),
-								getBuiltinTexture(defVal.integer));
+
+							param.hasDefault = true;
+							param.defaultTexture = (UINT32)defVal.integer;
 						}
 					}
 					else
 					{
-						// Ignore parameters that were already registered in some previous variation. Note that this implies
-						// you cannot have same names for different parameters in different variations.
-						if (desc.bufferParams.find(ident) != desc.bufferParams.end())
-							continue;
-
-						objType = ReflTypeToBufferType((Xsc::Reflection::BufferType)entry.baseType);
-						desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, objType));
+						param.type = BSLReflectedParamType::Buffer;
+						param.objectType = ReflTypeToBufferType((Xsc::Reflection::BufferType)entry.baseType);
 					}
 				}
 				break;
 			case Xsc::Reflection::VariableType::Sampler:
 			{
+				param.type = BSLReflectedParamType::Sampler;
+				param.objectType = GPOT_SAMPLER2D;
+
 				auto findIter = reflData.samplerStates.find(entry.ident);
 				if (findIter != reflData.samplerStates.end())
 				{
-					// Ignore parameters that were already registered in some previous variation. Note that this implies
-					// you cannot have same names for different parameters in different variations.
-					if(desc.samplerParams.find(ident) != desc.samplerParams.end())
-						continue;
-
-					String alias = findIter->second.alias.c_str();
+					param.hasSamplerInfo = true;
+					param.alias = findIter->second.alias.c_str();
 
 					if(findIter->second.isNonDefault)
 					{
-						SPtr<SamplerState> defaultVal = parseSamplerState(findIter->second);
-						desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, GPOT_SAMPLER2D), defaultVal);
-
-						if (!alias.empty())
-							desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, alias, GPOT_SAMPLER2D), defaultVal);
-					}
-					else
-					{
-						desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, GPOT_SAMPLER2D));
-
-						if (!alias.empty())
-							desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, alias, GPOT_SAMPLER2D));
+						param.hasDefault = true;
+						param.defaultSampler = parseSamplerState(findIter->second);
 					}
 				}
-				else
-				{
-					desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, GPOT_SAMPLER2D));
-				}
 				break;
 			}
 			case Xsc::Reflection::VariableType::Variable:
@@ -531,49 +517,131 @@ namespace bs
 					}
 				}
 
-				if (!isBlockInternal)
-				{
-					GpuParamDataType type = ReflTypeToDataType((Xsc::Reflection::DataType)entry.baseType);
-					if ((entry.flags & Xsc::Reflection::Uniform::Flags::Color) != 0 &&
-						(type == GPDT_FLOAT3 || type == GPDT_FLOAT4))
-					{
-						type = GPDT_COLOR;
-					}
-
-					UINT32 arraySize = entry.arraySize;
+				if (isBlockInternal)
+					continue;
 
-					if (entry.defaultValue == -1)
-						desc.addParameter(SHADER_DATA_PARAM_DESC(ident, ident, type, StringID::NONE, arraySize));
-					else
-					{
-						const Xsc::Reflection::DefaultValue& defVal = reflData.defaultValues[entry.defaultValue];
+				GpuParamDataType type = ReflTypeToDataType((Xsc::Reflection::DataType)entry.baseType);
+				if ((entry.flags & Xsc::Reflection::Uniform::Flags::Color) != 0 &&
+					(type == GPDT_FLOAT3 || type == GPDT_FLOAT4))
+				{
+					type = GPDT_COLOR;
+				}
 
-						desc.addParameter(SHADER_DATA_PARAM_DESC(ident, ident, type, StringID::NONE, arraySize, 0), 
-							(UINT8*)defVal.matrix);
-					}
+				param.type = BSLReflectedParamType::Data;
+				param.dataType = type;
+				param.arraySize = entry.arraySize;
 
-					if(!entry.spriteUVRef.empty() && (type == GPDT_FLOAT4))
-					{
-						SHADER_PARAM_ATTRIBUTE attribute;
-						attribute.value.assign(entry.spriteUVRef.data(), entry.spriteUVRef.size());
-						attribute.nextParamIdx = (UINT32)-1;
-						attribute.type = ShaderParamAttributeType::SpriteUV;
+				if (entry.defaultValue != -1)
+				{
+					const Xsc::Reflection::DefaultValue& defVal = reflData.defaultValues[entry.defaultValue];
 
-						desc.setParameterAttribute(ident, attribute);
-					}
+					param.hasDefault = true;
+					memcpy(param.defaultValue, defVal.matrix, std::min(sizeof(param.defaultValue), sizeof(defVal.matrix)));
 				}
+
+				if(!entry.spriteUVRef.empty() && (type == GPDT_FLOAT4))
+					param.spriteUVRef.assign(entry.spriteUVRef.data(), entry.spriteUVRef.size());
 			}
 				break;
 			case Xsc::Reflection::VariableType::Struct:
 			{
-				INT32 structIdx = entry.baseType;
-				UINT32 structSize = getStructSize(structIdx, reflData.structs);
-
-				desc.addParameter(SHADER_DATA_PARAM_DESC(ident, ident, GPDT_STRUCT, StringID::NONE, entry.arraySize,
-					structSize));
+				param.type = BSLReflectedParamType::Data;
+				param.dataType = GPDT_STRUCT;
+				param.arraySize = entry.arraySize;
+				param.elementSize = getStructSize(entry.baseType, reflData.structs);
+			}
+				break;
+			default:
+				continue;
 			}
+
+			output.push_back(param);
+		}
+	}
+
+	/** Registers parameters previously retrieved through reflectParameters() with the shader descriptor. */
+	void applyParameters(const Vector<BSLReflectedParam>& params, SHADER_DESC& desc)
+	{
+		for(auto& entry : params)
+		{
+			const String& ident = entry.name;
+			switch(entry.type)
+			{
+			case BSLReflectedParamType::ParamBlock:
+				desc.setParamBlockAttribs(ident, false, GBU_STATIC);
+				break;
+			case BSLReflectedParamType::Texture:
+				// Ignore parameters that were already registered in some previous variation. Note that this implies
+				// you cannot have same names for different parameters in different variations.
+				if (desc.textureParams.find(ident) != desc.textureParams.end())
+					continue;
+
+				if (!entry.hasDefault)
+					desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, entry.objectType));
+				else
+				{
+					desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, entry.objectType),
+						getBuiltinTexture(entry.defaultTexture));
+				}
+				break;
+			case BSLReflectedParamType::Buffer:
+				// Ignore parameters that were already registered in some previous variation. Note that this implies
+				// you cannot have same names for different parameters in different variations.
+				if (desc.bufferParams.find(ident) != desc.bufferParams.end())
+					continue;
+
+				desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, entry.objectType));
+				break;
+			case BSLReflectedParamType::Sampler:
+				if (!entry.hasSamplerInfo)
+				{
+					desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, GPOT_SAMPLER2D));
+					break;
+				}
+
+				// Ignore parameters that were already registered in some previous variation. Note that this implies
+				// you cannot have same names for different parameters in different variations.
+				if(desc.samplerParams.find(ident) != desc.samplerParams.end())
+					continue;
+
+				if(entry.hasDefault)
+				{
+					SPtr<SamplerState> defaultVal = SamplerState::create(entry.defaultSampler);
+					desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, GPOT_SAMPLER2D), defaultVal);
+
+					if (!entry.alias.empty())
+						desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, entry.alias, GPOT_SAMPLER2D), defaultVal);
+				}
+				else
+				{
+					desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, ident, GPOT_SAMPLER2D));
+
+					if (!entry.alias.empty())
+						desc.addParameter(SHADER_OBJECT_PARAM_DESC(ident, entry.alias, GPOT_SAMPLER2D));
+				}
+				break;
+			case BSLReflectedParamType::Data:
+				if (!entry.hasDefault)
+				{
+					desc.addParameter(SHADER_DATA_PARAM_DESC(ident, ident, entry.dataType, StringID::NONE, entry.arraySize,
+						entry.elementSize));
+				}
+				else
+				{
+					desc.addParameter(SHADER_DATA_PARAM_DESC(ident, ident, entry.dataType, StringID::NONE, entry.arraySize,
+						entry.elementSize), (UINT8*)entry.defaultValue);
+				}
+
+				if(!entry.spriteUVRef.empty())
+				{
+					SHADER_PARAM_ATTRIBUTE attribute;
+					attribute.value = entry.spriteUVRef;
+					attribute.nextParamIdx = (UINT32)-1;
+					attribute.type = ShaderParamAttributeType::SpriteUV;
+
+					desc.setParameterAttribute(ident, attribute);
+				}
 				break;
-			default: ;
 			}
 		}
 	}
@@ -587,7 +655,8 @@ namespace bs
 	};
 
 	String crossCompile(const String& hlsl, GpuProgramType type, CrossCompileOutput outputType, bool optionalEntry,
-		UINT32& startBindingSlot, SHADER_DESC* shaderDesc = nullptr, Vector<GpuProgramType>* detectedTypes = nullptr)
+		UINT32& startBindingSlot, Xsc::Reflection::ReflectionData* reflection = nullptr, 
+		Vector<GpuProgramType>* detectedTypes = nullptr)
 	{
 		SPtr<StringStream> input = bs_shared_ptr_new<StringStream>();
 
@@ -732,8 +801,8 @@ namespace bs
 			}
 		}
 
-		if (shaderDesc != nullptr)
-			parseParameters(reflectionData, *shaderDesc);
+		if (reflection != nullptr)
+			*reflection = std::move(reflectionData);
 
 		return output.str();
 	}
@@ -744,20 +813,81 @@ namespace bs
 		return crossCompile(hlsl, type, outputType, false, startBindingSlot);
 	}
 
-	void reflectHLSL(const String& hlsl, SHADER_DESC& shaderDesc, Vector<GpuProgramType>& entryPoints)
+	void reflectHLSL(const String& hlsl, Xsc::Reflection::ReflectionData& reflection, Vector<GpuProgramType>& entryPoints)
 	{
 		UINT32 dummy = 0;
-		crossCompile(hlsl, GPT_VERTEX_PROGRAM, CrossCompileOutput::GLSL45, true, dummy, &shaderDesc, &entryPoints);
+		crossCompile(hlsl, GPT_VERTEX_PROGRAM, CrossCompileOutput::GLSL45, true, dummy, &reflection, &entryPoints);
 	}
 
+	/**
+	 * Reflects the provided pass code, and generates the per-program code for each of the requested languages. Returns
+	 * false if any of the programs failed to cross-compile.
+	 */
+	bool compilePassPrograms(const String& code, ShadingLanguageFlags languages, CrossCompileOutput glslVersion,
+		BSLPassPrograms& output)
+	{
+		// Find valid entry points and parameters
+		// Note: XShaderCompiler needs to do a full pass when doing reflection, and for each individual program
+		// type. If performance is ever important here it could be good to update XShaderCompiler so it can
+		// somehow save the AST and then re-use it for multiple actions.
+		Xsc::Reflection::ReflectionData reflection;
+		reflectHLSL(code, reflection, output.types);
+		reflectParameters(reflection, output.params);
+
+		bool success = true;
+		if(languages.isSet(ShadingLanguageFlag::GLSL))
+		{
+			UINT32 glslBinding = 0;
+			for (auto& type : output.types)
+			{
+				output.glsl[type] = HLSLtoGLSL(code, type, glslVersion, glslBinding);
+				success &= !output.glsl[type].empty();
+			}
+		}
+
+		if(languages.isSet(ShadingLanguageFlag::VKSL))
+		{
+			UINT32 vkslBinding = 0;
+			for (auto& type : output.types)
+			{
+				output.vksl[type] = HLSLtoGLSL(code, type, CrossCompileOutput::VKSL45, vkslBinding);
+				success &= !output.vksl[type].empty();
+			}
+		}
+
+		if(languages.isSet(ShadingLanguageFlag::HLSL))
+		{
+			// Clean non-standard HLSL
+			// Note: Ideally we add a full HLSL output module to XShaderCompiler, instead of using simple regex. This
+			// way the syntax could be enhanced with more complex features, while still being able to output pure
+			// HLSL.
+			static const std::regex attrRegex(
+				R"(\[\s*layout\s*\(.*\)\s*\]|\[\s*internal\s*\]|\[\s*color\s*\]|\[\s*alias\s*\(.*\)\s*\]|\[\s*spriteuv\s*\(.*\)\s*\])");
+			output.hlsl = regex_replace(code, attrRegex, "");
+
+			static const std::regex initializerRegex(
+				R"(Texture2D\s*(\S*)\s*=.*;)");
+			output.hlsl = regex_replace(output.hlsl, initializerRegex, "Texture2D $1;");
+		}
+
+		return success;
+	}
+
+
 	BSLFXCompileResult BSLFXCompiler::compile(const String& name, const String& source,
-		const UnorderedMap<String, String>& defines, ShadingLanguageFlags languages)
+		const UnorderedMap<String, String>& defines, ShadingLanguageFlags languages, const Path& cacheDirectory,
+		bool parallel)
 	{
+		UPtr<BSLProgramCache> cache;
+		if (!cacheDirectory.isEmpty())
+			cache = bs_unique_ptr_new<BSLProgramCache>(cacheDirectory, BS_XSC_BUILD_ID);
+
 		// Parse global shader options & shader meta-data
 		SHADER_DESC shaderDesc;
 		Vector<String> includes;
 
-		BSLFXCompileResult output = compileShader(source, defines, languages, shaderDesc, includes);
+		BSLFXCompileResult output = compileShader(source, defines, languages, cache.get(), parallel, shaderDesc,
+			includes);
 
 		// Generate a shader from the parsed information
 		output.shader = Shader::_createPtr(name, shaderDesc);
@@ -1699,13 +1829,15 @@ namespace bs
 
 	BSLFXCompileResult BSLFXCompiler::compileTechniques(
 		const Vector<std::pair<ASTFXNode*, ShaderMetaData>>& shaderMetaData, const String& source,
-		const UnorderedMap<String, String>& defines, ShadingLanguageFlags languages, SHADER_DESC& shaderDesc, 
+		const UnorderedMap<String, String>& defines, UnorderedMap<String, String>& includeSources, 
+		ShadingLanguageFlags languages, const BSLProgramCache* cache, bool parallel, SHADER_DESC& shaderDesc, 
 		Vector<String>& includes)
 	{
 		BSLFXCompileResult output;
 
 		// Build a list of different variations and re-parse the source using the relevant defines
 		UnorderedSet<String> includeSet;
+		Vector<CompiledVariation> compiledVariations;
 		for (auto& entry : shaderMetaData)
 		{
 			const ShaderMetaData& metaData = entry.second;
@@ -1788,40 +1920,68 @@ namespace bs
 				}
 			}
 
-			// For every variation, re-parse the file with relevant defines
 			for (auto& variation : variations)
 			{
-				UnorderedMap<String, String> globalDefines = defines;
-				UnorderedMap<String, String> variationDefines = variation.getDefines().getAll();
-
-				for (auto& define : variationDefines)
-					globalDefines[define.first] = define.second;
+				compiledVariations.push_back(CompiledVariation());
+				compiledVariations.back().name = metaData.name;
+				compiledVariations.back().variation = variation;
+			}
+		}
 
-				ParseState* variationParseState = parseStateCreate();
-				output = parseFX(variationParseState, source.c_str(), globalDefines);
+		// For every variation, re-parse the file with relevant defines and cross-compile the programs. This is where most
+		// of the time is spent, so do it in parallel, and only register the results afterwards, in order.
+		const auto compileWorker = 
+			[&compiledVariations, &source, &defines, &includeSources, languages, cache, parallel](UINT32 idx)
+		{
+			compileVariation(source, defines, includeSources, languages, cache, parallel, compiledVariations[idx]);
+		};
 
-				if (!output.errorMessage.empty())
-					parseStateDelete(variationParseState);
-				else
-				{
-					Vector<String> codeBlocks;
-					RawCode* rawCode = variationParseState->rawCodeBlock[RCT_CodeBlock];
-					while (rawCode != nullptr)
-					{
-						while ((INT32)codeBlocks.size() <= rawCode->index)
-							codeBlocks.push_back(String());
+		Vector<UINT32> todo(compiledVariations.size());
+		for (UINT32 i = 0; i < (UINT32)todo.size(); i++)
+			todo[i] = i;
 
-						codeBlocks[rawCode->index] = String(rawCode->code, rawCode->size);
-						rawCode = rawCode->next;
-					}
+		while (!todo.empty())
+		{
+			if (parallel && TaskScheduler::isStarted())
+				TaskScheduler::instance().parallelFor(0, (UINT32)todo.size(), 1, 
+					[&todo, &compileWorker](UINT32 i) { compileWorker(todo[i]); });
+			else
+			{
+				for (auto& idx : todo)
+					compileWorker(idx);
+			}
 
-					output = compileTechniques(variationParseState, entry.second.name, codeBlocks, variation, languages,
-						includeSet, shaderDesc);
+			// Includes enabled only by the defines of a variation aren't seen when parsing the source up front. Look them
+			// up here, on the calling thread, and parse the variations that need them again. Includes that cannot be
+			// found leave the variation with the parse error.
+			Vector<UINT32> retry;
+			for (auto& idx : todo)
+			{
+				const String& missingInclude = compiledVariations[idx].missingInclude;
+				if (missingInclude.empty())
+					continue;
 
-					if (!output.errorMessage.empty())
-						return output;
+				if (includeSources.find(missingInclude) != includeSources.end() ||
+					resolveInclude(missingInclude, includeSources))
+				{
+					retry.push_back(idx);
 				}
 			}
+
+			todo = std::move(retry);
+		}
+
+		for (auto& entry : compiledVariations)
+		{
+			// Variations that fail to parse are skipped, while failing to compile aborts
+			output = entry.output;
+			if (!entry.parsed)
+				continue;
+
+			if (!output.errorMessage.empty())
+				return output;
+
+			createTechniques(entry, includeSet, shaderDesc);
 		}
 
 		// Generate a shader from the parsed techniques
@@ -1884,7 +2044,8 @@ namespace bs
 	}
 
 	BSLFXCompileResult BSLFXCompiler::compileShader(String source, const UnorderedMap<String, String>& defines,
-		ShadingLanguageFlags languages, SHADER_DESC& shaderDesc, Vector<String>& includes)
+		ShadingLanguageFlags languages, const BSLProgramCache* cache, bool parallel, SHADER_DESC& shaderDesc, 
+		Vector<String>& includes)
 	{
 		SPtr<ct::Renderer> renderer = RendererManager::instance().getActive();
 
@@ -1922,6 +2083,10 @@ namespace bs
 			rawCode = rawCode->next;
 		}
 
+		// Variations might be parsed on worker threads, so look up their includes here
+		UnorderedMap<String, String> includeSources;
+		resolveIncludes(parseState, includeSources);
+
 		parseStateDelete(parseState);
 
 		output = populateVariations(shaderMetaData);
@@ -1929,7 +2094,8 @@ namespace bs
 		if (!output.errorMessage.empty())
 			return output;
 
-		output = compileTechniques(shaderMetaData, source, defines, languages, shaderDesc, includes);
+		output = compileTechniques(shaderMetaData, source, defines, includeSources, languages, cache, parallel,
+			shaderDesc, includes);
 
 		if (!output.errorMessage.empty())
 			return output;
@@ -1952,7 +2118,7 @@ namespace bs
 				StringStream subShaderSource;
 				const UnorderedMap<String, String> subShaderDefines = extPointShader.defines.getAll();
 				{
-					Lock fileLock = FileScheduler::getLock(path);
+					SharedLock fileLock = FileScheduler::getReadLock(path);
 
 					SPtr<DataStream> stream = FileSystem::openFile(path);
 					if(stream)
@@ -1965,7 +2131,7 @@ namespace bs
 				SHADER_DESC subShaderDesc;
 				Vector<String> subShaderIncludes;
 				BSLFXCompileResult subShaderOutput = compileShader(subShaderSource.str(), subShaderDefines, languages, 
-					subShaderDesc, subShaderIncludes);
+					cache, parallel, subShaderDesc, subShaderIncludes);
 
 				if (!subShaderOutput.errorMessage.empty())
 					return subShaderOutput;
@@ -1986,11 +2152,81 @@ namespace bs
 		return output;
 	}
 
-	BSLFXCompileResult BSLFXCompiler::compileTechniques(ParseState* parseState, const String& name,
-		const Vector<String>& codeBlocks, const ShaderVariation& variation, ShadingLanguageFlags languages,
-		UnorderedSet<String>& includes, SHADER_DESC& shaderDesc)
+	void BSLFXCompiler::resolveIncludes(ParseState* parseState, UnorderedMap<String, String>& includeSources)
+	{
+		IncludeLink* includeLink = parseState->includes;
+		while (includeLink != nullptr)
+		{
+			const String name = includeLink->data->filename;
+			includeLink = includeLink->next;
+
+			if (includeSources.find(name) != includeSources.end())
+				continue;
+
+			resolveInclude(name, includeSources);
+		}
+	}
+
+	bool BSLFXCompiler::resolveInclude(const String& name, UnorderedMap<String, String>& includeSources)
+	{
+		HShaderInclude include = ShaderManager::instance().findInclude(name);
+		if (include != nullptr)
+			include.blockUntilLoaded();
+
+		if (!include.isLoaded())
+			return false;
+
+		includeSources[name] = include->getString();
+		return true;
+	}
+
+	void BSLFXCompiler::compileVariation(const String& source, const UnorderedMap<String, String>& defines,
+		const UnorderedMap<String, String>& includeSources, ShadingLanguageFlags languages, const BSLProgramCache* cache,
+		bool parallel, CompiledVariation& variation)
+	{
+		UnorderedMap<String, String> globalDefines = defines;
+		UnorderedMap<String, String> variationDefines = variation.variation.getDefines().getAll();
+
+		for (auto& define : variationDefines)
+			globalDefines[define.first] = define.second;
+
+		variation.missingInclude.clear();
+
+		// Parse state (and its memory allocator) is private to this variation, so variations can be parsed concurrently
+		ParseState* variationParseState = parseStateCreate();
+		variationParseState->includeSources = &includeSources;
+		variation.output = parseFX(variationParseState, source.c_str(), globalDefines);
+
+		if (!variation.output.errorMessage.empty())
+		{
+			if (variationParseState->missingInclude != nullptr)
+				variation.missingInclude = variationParseState->missingInclude;
+
+			parseStateDelete(variationParseState);
+			return;
+		}
+
+		variation.parsed = true;
+
+		Vector<String> codeBlocks;
+		RawCode* rawCode = variationParseState->rawCodeBlock[RCT_CodeBlock];
+		while (rawCode != nullptr)
+		{
+			while ((INT32)codeBlocks.size() <= rawCode->index)
+				codeBlocks.push_back(String());
+
+			codeBlocks[rawCode->index] = String(rawCode->code, rawCode->size);
+			rawCode = rawCode->next;
+		}
+
+		variation.output = compileTechniques(variationParseState, codeBlocks, languages, cache, parallel, variation);
+	}
+
+	BSLFXCompileResult BSLFXCompiler::compileTechniques(ParseState* parseState, const Vector<String>& codeBlocks, 
+		ShadingLanguageFlags languages, const BSLProgramCache* cache, bool parallel, CompiledVariation& variation)
 	{
 		BSLFXCompileResult output;
+		const String& name = variation.name;
 
 		if (parseState->rootNode == nullptr || parseState->rootNode->type != NT_Root)
 		{
@@ -2105,12 +2341,7 @@ namespace bs
 		IncludeLink* includeLink = parseState->includes;
 		while(includeLink != nullptr)
 		{
-			String includeFilename = includeLink->data->filename;
-
-			auto iterFind = std::find(includes.begin(), includes.end(), includeFilename);
-			if (iterFind == includes.end())
-				includes.insert(includeFilename);
-
+			variation.includes.push_back(includeLink->data->filename);
 			includeLink = includeLink->next;
 		}
 
@@ -2118,7 +2349,6 @@ namespace bs
 
 		// Parse extended HLSL code and generate per-program code, also convert to GLSL/VKSL
 		const auto end = (UINT32)shaderData.size();
-		Vector<pair<ASTFXNode*, ShaderData>> outputShaderData;
 		for(UINT32 i = 0; i < end; i++)
 		{
 			const ShaderMetaData& metaData = shaderData[i].second.metaData;
@@ -2144,156 +2374,119 @@ namespace bs
 			vkslShaderData.metaData.language = "vksl";
 
 			const auto numPasses = (UINT32)shaderDataEntry.passes.size();
-			for(UINT32 j = 0; j < numPasses; j++)
+			const auto paramsOffset = (UINT32)variation.params.size();
+			variation.params.resize(paramsOffset + numPasses);
+
+			// Each pass only writes to its own pass data and parameter list, so passes can be cross-compiled in parallel
+			const auto compilePass = [&](UINT32 j)
 			{
-				PassData& passData = shaderDataEntry.passes[j];
+				const String& code = shaderDataEntry.passes[j].code;
+				const bool highEnd = glslVersion == CrossCompileOutput::GLSL45;
 
-				// Find valid entry points and parameters
-				// Note: XShaderCompiler needs to do a full pass when doing reflection, and for each individual program
-				// type. If performance is ever important here it could be good to update XShaderCompiler so it can
-				// somehow save the AST and then re-use it for multiple actions.
-				Vector<GpuProgramType> types;
-				reflectHLSL(passData.code, shaderDesc, types);
+				BSLPassPrograms programs;
+				String cacheKey;
+				bool cached = false;
+				if(cache != nullptr)
+				{
+					cacheKey = BSLProgramCache::getKey(code, languages, highEnd, BS_XSC_BUILD_ID);
+					cached = cache->load(cacheKey, programs);
+				}
 
-				if(languages.isSet(ShadingLanguageFlag::GLSL))
+				if(!cached)
 				{
-					PassData& glslPassData = glslShaderData.passes[j];
-					UINT32 glslBinding = 0;
+					// Don't cache failures, so the errors get reported again on the next compile
+					const bool success = compilePassPrograms(code, languages, glslVersion, programs);
+					if(cache != nullptr && success)
+						cache->save(cacheKey, programs);
+				}
 
-					for (auto& type : types)
+				const auto setProgramCode = [](PassData& passData, GpuProgramType type, const String& programCode)
+				{
+					switch (type)
 					{
-						switch (type)
-						{
-						case GPT_VERTEX_PROGRAM:
-							glslPassData.vertexCode = HLSLtoGLSL(glslPassData.code, GPT_VERTEX_PROGRAM,
-								glslVersion, glslBinding);
-							break;
-						case GPT_FRAGMENT_PROGRAM:
-							glslPassData.fragmentCode = HLSLtoGLSL(glslPassData.code, GPT_FRAGMENT_PROGRAM,
-								glslVersion, glslBinding);
-							break;
-						case GPT_GEOMETRY_PROGRAM:
-							glslPassData.geometryCode = HLSLtoGLSL(glslPassData.code, GPT_GEOMETRY_PROGRAM,
-								glslVersion, glslBinding);
-							break;
-						case GPT_HULL_PROGRAM:
-							glslPassData.hullCode = HLSLtoGLSL(glslPassData.code, GPT_HULL_PROGRAM,
-								glslVersion, glslBinding);
-							break;
-						case GPT_DOMAIN_PROGRAM:
-							glslPassData.domainCode = HLSLtoGLSL(glslPassData.code, GPT_DOMAIN_PROGRAM,
-								glslVersion, glslBinding);
-							break;
-						case GPT_COMPUTE_PROGRAM:
-							glslPassData.computeCode = HLSLtoGLSL(glslPassData.code, GPT_COMPUTE_PROGRAM,
-								glslVersion, glslBinding);
-							break;
-						default:
-							break;
-						}
+					case GPT_VERTEX_PROGRAM:
+						passData.vertexCode = programCode;
+						break;
+					case GPT_FRAGMENT_PROGRAM:
+						passData.fragmentCode = programCode;
+						break;
+					case GPT_GEOMETRY_PROGRAM:
+						passData.geometryCode = programCode;
+						break;
+					case GPT_HULL_PROGRAM:
+						passData.hullCode = programCode;
+						break;
+					case GPT_DOMAIN_PROGRAM:
+						passData.domainCode = programCode;
+						break;
+					case GPT_COMPUTE_PROGRAM:
+						passData.computeCode = programCode;
+						break;
+					default:
+						break;
 					}
+				};
+
+				if(languages.isSet(ShadingLanguageFlag::GLSL))
+				{
+					for (auto& type : programs.types)
+						setProgramCode(glslShaderData.passes[j], type, programs.glsl[type]);
 				}
 
 				if(languages.isSet(ShadingLanguageFlag::VKSL))
 				{
-					PassData& vkslPassData = vkslShaderData.passes[j];
-					UINT32 vkslBinding = 0;
-
-					for (auto& type : types)
-					{
-						switch (type)
-						{
-						case GPT_VERTEX_PROGRAM:
-							vkslPassData.vertexCode = HLSLtoGLSL(vkslPassData.code, GPT_VERTEX_PROGRAM,
-								CrossCompileOutput::VKSL45, vkslBinding);
-							break;
-						case GPT_FRAGMENT_PROGRAM:
-							vkslPassData.fragmentCode = HLSLtoGLSL(vkslPassData.code, GPT_FRAGMENT_PROGRAM,
-								CrossCompileOutput::VKSL45, vkslBinding);
-							break;
-						case GPT_GEOMETRY_PROGRAM:
-							vkslPassData.geometryCode = HLSLtoGLSL(vkslPassData.code, GPT_GEOMETRY_PROGRAM,
-								CrossCompileOutput::VKSL45, vkslBinding);
-							break;
-						case GPT_HULL_PROGRAM:
-							vkslPassData.hullCode = HLSLtoGLSL(vkslPassData.code, GPT_HULL_PROGRAM,
-								CrossCompileOutput::VKSL45, vkslBinding);
-							break;
-						case GPT_DOMAIN_PROGRAM:
-							vkslPassData.domainCode = HLSLtoGLSL(vkslPassData.code, GPT_DOMAIN_PROGRAM,
-								CrossCompileOutput::VKSL45, vkslBinding);
-							break;
-						case GPT_COMPUTE_PROGRAM:
-							vkslPassData.computeCode = HLSLtoGLSL(vkslPassData.code, GPT_COMPUTE_PROGRAM,
-								CrossCompileOutput::VKSL45, vkslBinding);
-							break;
-						default:
-							break;
-						}
-					}
+					for (auto& type : programs.types)
+						setProgramCode(vkslShaderData.passes[j], type, programs.vksl[type]);
 				}
 
 				if(languages.isSet(ShadingLanguageFlag::HLSL))
 				{
-					PassData& hlslPassData = hlslShaderData.passes[j];
-
-					// Clean non-standard HLSL
-					// Note: Ideally we add a full HLSL output module to XShaderCompiler, instead of using simple regex. This
-					// way the syntax could be enhanced with more complex features, while still being able to output pure
-					// HLSL.
-					static const std::regex attrRegex(
-						R"(\[\s*layout\s*\(.*\)\s*\]|\[\s*internal\s*\]|\[\s*color\s*\]|\[\s*alias\s*\(.*\)\s*\]|\[\s*spriteuv\s*\(.*\)\s*\])");
-					hlslPassData.code = regex_replace(hlslPassData.code, attrRegex, "");
-
-					static const std::regex initializerRegex(
-						R"(Texture2D\s*(\S*)\s*=.*;)");
-					hlslPassData.code = regex_replace(hlslPassData.code, initializerRegex, "Texture2D $1;");
-
 					// Note: I'm just copying HLSL code as-is. This code will contain all entry points which could have
 					// an effect on compile time. It would be ideal to remove dead code depending on program type. This would
 					// involve adding a HLSL code generator to XShaderCompiler.
-					for (auto& type : types)
-					{
-						switch (type)
-						{
-						case GPT_VERTEX_PROGRAM:
-							hlslPassData.vertexCode = hlslPassData.code;
-							break;
-						case GPT_FRAGMENT_PROGRAM:
-							hlslPassData.fragmentCode = hlslPassData.code;
-							break;
-						case GPT_GEOMETRY_PROGRAM:
-							hlslPassData.geometryCode = hlslPassData.code;
-							break;
-						case GPT_HULL_PROGRAM:
-							hlslPassData.hullCode = hlslPassData.code;
-							break;
-						case GPT_DOMAIN_PROGRAM:
-							hlslPassData.domainCode = hlslPassData.code;
-							break;
-						case GPT_COMPUTE_PROGRAM:
-							hlslPassData.computeCode = hlslPassData.code;
-							break;
-						default:
-							break;
-						}
-					}
+					PassData& hlslPassData = hlslShaderData.passes[j];
+					hlslPassData.code = programs.hlsl;
+
+					for (auto& type : programs.types)
+						setProgramCode(hlslPassData, type, programs.hlsl);
 				}
+
+				variation.params[paramsOffset + j] = std::move(programs.params);
+			};
+
+			if (parallel && TaskScheduler::isStarted())
+				TaskScheduler::instance().parallelFor(0, numPasses, 1, compilePass);
+			else
+			{
+				for(UINT32 j = 0; j < numPasses; j++)
+					compilePass(j);
 			}
 
-			outputShaderData.push_back(std::make_pair(nullptr, hlslShaderData));
-			outputShaderData.push_back(std::make_pair(nullptr, glslShaderData));
-			outputShaderData.push_back(std::make_pair(nullptr, vkslShaderData));
+			variation.shaders.push_back(hlslShaderData);
+			variation.shaders.push_back(glslShaderData);
+			variation.shaders.push_back(vkslShaderData);
 		}
 
-		for(auto& entry : outputShaderData)
+		return output;
+	}
+
+	void BSLFXCompiler::createTechniques(const CompiledVariation& variation, UnorderedSet<String>& includes, 
+		SHADER_DESC& shaderDesc)
+	{
+		for (auto& entry : variation.params)
+			applyParameters(entry, shaderDesc);
+
+		for (auto& entry : variation.includes)
+			includes.insert(entry);
+
+		for(auto& entry : variation.shaders)
 		{
-			const ShaderMetaData& metaData = entry.second.metaData;
+			const ShaderMetaData& metaData = entry.metaData;
 			if (metaData.isMixin)
 				continue;
 
 			Map<UINT32, SPtr<Pass>, std::greater<UINT32>> passes;
-			for (auto& passData : entry.second.passes)
+			for (auto& passData : entry.passes)
 			{
 				PASS_DESC passDesc;
 				passDesc.blendStateDesc = passData.blendDesc;
@@ -2362,12 +2555,11 @@ namespace bs
 
 			if (!orderedPasses.empty())
 			{
-				SPtr<Technique> technique = Technique::create(metaData.language, metaData.tags, variation, orderedPasses);
+				SPtr<Technique> technique = Technique::create(metaData.language, metaData.tags, variation.variation,
+					orderedPasses);
 				shaderDesc.techniques.push_back(technique);
 			}
 		}
-
-		return output;
 	}
 
 	String BSLFXCompiler::removeQuotes(const char* input)
@@ -4,11 +4,13 @@
 
 #include "BsSLPrerequisites.h"
 #include "Material/BsShader.h"
+#include "Material/BsShaderVariation.h"
 #include "RenderAPI/BsGpuProgram.h"
 #include "RenderAPI/BsRasterizerState.h"
 #include "RenderAPI/BsDepthStencilState.h"
 #include "RenderAPI/BsBlendState.h"
 #include "Importer/BsShaderImportOptions.h"
+#include "BsSLProgramCache.h"
 
 extern "C" {
 #include "BsASTFX.h"
@@ -90,6 +92,26 @@ namespace bs
 			Vector<PassData> passes;
 		};
 
+		/** 
+		 * Temporary data describing a single variation of a shader that has been parsed and cross-compiled, but not yet
+		 * registered with the shader descriptor.
+		 */
+		struct CompiledVariation
+		{
+			String name;
+			ShaderVariation variation;
+
+			BSLFXCompileResult output;
+			bool parsed = false;
+
+			/** Include that wasn't in the provided include sources, if parsing failed because of it. */
+			String missingInclude;
+
+			Vector<ShaderData> shaders;
+			Vector<Vector<BSLReflectedParam>> params;
+			Vector<String> includes;
+		};
+
 		/** Temporary data describing a sub-shader during parsing. */
 		struct SubShaderData
 		{
@@ -98,9 +120,21 @@ namespace bs
 		};
 
 	public:
-		/**	Transforms a source file written in BSL FX syntax into a Shader object. */
+		/**	
+		 * Transforms a source file written in BSL FX syntax into a Shader object. 
+		 * 
+		 * @param[in]	name			Name of the shader.
+		 * @param[in]	source			BSL source to compile.
+		 * @param[in]	defines			Defines to apply to all variations.
+		 * @param[in]	languages		Shading languages to generate techniques for.
+		 * @param[in]	cacheDirectory	Folder in which to cache the results of GPU program cross-compilation and 
+		 *								reflection. Caching is disabled if empty.
+		 * @param[in]	parallel		If true, shader variations and their passes are compiled in parallel when the task
+		 *								scheduler is running. Output is the same either way.
+		 */
 		static BSLFXCompileResult compile(const String& name, const String& source, 
-			const UnorderedMap<String, String>& defines, ShadingLanguageFlags languages);
+			const UnorderedMap<String, String>& defines, ShadingLanguageFlags languages, 
+			const Path& cacheDirectory = Path::BLANK, bool parallel = true);
 
 	private:
 		/** Converts the provided source into an abstract syntax tree using the lexer & parser for BSL FX syntax. */
@@ -244,17 +278,38 @@ namespace bs
 		 *									applied to all variations.
 		 * @param[in]	languages			Shading languages to generate techniques for. Each shader variation will be
 		 *									compiled into a separate technique for each of the provided languages.
+		 * @param[in]	cache				Cache to look up cross-compiled programs in, and to store them to. Can be null.
+		 * @param[in]	parallel			If true, shader variations are compiled in parallel when the task scheduler
+		 *									is running.
 		 * @param[out]	shaderDesc			Shader descriptor that resulting techniques, sub-shaders, and parameters will be
 		 *									registered with.
 		 * @param[out]	includes			A list of all include files included by the BSL source.
 		 * @return							A result object containing an error message if not successful.
 		 */
 		static BSLFXCompileResult compileShader(String source, const UnorderedMap<String, String>& defines, 
-				ShadingLanguageFlags languages, SHADER_DESC& shaderDesc, Vector<String>& includes);
+				ShadingLanguageFlags languages, const BSLProgramCache* cache, bool parallel, SHADER_DESC& shaderDesc, 
+				Vector<String>& includes);
+
+		/**
+		 * Looks up the sources of all the includes encountered while parsing. Includes in disabled conditional blocks are
+		 * skipped by the lexer, so variations can reference includes not found here. Those are looked up by 
+		 * compileTechniques() as they are encountered.
+		 *
+		 * @param[in]	parseState		Parser state object that has previously been used for parsing the source.
+		 * @param[out]	includeSources	Map of include names and their sources.
+		 */
+		static void resolveIncludes(ParseState* parseState, UnorderedMap<String, String>& includeSources);
+
+		/** 
+		 * Looks up the source of a single include and adds it to the @p includeSources map. Returns false if the include
+		 * cannot be found. 
+		 */
+		static bool resolveInclude(const String& name, UnorderedMap<String, String>& includeSources);
 
 		/**
 		 * Uses the provided list of shaders/mixins to generate a list of techniques. A technique is generated for
-		 * every variation and render backend.
+		 * every variation and render backend. Variations are parsed and cross-compiled in parallel if requested and the 
+		 * task scheduler is running.
 		 * 
 		 * @param[in]	shaderMetaData		A list of mixins and shaders. Shaders should contain a list of variations to
 		 *									generate (usually populated via a previous call to populateVariations()).
@@ -262,36 +317,71 @@ namespace bs
 		 *									needs to be re-parsed due to variations.
 		 * @param[in]	defines				An optional set of defines to set before parsing the source, that is to be
 		 *									applied to all variations.
+		 * @param[in, out]	includeSources	Sources of the includes referenced by the source, as output by
+		 *									resolveIncludes(). Includes referenced only by some variations are looked up
+		 *									and added to the map.
 		 * @param[in]	languages			Shading languages to generate techniques for. Each shader variation will be
 		 *									compiled into a separate technique for each of the provided languages.
+		 * @param[in]	cache				Cache to look up cross-compiled programs in, and to store them to. Can be null.
+		 * @param[in]	parallel			If true, variations are compiled in parallel when the task scheduler is 
+		 *									running.
 		 * @param[out]	shaderDesc			Shader descriptor that resulting techniques, and non-internal parameters will be
 		 *									registered with.
 		 * @param[out]	includes			A list of all include files included by the BSL source.
 		 * @return							A result object containing an error message if not successful.
 		 */
 		static BSLFXCompileResult compileTechniques(const Vector<std::pair<ASTFXNode*, ShaderMetaData>>& shaderMetaData,
-			const String& source, const UnorderedMap<String, String>& defines, ShadingLanguageFlags languages, 
-			SHADER_DESC& shaderDesc, Vector<String>& includes);
+			const String& source, const UnorderedMap<String, String>& defines, 
+			UnorderedMap<String, String>& includeSources, ShadingLanguageFlags languages, 
+			const BSLProgramCache* cache, bool parallel, SHADER_DESC& shaderDesc, Vector<String>& includes);
+
+		/**
+		 * Parses the provided source using the defines of a single variation, and cross-compiles the resulting programs.
+		 * Doesn't touch any shared state, allowing multiple variations to be compiled in parallel.
+		 *
+		 * @param[in]	source			BSL source to parse.
+		 * @param[in]	defines			Defines to apply in addition to the variation defines.
+		 * @param[in]	includeSources	Sources of the includes referenced by the source. Includes are only looked up in
+		 *								this map, so the importer is never accessed. If an include is missing, parsing
+		 *								fails and its name is recorded in CompiledVariation::missingInclude.
+		 * @param[in]	languages		Shading languages to generate programs for.
+		 * @param[in]	cache			Cache to look up cross-compiled programs in, and to store them to. Can be null.
+		 * @param[in]	parallel		If true, passes are cross-compiled in parallel when the task scheduler is running.
+		 * @param[in, out]	variation	Variation to compile. Name and variation must be set, and the rest of the fields
+		 *								will be populated with the results.
+		 */
+		static void compileVariation(const String& source, const UnorderedMap<String, String>& defines, 
+			const UnorderedMap<String, String>& includeSources, ShadingLanguageFlags languages, 
+			const BSLProgramCache* cache, bool parallel, CompiledVariation& variation);
 
 		/**
-		 * Generates a set of techniques for a single variation. Uses AST parse state as input, which must be created using
-		 * the defines of the relevant variation.
+		 * Generates the per-language shader data for a single variation. Uses AST parse state as input, which must be 
+		 * created using the defines of the relevant variation.
 		 *
 		 * @param[in, out]	parseState	Parser state object that has previously been initialized with the AST using 
-		 *								parseFX().
-		 * @param[in]	name			Name of the shader to generate the variation for.
+		 *								parseFX(). Deleted by the method.
 		 * @param[in]	codeBlocks		Blocks containing GPU program source code that are referenced by the AST.
-		 * @param[in]	variation		Shader variation the AST was parsed with.
 		 * @param[in]	languages		Shading languages to generate techniques for. Each shader variation will be
 		 *								compiled into a separate technique for each of the provided languages.
+		 * @param[in]	cache			Cache to look up cross-compiled programs in, and to store them to. Can be null.
+		 * @param[in]	parallel		If true, passes are cross-compiled in parallel when the task scheduler is running.
+		 * @param[in, out]	variation	Variation to output the shader data, parameters and includes to.
+		 * @return						A result object containing an error message if not successful.
+		 */
+		static BSLFXCompileResult compileTechniques(ParseState* parseState, const Vector<String>& codeBlocks, 
+			ShadingLanguageFlags languages, const BSLProgramCache* cache, bool parallel, CompiledVariation& variation);
+
+		/**
+		 * Registers the techniques, parameters and includes of a compiled variation. Variations must be registered in the
+		 * same order every time to keep the output deterministic.
+		 *
+		 * @param[in]	variation		Variation previously compiled with compileVariation().
 		 * @param[out]	includes		Set to append newly found includes to.
 		 * @param[out]	shaderDesc		Shader descriptor that resulting techniques, and non-internal parameters will be
 		 *								registered with.
-		 * @return						A result object containing an error message if not successful.
 		 */
-		static BSLFXCompileResult compileTechniques(ParseState* parseState, const String& name, 
-			const Vector<String>& codeBlocks, const ShaderVariation& variation, ShadingLanguageFlags languages, 
-			UnorderedSet<String>& includes, SHADER_DESC& shaderDesc);
+		static void createTechniques(const CompiledVariation& variation, UnorderedSet<String>& includes, 
+			SHADER_DESC& shaderDesc);
 
 		/**
 		 * Converts a null-terminated string into a standard string, and eliminates quotes that are assumed to be at the 
@@ -25,7 +25,7 @@ namespace bs
 	{
 		String source;
 		{
-			Lock fileLock = FileScheduler::getLock(filePath);
+			SharedLock fileLock = FileScheduler::getReadLock(filePath);
 
 			SPtr<DataStream> stream = FileSystem::openFile(filePath);
 			source = stream->getAsString();
@@ -33,7 +33,8 @@ namespace bs
 
 		SPtr<const ShaderImportOptions> io = std::static_pointer_cast<const ShaderImportOptions>(importOptions);
 		String shaderName = filePath.getFilename(false);
-		BSLFXCompileResult result = BSLFXCompiler::compile(shaderName, source, io->getDefines(), io->languages);
+		BSLFXCompileResult result = BSLFXCompiler::compile(shaderName, source, io->getDefines(), io->languages,
+			io->cacheDirectory);
 
 		if (result.shader != nullptr)
 			result.shader->setName(shaderName);
@@ -0,0 +1,350 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#include "BsSLProgramCache.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Utility/BsUUID.h"
+
+namespace bs
+{
+	/** Identifier at the start of every cache entry file. */
+	static constexpr UINT32 CACHE_MAGIC = 0x43534C42; // "BSLC"
+
+	/**
+	 * Version of the cache entry format and of the code generation in BSLFXCompiler. Must be increased whenever either
+	 * changes, so that stale entries are no longer found.
+	 */
+	static constexpr UINT32 CACHE_VERSION = 1;
+
+	/** Age after which temporary files are considered abandoned by writers that didn't finish, in seconds. */
+	static constexpr std::time_t TEMP_FILE_TIMEOUT = 60 * 60;
+
+	/** Fraction of the maximum size the entries are reduced to when they exceed it, so pruning doesn't run every time. */
+	static constexpr UINT64 PRUNE_TARGET_PERCENT = 75;
+
+	/** Cache folders that were already pruned by this process. */
+	static UnorderedSet<String> sPrunedDirectories;
+	static Mutex sPrunedDirectoriesMutex;
+
+	/** Appends plain values and strings to a memory buffer. */
+	class CacheWriter
+	{
+	public:
+		template<class T>
+		void write(const T& value)
+		{
+			const auto data = (const UINT8*)&value;
+			mData.insert(mData.end(), data, data + sizeof(T));
+		}
+
+		void write(const String& value)
+		{
+			write((UINT32)value.size());
+			mData.insert(mData.end(), value.begin(), value.end());
+		}
+
+		const Vector<UINT8>& getData() const { return mData; }
+
+	private:
+		Vector<UINT8> mData;
+	};
+
+	/** Reads plain values and strings from a memory buffer. Reads fail when attempting to read past the buffer end. */
+	class CacheReader
+	{
+	public:
+		CacheReader(const UINT8* data, size_t size)
+			:mData(data), mSize(size)
+		{ }
+
+		template<class T>
+		bool read(T& value)
+		{
+			if (mPos + sizeof(T) > mSize)
+				return false;
+
+			memcpy(&value, mData + mPos, sizeof(T));
+			mPos += sizeof(T);
+			return true;
+		}
+
+		bool read(String& value)
+		{
+			UINT32 size = 0;
+			if (!read(size) || mPos + size > mSize)
+				return false;
+
+			value.assign((const char*)mData + mPos, size);
+			mPos += size;
+			return true;
+		}
+
+		bool eof() const { return mPos == mSize; }
+
+	private:
+		const UINT8* mData;
+		size_t mSize;
+		size_t mPos = 0;
+	};
+
+	BSLProgramCache::BSLProgramCache(const Path& directory, const String& compilerVersion, UINT64 maxSize)
+		:mDirectory(directory)
+	{
+		mDirectory.makeAbsolute(FileSystem::getWorkingDirectoryPath());
+
+		StringStream buildSource;
+		buildSource << CACHE_VERSION << "/" << compilerVersion;
+		mDirectory.append(md5(buildSource.str()) + "/");
+
+		if (!FileSystem::exists(mDirectory))
+			FileSystem::createDir(mDirectory);
+
+		bool firstUse;
+		{
+			Lock lock(sPrunedDirectoriesMutex);
+			firstUse = sPrunedDirectories.insert(mDirectory.toString()).second;
+		}
+
+		if (firstUse)
+			prune(maxSize);
+	}
+
+	String BSLProgramCache::getKey(const String& code, ShadingLanguageFlags languages, bool highEnd,
+		const String& compilerVersion)
+	{
+		StringStream keySource;
+		keySource << CACHE_VERSION << "/" << compilerVersion << "/" << (UINT32)languages << "/" << (highEnd ? 1 : 0);
+		keySource << "/" << code;
+		return md5(keySource.str());
+	}
+
+	bool BSLProgramCache::load(const String& key, BSLPassPrograms& output) const
+	{
+		const Path entryPath = getEntryPath(key);
+		if (!FileSystem::isFile(entryPath))
+			return false;
+
+		SPtr<DataStream> stream = FileSystem::openFile(entryPath);
+		if (stream == nullptr)
+			return false;
+
+		Vector<UINT8> data(stream->size());
+		if (stream->read(data.data(), data.size()) != data.size())
+			return false;
+
+		stream->close();
+
+		CacheReader reader(data.data(), data.size());
+		BSLPassPrograms programs;
+
+		UINT32 magic = 0;
+		UINT32 version = 0;
+		if (!reader.read(magic) || !reader.read(version) || magic != CACHE_MAGIC || version != CACHE_VERSION)
+			return false;
+
+		UINT32 numTypes = 0;
+		if (!reader.read(numTypes) || numTypes > GPT_COUNT)
+			return false;
+
+		programs.types.resize(numTypes);
+		for (auto& entry : programs.types)
+		{
+			UINT32 type = 0;
+			if (!reader.read(type) || type >= GPT_COUNT)
+				return false;
+
+			entry = (GpuProgramType)type;
+		}
+
+		UINT32 numParams = 0;
+		if (!reader.read(numParams))
+			return false;
+
+		for (UINT32 i = 0; i < numParams; i++)
+		{
+			BSLReflectedParam param;
+			UINT32 type = 0;
+			UINT32 objectType = 0;
+			UINT32 dataType = 0;
+			UINT8 hasDefault = 0;
+			UINT8 hasSamplerInfo = 0;
+
+			bool success = reader.read(type) && reader.read(param.name) && reader.read(param.alias) &&
+				reader.read(objectType) && reader.read(dataType) && reader.read(param.arraySize) &&
+				reader.read(param.elementSize) && reader.read(hasDefault) && reader.read(hasSamplerInfo) &&
+				reader.read(param.defaultTexture) && reader.read(param.defaultSampler) &&
+				reader.read(param.defaultValue) && reader.read(param.spriteUVRef);
+
+			if (!success || type > (UINT32)BSLReflectedParamType::Data)
+				return false;
+
+			param.type = (BSLReflectedParamType)type;
+			param.objectType = (GpuParamObjectType)objectType;
+			param.dataType = (GpuParamDataType)dataType;
+			param.hasDefault = hasDefault != 0;
+			param.hasSamplerInfo = hasSamplerInfo != 0;
+
+			programs.params.push_back(param);
+		}
+
+		if (!reader.read(programs.hlsl))
+			return false;
+
+		for (auto& entry : programs.glsl)
+		{
+			if (!reader.read(entry))
+				return false;
+		}
+
+		for (auto& entry : programs.vksl)
+		{
+			if (!reader.read(entry))
+				return false;
+		}
+
+		if (!reader.eof())
+			return false;
+
+		output = std::move(programs);
+		return true;
+	}
+
+	void BSLProgramCache::save(const String& key, const BSLPassPrograms& programs) const
+	{
+		const Path entryPath = getEntryPath(key);
+		if (FileSystem::exists(entryPath))
+			return;
+
+		CacheWriter writer;
+		writer.write(CACHE_MAGIC);
+		writer.write(CACHE_VERSION);
+
+		writer.write((UINT32)programs.types.size());
+		for (auto& entry : programs.types)
+			writer.write((UINT32)entry);
+
+		writer.write((UINT32)programs.params.size());
+		for (auto& entry : programs.params)
+		{
+			writer.write((UINT32)entry.type);
+			writer.write(entry.name);
+			writer.write(entry.alias);
+			writer.write((UINT32)entry.objectType);
+			writer.write((UINT32)entry.dataType);
+			writer.write(entry.arraySize);
+			writer.write(entry.elementSize);
+			writer.write((UINT8)(entry.hasDefault ? 1 : 0));
+			writer.write((UINT8)(entry.hasSamplerInfo ? 1 : 0));
+			writer.write(entry.defaultTexture);
+			writer.write(entry.defaultSampler);
+			writer.write(entry.defaultValue);
+			writer.write(entry.spriteUVRef);
+		}
+
+		writer.write(programs.hlsl);
+
+		for (auto& entry : programs.glsl)
+			writer.write(entry);
+
+		for (auto& entry : programs.vksl)
+			writer.write(entry);
+
+		// Write to a uniquely named file first and move it in place once complete, so other threads or processes never
+		// see a partially written entry. If two writers race, both write identical contents so either can win.
+		const Path tempPath = mDirectory + (key + "." + UUIDGenerator::generateRandom().toString() + ".tmp");
+
+		SPtr<DataStream> stream = FileSystem::createAndOpenFile(tempPath);
+		if (stream == nullptr)
+			return;
+
+		const Vector<UINT8>& data = writer.getData();
+		const size_t written = stream->write(data.data(), data.size());
+		stream->close();
+
+		// Another writer finishing first is a success as well, since entries with the same key are identical
+		if (written == data.size() && !FileSystem::exists(entryPath))
+			FileSystem::move(tempPath, entryPath, false);
+
+		if (FileSystem::exists(tempPath))
+			FileSystem::remove(tempPath);
+	}
+
+	Path BSLProgramCache::getEntryPath(const String& key) const
+	{
+		return mDirectory + (key + ".bslc");
+	}
+
+	void BSLProgramCache::prune(UINT64 maxSize) const
+	{
+		// Other compiler builds (and cache format versions) can never produce a hit for this build
+		const Path rootDirectory = mDirectory.getParent();
+		const String& buildDirectory = mDirectory.getTail();
+
+		Vector<Path> files;
+		Vector<Path> directories;
+		FileSystem::getChildren(rootDirectory, files, directories);
+
+		for (auto& entry : directories)
+		{
+			if (entry.getTail() != buildDirectory)
+				FileSystem::remove(entry, true);
+		}
+
+		// Entries from before they were stored per build
+		for (auto& entry : files)
+		{
+			const String extension = entry.getExtension();
+			if (extension == ".bslc" || extension == ".tmp")
+				FileSystem::remove(entry);
+		}
+
+		struct Entry
+		{
+			Path path;
+			std::time_t modifiedTime;
+			UINT64 size;
+		};
+
+		const std::time_t now = std::time(nullptr);
+		Vector<Entry> entries;
+		UINT64 totalSize = 0;
+
+		files.clear();
+		directories.clear();
+		FileSystem::getChildren(mDirectory, files, directories);
+
+		for (auto& entry : files)
+		{
+			const std::time_t modifiedTime = FileSystem::getLastModifiedTime(entry);
+			const String extension = entry.getExtension();
+
+			if (extension == ".tmp")
+			{
+				if (now - modifiedTime > TEMP_FILE_TIMEOUT)
+					FileSystem::remove(entry);
+			}
+			else if (extension == ".bslc")
+			{
+				const UINT64 size = FileSystem::getFileSize(entry);
+				entries.push_back({ entry, modifiedTime, size });
+				totalSize += size;
+			}
+		}
+
+		if (totalSize <= maxSize)
+			return;
+
+		std::sort(entries.begin(), entries.end(), 
+			[](const Entry& a, const Entry& b) { return a.modifiedTime < b.modifiedTime; });
+
+		const UINT64 targetSize = maxSize / 100 * PRUNE_TARGET_PERCENT;
+		for (auto& entry : entries)
+		{
+			if (totalSize <= targetSize)
+				break;
+
+			FileSystem::remove(entry.path);
+			totalSize -= entry.size;
+		}
+	}
+}
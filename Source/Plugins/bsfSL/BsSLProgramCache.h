@@ -0,0 +1,135 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#pragma once
+
+#include "BsSLPrerequisites.h"
+#include "RenderAPI/BsSamplerState.h"
+#include "Importer/BsShaderImportOptions.h"
+
+namespace bs
+{
+	/** @addtogroup bsfSL
+	 *  @{
+	 */
+
+	/** Types of shader parameters that can be reported by GPU program reflection. */
+	enum class BSLReflectedParamType
+	{
+		ParamBlock, Texture, Buffer, Sampler, Data
+	};
+
+	/**
+	 * Information about a single shader parameter reported by GPU program reflection, in a form that can be registered
+	 * with a shader descriptor later, or cached.
+	 */
+	struct BSLReflectedParam
+	{
+		BSLReflectedParamType type = BSLReflectedParamType::Data;
+		String name;
+
+		/** Alternative name of a sampler parameter. Empty if none. */
+		String alias;
+
+		GpuParamObjectType objectType = GPOT_UNKNOWN;
+		GpuParamDataType dataType = GPDT_UNKNOWN;
+		UINT32 arraySize = 1;
+		UINT32 elementSize = 0;
+
+		/** True if a default value was provided (builtin texture, sampler state or data value, depending on type). */
+		bool hasDefault = false;
+
+		/**
+		 * True if the sampler parameter had sampler state information. Samplers without it are registered even if a
+		 * parameter with the same name already exists.
+		 */
+		bool hasSamplerInfo = false;
+
+		/** Index of the builtin texture to use as the default value of a texture parameter. */
+		UINT32 defaultTexture = 0;
+
+		/** Default value of a sampler parameter. */
+		SAMPLER_STATE_DESC defaultSampler;
+
+		/** Default value of a data parameter. Large enough for the largest data type (4x4 matrix). */
+		UINT8 defaultValue[64] = { };
+
+		/** Name of the texture whose sprite UVs to use for this parameter. Empty if none. */
+		String spriteUVRef;
+	};
+
+	/** Reflection information and cross-compiled programs generated from the HLSL code of a single pass. */
+	struct BSLPassPrograms
+	{
+		/** Types of programs whose entry points were found in the code. */
+		Vector<GpuProgramType> types;
+
+		/** Parameters reported by the reflection. */
+		Vector<BSLReflectedParam> params;
+
+		/** HLSL code with non-standard syntax removed. Shared between all program types. */
+		String hlsl;
+
+		/** GLSL code for each program type. Empty for types that aren't present. */
+		String glsl[GPT_COUNT];
+
+		/** Vulkan GLSL code for each program type. Empty for types that aren't present. */
+		String vksl[GPT_COUNT];
+	};
+
+	/**
+	 * Persistent on-disk cache for the results of GPU program reflection and cross-compilation. Entries are addressed by
+	 * a hash of everything that affects the output (preprocessed source, target languages and compiler version), which
+	 * makes them immutable and allows a single cache directory to be shared between multiple processes: entries are
+	 * written to a temporary file and then moved in place, so readers never observe partially written entries.
+	 *
+	 * Entries are stored in a sub-folder specific to the cross-compiler build. The first time a cache folder is used in a
+	 * process, sub-folders of other builds are removed, along with temporary files left behind by writers that didn't
+	 * finish. If the entries still exceed the maximum size, the oldest ones are removed.
+	 */
+	class BSLProgramCache
+	{
+	public:
+		/** Default maximum size of all the entries in a cache folder, in bytes. */
+		static constexpr UINT64 DEFAULT_MAX_SIZE = 256 * 1024 * 1024;
+
+		/**
+		 * Creates a cache that stores its entries in the provided folder. Folder is created if it doesn't exist.
+		 *
+		 * @param[in]	directory		Folder to store the entries in.
+		 * @param[in]	compilerVersion	Identifier of the cross-compiler build. Entries of other builds are removed.
+		 * @param[in]	maxSize			Maximum size of all the entries, in bytes. Oldest entries are removed when the
+		 *								cache folder is first used and exceeds this size.
+		 */
+		BSLProgramCache(const Path& directory, const String& compilerVersion, UINT64 maxSize = DEFAULT_MAX_SIZE);
+
+		/**
+		 * Generates the key used for looking up an entry.
+		 *
+		 * @param[in]	code			Preprocessed HLSL code of the pass.
+		 * @param[in]	languages		Languages the code is to be cross-compiled to.
+		 * @param[in]	highEnd			True if cross-compiling to GLSL for the high-end feature set, false otherwise.
+		 * @param[in]	compilerVersion	Identifier of the cross-compiler build. Entries generated by other builds of the
+		 *								cross-compiler are not found.
+		 * @return						Key to use for the load() and save() calls.
+		 */
+		static String getKey(const String& code, ShadingLanguageFlags languages, bool highEnd, 
+			const String& compilerVersion);
+
+		/** Attempts to find the entry with the provided key. Returns false if no valid entry exists. */
+		bool load(const String& key, BSLPassPrograms& output) const;
+
+		/** Adds a new entry to the cache. Does nothing if the entry already exists. */
+		void save(const String& key, const BSLPassPrograms& programs) const;
+
+	private:
+		/** Returns the path to the file storing the entry with the provided key. */
+		Path getEntryPath(const String& key) const;
+
+		/** Removes entries of other compiler builds, stale temporary files and oldest entries over @p maxSize. */
+		void prune(UINT64 maxSize) const;
+
+		Path mDirectory;
+	};
+
+	/** @} */
+}
@@ -4,6 +4,7 @@ set(BS_SL_INC_NOFILTER
 	"BsMMAlloc.h"
 	"BsSLImporter.h"
 	"BsSLFXCompiler.h"
+	"BsSLProgramCache.h"
 	"BsIncludeHandler.h"
 	"BsLexerFX.h"
 	"BsParserFX.h"
@@ -14,6 +15,7 @@ set(BS_SL_SRC_NOFILTER
 	"BsASTFX.c"
 	"BsSLImporter.cpp"
 	"BsSLFXCompiler.cpp"
+	"BsSLProgramCache.cpp"
 	"BsIncludeHandler.cpp"
 	"BSMMAlloc.c"
 	"BsLexerFX.c"
@@ -0,0 +1,587 @@
+//************************************ bs::framework - Copyright 2018 Marko Pintera **************************************//
+//*********** Licensed under the MIT license. See LICENSE.md for full terms. This notice is not to be removed. ***********//
+#include "Testing/BsConsoleTestOutput.h"
+#include "Testing/BsTestSuite.h"
+#include "CoreThread/BsCoreThread.h"
+#include "CoreThread/BsCoreObjectManager.h"
+#include "Threading/BsThreadPool.h"
+#include "Threading/BsTaskScheduler.h"
+#include "Managers/BsGpuProgramManager.h"
+#include "Material/BsShaderManager.h"
+#include "Material/BsShaderInclude.h"
+#include "Material/BsShader.h"
+#include "Material/BsTechnique.h"
+#include "Material/BsPass.h"
+#include "Resources/BsResources.h"
+#include "Renderer/BsRendererManager.h"
+#include "Utility/BsUUID.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "BsSLProgramCache.h"
+#include "BsSLFXCompiler.h"
+
+namespace bs
+{
+	/** Provides shader includes from memory, instead of loading them from disk. */
+	class TestShaderIncludeHandler : public IShaderIncludeHandler
+	{
+	public:
+		HShaderInclude findInclude(const String& name) const override
+		{
+			if (name == "TestFog.bslinc")
+			{
+				return ShaderInclude::create(R"(
+					mixin TestFog
+					{
+						code
+						{
+							cbuffer FogParams
+							{
+								float4 gFogColor;
+							}
+
+							float4 applyFog(float4 color)
+							{
+								return lerp(color, gFogColor, gFogColor.a);
+							}
+						};
+					};
+				)");
+			}
+
+			if (name != "TestCommon.bslinc")
+				return HShaderInclude();
+
+			return ShaderInclude::create(R"(
+				mixin TestCommon
+				{
+					code
+					{
+						cbuffer Params
+						{
+							float4x4 gMatViewProj;
+							float4 gTint;
+						}
+
+						float4 applyTint(float4 color)
+						{
+							return color * gTint;
+						}
+					};
+				};
+			)");
+		}
+	};
+
+	/** Checks if two shaders contain the same techniques, with byte-identical GPU programs in the same order. */
+	bool sameProgramSources(const Shader& a, const Shader& b)
+	{
+		const Vector<SPtr<Technique>>& techniquesA = a.getTechniques();
+		const Vector<SPtr<Technique>>& techniquesB = b.getTechniques();
+		if (techniquesA.size() != techniquesB.size())
+			return false;
+
+		for (UINT32 i = 0; i < (UINT32)techniquesA.size(); i++)
+		{
+			const SPtr<Technique>& techniqueA = techniquesA[i];
+			const SPtr<Technique>& techniqueB = techniquesB[i];
+			if (!(techniqueA->getVariation() == techniqueB->getVariation()) || 
+				techniqueA->getNumPasses() != techniqueB->getNumPasses())
+				return false;
+
+			for (UINT32 j = 0; j < techniqueA->getNumPasses(); j++)
+			{
+				for (UINT32 k = 0; k < GPT_COUNT; k++)
+				{
+					const GPU_PROGRAM_DESC& descA = techniqueA->getPass(j)->getProgramDesc((GpuProgramType)k);
+					const GPU_PROGRAM_DESC& descB = techniqueB->getPass(j)->getProgramDesc((GpuProgramType)k);
+
+					if (descA.language != descB.language || descA.entryPoint != descB.entryPoint ||
+						descA.source != descB.source)
+						return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	class SLTestSuite : public TestSuite
+	{
+	public:
+		SLTestSuite();
+
+		void startUp() override;
+		void shutDown() override;
+
+	private:
+		void testBSLProgramCache();
+		void testBSLParallelCompile();
+		void testBSLVariationInclude();
+	};
+
+	SLTestSuite::SLTestSuite()
+	{
+		BS_ADD_TEST(SLTestSuite::testBSLProgramCache);
+		BS_ADD_TEST(SLTestSuite::testBSLParallelCompile);
+		BS_ADD_TEST(SLTestSuite::testBSLVariationInclude);
+	}
+
+	void SLTestSuite::startUp()
+	{
+		MemStack::beginThread();
+		ThreadPool::startUp<TThreadPool<ThreadDefaultPolicy>>(4);
+		TaskScheduler::startUp();
+
+		CoreThread::startUp();
+		CoreObjectManager::startUp();
+
+		// No render API is started, so no technique is supported and the compiler only produces the program descriptors
+		GpuProgramManager::startUp();
+		ct::GpuProgramManager::startUp();
+		Resources::startUp();
+		RendererManager::startUp();
+		ShaderManager::startUp(bs_shared_ptr_new<TestShaderIncludeHandler>());
+	}
+
+	void SLTestSuite::shutDown()
+	{
+		CoreObjectManager::instance().syncToCore();
+		gCoreThread().update();
+		gCoreThread().submitAll(true);
+
+		ShaderManager::shutDown();
+		RendererManager::shutDown();
+		Resources::shutDown();
+		ct::GpuProgramManager::shutDown();
+		GpuProgramManager::shutDown();
+
+		CoreObjectManager::shutDown();
+		CoreThread::shutDown();
+		TaskScheduler::shutDown();
+		ThreadPool::shutDown();
+		MemStack::endThread();
+	}
+
+	void SLTestSuite::testBSLProgramCache()
+	{
+		Path cacheDirectory = FileSystem::getTempDirectoryPath();
+		cacheDirectory.append("BSLProgramCacheTest-" + UUIDGenerator::generateRandom().toString() + "/");
+
+		BSLProgramCache cache(cacheDirectory, "1");
+
+		BSLPassPrograms programs;
+		programs.types = { GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM };
+
+		BSLReflectedParam textureParam;
+		textureParam.type = BSLReflectedParamType::Texture;
+		textureParam.name = "gAlbedoTex";
+		textureParam.objectType = GPOT_TEXTURE2D;
+		textureParam.hasDefault = true;
+		textureParam.defaultTexture = 2;
+		textureParam.spriteUVRef = "gAlbedoTex";
+		programs.params.push_back(textureParam);
+
+		BSLReflectedParam samplerParam;
+		samplerParam.type = BSLReflectedParamType::Sampler;
+		samplerParam.name = "gAlbedoSamp";
+		samplerParam.alias = "gAlbedoTex";
+		samplerParam.objectType = GPOT_SAMPLER2D;
+		samplerParam.hasDefault = true;
+		samplerParam.hasSamplerInfo = true;
+		samplerParam.defaultSampler.maxAniso = 8;
+		programs.params.push_back(samplerParam);
+
+		BSLReflectedParam dataParam;
+		dataParam.type = BSLReflectedParamType::Data;
+		dataParam.name = "gTint";
+		dataParam.dataType = GPDT_FLOAT4;
+		dataParam.arraySize = 2;
+		dataParam.elementSize = 16;
+		dataParam.hasDefault = true;
+		for (UINT32 i = 0; i < sizeof(dataParam.defaultValue); i++)
+			dataParam.defaultValue[i] = (UINT8)i;
+		programs.params.push_back(dataParam);
+
+		programs.hlsl = "float4 fsmain() : SV_Target0 { return gTint[0]; }";
+		programs.glsl[GPT_FRAGMENT_PROGRAM] = "void main() { fragColor = gTint[0]; }";
+		programs.vksl[GPT_VERTEX_PROGRAM] = "void main() { gl_Position = vec4(0.0); }";
+
+		const String code = "float4 fsmain() : SV_Target0 { return gTint[0]; }";
+		const ShadingLanguageFlags languages = ShadingLanguageFlag::HLSL | ShadingLanguageFlag::GLSL;
+		const String key = BSLProgramCache::getKey(code, languages, true, "1");
+
+		BSLPassPrograms loaded;
+		BS_TEST_ASSERT(!cache.load(key, loaded));
+
+		// Everything saved must be restored exactly
+		cache.save(key, programs);
+		BS_TEST_ASSERT(cache.load(key, loaded));
+		BS_TEST_ASSERT(loaded.types == programs.types);
+		BS_TEST_ASSERT(loaded.hlsl == programs.hlsl);
+		for (UINT32 i = 0; i < GPT_COUNT; i++)
+		{
+			BS_TEST_ASSERT(loaded.glsl[i] == programs.glsl[i]);
+			BS_TEST_ASSERT(loaded.vksl[i] == programs.vksl[i]);
+		}
+
+		BS_TEST_ASSERT(loaded.params.size() == programs.params.size());
+		for (UINT32 i = 0; i < (UINT32)loaded.params.size() && i < (UINT32)programs.params.size(); i++)
+		{
+			const BSLReflectedParam& a = loaded.params[i];
+			const BSLReflectedParam& b = programs.params[i];
+
+			BS_TEST_ASSERT(a.type == b.type && a.name == b.name && a.alias == b.alias);
+			BS_TEST_ASSERT(a.objectType == b.objectType && a.dataType == b.dataType);
+			BS_TEST_ASSERT(a.arraySize == b.arraySize && a.elementSize == b.elementSize);
+			BS_TEST_ASSERT(a.hasDefault == b.hasDefault && a.hasSamplerInfo == b.hasSamplerInfo);
+			BS_TEST_ASSERT(a.defaultTexture == b.defaultTexture && a.spriteUVRef == b.spriteUVRef);
+			BS_TEST_ASSERT(a.defaultSampler.maxAniso == b.defaultSampler.maxAniso);
+			BS_TEST_ASSERT(memcmp(a.defaultValue, b.defaultValue, sizeof(a.defaultValue)) == 0);
+		}
+
+		// Changing any of the inputs must result in a miss
+		BS_TEST_ASSERT(!cache.load(BSLProgramCache::getKey(code, languages, true, "2"), loaded));
+		BS_TEST_ASSERT(!cache.load(BSLProgramCache::getKey(code, languages, false, "1"), loaded));
+		BS_TEST_ASSERT(!cache.load(BSLProgramCache::getKey(code, ShadingLanguageFlag::All, true, "1"), loaded));
+		BS_TEST_ASSERT(!cache.load(BSLProgramCache::getKey(code + " ", languages, true, "1"), loaded));
+
+		// Truncated entries must be rejected rather than partially loaded
+		Vector<Path> files;
+		Vector<Path> directories;
+		FileSystem::getChildren(cacheDirectory, files, directories);
+		BS_TEST_ASSERT(files.empty() && directories.size() == 1);
+
+		const Path buildDirectory = directories[0];
+		directories.clear();
+		FileSystem::getChildren(buildDirectory, files, directories);
+		BS_TEST_ASSERT(files.size() == 1);
+
+		if (files.size() == 1)
+		{
+			SPtr<DataStream> stream = FileSystem::openFile(files[0]);
+			Vector<UINT8> data(stream->size());
+			stream->read(data.data(), data.size());
+			stream->close();
+
+			for (auto truncatedSize : { data.size() - 1, data.size() / 2, (size_t)4 })
+			{
+				stream = FileSystem::createAndOpenFile(files[0]);
+				stream->write(data.data(), truncatedSize);
+				stream->close();
+
+				BS_TEST_ASSERT(!cache.load(key, loaded));
+			}
+		}
+
+		// Saving an entry that already exists leaves no temporary files behind
+		cache.save(key, programs);
+		cache.save(key, programs);
+
+		files.clear();
+		FileSystem::getChildren(buildDirectory, files, directories);
+		BS_TEST_ASSERT(files.size() == 1);
+
+		// Entries over the maximum size are evicted, when a cache folder is first used
+		for (UINT32 i = 0; i < 20; i++)
+			cache.save(BSLProgramCache::getKey(code + toString(i), languages, true, "1"), programs);
+
+		files.clear();
+		FileSystem::getChildren(buildDirectory, files, directories);
+
+		UINT64 entrySize = 0;
+		for (auto& entry : files)
+			entrySize = std::max(entrySize, FileSystem::getFileSize(entry));
+
+		Path copyDirectory = FileSystem::getTempDirectoryPath();
+		copyDirectory.append("BSLProgramCacheTest-" + UUIDGenerator::generateRandom().toString() + "/");
+
+		const Path copyBuildDirectory = copyDirectory + (buildDirectory.getTail() + "/");
+		FileSystem::createDir(copyBuildDirectory);
+
+		for (auto& entry : files)
+			FileSystem::copy(entry, copyBuildDirectory + entry.getFilename());
+
+		{
+			BSLProgramCache smallCache(copyDirectory, "1", entrySize * 10);
+		}
+
+		files.clear();
+		FileSystem::getChildren(copyBuildDirectory, files, directories);
+		BS_TEST_ASSERT(!files.empty() && files.size() * entrySize <= entrySize * 10 * 3 / 4);
+
+		FileSystem::remove(copyDirectory, true);
+
+		// Entries of other compiler builds are removed
+		BSLProgramCache otherCache(cacheDirectory, "2");
+		BS_TEST_ASSERT(!FileSystem::exists(buildDirectory));
+		BS_TEST_ASSERT(!otherCache.load(key, loaded));
+
+		FileSystem::remove(cacheDirectory, true);
+	}
+
+	void SLTestSuite::testBSLParallelCompile()
+	{
+		// Multiple variations and passes, with code coming from an include, so that both the variations and the passes
+		// get compiled on the worker threads
+		const String source = R"(
+			#include "TestCommon.bslinc"
+
+			shader TestParallelCompile
+			{
+				mixin TestCommon;
+
+				variations
+				{
+					USE_TEXTURE = { 0, 1 };
+					NUM_LIGHTS = { 1, 2, 4 };
+				};
+
+				pass
+				{
+					code
+					{
+						#if USE_TEXTURE
+						Texture2D gAlbedoTex;
+						SamplerState gAlbedoSamp;
+						#endif
+
+						void vsmain(
+							in float3 inPos : POSITION,
+							in float2 inUV : TEXCOORD0,
+							out float4 oPosition : SV_Position,
+							out float2 oUV : TEXCOORD0)
+						{
+							oPosition = mul(gMatViewProj, float4(inPos.xyz, 1));
+							oUV = inUV;
+						}
+
+						float4 fsmain(in float4 inPos : SV_Position, in float2 uv : TEXCOORD0) : SV_Target0
+						{
+							float4 color = float4(0, 0, 0, 0);
+							for (int i = 0; i < NUM_LIGHTS; i++)
+								color += applyTint(float4(uv, i, 1));
+
+							#if USE_TEXTURE
+							color *= gAlbedoTex.Sample(gAlbedoSamp, uv);
+							#endif
+
+							return color;
+						}
+					};
+				};
+
+				pass
+				{
+					blend
+					{
+						target
+						{
+							enabled = true;
+							color = { one, one, add };
+						};
+					};
+
+					code
+					{
+						void vsmain(in float3 inPos : POSITION, out float4 oPosition : SV_Position)
+						{
+							oPosition = mul(gMatViewProj, float4(inPos.xyz, 1));
+						}
+
+						float4 fsmain(in float4 inPos : SV_Position) : SV_Target0
+						{
+							return applyTint(float4(1, 1, 1, NUM_LIGHTS));
+						}
+					};
+				};
+			};
+		)";
+
+		const ShadingLanguageFlags languages = ShadingLanguageFlag::HLSL | ShadingLanguageFlag::GLSL;
+		BSLFXCompileResult parallelResult = BSLFXCompiler::compile("TestParallelCompile", source, {}, languages,
+			Path::BLANK, true);
+		BSLFXCompileResult serialResult = BSLFXCompiler::compile("TestParallelCompile", source, {}, languages,
+			Path::BLANK, false);
+
+		BS_TEST_ASSERT(parallelResult.errorMessage.empty());
+		BS_TEST_ASSERT(serialResult.errorMessage.empty());
+		BS_TEST_ASSERT(parallelResult.shader != nullptr && serialResult.shader != nullptr);
+
+		if (parallelResult.shader != nullptr && serialResult.shader != nullptr)
+		{
+			const Vector<SPtr<Technique>>& parallelTechniques = parallelResult.shader->getTechniques();
+			const Vector<SPtr<Technique>>& serialTechniques = serialResult.shader->getTechniques();
+			BS_TEST_ASSERT(!serialTechniques.empty());
+			BS_TEST_ASSERT(parallelTechniques.size() == serialTechniques.size());
+
+			Vector<ShaderVariation> variations;
+			const auto numTechniques = (UINT32)std::min(parallelTechniques.size(), serialTechniques.size());
+			for (UINT32 i = 0; i < numTechniques; i++)
+			{
+				const SPtr<Technique>& parallelTechnique = parallelTechniques[i];
+				const SPtr<Technique>& serialTechnique = serialTechniques[i];
+
+				BS_TEST_ASSERT(parallelTechnique->getVariation() == serialTechnique->getVariation());
+				BS_TEST_ASSERT(parallelTechnique->getNumPasses() == 2);
+				BS_TEST_ASSERT(parallelTechnique->getNumPasses() == serialTechnique->getNumPasses());
+
+				if (std::find(variations.begin(), variations.end(), serialTechnique->getVariation()) == variations.end())
+					variations.push_back(serialTechnique->getVariation());
+
+				const UINT32 numPasses = std::min(parallelTechnique->getNumPasses(), serialTechnique->getNumPasses());
+				for (UINT32 j = 0; j < numPasses; j++)
+				{
+					SPtr<Pass> parallelPass = parallelTechnique->getPass(j);
+					SPtr<Pass> serialPass = serialTechnique->getPass(j);
+
+					for (UINT32 k = 0; k < GPT_COUNT; k++)
+					{
+						const GPU_PROGRAM_DESC& parallelDesc = parallelPass->getProgramDesc((GpuProgramType)k);
+						const GPU_PROGRAM_DESC& serialDesc = serialPass->getProgramDesc((GpuProgramType)k);
+
+						BS_TEST_ASSERT(parallelDesc.language == serialDesc.language);
+						BS_TEST_ASSERT(parallelDesc.entryPoint == serialDesc.entryPoint);
+						BS_TEST_ASSERT(parallelDesc.source == serialDesc.source);
+					}
+
+					BS_TEST_ASSERT(!serialPass->getProgramDesc(GPT_VERTEX_PROGRAM).source.empty());
+					BS_TEST_ASSERT(!serialPass->getProgramDesc(GPT_FRAGMENT_PROGRAM).source.empty());
+				}
+			}
+
+			// Two values of USE_TEXTURE, times three values of NUM_LIGHTS
+			BS_TEST_ASSERT(variations.size() == 6);
+
+			const auto sameNames = [](const Map<String, SHADER_OBJECT_PARAM_DESC>& a,
+				const Map<String, SHADER_OBJECT_PARAM_DESC>& b)
+			{
+				if (a.size() != b.size())
+					return false;
+
+				return std::equal(a.begin(), a.end(), b.begin(),
+					[](const std::pair<const String, SHADER_OBJECT_PARAM_DESC>& lhs,
+						const std::pair<const String, SHADER_OBJECT_PARAM_DESC>& rhs)
+				{
+					return lhs.first == rhs.first;
+				});
+			};
+
+			const Map<String, SHADER_DATA_PARAM_DESC>& parallelDataParams = parallelResult.shader->getDataParams();
+			const Map<String, SHADER_DATA_PARAM_DESC>& serialDataParams = serialResult.shader->getDataParams();
+			BS_TEST_ASSERT(parallelDataParams.size() == serialDataParams.size());
+
+			for (auto& entry : serialDataParams)
+			{
+				auto iterFind = parallelDataParams.find(entry.first);
+				BS_TEST_ASSERT(iterFind != parallelDataParams.end());
+
+				if (iterFind != parallelDataParams.end())
+				{
+					BS_TEST_ASSERT(iterFind->second.type == entry.second.type);
+					BS_TEST_ASSERT(iterFind->second.arraySize == entry.second.arraySize);
+				}
+			}
+
+			BS_TEST_ASSERT(!serialResult.shader->getTextureParams().empty());
+			BS_TEST_ASSERT(sameNames(parallelResult.shader->getTextureParams(), serialResult.shader->getTextureParams()));
+			BS_TEST_ASSERT(sameNames(parallelResult.shader->getSamplerParams(), serialResult.shader->getSamplerParams()));
+			BS_TEST_ASSERT(sameNames(parallelResult.shader->getBufferParams(), serialResult.shader->getBufferParams()));
+		}
+
+		parallelResult.shader = nullptr;
+		serialResult.shader = nullptr;
+	}
+
+	void SLTestSuite::testBSLVariationInclude()
+	{
+		// The fog include is skipped by the lexer unless the variation enables it, so it is never seen when parsing the
+		// source with only the global defines
+		const String source = R"(
+			#include "TestCommon.bslinc"
+
+			#if USE_FOG
+			#include "TestFog.bslinc"
+			#endif
+
+			shader TestVariationInclude
+			{
+				mixin TestCommon;
+
+				#if USE_FOG
+				mixin TestFog;
+				#endif
+
+				variations
+				{
+					USE_FOG = { 0, 1 };
+				};
+
+				code
+				{
+					void vsmain(in float3 inPos : POSITION, out float4 oPosition : SV_Position)
+					{
+						oPosition = mul(gMatViewProj, float4(inPos.xyz, 1));
+					}
+
+					float4 fsmain(in float4 inPos : SV_Position) : SV_Target0
+					{
+						float4 color = applyTint(float4(1, 1, 1, 1));
+
+						#if USE_FOG
+						color = applyFog(color);
+						#endif
+
+						return color;
+					}
+				};
+			};
+		)";
+
+		const ShadingLanguageFlags languages = ShadingLanguageFlag::HLSL | ShadingLanguageFlag::GLSL;
+		BSLFXCompileResult results[2];
+		for (UINT32 i = 0; i < 2; i++)
+		{
+			// Parallel first, then serial
+			BSLFXCompileResult& result = results[i];
+			result = BSLFXCompiler::compile("TestVariationInclude", source, {}, languages, Path::BLANK, i == 0);
+
+			BS_TEST_ASSERT(result.errorMessage.empty());
+			BS_TEST_ASSERT(result.shader != nullptr);
+
+			if (result.shader == nullptr)
+				continue;
+
+			Vector<ShaderVariation> variations;
+			for (auto& technique : result.shader->getTechniques())
+			{
+				if (std::find(variations.begin(), variations.end(), technique->getVariation()) == variations.end())
+					variations.push_back(technique->getVariation());
+			}
+
+			// Both variations must compile, and the fog variation must pull in the parameters from its include
+			BS_TEST_ASSERT(variations.size() == 2);
+			BS_TEST_ASSERT(result.shader->getDataParams().count("gFogColor") == 1);
+			BS_TEST_ASSERT(result.shader->getDataParams().count("gTint") == 1);
+		}
+
+		// Includes found late by the parallel compile must not change the output
+		if (results[0].shader != nullptr && results[1].shader != nullptr)
+			BS_TEST_ASSERT(sameProgramSources(*results[0].shader, *results[1].shader));
+
+		results[0].shader = nullptr;
+		results[1].shader = nullptr;
+	}
+}
+
+using namespace bs;
+
+int main()
+{
+	SPtr<TestSuite> tests = SLTestSuite::create<SLTestSuite>();
+
+	ExceptionTestOutput testOutput;
+	tests->run(testOutput);
+
+	return 0;
+}
@@ -19,6 +19,7 @@ namespace bs
 		MonoString* audio;
 		MonoString* input;
 		bool physicsCooking;
+		uint32_t maxFramesInFlight;
 		__RENDER_WINDOW_DESCInterop primaryWindowDesc;
 		MonoArray* importers;
 	};
@@ -25,6 +25,7 @@ namespace bs
 			value.audio = "";
 			value.input = "";
 			value.physicsCooking = true;
+			value.maxFramesInFlight = 1;
 			value.primaryWindowDesc = RenderWindowDesc.Default();
 			value.importers = null;
 
@@ -47,6 +48,12 @@ namespace bs
 		/// cooking library.
 		/// </summary>
 		public bool physicsCooking;
+		/// <summary>
+		/// Maximum number of frames the core thread can be behind the simulation thread. Higher values allow the threads to 
+		/// overlap more and reduce stalls when one of them has an uneven workload, at the cost of increased input latency. 
+		/// Must be in range [1, 4].
+		/// </summary>
+		public uint maxFramesInFlight;
 		/// <summary>Describes the window to create during start-up.</summary>
 		public RenderWindowDesc primaryWindowDesc;
 		/// <summary>A list of importer plugins to load.</summary>
@@ -259,7 +259,8 @@ namespace bs
     {
         Box,
         Triangle,
-        Kaiser
+        Kaiser,
+        Lanczos
     };
 
     /// <summary>